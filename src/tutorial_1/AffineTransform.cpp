@@ -0,0 +1,156 @@
+//*****************************************************************************
+// FILE NAME:  AffineTransform.cpp
+//
+//*****************************************************************************
+#include "AffineTransform.h"
+
+// 3rd party includes
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AFFINE_TRANSFORM_SSE2
+#include <emmintrin.h>
+#endif
+
+// standard includes
+#include <cmath>
+
+//!***************************************************************
+//! @details:
+//! constructor, identity transform
+//!
+//!***************************************************************
+AffineTransform::AffineTransform()
+: a(1.0), b(0.0), c(0.0), d(0.0), e(1.0), f(0.0)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! builds the transform from where it takes three points, the
+//! origin and the points scale units along x and along y
+//!
+//! @param[in]: originX, originY
+//! where (0, 0) ends up
+//!
+//! @param[in]: unitXx, unitXy
+//! where (scale, 0) ends up
+//!
+//! @param[in]: unitYx, unitYy
+//! where (0, scale) ends up
+//!
+//! @param[in]: scale
+//! distance of the sample points from the origin
+//!
+//! @return: 
+//! AffineTransform
+//! 
+//!***************************************************************
+AffineTransform AffineTransform::FromBasis(double originX, double originY, double unitXx, double unitXy,
+	double unitYx, double unitYy, double scale)
+{
+	AffineTransform transform;
+	transform.a = (unitXx - originX) / scale;
+	transform.b = (unitYx - originX) / scale;
+	transform.c = originX;
+	transform.d = (unitXy - originY) / scale;
+	transform.e = (unitYy - originY) / scale;
+	transform.f = originY;
+
+	return transform;
+}
+
+//!***************************************************************
+//! @details:
+//! computes the transform that undoes this one
+//!
+//! @param[out]: inverse
+//! the inverse transform
+//!
+//! @return: 
+//! bool - false if the transform cannot be inverted
+//! 
+//!***************************************************************
+bool AffineTransform::Invert(AffineTransform& inverse) const
+{
+	double determinant = a * e - b * d;
+	if (std::fabs(determinant) < 1e-12)
+	{
+		return false;
+	}
+
+	double scale = 1.0 / determinant;
+	inverse.a = e * scale;
+	inverse.b = -b * scale;
+	inverse.d = -d * scale;
+	inverse.e = a * scale;
+	inverse.c = -(inverse.a * c + inverse.b * f);
+	inverse.f = -(inverse.d * c + inverse.e * f);
+
+	return true;
+}
+
+//!***************************************************************
+//! @details:
+//! transforms a single point
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void AffineTransform::Apply(double x, double y, double& outX, double& outY) const
+{
+	outX = a * x + b * y + c;
+	outY = d * x + e * y + f;
+}
+
+//!***************************************************************
+//! @details:
+//! transforms arrays of points, the output arrays may be the
+//! input arrays
+//!
+//! @param[in]: x, y
+//! coordinates of the points
+//!
+//! @param[in]: count
+//! number of points
+//!
+//! @param[out]: outX, outY
+//! transformed coordinates
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void AffineTransform::ApplyBatch(const double* x, const double* y, size_t count, double* outX, double* outY) const
+{
+	size_t i = 0;
+
+#if defined(AFFINE_TRANSFORM_SSE2)
+	const __m128d va = _mm_set1_pd(a);
+	const __m128d vb = _mm_set1_pd(b);
+	const __m128d vc = _mm_set1_pd(c);
+	const __m128d vd = _mm_set1_pd(d);
+	const __m128d ve = _mm_set1_pd(e);
+	const __m128d vf = _mm_set1_pd(f);
+
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128d px = _mm_loadu_pd(x + i);
+		__m128d py = _mm_loadu_pd(y + i);
+
+		__m128d rx = _mm_add_pd(_mm_add_pd(_mm_mul_pd(va, px), _mm_mul_pd(vb, py)), vc);
+		__m128d ry = _mm_add_pd(_mm_add_pd(_mm_mul_pd(vd, px), _mm_mul_pd(ve, py)), vf);
+
+		_mm_storeu_pd(outX + i, rx);
+		_mm_storeu_pd(outY + i, ry);
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		double px = x[i];
+		double py = y[i];
+		outX[i] = a * px + b * py + c;
+		outY[i] = d * px + e * py + f;
+	}
+}
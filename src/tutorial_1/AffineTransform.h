@@ -0,0 +1,34 @@
+//*****************************************************************************
+// FILE NAME:  AffineTransform.h
+//
+//*****************************************************************************
+#ifndef AFFINE_TRANSFORM_H_
+#define AFFINE_TRANSFORM_H_
+
+#include <cstddef>
+
+//! 2d affine transform
+//!   x' = a * x + b * y + c
+//!   y' = d * x + e * y + f
+//! with a batch version that converts arrays of points, two at a time
+//! with SSE2 where available
+struct AffineTransform
+{
+	AffineTransform();
+
+	static AffineTransform FromBasis(double originX, double originY, double unitXx, double unitXy,
+		double unitYx, double unitYy, double scale);
+
+	bool Invert(AffineTransform& inverse) const;
+	void Apply(double x, double y, double& outX, double& outY) const;
+	void ApplyBatch(const double* x, const double* y, size_t count, double* outX, double* outY) const;
+
+	double a;
+	double b;
+	double c;
+	double d;
+	double e;
+	double f;
+};
+
+#endif
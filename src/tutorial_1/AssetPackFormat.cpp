@@ -0,0 +1,519 @@
+//*****************************************************************************
+// FILE NAME:  AssetPackFormat.cpp
+//
+//*****************************************************************************
+#include "AssetPackFormat.h"
+
+// standard includes
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+	//!***************************************************************
+	//! @details:
+	//! rounds an offset up to the blob alignment
+	//!
+	//! @param[in]: offset
+	//! byte offset
+	//!
+	//! @return:
+	//! uint64_t
+	//!
+	//!***************************************************************
+	uint64_t Align(uint64_t offset)
+	{
+		return (offset + AssetPack::BlobAlignment - 1) & ~static_cast<uint64_t>(AssetPack::BlobAlignment - 1);
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! writes zero bytes up to the next aligned offset
+	//!
+	//! @param[in]: out
+	//! the pack being written
+	//!
+	//! @param[in]: offset
+	//! current write offset, moved to the aligned offset
+	//!
+	//! @return:
+	//! void
+	//!
+	//!***************************************************************
+	void Pad(std::ofstream& out, uint64_t& offset)
+	{
+		static const char zeros[AssetPack::BlobAlignment] = { 0 };
+
+		uint64_t aligned = Align(offset);
+		out.write(zeros, static_cast<std::streamsize>(aligned - offset));
+		offset = aligned;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! turns a path into the form file names are stored in: forward
+//! slashes, no "." parts, ".." folded into the parent
+//!
+//! @param[in]: path
+//! path as built by the caller, e.g. "assets/maps/../objects"
+//!
+//! @return:
+//! std::string - e.g. "assets/objects"
+//!
+//!***************************************************************
+std::string AssetPack::NormalizePath(const std::string& path)
+{
+	std::vector<std::string> parts;
+	std::string part;
+
+	for (size_t i = 0; i <= path.size(); ++i)
+	{
+		char c = (i < path.size()) ? path[i] : '/';
+		if (c != '/' && c != '\\')
+		{
+			part += c;
+			continue;
+		}
+
+		if (part == "..")
+		{
+			if (!parts.empty() && parts.back() != "..")
+			{
+				parts.pop_back();
+			}
+			else
+			{
+				parts.push_back(part);
+			}
+		}
+		else if (!part.empty() && part != ".")
+		{
+			parts.push_back(part);
+		}
+		part.clear();
+	}
+
+	std::string result;
+	for (std::vector<std::string>::const_iterator it = parts.begin(); it != parts.end(); ++it)
+	{
+		if (!result.empty())
+		{
+			result += '/';
+		}
+		result += *it;
+	}
+
+	return result;
+}
+
+//!***************************************************************
+//! @details:
+//! orders files by name
+//!
+//!***************************************************************
+bool AssetPack::Writer::File::operator<(const File& rhs) const
+{
+	return name < rhs.name;
+}
+
+//!***************************************************************
+//! @details:
+//! adds a file to the pack, the file is read when the pack is
+//! written
+//!
+//! @param[in]: name
+//! name the file is looked up by
+//!
+//! @param[in]: path
+//! file on disk
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void AssetPack::Writer::AddFile(const std::string& name, const std::string& path)
+{
+	File file;
+	file.name = NormalizePath(name);
+	file.path = path;
+	m_files.push_back(file);
+}
+
+//!***************************************************************
+//! @details:
+//! number of files added
+//!
+//! @return:
+//! size_t
+//!
+//!***************************************************************
+size_t AssetPack::Writer::GetFileCount() const
+{
+	return m_files.size();
+}
+
+//!***************************************************************
+//! @details:
+//! writes the pack, the files are streamed through one at a time
+//!
+//! @param[in]: path
+//! pack file to write
+//!
+//! @return:
+//! bool - false if a file could not be read or written
+//!
+//!***************************************************************
+bool AssetPack::Writer::Write(const std::string& path) const
+{
+	std::vector<File> files(m_files);
+	std::sort(files.begin(), files.end());
+
+	std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+	if (!out)
+	{
+		return false;
+	}
+
+	// the header is written again once all offsets are known
+	Header header;
+	std::memset(&header, 0, sizeof(header));
+	header.magic = Magic;
+	header.version = Version;
+	header.entryCount = static_cast<uint32_t>(files.size());
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	uint64_t offset = sizeof(header);
+	std::vector<Entry> entries;
+	std::string names;
+	std::vector<char> buffer(64 * 1024);
+
+	for (std::vector<File>::const_iterator it = files.begin(); it != files.end(); ++it)
+	{
+		// a name added twice keeps the first file
+		if (!entries.empty() && it->name == (it - 1)->name)
+		{
+			--header.entryCount;
+			continue;
+		}
+
+		std::ifstream in(it->path.c_str(), std::ios::binary);
+		if (!in)
+		{
+			return false;
+		}
+
+		Pad(out, offset);
+
+		Entry entry;
+		entry.offset = offset;
+		entry.size = 0;
+		entry.name = names.size();
+
+		while (in)
+		{
+			in.read(&buffer[0], static_cast<std::streamsize>(buffer.size()));
+			std::streamsize count = in.gcount();
+			out.write(&buffer[0], count);
+			entry.size += static_cast<uint64_t>(count);
+		}
+
+		if (!in.eof())
+		{
+			return false;
+		}
+
+		offset += entry.size;
+		names.append(it->name.c_str(), it->name.size() + 1);
+		entries.push_back(entry);
+	}
+
+	Pad(out, offset);
+	header.names = offset;
+	header.namesSize = names.size();
+	out.write(names.data(), static_cast<std::streamsize>(names.size()));
+	offset += names.size();
+
+	Pad(out, offset);
+	header.entries = offset;
+	if (!entries.empty())
+	{
+		out.write(reinterpret_cast<const char*>(&entries[0]), static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+	}
+
+	out.seekp(0);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	return out.good();
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//!***************************************************************
+AssetPack::Reader::Reader()
+: m_data(0), m_size(0), m_header(0), m_entries(0), m_names(0)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! checks the header and that the index and every file lie
+//! inside the data, nothing is copied
+//!
+//! @param[in]: data
+//! start of the pack
+//!
+//! @param[in]: size
+//! size of the pack in bytes
+//!
+//! @return:
+//! bool - false if the data is not a valid pack
+//!
+//!***************************************************************
+bool AssetPack::Reader::Open(const unsigned char* data, size_t size)
+{
+	m_data = data;
+	m_size = size;
+	m_header = 0;
+
+	if (!data || size < sizeof(Header))
+	{
+		return false;
+	}
+
+	const Header* header = reinterpret_cast<const Header*>(data);
+	if (header->magic != Magic || header->version != Version ||
+		header->names > size || header->namesSize > size - header->names ||
+		header->entries > size || header->entryCount > (size - header->entries) / sizeof(Entry))
+	{
+		return false;
+	}
+
+	m_names = reinterpret_cast<const char*>(data + header->names);
+	m_entries = reinterpret_cast<const Entry*>(data + header->entries);
+
+	// names must be terminated inside the name data
+	if (header->namesSize > 0 && m_names[header->namesSize - 1] != '\0')
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i < header->entryCount; ++i)
+	{
+		const Entry& entry = m_entries[i];
+		if (entry.name >= header->namesSize || entry.offset > size || entry.size > size - entry.offset)
+		{
+			return false;
+		}
+	}
+
+	m_header = header;
+	return true;
+}
+
+//!***************************************************************
+//! @details:
+//! whether a valid pack is open
+//!
+//! @return:
+//! bool
+//!
+//!***************************************************************
+bool AssetPack::Reader::IsOpen() const
+{
+	return m_header != 0;
+}
+
+//!***************************************************************
+//! @details:
+//! looks up a file, the returned data points into the pack
+//!
+//! @param[in]: path
+//! file to find, it is normalized first
+//!
+//! @param[out]: data
+//! start of the file contents
+//!
+//! @param[out]: size
+//! size of the file in bytes
+//!
+//! @return:
+//! bool - false if the pack has no such file
+//!
+//!***************************************************************
+bool AssetPack::Reader::Find(const std::string& path, const unsigned char*& data, size_t& size) const
+{
+	if (!m_header)
+	{
+		return false;
+	}
+
+	std::string name = NormalizePath(path);
+	uint32_t index = LowerBound(name);
+	if (index == m_header->entryCount || name != GetName(index))
+	{
+		return false;
+	}
+
+	data = m_data + m_entries[index].offset;
+	size = static_cast<size_t>(m_entries[index].size);
+	return true;
+}
+
+//!***************************************************************
+//! @details:
+//! lists the files in a directory by their names relative to
+//! the directory, e.g. "walk/045_3.png" for recursive listings
+//!
+//! @param[in]: directory
+//! directory to list
+//!
+//! @param[in]: recursive
+//! true - include the files of sub directories
+//!
+//! @param[out]: files
+//! the files are appended to this
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void AssetPack::Reader::List(const std::string& directory, bool recursive, std::vector<std::string>& files) const
+{
+	if (!m_header)
+	{
+		return;
+	}
+
+	std::string prefix = NormalizePath(directory);
+	if (!prefix.empty())
+	{
+		prefix += '/';
+	}
+
+	for (uint32_t i = LowerBound(prefix); i < m_header->entryCount; ++i)
+	{
+		const char* name = GetName(i);
+		if (std::strncmp(name, prefix.c_str(), prefix.size()) != 0)
+		{
+			break;
+		}
+
+		const char* relative = name + prefix.size();
+		if (recursive || !std::strchr(relative, '/'))
+		{
+			files.push_back(relative);
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! lists the names of the directories inside a directory
+//!
+//! @param[in]: directory
+//! directory to list
+//!
+//! @param[out]: directories
+//! the directory names are appended to this
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void AssetPack::Reader::ListDirectories(const std::string& directory, std::vector<std::string>& directories) const
+{
+	if (!m_header)
+	{
+		return;
+	}
+
+	std::string prefix = NormalizePath(directory);
+	if (!prefix.empty())
+	{
+		prefix += '/';
+	}
+
+	for (uint32_t i = LowerBound(prefix); i < m_header->entryCount; ++i)
+	{
+		const char* name = GetName(i);
+		if (std::strncmp(name, prefix.c_str(), prefix.size()) != 0)
+		{
+			break;
+		}
+
+		// sorted names keep the files of a sub directory together
+		const char* relative = name + prefix.size();
+		const char* slash = std::strchr(relative, '/');
+		if (slash)
+		{
+			std::string child(relative, slash);
+			if (directories.empty() || directories.back() != child)
+			{
+				directories.push_back(child);
+			}
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! number of files in the pack
+//!
+//! @return:
+//! uint32_t
+//!
+//!***************************************************************
+uint32_t AssetPack::Reader::GetEntryCount() const
+{
+	return m_header ? m_header->entryCount : 0;
+}
+
+//!***************************************************************
+//! @details:
+//! name of an entry
+//!
+//! @return:
+//! const char*
+//!
+//!***************************************************************
+const char* AssetPack::Reader::GetName(uint32_t index) const
+{
+	return m_names + m_entries[index].name;
+}
+
+//!***************************************************************
+//! @details:
+//! first entry whose name is not less than the given name
+//!
+//! @return:
+//! uint32_t - the entry count if there is none
+//!
+//!***************************************************************
+uint32_t AssetPack::Reader::LowerBound(const std::string& name) const
+{
+	uint32_t first = 0;
+	uint32_t count = m_header->entryCount;
+
+	while (count > 0)
+	{
+		uint32_t step = count / 2;
+		uint32_t middle = first + step;
+
+		if (std::strcmp(GetName(middle), name.c_str()) < 0)
+		{
+			first = middle + 1;
+			count -= step + 1;
+		}
+		else
+		{
+			count = step;
+		}
+	}
+
+	return first;
+}
@@ -0,0 +1,99 @@
+//*****************************************************************************
+// FILE NAME:  AssetPackFormat.h
+//
+//*****************************************************************************
+#ifndef ASSET_PACK_FORMAT_H_
+#define ASSET_PACK_FORMAT_H_
+
+// this file is shared with the offline asset packer and must not
+// depend on the engine
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+//! asset pack layout, all files of the asset tree in one file that is
+//! read in place from a memory mapping. written in native byte order
+//!
+//! the header is followed by the file contents, each starting on the
+//! blob alignment, then the null terminated file names and the index.
+//! index entries are sorted by name so a file is found by binary search
+//! and a directory is one contiguous range of entries
+namespace AssetPack
+{
+	const uint32_t Magic = 0x4b504146; // "FAPK"
+	const uint32_t Version = 1;
+
+	// every file starts on this boundary, enough for any decoder
+	const uint32_t BlobAlignment = 16;
+
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t entryCount;
+		uint32_t reserved;
+		uint64_t names;
+		uint64_t namesSize;
+		uint64_t entries;
+	};
+
+	struct Entry
+	{
+		uint64_t offset;
+		uint64_t size;
+		uint64_t name;
+	};
+
+	std::string NormalizePath(const std::string& path);
+
+	//! collects the files and writes the pack
+	class Writer
+	{
+	public:
+		void AddFile(const std::string& name, const std::string& path);
+
+		size_t GetFileCount() const;
+
+		bool Write(const std::string& path) const;
+	private:
+		struct File
+		{
+			std::string name;
+			std::string path;
+
+			bool operator<(const File& rhs) const;
+		};
+
+		std::vector<File> m_files;
+	};
+
+	//! validates and looks up files of a pack held in memory
+	class Reader
+	{
+	public:
+		Reader();
+
+		bool Open(const unsigned char* data, size_t size);
+		bool IsOpen() const;
+
+		bool Find(const std::string& path, const unsigned char*& data, size_t& size) const;
+		void List(const std::string& directory, bool recursive, std::vector<std::string>& files) const;
+		void ListDirectories(const std::string& directory, std::vector<std::string>& directories) const;
+
+		uint32_t GetEntryCount() const;
+	private:
+		const char* GetName(uint32_t index) const;
+		uint32_t LowerBound(const std::string& name) const;
+	private:
+		const unsigned char* m_data;
+		size_t m_size;
+		const Header* m_header;
+		const Entry* m_entries;
+		const char* m_names;
+	};
+}
+
+#endif
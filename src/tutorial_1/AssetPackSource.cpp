@@ -0,0 +1,186 @@
+//*****************************************************************************
+// FILE NAME:  AssetPackSource.cpp
+//
+//*****************************************************************************
+#include "AssetPackSource.h"
+
+// fife includes
+#include "util/base/exception.h"
+#include "vfs/raw/rawdata.h"
+#include "vfs/raw/rawdatasource.h"
+
+// standard includes
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	//! raw data over a slice of the mapped pack, reads copy straight
+	//! from the mapping into the caller's buffer
+	class SliceSource : public FIFE::RawDataSource
+	{
+	public:
+		SliceSource(const unsigned char* data, size_t size)
+		: m_data(data), m_size(static_cast<uint32_t>(size))
+		{
+
+		}
+
+		virtual uint32_t getSize() const
+		{
+			return m_size;
+		}
+
+		virtual void readInto(uint8_t* buffer, uint32_t start, uint32_t length)
+		{
+			if (start > m_size || length > m_size - start)
+			{
+				throw FIFE::IndexOverflow(__FUNCTION__);
+			}
+
+			std::memcpy(buffer, m_data + start, length);
+		}
+	private:
+		const unsigned char* m_data;
+		uint32_t m_size;
+	};
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: vfs
+//! the engine's virtual file system
+//!
+//!***************************************************************
+AssetPackSource::AssetPackSource(FIFE::VFS* vfs)
+: FIFE::VFSSource(vfs)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! destructor, unmaps the pack
+//!
+//!***************************************************************
+AssetPackSource::~AssetPackSource()
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! maps the pack and checks its index
+//!
+//! @param[in]: path
+//! the pack file
+//!
+//! @return:
+//! bool - false if the file is missing or not a valid pack
+//!
+//!***************************************************************
+bool AssetPackSource::Open(const std::string& path)
+{
+	if (!m_file.Open(path) || !m_reader.Open(m_file.GetData(), m_file.GetSize()))
+	{
+		m_file.Close();
+		return false;
+	}
+
+	return true;
+}
+
+//!***************************************************************
+//! @details:
+//! the pack index, the slices it hands out stay valid for as
+//! long as the source lives
+//!
+//! @return:
+//! const AssetPack::Reader&
+//!
+//!***************************************************************
+const AssetPack::Reader& AssetPackSource::GetReader() const
+{
+	return m_reader;
+}
+
+//!***************************************************************
+//! @details:
+//! whether the pack has a file
+//!
+//! @param[in]: file
+//! path of the file
+//!
+//! @return:
+//! bool
+//!
+//!***************************************************************
+bool AssetPackSource::fileExists(const std::string& file) const
+{
+	const unsigned char* data = 0;
+	size_t size = 0;
+	return m_reader.Find(file, data, size);
+}
+
+//!***************************************************************
+//! @details:
+//! opens a file of the pack
+//!
+//! @param[in]: file
+//! path of the file
+//!
+//! @return:
+//! FIFE::RawData* - owned by the caller
+//!
+//!***************************************************************
+FIFE::RawData* AssetPackSource::open(const std::string& file) const
+{
+	const unsigned char* data = 0;
+	size_t size = 0;
+	if (!m_reader.Find(file, data, size))
+	{
+		throw FIFE::NotFound(file);
+	}
+
+	return new FIFE::RawData(new SliceSource(data, size));
+}
+
+//!***************************************************************
+//! @details:
+//! names of the files in a directory
+//!
+//! @param[in]: path
+//! the directory
+//!
+//! @return:
+//! std::set<std::string>
+//!
+//!***************************************************************
+std::set<std::string> AssetPackSource::listFiles(const std::string& path) const
+{
+	std::vector<std::string> files;
+	m_reader.List(path, false, files);
+
+	return std::set<std::string>(files.begin(), files.end());
+}
+
+//!***************************************************************
+//! @details:
+//! names of the directories in a directory
+//!
+//! @param[in]: path
+//! the directory
+//!
+//! @return:
+//! std::set<std::string>
+//!
+//!***************************************************************
+std::set<std::string> AssetPackSource::listDirectories(const std::string& path) const
+{
+	std::vector<std::string> directories;
+	m_reader.ListDirectories(path, directories);
+
+	return std::set<std::string>(directories.begin(), directories.end());
+}
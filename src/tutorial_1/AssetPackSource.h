@@ -0,0 +1,43 @@
+//*****************************************************************************
+// FILE NAME:  AssetPackSource.h
+//
+//*****************************************************************************
+#ifndef ASSET_PACK_SOURCE_H_
+#define ASSET_PACK_SOURCE_H_
+
+#include <set>
+#include <string>
+
+// fife includes
+#include "vfs/vfssource.h"
+
+#include "AssetPackFormat.h"
+#include "MappedFile.h"
+
+//! serves the engine's file reads from an asset pack, the pack is
+//! mapped once and every file is a slice of the mapping
+//!
+//! the source is owned by the vfs once it is added to it
+class AssetPackSource : public FIFE::VFSSource
+{
+public:
+	AssetPackSource(FIFE::VFS* vfs);
+	virtual ~AssetPackSource();
+
+	bool Open(const std::string& path);
+	const AssetPack::Reader& GetReader() const;
+
+	// FIFE::VFSSource
+	virtual bool fileExists(const std::string& file) const;
+	virtual FIFE::RawData* open(const std::string& file) const;
+	virtual std::set<std::string> listFiles(const std::string& path) const;
+	virtual std::set<std::string> listDirectories(const std::string& path) const;
+private:
+	AssetPackSource(const AssetPackSource&);
+	AssetPackSource& operator=(const AssetPackSource&);
+private:
+	MappedFile m_file;
+	AssetPack::Reader m_reader;
+};
+
+#endif
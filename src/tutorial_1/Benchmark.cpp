@@ -0,0 +1,552 @@
+//*****************************************************************************
+// FILE NAME:  Benchmark.cpp
+//
+//*****************************************************************************
+#include "Benchmark.h"
+#include "MemoryTracker.h"
+#include "ProcessMemory.h"
+
+// fife includes
+#include "model/structures/location.h"
+#include "view/camera.h"
+
+// standard includes
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+
+namespace
+{
+	const double Pi = 3.14159265358979323846;
+
+	// radius of the circular pan around the start location, in map units
+	const double PathRadius = 8.0;
+
+	// number of full circles the camera makes during the run
+	const int PathLoops = 2;
+
+	// the zoom swings between origin / ZoomRange and origin * ZoomRange
+	const double ZoomRange = 2.0;
+
+	// the pan sweep goes this far either side of the start location, in map units
+	const double SweepDistance = 16.0;
+
+	// number of times the pan sweep goes there and back
+	const int SweepCount = 2;
+
+	// frames of one zoom in and out during the zoom storm
+	const int ZoomStormPeriod = 8;
+
+	// number of full turns during the rotate cycle
+	const int RotateTurns = 2;
+
+	// the switch scenario starts loading the other map this far into the run,
+	// the frames before it show the cost of the map on its own
+	const int SwitchStartDivisor = 10;
+
+	// names the scenarios are chosen by on the command line
+	const char* ScenarioNames[Benchmark::SCENARIO_COUNT] =
+	{
+		"tour",
+		"still",
+		"pan",
+		"zoom",
+		"rotate",
+		"switch"
+	};
+
+	//!***************************************************************
+	//! @details:
+	//! escapes a string so it can be written as a json string value
+	//!
+	//! @param[in]: value
+	//! the raw string
+	//!
+	//! @return:
+	//! std::string
+	//!
+	//!***************************************************************
+	std::string JsonEscape(const std::string& value)
+	{
+		std::string escaped;
+		escaped.reserve(value.size());
+
+		for (std::string::const_iterator it = value.begin(); it != value.end(); ++it)
+		{
+			if (*it == '"' || *it == '\\')
+			{
+				escaped += '\\';
+			}
+			escaped += *it;
+		}
+
+		return escaped;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: camera
+//! the camera that is moved along the scripted path
+//!
+//! @param[in]: frameCount
+//! number of frames to measure
+//!
+//! @param[in]: scenario
+//! path the camera takes
+//!
+//!***************************************************************
+Benchmark::Benchmark(FIFE::Camera* camera, int frameCount, Scenario scenario)
+: m_camera(camera), m_frameCount(frameCount), m_scenario(scenario), m_frame(0), m_originZoom(1.0),
+  m_originRotation(0.0), m_loadTimeMs(0.0), m_firstFrameMs(0.0), m_loadHeapAllocations(0), m_loadArenaAllocations(0),
+  m_runTimeMs(0.0),
+  m_crowdAgents(0), m_agentTicksPerSecond(0.0), m_drawCallsPerFrame(0.0), m_textureSwitchesPerFrame(0.0),
+  m_culledPerFrame(0.0), m_switching(false), m_switchCompleted(false), m_switchFrames(0), m_switchWorstFrameMs(0.0),
+  m_switchTimeMs(0.0)
+{
+	assert(m_camera);
+	assert(m_frameCount > 0);
+
+	m_frameStats.Reserve(m_frameCount);
+}
+
+//!***************************************************************
+//! @details:
+//! destructor
+//!
+//!***************************************************************
+Benchmark::~Benchmark()
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! looks up a scenario by its name
+//!
+//! @param[in]: name
+//! name given on the command line
+//!
+//! @param[out]: scenario
+//! the scenario
+//!
+//! @return: 
+//! bool - false if there is no scenario of that name
+//! 
+//!***************************************************************
+bool Benchmark::FindScenario(const std::string& name, Scenario& scenario)
+{
+	for (int i = 0; i < SCENARIO_COUNT; ++i)
+	{
+		if (name == ScenarioNames[i])
+		{
+			scenario = static_cast<Scenario>(i);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//!***************************************************************
+//! @details:
+//! name of a scenario as it is written to the report
+//!
+//! @param[in]: scenario
+//! the scenario
+//!
+//! @return: 
+//! const char*
+//! 
+//!***************************************************************
+const char* Benchmark::GetScenarioName(Scenario scenario)
+{
+	return ScenarioNames[scenario];
+}
+
+//!***************************************************************
+//! @details:
+//! stores how long loading the map took
+//!
+//! @param[in]: ms
+//! load time in milliseconds
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Benchmark::SetLoadTime(double ms)
+{
+	m_loadTimeMs = ms;
+}
+
+//!***************************************************************
+//! @details:
+//! stores how long the game took from being created to its
+//! first frame
+//!
+//! @param[in]: ms
+//! time to the first frame in milliseconds
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Benchmark::SetFirstFrameTime(double ms)
+{
+	m_firstFrameMs = ms;
+}
+
+//!***************************************************************
+//! @details:
+//! stores how many allocations loading the map made
+//!
+//! @param[in]: heapAllocations
+//! allocations from the heap, only counted when memory
+//! tracking is built in
+//!
+//! @param[in]: arenaAllocations
+//! allocations served by the load arena
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Benchmark::SetLoadAllocations(size_t heapAllocations, size_t arenaAllocations)
+{
+	m_loadHeapAllocations = heapAllocations;
+	m_loadArenaAllocations = arenaAllocations;
+}
+
+//!***************************************************************
+//! @details:
+//! stores the crowd throughput measured during the run
+//!
+//! @param[in]: agents
+//! number of agents walking around
+//!
+//! @param[in]: agentTicksPerSecond
+//! agents updated per second of wall time
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Benchmark::SetCrowdStats(int agents, double agentTicksPerSecond)
+{
+	m_crowdAgents = agents;
+	m_agentTicksPerSecond = agentTicksPerSecond;
+}
+
+//!***************************************************************
+//! @details:
+//! stores the render counters averaged over the run
+//!
+//! @param[in]: drawCallsPerFrame
+//! average draw calls per frame
+//!
+//! @param[in]: textureSwitchesPerFrame
+//! average texture switches per frame
+//!
+//! @param[in]: culledPerFrame
+//! average instances culled per frame
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Benchmark::SetRenderStats(double drawCallsPerFrame, double textureSwitchesPerFrame, double culledPerFrame)
+{
+	m_drawCallsPerFrame = drawCallsPerFrame;
+	m_textureSwitchesPerFrame = textureSwitchesPerFrame;
+	m_culledPerFrame = culledPerFrame;
+}
+
+//!***************************************************************
+//! @details:
+//! remembers the initial camera state the path is relative to
+//! and starts the measurement
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Benchmark::Start()
+{
+	m_origin = m_camera->getLocation().getMapCoordinates();
+	m_originZoom = m_camera->getZoom();
+	m_originRotation = m_camera->getRotation();
+
+	m_frame = 0;
+	m_frameStats.Clear();
+	m_runTime.Start();
+}
+
+//!***************************************************************
+//! @details:
+//! checks whether all frames have been measured
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+bool Benchmark::IsFinished() const
+{
+	return m_frame >= m_frameCount;
+}
+
+//!***************************************************************
+//! @details:
+//! places the camera for the current frame, the path only
+//! depends on the frame number so every run renders the same
+//! sequence of views
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Benchmark::UpdateCamera()
+{
+	double progress = static_cast<double>(m_frame) / m_frameCount;
+	double angle = 2.0 * Pi * PathLoops * progress;
+
+	FIFE::Location camLocation(m_camera->getLocation());
+	FIFE::ExactModelCoordinate mapCoords = m_origin;
+	mapCoords.z = 0.0;
+
+	switch (m_scenario)
+	{
+		case SCENARIO_TOUR:
+		{
+			// pan in a circle around the start location
+			mapCoords.x += PathRadius * std::cos(angle);
+			mapCoords.y += PathRadius * std::sin(angle);
+			camLocation.setMapCoordinates(mapCoords);
+			m_camera->setLocation(camLocation);
+
+			// swing the zoom in and out once per loop
+			m_camera->setZoom(m_originZoom * std::pow(ZoomRange, std::sin(angle)));
+
+			// turn the view a quarter every quarter of the run
+			int quarter = static_cast<int>(progress * 4.0);
+			m_camera->setRotation(static_cast<int>(m_originRotation + quarter * 90) % 360);
+			break;
+		}
+		case SCENARIO_PAN:
+		{
+			// sweep along a straight line there and back, every frame
+			// brings a strip of new cells into view
+			double sweep = std::fmod(progress * SweepCount * 2.0, 2.0);
+			double offset = (sweep < 1.0) ? sweep : 2.0 - sweep;
+			mapCoords.x += SweepDistance * (2.0 * offset - 1.0);
+			camLocation.setMapCoordinates(mapCoords);
+			m_camera->setLocation(camLocation);
+			break;
+		}
+		case SCENARIO_ZOOM:
+		{
+			// zoom all the way in and out every few frames
+			double phase = 2.0 * Pi * (m_frame % ZoomStormPeriod) / ZoomStormPeriod;
+			m_camera->setZoom(m_originZoom * std::pow(ZoomRange, std::sin(phase)));
+			break;
+		}
+		case SCENARIO_ROTATE:
+		{
+			// turn a degree step at a time so every angle is drawn
+			int degrees = static_cast<int>(progress * RotateTurns * 360.0);
+			m_camera->setRotation(static_cast<int>(m_originRotation + degrees) % 360);
+			break;
+		}
+		default:
+		{
+			// the camera stays where the map put it
+			break;
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! records the time the last frame took and advances the path
+//!
+//! @param[in]: ms
+//! frame time in milliseconds
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Benchmark::RecordFrame(double ms)
+{
+	m_frameStats.AddSample(ms);
+	++m_frame;
+
+	if (m_switching)
+	{
+		++m_switchFrames;
+		m_switchWorstFrameMs = std::max(m_switchWorstFrameMs, ms);
+	}
+
+	if (IsFinished())
+	{
+		m_runTimeMs = m_runTime.ElapsedMs();
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! moves the path over to the camera of another map, the path
+//! continues relative to where that camera starts
+//!
+//! @param[in]: camera
+//! main camera of the map switched to
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Benchmark::AttachCamera(FIFE::Camera* camera)
+{
+	assert(camera);
+
+	m_camera = camera;
+	m_origin = m_camera->getLocation().getMapCoordinates();
+	m_originZoom = m_camera->getZoom();
+	m_originRotation = m_camera->getRotation();
+}
+
+//!***************************************************************
+//! @details:
+//! checks whether the map switch of the switch scenario should
+//! start with the coming frame
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+bool Benchmark::IsSwitchDue() const
+{
+	return m_scenario == SCENARIO_SWITCH && !m_switching && !m_switchCompleted &&
+		m_frame == m_frameCount / SwitchStartDivisor;
+}
+
+//!***************************************************************
+//! @details:
+//! the frames from now on belong to the map switch
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Benchmark::BeginSwitch()
+{
+	m_switching = true;
+	m_switchFrames = 0;
+	m_switchWorstFrameMs = 0.0;
+	m_switchTime.Start();
+}
+
+//!***************************************************************
+//! @details:
+//! ends the frames of the map switch
+//!
+//! @param[in]: completed
+//! true - the game runs on the new map and the old one is gone
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Benchmark::EndSwitch(bool completed)
+{
+	if (!m_switching)
+	{
+		return;
+	}
+
+	m_switching = false;
+	m_switchCompleted = completed;
+	m_switchTimeMs = m_switchTime.ElapsedMs();
+}
+
+//!***************************************************************
+//! @details:
+//! accessor for the recorded frame times
+//!
+//! @return: 
+//! const FrameStats&
+//! 
+//!***************************************************************
+const FrameStats& Benchmark::GetFrameStats() const
+{
+	return m_frameStats;
+}
+
+//!***************************************************************
+//! @details:
+//! writes the results as json
+//!
+//! @param[in]: path
+//! the file to write
+//!
+//! @param[in]: mapFile
+//! the map that was measured
+//!
+//! @return: 
+//! bool - false if the file could not be written
+//! 
+//!***************************************************************
+bool Benchmark::WriteReport(const std::string& path, const std::string& mapFile) const
+{
+	std::ofstream out(path.c_str());
+
+	if (!out)
+	{
+		return false;
+	}
+
+	out << "{" << std::endl
+		<< "  \"map\": \"" << JsonEscape(mapFile) << "\"," << std::endl
+		<< "  \"scenario\": \"" << GetScenarioName(m_scenario) << "\"," << std::endl
+		<< "  \"frames\": " << m_frameStats.GetSampleCount() << "," << std::endl
+		<< "  \"load_time_ms\": " << m_loadTimeMs << "," << std::endl
+		<< "  \"first_frame_ms\": " << m_firstFrameMs << "," << std::endl
+		<< "  \"load_arena_allocations\": " << m_loadArenaAllocations << "," << std::endl;
+
+	// heap allocations are only counted when tracking is built in
+	if (MemoryTracker::IsEnabled())
+	{
+		out << "  \"load_heap_allocations\": " << m_loadHeapAllocations << "," << std::endl;
+	}
+
+	out << "  \"run_time_ms\": " << m_runTimeMs << "," << std::endl
+		<< "  \"frame_time_ms\": {" << std::endl
+		<< "    \"mean\": " << m_frameStats.GetMean() << "," << std::endl
+		<< "    \"p50\": " << m_frameStats.GetPercentile(50.0) << "," << std::endl
+		<< "    \"p95\": " << m_frameStats.GetPercentile(95.0) << "," << std::endl
+		<< "    \"p99\": " << m_frameStats.GetPercentile(99.0) << "," << std::endl
+		<< "    \"max\": " << m_frameStats.GetMax() << std::endl
+		<< "  }," << std::endl
+		<< "  \"crowd_agents\": " << m_crowdAgents << "," << std::endl
+		<< "  \"agent_ticks_per_second\": " << m_agentTicksPerSecond << "," << std::endl
+		<< "  \"draw_calls_per_frame\": " << m_drawCallsPerFrame << "," << std::endl
+		<< "  \"texture_switches_per_frame\": " << m_textureSwitchesPerFrame << "," << std::endl
+		<< "  \"culled_per_frame\": " << m_culledPerFrame << "," << std::endl;
+
+	// the worst frame of the switch is what the switch test checks
+	if (m_scenario == SCENARIO_SWITCH)
+	{
+		out << "  \"switch_completed\": " << (m_switchCompleted ? "true" : "false") << "," << std::endl
+			<< "  \"switch_frames\": " << m_switchFrames << "," << std::endl
+			<< "  \"switch_ms\": " << m_switchTimeMs << "," << std::endl
+			<< "  \"switch_worst_frame_ms\": " << m_switchWorstFrameMs << "," << std::endl;
+	}
+
+	out << "  \"peak_rss_bytes\": " << ProcessMemory::GetPeakResidentBytes() << std::endl
+		<< "}" << std::endl;
+
+	return out.good();
+}
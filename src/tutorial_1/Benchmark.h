@@ -0,0 +1,90 @@
+//*****************************************************************************
+// FILE NAME:  Benchmark.h
+//
+//*****************************************************************************
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <string>
+
+#include "model/metamodel/modelcoords.h"
+
+#include "FrameStats.h"
+#include "Stopwatch.h"
+
+namespace FIFE
+{
+	class Camera;
+}
+
+//! drives the camera along a scripted path for a fixed number of
+//! frames and reports the measured frame time distribution
+class Benchmark
+{
+public:
+	//! camera paths the benchmark can run
+	enum Scenario
+	{
+		SCENARIO_TOUR,
+		SCENARIO_STILL,
+		SCENARIO_PAN,
+		SCENARIO_ZOOM,
+		SCENARIO_ROTATE,
+		SCENARIO_SWITCH,
+		SCENARIO_COUNT
+	};
+
+	Benchmark(FIFE::Camera* camera, int frameCount, Scenario scenario = SCENARIO_TOUR);
+	~Benchmark();
+
+	static bool FindScenario(const std::string& name, Scenario& scenario);
+	static const char* GetScenarioName(Scenario scenario);
+
+	void SetLoadTime(double ms);
+	void SetFirstFrameTime(double ms);
+	void SetLoadAllocations(size_t heapAllocations, size_t arenaAllocations);
+	void SetCrowdStats(int agents, double agentTicksPerSecond);
+	void SetRenderStats(double drawCallsPerFrame, double textureSwitchesPerFrame, double culledPerFrame);
+	void Start();
+	bool IsFinished() const;
+	void UpdateCamera();
+	void RecordFrame(double ms);
+	void AttachCamera(FIFE::Camera* camera);
+
+	bool IsSwitchDue() const;
+	void BeginSwitch();
+	void EndSwitch(bool completed);
+	const FrameStats& GetFrameStats() const;
+
+	bool WriteReport(const std::string& path, const std::string& mapFile) const;
+private:
+	FIFE::Camera* m_camera;
+	int m_frameCount;
+	Scenario m_scenario;
+	int m_frame;
+	FIFE::ExactModelCoordinate m_origin;
+	double m_originZoom;
+	double m_originRotation;
+	double m_loadTimeMs;
+	double m_firstFrameMs;
+	size_t m_loadHeapAllocations;
+	size_t m_loadArenaAllocations;
+	FrameStats m_frameStats;
+	Stopwatch m_runTime;
+	double m_runTimeMs;
+	int m_crowdAgents;
+	double m_agentTicksPerSecond;
+	double m_drawCallsPerFrame;
+	double m_textureSwitchesPerFrame;
+	double m_culledPerFrame;
+
+	// frames from the start of a map switch until the old map is gone
+	bool m_switching;
+	bool m_switchCompleted;
+	int m_switchFrames;
+	double m_switchWorstFrameMs;
+	Stopwatch m_switchTime;
+	double m_switchTimeMs;
+};
+
+#endif
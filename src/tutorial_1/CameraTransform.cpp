@@ -0,0 +1,220 @@
+//*****************************************************************************
+// FILE NAME:  CameraTransform.cpp
+//
+//*****************************************************************************
+#include "CameraTransform.h"
+
+// fife includes
+#include "model/structures/location.h"
+
+// standard includes
+#include <cmath>
+
+namespace
+{
+	// screen distance of the points the transform is sampled at,
+	// large enough to keep the rounding of the camera out of it
+	const int SampleDistance = 1024;
+}
+
+//!***************************************************************
+//! @details:
+//! constructor, the transform is built on the first update
+//!
+//!***************************************************************
+CameraTransform::CameraTransform()
+: m_valid(false), m_zoom(0.0), m_rotation(0.0), m_tilt(0.0), m_rebuilds(0), m_shifts(0)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! brings the transform up to date with the camera, only the
+//! camera's getters are called unless something changed
+//!
+//! @param[in]: camera
+//! the camera to convert for
+//!
+//! @return: 
+//! bool - true if the transform changed
+//! 
+//!***************************************************************
+bool CameraTransform::Update(FIFE::Camera* camera)
+{
+	const FIFE::Rect& viewport = camera->getViewPort();
+
+	if (!m_valid || camera->getZoom() != m_zoom || camera->getRotation() != m_rotation ||
+		camera->getTilt() != m_tilt || viewport.x != m_viewport.x || viewport.y != m_viewport.y ||
+		viewport.w != m_viewport.w || viewport.h != m_viewport.h)
+	{
+		Rebuild(camera);
+		return true;
+	}
+
+	FIFE::ExactModelCoordinate location = camera->getLocationRef().getMapCoordinates();
+	if (location.x != m_location.x || location.y != m_location.y || location.z != m_location.z)
+	{
+		Shift(camera);
+		return true;
+	}
+
+	return false;
+}
+
+//!***************************************************************
+//! @details:
+//! forces a rebuild on the next update, e.g. after the cell image
+//! dimensions of the camera changed
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void CameraTransform::Invalidate()
+{
+	m_valid = false;
+}
+
+//!***************************************************************
+//! @details:
+//! converts a screen position to map coordinates on the ground,
+//! matches FIFE::Camera::toMapCoordinates(point, false)
+//!
+//! @param[in]: point
+//! screen position
+//!
+//! @return: 
+//! FIFE::ExactModelCoordinate
+//! 
+//!***************************************************************
+FIFE::ExactModelCoordinate CameraTransform::ToMap(const FIFE::ScreenPoint& point) const
+{
+	FIFE::ExactModelCoordinate result;
+	m_screenToMap.Apply(point.x, point.y, result.x, result.y);
+	result.z = 0.0;
+
+	return result;
+}
+
+//!***************************************************************
+//! @details:
+//! converts map coordinates on the ground to a screen position
+//!
+//! @param[in]: point
+//! map coordinates, z is ignored
+//!
+//! @return: 
+//! FIFE::ScreenPoint
+//! 
+//!***************************************************************
+FIFE::ScreenPoint CameraTransform::ToScreen(const FIFE::ExactModelCoordinate& point) const
+{
+	double x = 0.0;
+	double y = 0.0;
+	m_mapToScreen.Apply(point.x, point.y, x, y);
+
+	return FIFE::ScreenPoint(static_cast<int>(std::floor(x + 0.5)), static_cast<int>(std::floor(y + 0.5)));
+}
+
+//!***************************************************************
+//! @details:
+//! converts arrays of screen positions to map coordinates
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void CameraTransform::ToMap(const double* screenX, const double* screenY, size_t count, double* mapX, double* mapY) const
+{
+	m_screenToMap.ApplyBatch(screenX, screenY, count, mapX, mapY);
+}
+
+//!***************************************************************
+//! @details:
+//! converts arrays of map coordinates to screen positions, the
+//! results are not rounded to pixels
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void CameraTransform::ToScreen(const double* mapX, const double* mapY, size_t count, double* screenX, double* screenY) const
+{
+	m_mapToScreen.ApplyBatch(mapX, mapY, count, screenX, screenY);
+}
+
+//!***************************************************************
+//! @details:
+//! number of times the camera was sampled for a new transform
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int CameraTransform::GetRebuildCount() const
+{
+	return m_rebuilds;
+}
+
+//!***************************************************************
+//! @details:
+//! number of times only the camera location changed
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int CameraTransform::GetShiftCount() const
+{
+	return m_shifts;
+}
+
+//!***************************************************************
+//! @details:
+//! samples the camera at three screen points, the projection onto
+//! the ground plane is affine so they define it exactly
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void CameraTransform::Rebuild(FIFE::Camera* camera)
+{
+	FIFE::ExactModelCoordinate origin = camera->toMapCoordinates(FIFE::ScreenPoint(0, 0), false);
+	FIFE::ExactModelCoordinate unitX = camera->toMapCoordinates(FIFE::ScreenPoint(SampleDistance, 0), false);
+	FIFE::ExactModelCoordinate unitY = camera->toMapCoordinates(FIFE::ScreenPoint(0, SampleDistance), false);
+
+	m_screenToMap = AffineTransform::FromBasis(origin.x, origin.y, unitX.x, unitX.y, unitY.x, unitY.y, SampleDistance);
+	m_valid = m_screenToMap.Invert(m_mapToScreen);
+
+	m_zoom = camera->getZoom();
+	m_rotation = camera->getRotation();
+	m_tilt = camera->getTilt();
+	m_viewport = camera->getViewPort();
+	m_location = camera->getLocationRef().getMapCoordinates();
+
+	++m_rebuilds;
+}
+
+//!***************************************************************
+//! @details:
+//! the camera moved without turning or zooming, only the offset
+//! of the transform changes
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void CameraTransform::Shift(FIFE::Camera* camera)
+{
+	FIFE::ExactModelCoordinate origin = camera->toMapCoordinates(FIFE::ScreenPoint(0, 0), false);
+
+	m_screenToMap.c = origin.x;
+	m_screenToMap.f = origin.y;
+	m_valid = m_screenToMap.Invert(m_mapToScreen);
+
+	m_location = camera->getLocationRef().getMapCoordinates();
+
+	++m_shifts;
+}
@@ -0,0 +1,51 @@
+//*****************************************************************************
+// FILE NAME:  CameraTransform.h
+//
+//*****************************************************************************
+#ifndef CAMERA_TRANSFORM_H_
+#define CAMERA_TRANSFORM_H_
+
+#include <cstddef>
+
+#include "model/metamodel/modelcoords.h"
+#include "util/structures/rect.h"
+#include "view/camera.h"
+
+#include "AffineTransform.h"
+
+//! cached screen <-> map conversion of a camera on the ground plane,
+//! the camera is only asked again when its zoom, rotation, tilt or
+//! viewport change, a moved camera only shifts the cached transform
+class CameraTransform
+{
+public:
+	CameraTransform();
+
+	bool Update(FIFE::Camera* camera);
+	void Invalidate();
+
+	FIFE::ExactModelCoordinate ToMap(const FIFE::ScreenPoint& point) const;
+	FIFE::ScreenPoint ToScreen(const FIFE::ExactModelCoordinate& point) const;
+
+	void ToMap(const double* screenX, const double* screenY, size_t count, double* mapX, double* mapY) const;
+	void ToScreen(const double* mapX, const double* mapY, size_t count, double* screenX, double* screenY) const;
+
+	int GetRebuildCount() const;
+	int GetShiftCount() const;
+private:
+	void Rebuild(FIFE::Camera* camera);
+	void Shift(FIFE::Camera* camera);
+private:
+	AffineTransform m_screenToMap;
+	AffineTransform m_mapToScreen;
+	bool m_valid;
+	double m_zoom;
+	double m_rotation;
+	double m_tilt;
+	FIFE::Rect m_viewport;
+	FIFE::ExactModelCoordinate m_location;
+	int m_rebuilds;
+	int m_shifts;
+};
+
+#endif
@@ -0,0 +1,516 @@
+//*****************************************************************************
+// FILE NAME:  Crowd.cpp
+//
+//*****************************************************************************
+#include "Crowd.h"
+#include "LayerWalkGrid.h"
+#include "MemoryTracker.h"
+
+// fife includes
+#include "model/model.h"
+#include "model/metamodel/action.h"
+#include "model/metamodel/object.h"
+#include "model/structures/instance.h"
+#include "model/structures/layer.h"
+#include "model/structures/location.h"
+#include "view/visual.h"
+
+// standard includes
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <list>
+#include <sstream>
+#include <string>
+
+namespace
+{
+	// path searches handed to a worker in one job
+	const size_t PathsPerBatch = 64;
+
+	// how far away, in cells, agents pick their next destination
+	const int WanderRadius = 24;
+
+	// the engine walks straight lines of at most this many cells,
+	// its own path search for them stays trivial
+	const int MaxWaypointCells = 8;
+
+	// walk speed handed to FIFE::Instance::move
+	const double WalkSpeed = 1.0;
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: model
+//! the model the agent objects are looked up in
+//!
+//! @param[in]: layer
+//! the walkable layer the agents are created on
+//!
+//! @param[in]: workerPool
+//! threads the path searches run on
+//!
+//!***************************************************************
+Crowd::Crowd(FIFE::Model* model, FIFE::Layer* layer, WorkerPool* workerPool)
+: m_model(model), m_layer(layer), m_workerPool(workerPool), m_random(1), m_agentTicks(0.0),
+  m_pathsFound(0), m_pathsFailed(0), m_searchMs(0.0)
+{
+	assert(m_model && m_layer && m_workerPool);
+
+	// one batch in flight per worker, each batch has its own
+	// search memory so the workers never share any
+	for (int i = 0; i < m_workerPool->GetThreadCount(); ++i)
+	{
+		m_batches.push_back(new PathBatch(m_walkGrid));
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! destructor, waits for the searches in flight, the agents
+//! belong to the layer and are deleted with the map
+//!
+//!***************************************************************
+Crowd::~Crowd()
+{
+	for (std::vector<PathBatch*>::iterator it = m_batches.begin(); it != m_batches.end(); ++it)
+	{
+		while (SDL_AtomicGet(&(*it)->busy))
+		{
+			SDL_Delay(1);
+		}
+
+		delete *it;
+	}
+	m_batches.clear();
+}
+
+//!***************************************************************
+//! @details:
+//! creates agents from every object that has a walk action at
+//! random free cells of the layer
+//!
+//! @param[in]: count
+//! number of agents to create
+//!
+//! @param[in]: seed
+//! the same seed places and moves the agents the same way
+//!
+//! @return: 
+//! int - number of agents created
+//! 
+//!***************************************************************
+int Crowd::Spawn(int count, unsigned int seed)
+{
+	MemoryScope memoryScope(MEMORY_INSTANCES);
+	m_random = seed ? seed : 1;
+
+	if (m_walkGrid.IsEmpty())
+	{
+		LayerWalkGrid::Build(m_layer, m_walkGrid);
+	}
+
+	if (m_agentObjects.empty())
+	{
+		std::list<std::string> namespaces = m_model->getNamespaces();
+		for (std::list<std::string>::const_iterator ns = namespaces.begin(); ns != namespaces.end(); ++ns)
+		{
+			std::list<FIFE::Object*> objects = m_model->getObjects(*ns);
+			for (std::list<FIFE::Object*>::const_iterator it = objects.begin(); it != objects.end(); ++it)
+			{
+				if ((*it)->getAction("walk") && (*it)->getAction("stand"))
+				{
+					m_agentObjects.push_back(*it);
+				}
+			}
+		}
+	}
+
+	if (m_agentObjects.empty() || m_walkGrid.IsEmpty())
+	{
+		return 0;
+	}
+
+	GridPoint center = {
+		m_walkGrid.GetOriginX() + m_walkGrid.GetWidth() / 2,
+		m_walkGrid.GetOriginY() + m_walkGrid.GetHeight() / 2
+	};
+	int radius = std::max(m_walkGrid.GetWidth(), m_walkGrid.GetHeight()) / 2;
+
+	int created = 0;
+	for (int i = 0; i < count; ++i)
+	{
+		GridPoint cell;
+		if (!RandomWalkableCell(center, radius, cell))
+		{
+			continue;
+		}
+
+		std::ostringstream id;
+		id << "Crowd:" << m_agents.size();
+
+		FIFE::Object* object = m_agentObjects[NextRandom() % m_agentObjects.size()];
+		FIFE::Instance* instance = m_layer->createInstance(object, FIFE::ModelCoordinate(cell.x, cell.y), id.str());
+		if (!instance)
+		{
+			continue;
+		}
+
+		FIFE::InstanceVisual::create(instance);
+		instance->actRepeat("stand", instance->getLocationRef());
+
+		Agent agent;
+		agent.instance = instance;
+		agent.next = 0;
+		agent.waiting = false;
+		m_agents.push_back(agent);
+
+		RequestPath(static_cast<int>(m_agents.size()) - 1);
+		++created;
+	}
+
+	SubmitPaths();
+
+	m_agentTicks = 0.0;
+	m_runTime.Start();
+
+	return created;
+}
+
+//!***************************************************************
+//! @details:
+//! called once per frame, takes over finished searches, sends
+//! idle agents to their next waypoint and queues new searches for
+//! the agents that arrived
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Crowd::Update()
+{
+	CollectPaths();
+
+	for (size_t i = 0; i < m_agents.size(); ++i)
+	{
+		Agent& agent = m_agents[i];
+
+		if (agent.waiting)
+		{
+			continue;
+		}
+
+		// the engine clears or replaces the walk action on arrival
+		FIFE::Action* action = agent.instance->getCurrentAction();
+		if (action && action->getId() == "walk")
+		{
+			continue;
+		}
+
+		if (agent.next < agent.waypoints.size())
+		{
+			WalkTo(agent, agent.waypoints[agent.next++]);
+		}
+		else
+		{
+			agent.instance->actRepeat("stand", agent.instance->getLocationRef());
+			RequestPath(static_cast<int>(i));
+		}
+	}
+
+	m_agentTicks += static_cast<double>(m_agents.size());
+
+	SubmitPaths();
+}
+
+//!***************************************************************
+//! @details:
+//! number of agents walking around
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int Crowd::GetAgentCount() const
+{
+	return static_cast<int>(m_agents.size());
+}
+
+//!***************************************************************
+//! @details:
+//! instance of an agent
+//!
+//! @param[in]: index
+//! index of the agent, below the agent count
+//!
+//! @return: 
+//! FIFE::Instance*
+//! 
+//!***************************************************************
+FIFE::Instance* Crowd::GetAgent(int index) const
+{
+	return m_agents[index].instance;
+}
+
+//!***************************************************************
+//! @details:
+//! agent updates per second of wall time since the crowd spawned,
+//! one tick is one agent handled in one frame
+//!
+//! @return: 
+//! double
+//! 
+//!***************************************************************
+double Crowd::GetAgentTicksPerSecond() const
+{
+	double seconds = m_runTime.ElapsedMs() / 1000.0;
+	return (seconds > 0.0) ? m_agentTicks / seconds : 0.0;
+}
+
+//!***************************************************************
+//! @details:
+//! number of searches that found a path
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int Crowd::GetPathsFound() const
+{
+	return m_pathsFound;
+}
+
+//!***************************************************************
+//! @details:
+//! number of searches without a path, the agent picks another goal
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int Crowd::GetPathsFailed() const
+{
+	return m_pathsFailed;
+}
+
+//!***************************************************************
+//! @details:
+//! average worker time of one search
+//!
+//! @return: 
+//! double
+//! 
+//!***************************************************************
+double Crowd::GetAverageSearchMs() const
+{
+	int searches = m_pathsFound + m_pathsFailed;
+	return (searches > 0) ? m_searchMs / searches : 0.0;
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: walkGrid
+//! the grid searched, it does not change while batches run
+//!
+//!***************************************************************
+Crowd::PathBatch::PathBatch(const WalkGrid& walkGrid)
+: grid(walkGrid), searchMs(0.0)
+{
+	SDL_AtomicSet(&busy, 0);
+}
+
+//!***************************************************************
+//! @details:
+//! runs on a worker thread, searches every request of the batch
+//! and turns the found paths into waypoints
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Crowd::PathBatch::Run()
+{
+	Stopwatch timer;
+	std::vector<GridPoint> cells;
+	std::vector<size_t> waypoints;
+
+	paths.resize(requests.size());
+	for (size_t i = 0; i < requests.size(); ++i)
+	{
+		paths[i].clear();
+
+		if (grid.FindPath(requests[i].start, requests[i].goal, scratch, cells))
+		{
+			WalkGrid::FindWaypoints(cells, 0, MaxWaypointCells, waypoints);
+			for (std::vector<size_t>::const_iterator it = waypoints.begin(); it != waypoints.end(); ++it)
+			{
+				paths[i].push_back(cells[*it]);
+			}
+		}
+	}
+
+	searchMs = timer.ElapsedMs();
+
+	SDL_AtomicSet(&busy, 0);
+}
+
+//!***************************************************************
+//! @details:
+//! applies the results of the batches that finished
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Crowd::CollectPaths()
+{
+	for (std::vector<PathBatch*>::iterator it = m_batches.begin(); it != m_batches.end(); ++it)
+	{
+		PathBatch& batch = **it;
+		if (SDL_AtomicGet(&batch.busy) || batch.requests.empty())
+		{
+			continue;
+		}
+
+		for (size_t i = 0; i < batch.requests.size(); ++i)
+		{
+			Agent& agent = m_agents[batch.requests[i].agent];
+			agent.waypoints.swap(batch.paths[i]);
+			agent.next = 0;
+			agent.waiting = false;
+
+			if (agent.waypoints.empty())
+			{
+				++m_pathsFailed;
+			}
+			else
+			{
+				++m_pathsFound;
+			}
+		}
+
+		m_searchMs += batch.searchMs;
+		batch.requests.clear();
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! hands the queued searches to idle batches
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Crowd::SubmitPaths()
+{
+	for (std::vector<PathBatch*>::iterator it = m_batches.begin(); it != m_batches.end() && !m_pendingPaths.empty(); ++it)
+	{
+		PathBatch& batch = **it;
+		if (SDL_AtomicGet(&batch.busy) || !batch.requests.empty())
+		{
+			continue;
+		}
+
+		while (batch.requests.size() < PathsPerBatch && !m_pendingPaths.empty())
+		{
+			int agentIndex = m_pendingPaths.front();
+			m_pendingPaths.pop_front();
+
+			const Agent& agent = m_agents[agentIndex];
+			FIFE::ModelCoordinate position = agent.instance->getLocationRef().getLayerCoordinates();
+
+			PathRequest request;
+			request.agent = agentIndex;
+			request.start.x = position.x;
+			request.start.y = position.y;
+
+			if (!RandomWalkableCell(request.start, WanderRadius, request.goal))
+			{
+				request.goal = request.start;
+			}
+
+			batch.requests.push_back(request);
+		}
+
+		SDL_AtomicSet(&batch.busy, 1);
+		m_workerPool->Submit(&batch);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! queues a search to a new destination for an agent
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Crowd::RequestPath(int agentIndex)
+{
+	m_agents[agentIndex].waiting = true;
+	m_agents[agentIndex].waypoints.clear();
+	m_agents[agentIndex].next = 0;
+	m_pendingPaths.push_back(agentIndex);
+}
+
+//!***************************************************************
+//! @details:
+//! lets the engine walk an agent to the next waypoint
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Crowd::WalkTo(Agent& agent, const GridPoint& waypoint)
+{
+	FIFE::Location target(m_layer);
+	target.setLayerCoordinates(FIFE::ModelCoordinate(waypoint.x, waypoint.y));
+
+	agent.instance->move("walk", target, WalkSpeed);
+}
+
+//!***************************************************************
+//! @details:
+//! picks a random walkable cell in a square around a cell
+//!
+//! @return: 
+//! bool - false if no walkable cell was hit after a few tries
+//! 
+//!***************************************************************
+bool Crowd::RandomWalkableCell(const GridPoint& around, int radius, GridPoint& cell)
+{
+	const int Attempts = 16;
+	int span = 2 * radius + 1;
+
+	for (int i = 0; i < Attempts; ++i)
+	{
+		cell.x = around.x - radius + static_cast<int>(NextRandom() % span);
+		cell.y = around.y - radius + static_cast<int>(NextRandom() % span);
+
+		if (m_walkGrid.IsWalkable(cell.x, cell.y))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//!***************************************************************
+//! @details:
+//! small deterministic random generator, independent of rand()
+//!
+//! @return: 
+//! unsigned int
+//! 
+//!***************************************************************
+unsigned int Crowd::NextRandom()
+{
+	m_random = m_random * 1103515245u + 12345u;
+	return (m_random >> 16) & 0x7fff;
+}
@@ -0,0 +1,101 @@
+//*****************************************************************************
+// FILE NAME:  Crowd.h
+//
+//*****************************************************************************
+#ifndef CROWD_H_
+#define CROWD_H_
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include "SDL.h"
+
+#include "Stopwatch.h"
+#include "WalkGrid.h"
+#include "WorkerPool.h"
+
+namespace FIFE
+{
+	class Model;
+	class Layer;
+	class Object;
+	class Instance;
+}
+
+//! spawns agents that keep walking to random spots, the long path
+//! searches run on the worker pool over a snapshot of the layer's
+//! blockers, the engine only walks them from waypoint to waypoint
+class Crowd
+{
+public:
+	Crowd(FIFE::Model* model, FIFE::Layer* layer, WorkerPool* workerPool);
+	~Crowd();
+
+	int Spawn(int count, unsigned int seed = 1);
+	void Update();
+
+	int GetAgentCount() const;
+	FIFE::Instance* GetAgent(int index) const;
+	double GetAgentTicksPerSecond() const;
+	int GetPathsFound() const;
+	int GetPathsFailed() const;
+	double GetAverageSearchMs() const;
+private:
+	Crowd(const Crowd&);
+	Crowd& operator=(const Crowd&);
+
+	struct Agent
+	{
+		FIFE::Instance* instance;
+		std::vector<GridPoint> waypoints;
+		size_t next;
+		bool waiting;
+	};
+
+	struct PathRequest
+	{
+		int agent;
+		GridPoint start;
+		GridPoint goal;
+	};
+
+	//! a group of path searches run together on one worker thread
+	class PathBatch : public WorkerJob
+	{
+	public:
+		explicit PathBatch(const WalkGrid& walkGrid);
+		virtual void Run();
+
+		const WalkGrid& grid;
+		PathScratch scratch;
+		std::vector<PathRequest> requests;
+		std::vector<std::vector<GridPoint> > paths;
+		double searchMs;
+		SDL_atomic_t busy;
+	};
+
+	void CollectPaths();
+	void SubmitPaths();
+	void RequestPath(int agentIndex);
+	void WalkTo(Agent& agent, const GridPoint& waypoint);
+	bool RandomWalkableCell(const GridPoint& around, int radius, GridPoint& cell);
+	unsigned int NextRandom();
+private:
+	FIFE::Model* m_model;
+	FIFE::Layer* m_layer;
+	WorkerPool* m_workerPool;
+	WalkGrid m_walkGrid;
+	std::vector<FIFE::Object*> m_agentObjects;
+	std::vector<Agent> m_agents;
+	std::vector<PathBatch*> m_batches;
+	std::deque<int> m_pendingPaths;
+	unsigned int m_random;
+	Stopwatch m_runTime;
+	double m_agentTicks;
+	int m_pathsFound;
+	int m_pathsFailed;
+	double m_searchMs;
+};
+
+#endif
@@ -0,0 +1,289 @@
+//*****************************************************************************
+// FILE NAME:  DirtyTracker.cpp
+//
+//*****************************************************************************
+#include "DirtyTracker.h"
+
+// fife includes
+#include "model/structures/map.h"
+#include "model/structures/instance.h"
+#include "view/camera.h"
+
+// 3rd party includes
+#include "SDL.h"
+
+// standard includes
+#include <cassert>
+
+namespace
+{
+	// redraw period for instances that only play an animation in
+	// place, fast enough for the frame durations of the demo actions
+	const uint32_t AnimationIntervalMs = 66;
+
+	// a still scene is redrawn this often anyway so nothing that
+	// is not tracked can get stuck on screen
+	const uint32_t MaxIdleIntervalMs = 500;
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: camera
+//! camera the frames are drawn with
+//!
+//!***************************************************************
+DirtyTracker::DirtyTracker(FIFE::Camera* camera)
+: m_camera(camera), m_dirty(true), m_lastFrame(0), m_cameraZoom(0.0), m_cameraRotation(0.0), m_cameraTilt(0.0)
+{
+	assert(m_camera);
+}
+
+//!***************************************************************
+//! @details:
+//! destructor, stops listening to the layers
+//!
+//!***************************************************************
+DirtyTracker::~DirtyTracker()
+{
+	for (std::vector<FIFE::Layer*>::iterator it = m_layers.begin(); it != m_layers.end(); ++it)
+	{
+		(*it)->removeChangeListener(this);
+	}
+	m_layers.clear();
+}
+
+//!***************************************************************
+//! @details:
+//! starts watching every layer of a map for changes
+//!
+//! @param[in]: map
+//! map that is drawn
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void DirtyTracker::AddMap(FIFE::Map* map)
+{
+	if (!map)
+	{
+		return;
+	}
+
+	const std::list<FIFE::Layer*>& layers = map->getLayers();
+	for (std::list<FIFE::Layer*>::const_iterator layer = layers.begin(); layer != layers.end(); ++layer)
+	{
+		const std::vector<FIFE::Instance*>& instances = (*layer)->getInstances();
+		for (std::vector<FIFE::Instance*>::const_iterator it = instances.begin(); it != instances.end(); ++it)
+		{
+			TrackAction(*it);
+		}
+
+		(*layer)->addChangeListener(this);
+		m_layers.push_back(*layer);
+	}
+
+	m_dirty = true;
+}
+
+//!***************************************************************
+//! @details:
+//! forces the next frame to be drawn
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void DirtyTracker::MarkDirty()
+{
+	m_dirty = true;
+}
+
+//!***************************************************************
+//! @details:
+//! checks if the next frame has anything new to show
+//!
+//! @param[in]: time
+//! current SDL time in milliseconds
+//!
+//! @return: 
+//! bool - false if the frame can be skipped
+//! 
+//!***************************************************************
+bool DirtyTracker::NeedsFrame(uint32_t time)
+{
+	if (m_dirty || HasCameraMoved())
+	{
+		return true;
+	}
+
+	// the engine handles the input inside the frame, the event is
+	// only peeked at here and stays in the queue
+	SDL_PumpEvents();
+	if (SDL_HasEvents(SDL_FIRSTEVENT, SDL_LASTEVENT))
+	{
+		return true;
+	}
+
+	return time - m_lastFrame >= GetFrameInterval();
+}
+
+//!***************************************************************
+//! @details:
+//! time until the next frame is due if no input arrives
+//!
+//! @param[in]: time
+//! current SDL time in milliseconds
+//!
+//! @return: 
+//! uint32_t - milliseconds, at least 1
+//! 
+//!***************************************************************
+uint32_t DirtyTracker::GetIdleTimeout(uint32_t time) const
+{
+	uint32_t elapsed = time - m_lastFrame;
+	uint32_t interval = GetFrameInterval();
+
+	return (elapsed < interval) ? interval - elapsed : 1;
+}
+
+//!***************************************************************
+//! @details:
+//! called right before a frame is drawn. whatever changes while
+//! the frame runs is drawn in it, but marks the next frame dirty
+//! as things that moved this frame usually keep moving
+//!
+//! @param[in]: time
+//! current SDL time in milliseconds
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void DirtyTracker::BeginFrame(uint32_t time)
+{
+	m_dirty = false;
+	m_lastFrame = time;
+
+	m_cameraLocation = m_camera->getLocationRef().getMapCoordinates();
+	m_cameraZoom = m_camera->getZoom();
+	m_cameraRotation = m_camera->getRotation();
+	m_cameraTilt = m_camera->getTilt();
+}
+
+//!***************************************************************
+//! @details:
+//! number of instances that currently play an action
+//!
+//! @return: 
+//! size_t
+//! 
+//!***************************************************************
+size_t DirtyTracker::GetAnimatingCount() const
+{
+	return m_animating.size();
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void DirtyTracker::onLayerChanged(FIFE::Layer* layer, std::vector<FIFE::Instance*>& changedInstances)
+{
+	for (std::vector<FIFE::Instance*>::const_iterator it = changedInstances.begin(); it != changedInstances.end(); ++it)
+	{
+		TrackAction(*it);
+	}
+
+	if (!changedInstances.empty())
+	{
+		m_dirty = true;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void DirtyTracker::onInstanceCreate(FIFE::Layer* layer, FIFE::Instance* instance)
+{
+	TrackAction(instance);
+	m_dirty = true;
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void DirtyTracker::onInstanceDelete(FIFE::Layer* layer, FIFE::Instance* instance)
+{
+	m_animating.erase(instance);
+	m_dirty = true;
+}
+
+//!***************************************************************
+//! @details:
+//! compares the camera against its state at the last frame
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+bool DirtyTracker::HasCameraMoved() const
+{
+	FIFE::ExactModelCoordinate location = m_camera->getLocationRef().getMapCoordinates();
+
+	return location.x != m_cameraLocation.x || location.y != m_cameraLocation.y || location.z != m_cameraLocation.z ||
+		m_camera->getZoom() != m_cameraZoom || m_camera->getRotation() != m_cameraRotation ||
+		m_camera->getTilt() != m_cameraTilt;
+}
+
+//!***************************************************************
+//! @details:
+//! longest time a frame may be skipped for
+//!
+//! @return: 
+//! uint32_t - milliseconds
+//! 
+//!***************************************************************
+uint32_t DirtyTracker::GetFrameInterval() const
+{
+	return m_animating.empty() ? MaxIdleIntervalMs : AnimationIntervalMs;
+}
+
+//!***************************************************************
+//! @details:
+//! keeps the set of instances that play an action up to date
+//!
+//! @param[in]: instance
+//! instance that was created or changed
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void DirtyTracker::TrackAction(FIFE::Instance* instance)
+{
+	if (instance->getCurrentAction())
+	{
+		m_animating.insert(instance);
+	}
+	else
+	{
+		m_animating.erase(instance);
+	}
+}
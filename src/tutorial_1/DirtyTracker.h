@@ -0,0 +1,62 @@
+//*****************************************************************************
+// FILE NAME:  DirtyTracker.h
+//
+//*****************************************************************************
+#ifndef DIRTY_TRACKER_H_
+#define DIRTY_TRACKER_H_
+
+#include <set>
+#include <vector>
+
+#include "model/structures/layer.h"
+#include "model/structures/location.h"
+
+namespace FIFE
+{
+	class Map;
+	class Camera;
+}
+
+//! decides whether the next frame would look any different from the last
+//! one. a frame is needed while input is waiting, while the camera or the
+//! instances on the map still changed in the previous frame, and every so
+//! often while instances play an action animation
+class DirtyTracker : public FIFE::LayerChangeListener
+{
+public:
+	explicit DirtyTracker(FIFE::Camera* camera);
+	~DirtyTracker();
+
+	void AddMap(FIFE::Map* map);
+	void MarkDirty();
+
+	bool NeedsFrame(uint32_t time);
+	uint32_t GetIdleTimeout(uint32_t time) const;
+	void BeginFrame(uint32_t time);
+
+	size_t GetAnimatingCount() const;
+
+	// overridden from base class
+	virtual void onLayerChanged(FIFE::Layer* layer, std::vector<FIFE::Instance*>& changedInstances);
+	virtual void onInstanceCreate(FIFE::Layer* layer, FIFE::Instance* instance);
+	virtual void onInstanceDelete(FIFE::Layer* layer, FIFE::Instance* instance);
+private:
+	DirtyTracker(const DirtyTracker&);
+	DirtyTracker& operator=(const DirtyTracker&);
+
+	bool HasCameraMoved() const;
+	uint32_t GetFrameInterval() const;
+	void TrackAction(FIFE::Instance* instance);
+private:
+	FIFE::Camera* m_camera;
+	std::vector<FIFE::Layer*> m_layers;
+	std::set<FIFE::Instance*> m_animating;
+	bool m_dirty;
+	uint32_t m_lastFrame;
+	FIFE::ExactModelCoordinate m_cameraLocation;
+	double m_cameraZoom;
+	double m_cameraRotation;
+	double m_cameraTilt;
+};
+
+#endif
@@ -0,0 +1,215 @@
+//*****************************************************************************
+// FILE NAME:  FramePacer.cpp
+//
+//*****************************************************************************
+#include "FramePacer.h"
+#include "Stopwatch.h"
+
+namespace
+{
+	// the oversleep estimate follows new measurements by this much
+	const double OversleepSmoothing = 0.1;
+
+	// starting guess of how late SDL_Delay wakes up
+	const double InitialOversleepMs = 1.0;
+
+	// the end of a wait that is spun on the performance counter,
+	// before it the core is given away while waiting
+	const double MaxSpinMs = 0.2;
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: targetFps
+//! frames per second to hold the loop to, 0 does not limit it
+//!
+//!***************************************************************
+FramePacer::FramePacer(int targetFps)
+: m_frameTicks(0), m_deadline(0), m_scheduled(false), m_oversleepMs(InitialOversleepMs), m_sleptMs(0.0),
+  m_framesPaced(0), m_idleWaits(0)
+{
+	SetTargetFps(targetFps);
+}
+
+//!***************************************************************
+//! @details:
+//! changes the frame rate the loop is held to
+//!
+//! @param[in]: targetFps
+//! frames per second, 0 does not limit the frame rate
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void FramePacer::SetTargetFps(int targetFps)
+{
+	m_frameTicks = (targetFps > 0) ? SDL_GetPerformanceFrequency() / static_cast<Uint64>(targetFps) : 0;
+	m_scheduled = false;
+}
+
+//!***************************************************************
+//! @details:
+//! called after a frame was drawn, waits until the next frame is
+//! due. frames are scheduled on a fixed grid so small timing
+//! errors do not add up, a loop that falls more than a whole
+//! frame behind starts a new grid instead of rushing to catch up
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void FramePacer::EndFrame()
+{
+	++m_framesPaced;
+
+	if (m_frameTicks == 0)
+	{
+		return;
+	}
+
+	Uint64 now = SDL_GetPerformanceCounter();
+	if (!m_scheduled)
+	{
+		m_deadline = now;
+		m_scheduled = true;
+	}
+	m_deadline += m_frameTicks;
+
+	if (now >= m_deadline)
+	{
+		if (now - m_deadline > m_frameTicks)
+		{
+			m_deadline = now;
+		}
+		return;
+	}
+
+	Sleep(Stopwatch::TicksToMs(m_deadline - now));
+}
+
+//!***************************************************************
+//! @details:
+//! blocks until an input event arrives or the timeout runs out,
+//! the event stays in the queue for the engine to handle. used
+//! in place of a frame when there is nothing new to draw
+//!
+//! @param[in]: timeoutMs
+//! longest time to wait
+//!
+//! @return: 
+//! bool - true if an event is waiting
+//! 
+//!***************************************************************
+bool FramePacer::WaitForInput(Uint32 timeoutMs)
+{
+	++m_idleWaits;
+
+	Stopwatch idleTimer;
+	bool hasEvent = (SDL_WaitEventTimeout(0, static_cast<int>(timeoutMs)) == 1);
+	m_sleptMs += idleTimer.ElapsedMs();
+
+	// the next frame starts a new schedule, the wait is not a late frame
+	m_scheduled = false;
+
+	return hasEvent;
+}
+
+//!***************************************************************
+//! @details:
+//! number of frames that went through the pacer
+//!
+//! @return: 
+//! unsigned long
+//! 
+//!***************************************************************
+unsigned long FramePacer::GetFramesPaced() const
+{
+	return m_framesPaced;
+}
+
+//!***************************************************************
+//! @details:
+//! number of times the loop waited for input instead of drawing
+//!
+//! @return: 
+//! unsigned long
+//! 
+//!***************************************************************
+unsigned long FramePacer::GetIdleWaits() const
+{
+	return m_idleWaits;
+}
+
+//!***************************************************************
+//! @details:
+//! total time handed back to the system by sleeping
+//!
+//! @return: 
+//! double
+//! 
+//!***************************************************************
+double FramePacer::GetSleptMs() const
+{
+	return m_sleptMs;
+}
+
+//!***************************************************************
+//! @details:
+//! current estimate of how late SDL_Delay wakes up
+//!
+//! @return: 
+//! double
+//! 
+//!***************************************************************
+double FramePacer::GetOversleepMs() const
+{
+	return m_oversleepMs;
+}
+
+//!***************************************************************
+//! @details:
+//! sleeps for the given time. the scheduler wakes threads up
+//! late, so the sleep stops short by the measured oversleep. the
+//! rest is waited out on the performance counter, yielding the
+//! core until the last MaxSpinMs. SDL_Delay can not wait less than
+//! a millisecond, only that short tail is spun to hit the deadline
+//!
+//! @param[in]: ms
+//! time to wait
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void FramePacer::Sleep(double ms)
+{
+	Stopwatch timer;
+
+	double sleepMs = ms - m_oversleepMs;
+	if (sleepMs >= 1.0)
+	{
+		Uint32 requestMs = static_cast<Uint32>(sleepMs);
+		SDL_Delay(requestMs);
+
+		double oversleepMs = timer.ElapsedMs() - static_cast<double>(requestMs);
+		if (oversleepMs < 0.0)
+		{
+			oversleepMs = 0.0;
+		}
+		m_oversleepMs += (oversleepMs - m_oversleepMs) * OversleepSmoothing;
+	}
+
+	m_sleptMs += timer.ElapsedMs();
+
+	Uint64 spinTicks = static_cast<Uint64>(MaxSpinMs * static_cast<double>(SDL_GetPerformanceFrequency()) / 1000.0);
+	for (Uint64 now = SDL_GetPerformanceCounter(); now < m_deadline; now = SDL_GetPerformanceCounter())
+	{
+		if (m_deadline - now > spinTicks)
+		{
+			SDL_Delay(0);
+		}
+	}
+}
@@ -0,0 +1,38 @@
+//*****************************************************************************
+// FILE NAME:  FramePacer.h
+//
+//*****************************************************************************
+#ifndef FRAME_PACER_H_
+#define FRAME_PACER_H_
+
+#include "SDL.h"
+
+//! holds the game loop to a target frame rate, it sleeps away the rest
+//! of each frame and learns how late the sleep wakes up so the last
+//! bit of the frame can be waited out precisely
+class FramePacer
+{
+public:
+	explicit FramePacer(int targetFps);
+
+	void SetTargetFps(int targetFps);
+	void EndFrame();
+	bool WaitForInput(Uint32 timeoutMs);
+
+	unsigned long GetFramesPaced() const;
+	unsigned long GetIdleWaits() const;
+	double GetSleptMs() const;
+	double GetOversleepMs() const;
+private:
+	void Sleep(double ms);
+private:
+	Uint64 m_frameTicks;
+	Uint64 m_deadline;
+	bool m_scheduled;
+	double m_oversleepMs;
+	double m_sleptMs;
+	unsigned long m_framesPaced;
+	unsigned long m_idleWaits;
+};
+
+#endif
@@ -0,0 +1,139 @@
+//*****************************************************************************
+// FILE NAME:  FrameStats.cpp
+//
+//*****************************************************************************
+#include "FrameStats.h"
+
+// standard includes
+#include <algorithm>
+#include <cmath>
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//!***************************************************************
+FrameStats::FrameStats()
+: m_total(0.0), m_max(0.0)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! reserves room for the expected number of samples so recording
+//! does not allocate while the game loop is measured
+//!
+//! @param[in]: count
+//! expected number of samples
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void FrameStats::Reserve(int count)
+{
+	m_samples.reserve(count);
+}
+
+//!***************************************************************
+//! @details:
+//! throws away all recorded samples
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void FrameStats::Clear()
+{
+	m_samples.clear();
+	m_total = 0.0;
+	m_max = 0.0;
+}
+
+//!***************************************************************
+//! @details:
+//! records the duration of one frame
+//!
+//! @param[in]: ms
+//! frame time in milliseconds
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void FrameStats::AddSample(double ms)
+{
+	m_samples.push_back(ms);
+	m_total += ms;
+	m_max = std::max(m_max, ms);
+}
+
+//!***************************************************************
+//! @details:
+//! number of recorded samples
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int FrameStats::GetSampleCount() const
+{
+	return static_cast<int>(m_samples.size());
+}
+
+//!***************************************************************
+//! @details:
+//! nearest rank percentile of the recorded frame times
+//!
+//! @param[in]: percent
+//! percentile to compute in the range [0, 100]
+//!
+//! @return: 
+//! double - milliseconds, 0 if nothing was recorded
+//! 
+//!***************************************************************
+double FrameStats::GetPercentile(double percent) const
+{
+	if (m_samples.empty())
+	{
+		return 0.0;
+	}
+
+	// nearest rank, rank 1 is the smallest sample
+	size_t rank = static_cast<size_t>(std::ceil(percent / 100.0 * m_samples.size()));
+	size_t index = (rank > 0) ? rank - 1 : 0;
+	index = std::min(index, m_samples.size() - 1);
+
+	// partial sort on a copy, the recorded order is kept intact
+	std::vector<double> sorted(m_samples);
+	std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+
+	return sorted[index];
+}
+
+//!***************************************************************
+//! @details:
+//! average frame time
+//!
+//! @return: 
+//! double - milliseconds, 0 if nothing was recorded
+//! 
+//!***************************************************************
+double FrameStats::GetMean() const
+{
+	return m_samples.empty() ? 0.0 : m_total / m_samples.size();
+}
+
+//!***************************************************************
+//! @details:
+//! longest recorded frame time
+//!
+//! @return: 
+//! double - milliseconds
+//! 
+//!***************************************************************
+double FrameStats::GetMax() const
+{
+	return m_max;
+}
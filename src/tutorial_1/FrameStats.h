@@ -0,0 +1,30 @@
+//*****************************************************************************
+// FILE NAME:  FrameStats.h
+//
+//*****************************************************************************
+#ifndef FRAME_STATS_H_
+#define FRAME_STATS_H_
+
+#include <vector>
+
+//! collects frame times and reports their distribution
+class FrameStats
+{
+public:
+	FrameStats();
+
+	void Reserve(int count);
+	void Clear();
+	void AddSample(double ms);
+
+	int GetSampleCount() const;
+	double GetPercentile(double percent) const;
+	double GetMean() const;
+	double GetMax() const;
+private:
+	std::vector<double> m_samples;
+	double m_total;
+	double m_max;
+};
+
+#endif
@@ -1,366 +1,1537 @@
-//*****************************************************************************
-// FILE NAME:  Game.cpp
-//
-//*****************************************************************************
-#include "Game.h"
-#include "ViewController.h"
-#include "MouseListener.h"
-#include "KeyListener.h"
-
-// fife includes
-#include "controller/engine.h"
-#include "controller/enginesettings.h"
-#include "util/log/logger.h"
-#include "loaders/native/map/maploader.h"
-#include "model/structures/map.h"
-#include "model/structures/layer.h"
-#include "view/camera.h"
-#include "eventchannel/eventmanager.h"
-#include "gui/guimanager.h"
-#include "gui/fifechan/fifechanmanager.h"
-#include "gui/fifechan/console/console.h"
-#include "util/time/timemanager.h"
-#include "video/renderbackend.h"
-
-// 3rd party includes
-#include "boost/filesystem.hpp"
-#include "SDL.h"
-
-// standard includes
-#include <cassert>
-
-namespace fs = boost::filesystem;
-
-//!***************************************************************
-//! @details:
-//! constructor
-//!
-//!***************************************************************
-Game::Game()
-: m_map(0), m_mainCamera(0), m_mouseListener(0), m_keyListener(0), m_player(0), m_quit(false)
-{
-	// create the engine
-	m_engine = new FIFE::Engine();
-
-	// create view controller
-	m_viewController = new ViewController();
-
-	// apply game settings
-	InitSettings();
-
-	// initialize the engine
-	m_engine->init();
-
-	// create default gui
-	FIFE::FifechanManager* guiManager = new FIFE::FifechanManager();
-
-	// setup the gui
-	guiManager->setDefaultFont(
-		m_engine->getSettings().getDefaultFontPath(),
-		m_engine->getSettings().getDefaultFontSize(),
-		m_engine->getSettings().getDefaultFontGlyphs()
-	);
-		
-	guiManager->init(
-		m_engine->getRenderBackend()->getName(),
-		m_engine->getRenderBackend()->getScreenWidth(),
-		m_engine->getRenderBackend()->getScreenHeight()
-	);
-
-	m_engine->setGuiManager(guiManager);
-	m_engine->getEventManager()->addSdlEventListener(guiManager);
-}
-
-//!***************************************************************
-//! @details:
-//! destructor
-//!
-//!***************************************************************
-Game::~Game()
-{
-	// clean up our resources
-	delete m_viewController;
-	m_viewController = 0;
-
-	delete m_mouseListener;
-	m_mouseListener = 0;
-
-	delete m_keyListener;
-	m_keyListener = 0;
-
-	// the engine will clean up its resources
-	delete m_engine;
-	m_engine = 0;
-}
-
-//!***************************************************************
-//! @details:
-//! initializes the game and subsystems
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void Game::Init()
-{
-	// load the game map
-	CreateMap();
-
-	// initialize the cameras and view
-	InitView();
-
-	// initialize the user input
-	CreateInput();
-
-	// prep the engine for running
-	m_engine->initializePumping();
-}
-
-//!***************************************************************
-//! @details:
-//! this is the game loop
-//! internally calls the engine tick to make sure everything
-//! updates
-//!
-//! @return: 
-//! bool
-//! 
-//!***************************************************************
-void Game::Run()
-{  
-    int lastTime = 0;
-    int currTime = 0;
-	while (!m_quit)
-	{
-        // update fps reading approx. every second
-        if ((currTime > 0) && (currTime - lastTime >= 1e3))
-        {
-            // create FPS string
-            std::ostringstream oss;
-            oss << " [FPS: " << static_cast<int>(1e3/m_engine->getTimeManager()->getAverageFrameTime()) << "]";
-
-            // show fps in title, and keep it updated
-		    FIFE::EngineSettings& settings = m_engine->getSettings();
-		    std::string windowTitle = settings.getWindowTitle();
-		    windowTitle += oss.str();
-
-		    // this functionality should be part of the engine
-		    // it will be migrated there soon, so the client
-		    // does not have to call SDL directly
-		    SDL_SetWindowTitle(m_engine->getRenderBackend()->getWindow(), windowTitle.c_str());
-
-            // update the last time fps was calculated
-            lastTime = m_engine->getTimeManager()->getTime();
-        }
-
-		// engine timer tick
-		m_engine->pump();
-
-        // update the current run time
-        currTime = m_engine->getTimeManager()->getTime();
-	}
-}
-
-//!***************************************************************
-//! @details:
-//! signal to stop the game loop
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void Game::Quit()
-{
-	m_quit = true;
-}
-
-//!***************************************************************
-//! @details:
-//! toggle the console during game time
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void Game::toggleConsole()
-{
-	// get the engine's GUI manager
-	FIFE::FifechanManager* guiManager = static_cast<FIFE::FifechanManager*>(m_engine->getGuiManager());
-	guiManager->getConsole()->toggleShowHide();
-}
-
-//!***************************************************************
-//! @details:
-//! accessor for the game's view controller
-//!
-//! @return: 
-//! ViewController*
-//! 
-//!***************************************************************
-ViewController* Game::GetViewController()
-{
-	return m_viewController;
-}
-
-//!***************************************************************
-//! @details:
-//! initialize the engine settings
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void Game::InitSettings()
-{
-	// grab the current settings from the engine
-	FIFE::EngineSettings& settings = m_engine->getSettings();
-
-	// get the path to the font we are going to use
-	fs::path defaultFontPath("assets/fonts/FreeSans.ttf");
-
-	// change the engine settings to suite our game
-	settings.setRenderBackend("OpenGL");
-	settings.setScreenHeight(600);
-	settings.setScreenWidth(800);
-	settings.setBitsPerPixel(0);
-	settings.setFullScreen(false);
-	settings.setInitialVolume(5.0);
-	settings.setWindowTitle("FIFE - Tutorials");
-	settings.setDefaultFontGlyphs("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789.,!?-+/():;%&amp;`'*#=[]\"");
-	settings.setDefaultFontPath(defaultFontPath.string());
-
-	FIFE::LogManager* logManager = m_engine->getLogManager();
-	if (logManager)
-	{
-		// disable logging
-		logManager->setLogToFile(false);
-		logManager->setLogToPrompt(false);
-	}
-}
-
-//!***************************************************************
-//! @details:
-//! attaches the correct map loader to the engine and loads the
-//! map file
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void Game::CreateMap()
-{
-	if (m_engine->getModel() && m_engine->getVFS() && m_engine->getImageManager() && 
-		m_engine->getRenderBackend())
-	{
-		// create the default loader for the FIFE map format
-		//FIFE::DefaultMapLoader* mapLoader = FIFE::createDefaultMapLoader(m_engine->getModel(), m_engine->getVFS(), 
-		//	m_engine->getImagePool(), m_engine->getAnimationPool(), m_engine->getRenderBackend());
-		FIFE::MapLoader* mapLoader = new FIFE::MapLoader(m_engine->getModel(), m_engine->getVFS(), 
-			m_engine->getImageManager(), m_engine->getRenderBackend());
-
-		fs::path mapPath("assets/maps/shrine.xml");
-
-		if (mapLoader) {
-			// load the map
-			m_map = mapLoader->load(mapPath.string());
-		}
-
-		// done with map loader safe to delete
-		delete mapLoader;
-		mapLoader = 0;
-	}
-}
-
-//!***************************************************************
-//! @details:
-//! create the user input devices and attach to engine
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void Game::CreateInput()
-{
-	if (m_engine->getEventManager() && m_engine->getModel())
-	{
-		// attach our key listener to the engine
-		m_keyListener = new KeyListener(this);
-		m_engine->getEventManager()->addKeyListener(m_keyListener);
-
-		// attach our mouse listener to the engine
-		m_mouseListener = new MouseListener(this, m_mainCamera, m_engine->getEventManager(), m_engine->getTimeManager());
-		m_engine->getEventManager()->addMouseListener(m_mouseListener);
-
-		// grab the layer that has our main character
-		FIFE::Layer* layer = m_map->getLayer("TechdemoMapGroundObjectLayer");
-
-		if (layer)
-		{
-			// query the layer for our main character
-			m_player = layer->getInstance("PC");
-
-			if (m_player)
-			{
-				// set the main characters default action to standing
-				m_player->actRepeat("stand", m_player->getLocationRef());
-
-				// attach the mouse controller to our main character
-				// to control the player
-				m_mouseListener->SetController(m_player);
-			}
-
-			// query the layer for the other character we are interested in
-			FIFE::Instance* m_npc = layer->getInstance("NPC:girl");
-
-			if (m_npc)
-			{
-				// set this character's action to standing as well
-				m_npc->actRepeat("stand", m_npc->getLocationRef());
-			}
-		}
-	}
-}
-
-//!***************************************************************
-//! @details:
-//! initialize the camera and view
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void Game::InitView()
-{
-	if (m_map)
-	{
-		// get the main camera for this map
-		m_mainCamera = m_map->getCamera("main");
-
-		if (m_mainCamera)
-		{
-			// attach the controller to the camera
-			m_viewController->AttachCamera(m_mainCamera);
-			m_viewController->EnableCamera(true);
-
-			// get the renderer associated with viewing objects on the map
-			FIFE::RendererBase* renderer = m_mainCamera->getRenderer("InstanceRenderer");
-
-			if (renderer)
-			{
-				// activate all layers associated with the renderer
-				// for this map, this must be done to see anything
-				renderer->activateAllLayers(m_map);
-			}
-
-			// get the mini camera attached to the map
-			FIFE::Camera* miniCamera = m_map->getCamera("small");
-
-			// default the small camera to off, we will revisit the
-			// mini camera in a later demo
-			if (miniCamera)
-			{
-				miniCamera->setEnabled(false);
-			}
-		}
-	}
-}
+//*****************************************************************************
+// FILE NAME:  Game.cpp
+//
+//*****************************************************************************
+#include "Game.h"
+#include "ViewController.h"
+#include "MouseListener.h"
+#include "KeyListener.h"
+#include "Benchmark.h"
+#include "Profiler.h"
+#include "ProfilerOverlay.h"
+#include "Stopwatch.h"
+#include "MapCacheLoader.h"
+#include "WorkerPool.h"
+#include "ImagePreloader.h"
+#include "MapStreamer.h"
+#include "InstancePicker.h"
+#include "Crowd.h"
+#include "RouteFollower.h"
+#include "MouseEventBatcher.h"
+#include "FramePacer.h"
+#include "DirtyTracker.h"
+#include "StaticLayerRenderer.h"
+#include "RenderStats.h"
+#include "AssetPackSource.h"
+#include "InputRecorder.h"
+#include "InputReplayer.h"
+#include "MemoryReport.h"
+#include "MemoryTracker.h"
+#include "LoadArena.h"
+#include "MapSwitcher.h"
+#include "StartupTimeline.h"
+#include "GlyphAtlas.h"
+#include "HudText.h"
+#include "Minimap.h"
+
+// fife includes
+#include "controller/engine.h"
+#include "controller/enginesettings.h"
+#include "util/log/logger.h"
+#include "loaders/native/map/maploader.h"
+#include "model/model.h"
+#include "model/structures/map.h"
+#include "model/structures/layer.h"
+#include "view/camera.h"
+#include "eventchannel/eventmanager.h"
+#include "gui/guimanager.h"
+#include "gui/fifechan/fifechanmanager.h"
+#include "gui/fifechan/console/console.h"
+#include "util/time/timemanager.h"
+#include "video/renderbackend.h"
+#include "vfs/vfs.h"
+
+// 3rd party includes
+#include "boost/filesystem.hpp"
+#include "SDL.h"
+
+// standard includes
+#include <cassert>
+#include <iostream>
+#include <sstream>
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+	// decoded images turned into textures per upload pass
+	const int ImageUploadBatchSize = 16;
+
+	// time per frame a background map switch may spend loading the new
+	// map or deleting the old one, the rest of the frame is left to drawing
+	const double MapSwitchBudgetMs = 4.0;
+
+	// bitmap font of the hud and the characters it holds, left to right
+	const char* RpgFontPath = "assets/fonts/rpgfont.png";
+	const char* RpgFontGlyphs = " abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789.,!?-+/():;%&`'*#=[]\"";
+
+	// live counters of the hud, top to bottom
+	enum HudCounter
+	{
+		HUD_FPS,
+		HUD_FRAME_MS,
+		HUD_ENGINE_TIME,
+		HUD_DRAW_CALLS,
+		HUD_TEXTURE_BINDS,
+		HUD_VERTICES,
+		HUD_DRAWN,
+		HUD_CULLED,
+		HUD_AGENTS,
+		HUD_AGENT_TICKS,
+		HUD_CAMERA_X,
+		HUD_CAMERA_Y,
+		HUD_ZOOM,
+		HUD_QUAD_UPDATES,
+		HUD_COUNTER_COUNT
+	};
+
+	const char* HudLabels[HUD_COUNTER_COUNT] =
+	{
+		"fps",
+		"frame ms",
+		"time s",
+		"draw calls",
+		"texture binds",
+		"vertices",
+		"drawn",
+		"culled",
+		"agents",
+		"agent ticks/s",
+		"camera x",
+		"camera y",
+		"zoom",
+		"hud quads set"
+	};
+
+	//!***************************************************************
+	//! @details:
+	//! label of the memory snapshot taken after a map load
+	//!
+	//! @param[in]: reload
+	//! 0 for the first load, then the number of the reload
+	//!
+	//! @return:
+	//! std::string
+	//!
+	//!***************************************************************
+	std::string GetLoadSnapshotLabel(int reload)
+	{
+		if (reload == 0)
+		{
+			return "after load";
+		}
+
+		std::ostringstream label;
+		label << "after map switch " << reload;
+		return label.str();
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: options
+//! command line options the game was started with
+//!
+//!***************************************************************
+Game::Game(const GameOptions& options)
+: m_options(options), m_map(0), m_mainCamera(0), m_mouseListener(0), m_mouseEventBatcher(0), m_keyListener(0), m_player(0),
+  m_benchmark(0), m_profilerOverlay(0), m_workerPool(0), m_mapStreamer(0), m_instancePicker(0), m_crowd(0), m_routeFollower(0), m_framePacer(0),
+  m_dirtyTracker(0), m_staticLayerRenderer(0), m_renderStats(0), m_assetPack(0), m_inputRecorder(0),
+  m_inputReplayer(0), m_memoryReport(0), m_mapSwitcher(0), m_mapFile(options.mapFile), m_switchingMap(false),
+  m_mapSwapped(false), m_startupTimeline(0), m_hudAtlas(0), m_hudText(0), m_minimap(0), m_loadTimeMs(0.0), m_loadHeapAllocations(0), m_loadArenaAllocations(0), m_quit(false)
+{
+	// times every step up to the first frame
+	m_startupTimeline = new StartupTimeline();
+
+	// create the engine
+	m_engine = new FIFE::Engine();
+
+	// create view controller
+	m_viewController = new ViewController();
+
+	// apply game settings
+	InitSettings();
+
+	// initialize the engine
+	m_engine->init();
+	m_startupTimeline->Mark("engine init");
+
+	// read the assets from the pack when there is one, the vfs
+	// owns the source and falls back to the loose files
+	if (!m_options.assetPack.empty())
+	{
+		AssetPackSource* assetPackSource = new AssetPackSource(m_engine->getVFS());
+		if (assetPackSource->Open(m_options.assetPack))
+		{
+			m_engine->getVFS()->addSource(assetPackSource);
+			m_assetPack = &assetPackSource->GetReader();
+		}
+		else
+		{
+			delete assetPackSource;
+		}
+
+		m_startupTimeline->Mark("asset pack");
+	}
+
+	// the console and the profiler overlay start hidden, so the gui
+	// and its font are only created once one of them is shown
+	if (!m_options.lazyGui)
+	{
+		InitGui();
+		m_startupTimeline->Mark("gui");
+	}
+
+	// threads for background work such as image decoding
+	m_workerPool = new WorkerPool();
+
+	// loads other maps while the current one keeps running
+	m_mapSwitcher = new MapSwitcher(m_engine, m_workerPool, m_assetPack);
+
+	// snapshots of the memory use per subsystem
+	m_memoryReport = new MemoryReport(m_engine->getImageManager(), m_engine->getAnimationManager());
+
+	m_startupTimeline->Mark("workers");
+}
+
+//!***************************************************************
+//! @details:
+//! destructor
+//!
+//!***************************************************************
+Game::~Game()
+{
+	// clean up our resources
+	if (m_mainCamera)
+	{
+		m_engine->getTimeManager()->unregisterEvent(m_viewController);
+	}
+	delete m_viewController;
+	m_viewController = 0;
+
+	if (m_mouseEventBatcher)
+	{
+		m_engine->getTimeManager()->unregisterEvent(m_mouseEventBatcher);
+	}
+	delete m_mouseEventBatcher;
+	m_mouseEventBatcher = 0;
+
+	delete m_inputRecorder;
+	m_inputRecorder = 0;
+
+	delete m_inputReplayer;
+	m_inputReplayer = 0;
+
+	delete m_mouseListener;
+	m_mouseListener = 0;
+
+	delete m_keyListener;
+	m_keyListener = 0;
+
+	delete m_benchmark;
+	m_benchmark = 0;
+
+	delete m_profilerOverlay;
+	m_profilerOverlay = 0;
+
+	delete m_mapStreamer;
+	m_mapStreamer = 0;
+
+	delete m_instancePicker;
+	m_instancePicker = 0;
+
+	delete m_crowd;
+	m_crowd = 0;
+
+	delete m_routeFollower;
+	m_routeFollower = 0;
+
+	delete m_framePacer;
+	m_framePacer = 0;
+
+	delete m_dirtyTracker;
+	m_dirtyTracker = 0;
+
+	delete m_mapSwitcher;
+	m_mapSwitcher = 0;
+
+	delete m_workerPool;
+	m_workerPool = 0;
+
+	delete m_memoryReport;
+	m_memoryReport = 0;
+
+	delete m_startupTimeline;
+	m_startupTimeline = 0;
+
+	// the main camera keeps the hud text until the engine is deleted
+	// below, the text lets go of its glyphs before the atlas is gone
+	if (m_hudText)
+	{
+		m_hudText->Clear();
+		m_hudText = 0;
+	}
+	m_hudCounters.clear();
+
+	delete m_hudAtlas;
+	m_hudAtlas = 0;
+
+	// the engine will clean up its resources
+	delete m_engine;
+	m_engine = 0;
+}
+
+//!***************************************************************
+//! @details:
+//! initializes the game and subsystems
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::Init()
+{
+	Stopwatch loadTimer;
+	size_t heapAllocations = MemoryTracker::GetTotalAllocations();
+
+	// data that is only needed while the map loads comes from an
+	// arena, it is freed in one step once loading is done
+	LoadArena loadArena;
+
+	// start decoding the map's images on the worker threads,
+	// the map itself is parsed on this thread in the meantime
+	ImagePreloader preloader(m_engine->getImageManager(), m_workerPool, m_assetPack,
+		m_options.loadArena ? &loadArena : 0);
+	if (m_options.preloadImages)
+	{
+		preloader.AddMapImports(m_options.mapFile);
+	}
+
+	// load the game map
+	CreateMap();
+
+	// hand the decoded images to the engine and create their textures
+	preloader.Upload(ImageUploadBatchSize);
+
+	m_loadTimeMs = loadTimer.ElapsedMs();
+	m_loadHeapAllocations = MemoryTracker::GetTotalAllocations() - heapAllocations;
+	m_loadArenaAllocations = loadArena.GetAllocationCount();
+
+	m_memoryReport->Snapshot(GetLoadSnapshotLabel(0));
+	m_startupTimeline->Mark("map load");
+
+	// load the map again to see what switching maps leaves behind
+	for (int i = 1; i <= m_options.mapReloads; ++i)
+	{
+		ReloadMap();
+		m_memoryReport->Snapshot(GetLoadSnapshotLabel(i));
+	}
+
+	if (m_options.mapReloads > 0)
+	{
+		m_startupTimeline->Mark("map reloads");
+	}
+
+	// the hud glyphs are rasterized once, before the view draws them
+	if (m_options.showHud)
+	{
+		InitHud();
+		m_startupTimeline->Mark("hud");
+	}
+
+	// initialize the cameras and view
+	InitView();
+
+	// fill the first view before anything is drawn
+	if (m_mapStreamer && m_mainCamera)
+	{
+		m_mapStreamer->LoadAround(m_mainCamera->getLocationRef());
+	}
+
+	m_startupTimeline->Mark("view");
+
+	// initialize the user input
+	CreateInput();
+	m_startupTimeline->Mark("input");
+
+	// the layers are only checked for animations once the
+	// characters have been given their actions
+	if (m_options.bakeStaticLayers)
+	{
+		BakeStaticLayers();
+		m_startupTimeline->Mark("static layers");
+	}
+
+	// a fixed length benchmark replaces the interactive session
+	if (m_options.benchmarkFrames > 0 && m_mainCamera)
+	{
+		Benchmark::Scenario scenario = Benchmark::SCENARIO_TOUR;
+		Benchmark::FindScenario(m_options.benchmarkScenario, scenario);
+
+		m_benchmark = new Benchmark(m_mainCamera, m_options.benchmarkFrames, scenario);
+		m_benchmark->SetLoadTime(m_loadTimeMs);
+		m_benchmark->SetLoadAllocations(m_loadHeapAllocations, m_loadArenaAllocations);
+	}
+	else
+	{
+		// with vsync the buffer swap already waits for the display,
+		// a replay that is not in real time runs as fast as it can
+		bool unpaced = m_options.vsync || (!m_options.replayFile.empty() && !m_options.replayRealTime);
+		m_framePacer = new FramePacer(unpaced ? 0 : m_options.targetFps);
+
+		if (m_options.skipIdleFrames && m_mainCamera)
+		{
+			m_dirtyTracker = new DirtyTracker(m_mainCamera);
+			m_dirtyTracker->AddMap(m_map);
+		}
+	}
+
+	// prep the engine for running
+	m_engine->initializePumping();
+	m_startupTimeline->Mark("run setup");
+}
+
+//!***************************************************************
+//! @details:
+//! this is the game loop
+//! internally calls the engine tick to make sure everything
+//! updates
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+void Game::Run()
+{  
+	if (m_benchmark)
+	{
+		RunBenchmark();
+		PrintMemoryReport();
+		return;
+	}
+
+    int lastTime = 0;
+    int currTime = 0;
+	while (!m_quit)
+	{
+        // update fps reading approx. every second
+        if ((currTime > 0) && (currTime - lastTime >= 1e3))
+        {
+            // create FPS string
+            std::ostringstream oss;
+            oss << " [FPS: " << static_cast<int>(1e3/m_engine->getTimeManager()->getAverageFrameTime()) << "]";
+            if (m_crowd)
+            {
+                oss << " [Agents: " << m_crowd->GetAgentCount() << ", agent ticks/s: "
+                    << static_cast<int>(m_crowd->GetAgentTicksPerSecond()) << "]";
+            }
+
+            // show fps in title, and keep it updated
+		    FIFE::EngineSettings& settings = m_engine->getSettings();
+		    std::string windowTitle = settings.getWindowTitle();
+		    windowTitle += oss.str();
+
+		    // this functionality should be part of the engine
+		    // it will be migrated there soon, so the client
+		    // does not have to call SDL directly
+		    SDL_SetWindowTitle(m_engine->getRenderBackend()->getWindow(), windowTitle.c_str());
+
+            // update the last time fps was calculated
+            lastTime = m_engine->getTimeManager()->getTime();
+        }
+
+		// load the next map a little, the switch to it happens here too
+		UpdateMapSwitch();
+
+		// stream map chunks in and out around the camera
+		if (m_mapStreamer && m_mainCamera)
+		{
+			m_mapStreamer->Update(m_mainCamera->getLocationRef());
+		}
+
+		if (m_crowd)
+		{
+			ScopedTimer timer(PHASE_CROWD);
+			m_crowd->Update();
+		}
+
+		// walk the player on along its route
+		if (m_routeFollower)
+		{
+			ScopedTimer timer(PHASE_INPUT);
+			m_routeFollower->Update();
+		}
+
+		// nothing would change on screen, wait for input instead
+		if (m_dirtyTracker)
+		{
+			uint32_t now = SDL_GetTicks();
+			if (!IsBusy() && !m_dirtyTracker->NeedsFrame(now))
+			{
+				m_framePacer->WaitForInput(m_dirtyTracker->GetIdleTimeout(now));
+				continue;
+			}
+
+			m_dirtyTracker->BeginFrame(now);
+		}
+
+		UpdateHud();
+
+		// the engine handles the frame's input first thing in the tick
+		if (m_inputReplayer)
+		{
+			m_inputReplayer->BeginFrame(m_engine->getTimeManager()->getTime());
+		}
+		else if (m_inputRecorder)
+		{
+			m_inputRecorder->BeginFrame(m_engine->getTimeManager()->getTime());
+		}
+
+		// engine timer tick
+		{
+			ScopedTimer timer(PHASE_ENGINE_PUMP);
+			m_engine->pump();
+		}
+
+		// the startup ends with the first frame on screen
+		if (!m_startupTimeline->HasFirstFrame())
+		{
+			FinishStartup();
+		}
+
+		// the last recorded input has been handled
+		if (m_inputReplayer && m_inputReplayer->IsFinished())
+		{
+			Quit();
+		}
+
+		if (m_renderStats)
+		{
+			m_renderStats->EndFrame();
+		}
+
+        // update the current run time
+        currTime = m_engine->getTimeManager()->getTime();
+
+		// hand the phase timings of this frame to the overlay
+		Profiler::Instance().EndFrame();
+		if (m_profilerOverlay)
+		{
+			m_profilerOverlay->Update(currTime);
+		}
+
+		// sleep until the next frame is due
+		m_framePacer->EndFrame();
+	}
+
+	std::cout << "load: " << m_loadTimeMs << " ms, " << m_loadArenaAllocations << " allocations from the load arena";
+	if (MemoryTracker::IsEnabled())
+	{
+		std::cout << ", " << m_loadHeapAllocations << " from the heap";
+	}
+	std::cout << std::endl;
+
+	std::cout << "frames: " << m_framePacer->GetFramesPaced() << " drawn, " << m_framePacer->GetIdleWaits()
+		<< " idle frames skipped, " << m_framePacer->GetSleptMs() << " ms slept, "
+		<< m_framePacer->GetOversleepMs() << " ms average oversleep" << std::endl;
+
+	if (m_inputReplayer)
+	{
+		std::cout << "replay: " << m_inputReplayer->GetEventCount() << " events over "
+			<< m_inputReplayer->GetFrame() << " frames" << std::endl;
+	}
+
+	if (m_inputRecorder)
+	{
+		std::cout << "record: " << m_inputRecorder->GetRecordedEvents() << " events written to "
+			<< m_options.recordFile << std::endl;
+	}
+
+	if (m_mouseEventBatcher)
+	{
+		std::cout << "input: " << m_mouseEventBatcher->GetCoalescedEvents()
+			<< " mouse motion/drag events coalesced" << std::endl;
+	}
+
+	std::cout << "camera: " << m_viewController->GetCoalescedRequests()
+		<< " pan/zoom/rotate requests merged into an earlier camera update" << std::endl;
+
+	if (m_routeFollower)
+	{
+		const PathCache& pathCache = m_routeFollower->GetPathCache();
+		std::cout << "routes: " << pathCache.GetHits() << " cache hits, " << pathCache.GetMisses() << " searches, "
+			<< pathCache.GetSplices() << " re-planned by splicing" << std::endl;
+	}
+
+	if (m_renderStats)
+	{
+		const RenderCounters& totals = m_renderStats->GetTotals();
+		std::cout << "render: " << m_renderStats->PerFrame(totals.drawCalls) << " draw calls, "
+			<< m_renderStats->PerFrame(totals.textureBinds) << " texture binds, "
+			<< m_renderStats->PerFrame(totals.stateSwitches) << " state switches, "
+			<< m_renderStats->PerFrame(totals.vertices) << " vertices, "
+			<< m_renderStats->PerFrame(totals.drawn) << " instances drawn, "
+			<< m_renderStats->PerFrame(totals.culled) << " culled per frame" << std::endl;
+	}
+
+	if (m_minimap)
+	{
+		std::cout << "minimap: " << m_minimap->GetRefreshes() << " renders over " << m_minimap->GetFrames() << " frames, "
+			<< m_minimap->GetStaticRefreshes() << " for static changes, " << m_minimap->GetStaticLayerCount()
+			<< " static layers at " << m_minimap->GetTextureWidth() << "x" << m_minimap->GetTextureHeight() << ", "
+			<< m_minimap->GetMarkerCount() << " markers" << std::endl;
+	}
+
+	if (m_hudText)
+	{
+		std::cout << "hud: " << m_hudAtlas->GetGlyphCount() << " glyphs in a " << m_hudAtlas->GetWidth() << "x"
+			<< m_hudAtlas->GetHeight() << " atlas, " << m_hudText->GetQuadCount() << " quads, "
+			<< m_hudText->GetTextUpdates() << " text changes set " << m_hudText->GetQuadUpdates() << " quads" << std::endl;
+	}
+
+	if (m_staticLayerRenderer)
+	{
+		std::cout << "static layers: " << m_staticLayerRenderer->GetChunkCount() << " chunks, "
+			<< m_staticLayerRenderer->GetBakeCount() << " chunk textures baked, " << m_staticLayerRenderer->GetDrawnChunks()
+			<< " chunks drawn, " << m_staticLayerRenderer->GetCulledChunks() << " culled" << std::endl;
+	}
+
+	if (m_crowd)
+	{
+		std::cout << "crowd: " << m_crowd->GetAgentCount() << " agents, "
+			<< m_crowd->GetAgentTicksPerSecond() << " agent ticks/s, "
+			<< m_crowd->GetPathsFound() << " paths found, " << m_crowd->GetPathsFailed() << " failed, "
+			<< m_crowd->GetAverageSearchMs() << " ms per search" << std::endl;
+	}
+
+	PrintMemoryReport();
+}
+
+//!***************************************************************
+//! @details:
+//! runs the configured number of frames along the scripted
+//! camera path, timing every engine tick, and writes the report
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::RunBenchmark()
+{
+	Stopwatch frameTimer;
+
+	m_benchmark->Start();
+
+	while (!m_quit && !m_benchmark->IsFinished())
+	{
+		// the switch scenario loads the other map part way through
+		if (m_benchmark->IsSwitchDue())
+		{
+			m_benchmark->BeginSwitch();
+			switchMap();
+		}
+
+		// the whole frame is timed, from moving the camera to the
+		// next point on the path to the engine timer tick. the chunks
+		// streamed in and the work of a map switch count towards the
+		// frame they are done in
+		frameTimer.Start();
+		m_benchmark->UpdateCamera();
+		if (m_mapStreamer && m_mainCamera)
+		{
+			m_mapStreamer->Update(m_mainCamera->getLocationRef());
+		}
+		UpdateMapSwitch();
+		if (m_crowd)
+		{
+			m_crowd->Update();
+		}
+		UpdateHud();
+		m_engine->pump();
+		m_benchmark->RecordFrame(frameTimer.ElapsedMs());
+
+		if (!m_startupTimeline->HasFirstFrame())
+		{
+			FinishStartup();
+		}
+
+		if (m_renderStats)
+		{
+			m_renderStats->EndFrame();
+		}
+	}
+
+	if (m_renderStats)
+	{
+		const RenderCounters& totals = m_renderStats->GetTotals();
+		m_benchmark->SetRenderStats(m_renderStats->PerFrame(totals.drawCalls), m_renderStats->PerFrame(totals.textureBinds),
+			m_renderStats->PerFrame(totals.culled));
+	}
+
+	m_benchmark->SetFirstFrameTime(m_startupTimeline->GetFirstFrameMs());
+
+	if (m_crowd)
+	{
+		m_benchmark->SetCrowdStats(m_crowd->GetAgentCount(), m_crowd->GetAgentTicksPerSecond());
+	}
+
+	if (!m_benchmark->WriteReport(m_options.benchmarkOutput, m_options.mapFile))
+	{
+		std::cerr << "could not write benchmark results to " << m_options.benchmarkOutput << std::endl;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! checks for anything that changes the screen over time without
+//! showing up as input or a change to the map
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+bool Game::IsBusy() const
+{
+	// nothing of the gui is on screen before it is created
+	FIFE::FifechanManager* guiManager = static_cast<FIFE::FifechanManager*>(m_engine->getGuiManager());
+	bool guiVisible = guiManager && (m_profilerOverlay->IsVisible() || guiManager->getConsole()->isVisible());
+
+	return m_crowd != 0 || m_inputReplayer != 0 || m_switchingMap || guiVisible ||
+		(m_routeFollower && m_routeFollower->IsFollowing()) || (m_mouseListener && m_mouseListener->IsScrolling()) ||
+		(m_minimap && m_minimap->HasPendingChanges());
+}
+
+//!***************************************************************
+//! @details:
+//! writes the memory use after loading, while running and
+//! after every map switch, and what the last switch leaked
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::PrintMemoryReport()
+{
+	if (!m_options.memoryReport)
+	{
+		return;
+	}
+
+	m_memoryReport->Snapshot("steady state");
+	m_memoryReport->PrintAll(std::cout);
+
+	// the same map was loaded twice, whatever grew in between leaked
+	if (m_options.mapReloads > 0)
+	{
+		m_memoryReport->PrintDelta(std::cout, GetLoadSnapshotLabel(m_options.mapReloads - 1),
+			GetLoadSnapshotLabel(m_options.mapReloads));
+	}
+
+	m_memoryReport->PrintDelta(std::cout, GetLoadSnapshotLabel(m_options.mapReloads), "steady state");
+}
+
+//!***************************************************************
+//! @details:
+//! does this frame's share of a background map switch, switches
+//! over once the new map is ready and notes when the old map is
+//! gone
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::UpdateMapSwitch()
+{
+	if (!m_switchingMap)
+	{
+		return;
+	}
+
+	ScopedTimer timer(PHASE_MAP_SWITCH);
+
+	m_mapSwitcher->Update(MapSwitchBudgetMs);
+
+	if (m_mapSwitcher->IsReady())
+	{
+		SwapMap();
+	}
+	else if (m_mapSwitcher->IsIdle())
+	{
+		// the old map is deleted, or the new one could not be loaded
+		m_switchingMap = false;
+
+		if (m_mapSwapped)
+		{
+			m_memoryReport->Snapshot("after switching to " + fs::path(m_mapFile).filename().string());
+		}
+
+		if (m_benchmark)
+		{
+			m_benchmark->EndSwitch(m_mapSwapped);
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! replaces the current map with the one loaded in the background,
+//! done between two frames. everything that refers to the old map
+//! is recreated for the new one and the old map is handed back to
+//! the switcher to be deleted over the next frames
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::SwapMap()
+{
+	MapStreamer* mapStreamer = 0;
+	FIFE::Map* map = m_mapSwitcher->TakeMap(mapStreamer);
+	if (!map)
+	{
+		return;
+	}
+
+	// nothing may listen to the old map's layers once it is handed on
+	if (m_mouseListener)
+	{
+		m_mouseListener->SetController(0);
+		m_mouseListener->SetPicker(0);
+		m_mouseListener->SetRouteFollower(0);
+	}
+	m_player = 0;
+
+	delete m_instancePicker;
+	m_instancePicker = 0;
+
+	delete m_routeFollower;
+	m_routeFollower = 0;
+
+	delete m_crowd;
+	m_crowd = 0;
+
+	bool trackDirty = (m_dirtyTracker != 0);
+	delete m_dirtyTracker;
+	m_dirtyTracker = 0;
+
+	// the old camera owns this renderer and deletes it with the map
+	m_staticLayerRenderer = 0;
+
+	// the switcher disables the old cameras and deletes the map
+	m_mapSwitcher->Retire(m_map, m_mapStreamer);
+
+	FIFE::Camera* previousCamera = m_mainCamera;
+	m_map = map;
+	m_mapStreamer = mapStreamer;
+	m_mapFile = m_mapSwitcher->GetMapFile();
+
+	InitView();
+
+	// the view controller only runs while there is a camera to move
+	if (m_mainCamera && !previousCamera)
+	{
+		m_engine->getTimeManager()->registerEvent(m_viewController);
+	}
+	else if (!m_mainCamera && previousCamera)
+	{
+		m_engine->getTimeManager()->unregisterEvent(m_viewController);
+	}
+
+	if (m_mouseListener)
+	{
+		m_mouseListener->SetCamera(m_mainCamera);
+	}
+	InitCharacters();
+
+	if (m_options.bakeStaticLayers)
+	{
+		BakeStaticLayers();
+	}
+
+	if (trackDirty && m_mainCamera)
+	{
+		m_dirtyTracker = new DirtyTracker(m_mainCamera);
+		m_dirtyTracker->AddMap(m_map);
+	}
+
+	if (m_benchmark && m_mainCamera)
+	{
+		m_benchmark->AttachCamera(m_mainCamera);
+	}
+
+	m_mapSwapped = true;
+
+	std::cout << "map switch: " << m_mapFile << " loaded over " << m_mapSwitcher->GetLoadFrames() << " frames in "
+		<< m_mapSwitcher->GetLoadTimeMs() << " ms" << std::endl;
+}
+
+//!***************************************************************
+//! @details:
+//! signal to stop the game loop
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::Quit()
+{
+	m_quit = true;
+}
+
+//!***************************************************************
+//! @details:
+//! toggle the console during game time
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::toggleConsole()
+{
+	InitGui();
+
+	// get the engine's GUI manager
+	FIFE::FifechanManager* guiManager = static_cast<FIFE::FifechanManager*>(m_engine->getGuiManager());
+	guiManager->getConsole()->toggleShowHide();
+}
+
+//!***************************************************************
+//! @details:
+//! toggle the frame profiler overlay during game time
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::toggleProfiler()
+{
+	InitGui();
+	m_profilerOverlay->Toggle();
+}
+
+//!***************************************************************
+//! @details:
+//! writes the memory use right now and how it changed since
+//! the map was loaded
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::reportMemory()
+{
+	std::ostringstream label;
+	label << "at " << m_engine->getTimeManager()->getTime() << " ms";
+
+	m_memoryReport->Snapshot(label.str());
+	m_memoryReport->Print(std::cout, label.str());
+	m_memoryReport->PrintDelta(std::cout, GetLoadSnapshotLabel(m_options.mapReloads), label.str());
+}
+
+//!***************************************************************
+//! @details:
+//! ends the startup timeline once the first frame has been
+//! drawn, prints it and writes it out when asked to
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::FinishStartup()
+{
+	m_startupTimeline->MarkFirstFrame();
+	m_startupTimeline->Print(std::cout);
+
+	if (!m_options.startupOutput.empty() && !m_startupTimeline->WriteJson(m_options.startupOutput))
+	{
+		std::cerr << "could not write " << m_options.startupOutput << std::endl;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! starts loading the other map in the background, the game
+//! switches to it once it is loaded. does nothing while a switch
+//! is still in progress
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::switchMap()
+{
+	if (m_switchingMap)
+	{
+		return;
+	}
+
+	// go back and forth between the two maps
+	const std::string& mapFile = (m_mapFile == m_options.switchMapFile) ? m_options.mapFile : m_options.switchMapFile;
+
+	if (m_mapSwitcher->Start(mapFile, m_options.useMapCache, m_options.streamMap, m_options.preloadImages))
+	{
+		m_switchingMap = true;
+		m_mapSwapped = false;
+
+		std::cout << "map switch: loading " << mapFile << " in the background" << std::endl;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! accessor for the game's view controller
+//!
+//! @return: 
+//! ViewController*
+//! 
+//!***************************************************************
+ViewController* Game::GetViewController()
+{
+	return m_viewController;
+}
+
+//!***************************************************************
+//! @details:
+//! initialize the engine settings
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::InitSettings()
+{
+	// grab the current settings from the engine
+	FIFE::EngineSettings& settings = m_engine->getSettings();
+
+	// get the path to the font we are going to use
+	fs::path defaultFontPath("assets/fonts/FreeSans.ttf");
+
+	// change the engine settings to suite our game
+	if (m_options.headless)
+	{
+		// the dummy driver has no GL context, use the software renderer
+		settings.setVideoDriver("dummy");
+		settings.setRenderBackend("SDL");
+	}
+	else
+	{
+		settings.setRenderBackend("OpenGL");
+		settings.setVSync(m_options.vsync);
+	}
+	settings.setScreenHeight(600);
+	settings.setScreenWidth(800);
+	settings.setBitsPerPixel(0);
+	settings.setFullScreen(false);
+	settings.setInitialVolume(5.0);
+	settings.setWindowTitle("FIFE - Tutorials");
+	settings.setDefaultFontGlyphs("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789.,!?-+/():;%&amp;`'*#=[]\"");
+	settings.setDefaultFontPath(defaultFontPath.string());
+
+	FIFE::LogManager* logManager = m_engine->getLogManager();
+	if (logManager)
+	{
+		// disable logging
+		logManager->setLogToFile(false);
+		logManager->setLogToPrompt(false);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! creates the gui, rasterizes its default font and sets up
+//! the console and the profiler overlay. does nothing once the
+//! gui exists
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::InitGui()
+{
+	if (m_engine->getGuiManager())
+	{
+		return;
+	}
+
+	Stopwatch guiTimer;
+
+	// the gui and its fonts are charged to their own memory category
+	MemoryScope memoryScope(MEMORY_GUI);
+
+	// create default gui
+	FIFE::FifechanManager* guiManager = new FIFE::FifechanManager();
+
+	// setup the gui
+	guiManager->setDefaultFont(
+		m_engine->getSettings().getDefaultFontPath(),
+		m_engine->getSettings().getDefaultFontSize(),
+		m_engine->getSettings().getDefaultFontGlyphs()
+	);
+
+	guiManager->init(
+		m_engine->getRenderBackend()->getName(),
+		m_engine->getRenderBackend()->getScreenWidth(),
+		m_engine->getRenderBackend()->getScreenHeight()
+	);
+
+	m_engine->setGuiManager(guiManager);
+	m_engine->getEventManager()->addSdlEventListener(guiManager);
+
+	// frame profiler overlay, hidden until toggled
+	m_profilerOverlay = new ProfilerOverlay(guiManager);
+	m_profilerOverlay->SetRenderStats(m_renderStats);
+
+	if (m_startupTimeline->HasFirstFrame())
+	{
+		std::cout << "gui: created on first use in " << guiTimer.ElapsedMs() << " ms" << std::endl;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! attaches the correct map loader to the engine and loads the
+//! map file
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::CreateMap()
+{
+	MemoryScope memoryScope(MEMORY_MAP);
+
+	if (m_engine->getModel() && m_engine->getVFS() && m_engine->getImageManager() && 
+		m_engine->getRenderBackend())
+	{
+		// create the default loader for the FIFE map format
+		//FIFE::DefaultMapLoader* mapLoader = FIFE::createDefaultMapLoader(m_engine->getModel(), m_engine->getVFS(), 
+		//	m_engine->getImagePool(), m_engine->getAnimationPool(), m_engine->getRenderBackend());
+		FIFE::MapLoader* mapLoader = new FIFE::MapLoader(m_engine->getModel(), m_engine->getVFS(), 
+			m_engine->getImageManager(), m_engine->getRenderBackend());
+
+		fs::path mapPath(m_options.mapFile);
+
+		if (mapLoader && m_options.useMapCache) {
+			// try the precompiled map first, it is skipped if it
+			// does not match the xml file any more
+			MapCacheLoader cacheLoader(m_engine->getModel(), mapLoader, m_engine->getRenderBackend(), m_assetPack);
+
+			if (m_options.streamMap)
+			{
+				m_mapStreamer = new MapStreamer(m_engine->getModel(), m_workerPool);
+			}
+
+			m_map = cacheLoader.Load(mapPath.string(), MapCacheLoader::GetCachePath(mapPath.string()), m_mapStreamer);
+
+			if (!m_map)
+			{
+				// streaming needs the cache, the xml map is loaded whole
+				delete m_mapStreamer;
+				m_mapStreamer = 0;
+			}
+		}
+
+		if (mapLoader && !m_map) {
+			// load the map
+			m_map = mapLoader->load(mapPath.string());
+		}
+
+		// done with map loader safe to delete
+		delete mapLoader;
+		mapLoader = 0;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! deletes the map and loads it again, done before the view
+//! is set up so no camera or renderer holds on to the old map
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::ReloadMap()
+{
+	delete m_mapStreamer;
+	m_mapStreamer = 0;
+
+	if (m_map)
+	{
+		m_engine->getModel()->deleteMap(m_map);
+		m_map = 0;
+	}
+
+	CreateMap();
+}
+
+//!***************************************************************
+//! @details:
+//! create the user input devices and attach to engine
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::CreateInput()
+{
+	if (m_engine->getEventManager() && m_engine->getModel())
+	{
+		// create our key listener
+		m_keyListener = new KeyListener(this);
+
+		// create our mouse listener, motion events reach it at
+		// most once per frame through the batcher
+		m_mouseListener = new MouseListener(this, m_mainCamera, m_engine->getEventManager(), m_engine->getTimeManager());
+		m_mouseEventBatcher = new MouseEventBatcher(m_mouseListener);
+
+		// a replay feeds the listeners instead of the engine
+		if (!m_options.replayFile.empty())
+		{
+			m_inputReplayer = new InputReplayer(m_keyListener, m_mouseEventBatcher, m_options.replayRealTime);
+			if (!m_inputReplayer->Open(m_options.replayFile))
+			{
+				std::cerr << "could not read the input recording " << m_options.replayFile << std::endl;
+				delete m_inputReplayer;
+				m_inputReplayer = 0;
+			}
+		}
+
+		if (!m_inputReplayer)
+		{
+			FIFE::IKeyListener* keyListener = m_keyListener;
+			FIFE::IMouseListener* mouseListener = m_mouseEventBatcher;
+
+			// the recorder sees the raw events before they are batched
+			if (!m_options.recordFile.empty())
+			{
+				m_inputRecorder = new InputRecorder(m_keyListener, m_mouseEventBatcher);
+				if (m_inputRecorder->Open(m_options.recordFile))
+				{
+					keyListener = m_inputRecorder;
+					mouseListener = m_inputRecorder;
+				}
+				else
+				{
+					std::cerr << "could not write the input recording " << m_options.recordFile << std::endl;
+					delete m_inputRecorder;
+					m_inputRecorder = 0;
+				}
+			}
+
+			// attach the listeners to the engine
+			m_engine->getEventManager()->addKeyListener(keyListener);
+			m_engine->getEventManager()->addMouseListener(mouseListener);
+		}
+
+		// time events run in the order they were registered, the
+		// batched motion has to reach the view controller before it
+		// applies the camera changes of the frame
+		m_engine->getTimeManager()->registerEvent(m_mouseEventBatcher);
+		if (m_mainCamera)
+		{
+			m_engine->getTimeManager()->registerEvent(m_viewController);
+		}
+
+		// hook the input up to the characters of the map
+		InitCharacters();
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! finds the characters of the map and attaches the mouse to the
+//! player, done again for every map the game switches to
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::InitCharacters()
+{
+	if (m_map && m_mouseListener)
+	{
+		// grab the layer that has our main character
+		FIFE::Layer* layer = m_map->getLayer("TechdemoMapGroundObjectLayer");
+
+		if (layer && m_mainCamera)
+		{
+			// index the layer's instances for clicking on them
+			m_instancePicker = new InstancePicker(m_mainCamera);
+			m_instancePicker->AddLayer(layer);
+			m_mouseListener->SetPicker(m_instancePicker);
+		}
+
+		if (layer)
+		{
+			// query the layer for our main character
+			m_player = layer->getInstance("PC");
+
+			if (m_player)
+			{
+				// set the main characters default action to standing
+				m_player->actRepeat("stand", m_player->getLocationRef());
+
+				// attach the mouse controller to our main character
+				// to control the player
+				m_mouseListener->SetController(m_player);
+
+				// clicks are walked along cached routes
+				m_routeFollower = new RouteFollower(m_player, layer);
+				m_mouseListener->SetRouteFollower(m_routeFollower);
+			}
+
+			// query the layer for the other character we are interested in
+			FIFE::Instance* m_npc = layer->getInstance("NPC:girl");
+
+			if (m_npc)
+			{
+				// set this character's action to standing as well
+				m_npc->actRepeat("stand", m_npc->getLocationRef());
+			}
+
+			if (m_options.crowdSize > 0)
+			{
+				// fill the map with agents walking around
+				m_crowd = new Crowd(m_engine->getModel(), layer, m_workerPool);
+				int spawned = m_crowd->Spawn(m_options.crowdSize);
+
+				std::cout << "crowd: " << spawned << " agents spawned" << std::endl;
+			}
+
+			// the characters move, the minimap shows them as markers
+			if (m_minimap)
+			{
+				m_minimap->AddMarker(m_player, Minimap::MARKER_PLAYER);
+				m_minimap->AddMarker(m_npc, Minimap::MARKER_NPC);
+
+				for (int i = 0; m_crowd && i < m_crowd->GetAgentCount(); ++i)
+				{
+					m_minimap->AddMarker(m_crowd->GetAgent(i), Minimap::MARKER_AGENT);
+				}
+			}
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! initialize the camera and view
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::InitView()
+{
+	// stats of the map shown before, their counts carry on
+	RenderStats* previousStats = m_renderStats;
+	m_renderStats = 0;
+	m_mainCamera = 0;
+
+	// the old camera owns the hud text and the minimap and deletes them with the map
+	m_hudText = 0;
+	m_minimap = 0;
+	m_hudCounters.clear();
+
+	if (m_map)
+	{
+		// get the main camera for this map
+		m_mainCamera = m_map->getCamera("main");
+
+		if (m_mainCamera)
+		{
+			// attach the controller to the camera
+			m_viewController->AttachCamera(m_mainCamera);
+			m_viewController->EnableCamera(true);
+
+			// get the renderer associated with viewing objects on the map
+			FIFE::RendererBase* renderer = m_mainCamera->getRenderer("InstanceRenderer");
+
+			if (renderer)
+			{
+				// activate all layers associated with the renderer
+				// for this map, this must be done to see anything
+				renderer->activateAllLayers(m_map);
+			}
+
+			// counts what every frame costs per renderer and layer,
+			// the camera owns its renderers and deletes this one
+			m_renderStats = new RenderStats(m_engine->getRenderBackend());
+			m_mainCamera->addRenderer(m_renderStats);
+			m_renderStats->Attach(m_mainCamera, m_map);
+
+			if (previousStats)
+			{
+				m_renderStats->ContinueFrom(*previousStats);
+			}
+
+			if (!m_options.renderStatsFile.empty() &&
+				!m_renderStats->OpenCsv(m_options.renderStatsFile, previousStats != 0))
+			{
+				std::cerr << "could not write " << m_options.renderStatsFile << std::endl;
+			}
+
+			// live counters drawn over the map, also owned by the camera
+			if (m_hudAtlas)
+			{
+				m_hudText = new HudText(m_engine->getRenderBackend(), m_hudAtlas);
+				m_mainCamera->addRenderer(m_hudText);
+				m_hudText->Attach(m_map);
+				m_hudText->SetRenderStats(m_renderStats);
+
+				for (int i = 0; i < HUD_COUNTER_COUNT; ++i)
+				{
+					m_hudCounters.push_back(m_hudText->AddCounter(HudLabels[i]));
+				}
+			}
+
+			// get the mini camera attached to the map
+			FIFE::Camera* miniCamera = m_map->getCamera("small");
+
+			// the engine would render a second view every frame, the
+			// minimap renders the small camera now and then instead
+			if (miniCamera)
+			{
+				miniCamera->setEnabled(false);
+
+				if (m_options.minimap)
+				{
+					m_minimap = new Minimap(m_engine->getRenderBackend(), m_engine->getImageManager(), miniCamera,
+						m_options.minimapScale, m_options.minimapRate);
+					m_mainCamera->addRenderer(m_minimap);
+					m_minimap->Attach(m_map);
+					m_minimap->SetRenderStats(m_renderStats);
+				}
+			}
+		}
+	}
+
+	if (m_profilerOverlay)
+	{
+		m_profilerOverlay->SetRenderStats(m_renderStats);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! rasterizes the glyphs of the hud font into an atlas, the
+//! view draws its counters from it
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::InitHud()
+{
+	m_hudAtlas = new GlyphAtlas(m_engine->getImageManager(), m_assetPack);
+
+	bool loaded = false;
+	if (m_options.hudFont == "rpg")
+	{
+		loaded = m_hudAtlas->LoadImageFont(RpgFontPath, RpgFontGlyphs);
+	}
+	else
+	{
+		FIFE::EngineSettings& settings = m_engine->getSettings();
+		loaded = m_hudAtlas->LoadTrueType(settings.getDefaultFontPath(), settings.getDefaultFontSize());
+	}
+
+	if (!loaded)
+	{
+		std::cerr << "hud: could not load the " << m_options.hudFont << " font, the hud is off" << std::endl;
+
+		delete m_hudAtlas;
+		m_hudAtlas = 0;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! hands this frame's values to the hud counters. only the
+//! glyphs of the digits that changed are laid out again
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::UpdateHud()
+{
+	if (!m_hudText)
+	{
+		return;
+	}
+
+	FIFE::TimeManager* timeManager = m_engine->getTimeManager();
+	double frameMs = timeManager->getAverageFrameTime();
+
+	m_hudText->SetValue(m_hudCounters[HUD_FPS], (frameMs > 0.0) ? 1e3 / frameMs : 0.0);
+	m_hudText->SetValue(m_hudCounters[HUD_FRAME_MS], frameMs, 1);
+	m_hudText->SetValue(m_hudCounters[HUD_ENGINE_TIME], timeManager->getTime() / 1e3, 1);
+
+	if (m_renderStats)
+	{
+		const RenderCounters& lastFrame = m_renderStats->GetLastFrame();
+		m_hudText->SetValue(m_hudCounters[HUD_DRAW_CALLS], static_cast<double>(lastFrame.drawCalls));
+		m_hudText->SetValue(m_hudCounters[HUD_TEXTURE_BINDS], static_cast<double>(lastFrame.textureBinds));
+		m_hudText->SetValue(m_hudCounters[HUD_VERTICES], static_cast<double>(lastFrame.vertices));
+		m_hudText->SetValue(m_hudCounters[HUD_DRAWN], static_cast<double>(lastFrame.drawn));
+		m_hudText->SetValue(m_hudCounters[HUD_CULLED], static_cast<double>(lastFrame.culled));
+	}
+
+	m_hudText->SetValue(m_hudCounters[HUD_AGENTS], m_crowd ? m_crowd->GetAgentCount() : 0);
+	m_hudText->SetValue(m_hudCounters[HUD_AGENT_TICKS], m_crowd ? m_crowd->GetAgentTicksPerSecond() : 0.0);
+
+	if (m_mainCamera)
+	{
+		FIFE::ExactModelCoordinate position = m_mainCamera->getLocationRef().getMapCoordinates();
+		m_hudText->SetValue(m_hudCounters[HUD_CAMERA_X], position.x, 2);
+		m_hudText->SetValue(m_hudCounters[HUD_CAMERA_Y], position.y, 2);
+		m_hudText->SetValue(m_hudCounters[HUD_ZOOM], m_mainCamera->getZoom(), 2);
+	}
+
+	m_hudText->SetValue(m_hudCounters[HUD_QUAD_UPDATES], static_cast<double>(m_hudText->GetQuadUpdates()));
+}
+
+//!***************************************************************
+//! @details:
+//! hands the layers whose instances never animate to the static
+//! layer renderer, it draws them from baked chunk textures
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Game::BakeStaticLayers()
+{
+	if (!m_map || !m_mainCamera)
+	{
+		return;
+	}
+
+	// the camera owns its renderers and deletes this one with itself
+	m_staticLayerRenderer = new StaticLayerRenderer(m_engine->getRenderBackend(), m_engine->getImageManager());
+	m_mainCamera->addRenderer(m_staticLayerRenderer);
+	m_staticLayerRenderer->SetRenderStats(m_renderStats);
+
+	const std::list<FIFE::Layer*>& layers = m_map->getLayers();
+	for (std::list<FIFE::Layer*>::const_iterator it = layers.begin(); it != layers.end(); ++it)
+	{
+		if (m_staticLayerRenderer->AddLayer(m_mainCamera, *it))
+		{
+			std::cout << "static layers: baking " << (*it)->getId() << std::endl;
+		}
+	}
+}
\ No newline at end of file
@@ -1,53 +1,127 @@
-//*****************************************************************************
-// FILE NAME:  Game.h
-//
-//*****************************************************************************
-#ifndef GAME_H_
-#define GAME_H_
-
-// forward declarations for fife classes
-namespace FIFE
-{
-	class Engine;
-	class EngineSettings;
-	class Map;
-	class Camera;
-	class Instance;
-}
-
-class ViewController;
-class MouseListener;
-class KeyListener;
-
-//! main interface to the demo
-class Game
-{
-public:
-	Game();
-	~Game();
-
-	void Init();
-	void Run();
-	void Quit();
-
-	void toggleConsole();
-	ViewController* GetViewController();
-private:
-	void InitSettings();
-	void CreateMap();
-	void CreateInput();
-	void InitView();
-
-private:
-	FIFE::Engine* m_engine;
-	FIFE::Map* m_map;
-	FIFE::Camera* m_mainCamera;
-	ViewController* m_viewController;
-	MouseListener* m_mouseListener;
-	KeyListener* m_keyListener;
-	FIFE::Instance* m_player;
-	bool m_quit;
-};
-
-#endif
-
+//*****************************************************************************
+// FILE NAME:  Game.h
+//
+//*****************************************************************************
+#ifndef GAME_H_
+#define GAME_H_
+
+#include "GameOptions.h"
+
+// standard includes
+#include <vector>
+
+// forward declarations for fife classes
+namespace FIFE
+{
+	class Engine;
+	class EngineSettings;
+	class Map;
+	class Camera;
+	class Instance;
+}
+
+namespace AssetPack
+{
+	class Reader;
+}
+
+class ViewController;
+class MouseListener;
+class KeyListener;
+class Benchmark;
+class ProfilerOverlay;
+class WorkerPool;
+class MapStreamer;
+class InstancePicker;
+class Crowd;
+class RouteFollower;
+class MouseEventBatcher;
+class FramePacer;
+class DirtyTracker;
+class StaticLayerRenderer;
+class RenderStats;
+class InputRecorder;
+class InputReplayer;
+class MemoryReport;
+class MapSwitcher;
+class StartupTimeline;
+class GlyphAtlas;
+class HudText;
+class Minimap;
+
+//! main interface to the demo
+class Game
+{
+public:
+	explicit Game(const GameOptions& options = GameOptions());
+	~Game();
+
+	void Init();
+	void Run();
+	void Quit();
+
+	void toggleConsole();
+	void toggleProfiler();
+	void reportMemory();
+	void switchMap();
+	ViewController* GetViewController();
+private:
+	void InitSettings();
+	void InitGui();
+	void CreateMap();
+	void ReloadMap();
+	void CreateInput();
+	void InitCharacters();
+	void InitView();
+	void InitHud();
+	void UpdateHud();
+	void BakeStaticLayers();
+	void RunBenchmark();
+	bool IsBusy() const;
+	void PrintMemoryReport();
+	void UpdateMapSwitch();
+	void SwapMap();
+	void FinishStartup();
+
+private:
+	GameOptions m_options;
+	FIFE::Engine* m_engine;
+	FIFE::Map* m_map;
+	FIFE::Camera* m_mainCamera;
+	ViewController* m_viewController;
+	MouseListener* m_mouseListener;
+	MouseEventBatcher* m_mouseEventBatcher;
+	KeyListener* m_keyListener;
+	FIFE::Instance* m_player;
+	Benchmark* m_benchmark;
+	ProfilerOverlay* m_profilerOverlay;
+	WorkerPool* m_workerPool;
+	MapStreamer* m_mapStreamer;
+	InstancePicker* m_instancePicker;
+	Crowd* m_crowd;
+	RouteFollower* m_routeFollower;
+	FramePacer* m_framePacer;
+	DirtyTracker* m_dirtyTracker;
+	StaticLayerRenderer* m_staticLayerRenderer;
+	RenderStats* m_renderStats;
+	const AssetPack::Reader* m_assetPack;
+	InputRecorder* m_inputRecorder;
+	InputReplayer* m_inputReplayer;
+	MemoryReport* m_memoryReport;
+	MapSwitcher* m_mapSwitcher;
+	std::string m_mapFile;
+	bool m_switchingMap;
+	bool m_mapSwapped;
+	StartupTimeline* m_startupTimeline;
+	GlyphAtlas* m_hudAtlas;
+	HudText* m_hudText;
+	Minimap* m_minimap;
+	std::vector<int> m_hudCounters;
+	double m_loadTimeMs;
+	size_t m_loadHeapAllocations;
+	size_t m_loadArenaAllocations;
+	bool m_quit;
+};
+
+#endif
+
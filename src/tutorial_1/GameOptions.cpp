@@ -0,0 +1,306 @@
+//*****************************************************************************
+// FILE NAME:  GameOptions.cpp
+//
+//*****************************************************************************
+#include "GameOptions.h"
+#include "Benchmark.h"
+
+// standard includes
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+	// directory the bundled maps live in
+	const char* MapDirectory = "assets/maps/";
+
+	//!***************************************************************
+	//! @details:
+	//! turns a bare map name like "shrine.xml" into a path inside
+	//! the bundled map directory, full paths are left untouched
+	//!
+	//! @param[in]: name
+	//! map name or path given on the command line
+	//!
+	//! @return:
+	//! std::string
+	//!
+	//!***************************************************************
+	std::string ResolveMapPath(const std::string& name)
+	{
+		if (name.find('/') != std::string::npos || name.find('\\') != std::string::npos)
+		{
+			return name;
+		}
+
+		return std::string(MapDirectory) + name;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! constructor, sets up the interactive defaults
+//!
+//!***************************************************************
+GameOptions::GameOptions()
+: mapFile("assets/maps/shrine.xml"), assetPack("assets.pack"), useMapCache(true), streamMap(false), preloadImages(true), loadArena(true), headless(false), bakeStaticLayers(false), crowdSize(0), targetFps(60), vsync(false),
+  skipIdleFrames(true), benchmarkFrames(0),
+  benchmarkScenario("tour"), benchmarkOutput("benchmark.json"), replayRealTime(false),
+  memoryReport(false), mapReloads(0), switchMapFile("assets/maps/tourist_beach.xml"),
+  lazyGui(true), showHud(false), hudFont("sans"), minimap(false),
+  minimapScale(0.5), minimapRate(2.0)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! reads the options from the program arguments
+//!
+//! @param[in]: argc
+//! number of arguments
+//!
+//! @param[in]: argv
+//! the argument strings
+//!
+//! @return:
+//! bool - false if the arguments could not be understood
+//!
+//!***************************************************************
+bool GameOptions::Parse(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		bool hasValue = (i + 1 < argc);
+
+		if (arg == "--map" && hasValue)
+		{
+			mapFile = ResolveMapPath(argv[++i]);
+		}
+		else if (arg == "--asset-pack" && hasValue)
+		{
+			assetPack = argv[++i];
+		}
+		else if (arg == "--no-asset-pack")
+		{
+			assetPack.clear();
+		}
+		else if (arg == "--no-map-cache")
+		{
+			useMapCache = false;
+		}
+		else if (arg == "--stream")
+		{
+			streamMap = true;
+		}
+		else if (arg == "--no-preload")
+		{
+			preloadImages = false;
+		}
+		else if (arg == "--no-load-arena")
+		{
+			loadArena = false;
+		}
+		else if (arg == "--headless")
+		{
+			headless = true;
+		}
+		else if (arg == "--bake-static")
+		{
+			bakeStaticLayers = true;
+		}
+		else if (arg == "--crowd" && hasValue)
+		{
+			crowdSize = std::atoi(argv[++i]);
+
+			if (crowdSize < 0)
+			{
+				std::cerr << "crowd size must not be negative" << std::endl;
+				return false;
+			}
+		}
+		else if (arg == "--fps" && hasValue)
+		{
+			targetFps = std::atoi(argv[++i]);
+
+			if (targetFps < 0)
+			{
+				std::cerr << "target fps must not be negative" << std::endl;
+				return false;
+			}
+		}
+		else if (arg == "--vsync")
+		{
+			vsync = true;
+		}
+		else if (arg == "--no-idle-skip")
+		{
+			skipIdleFrames = false;
+		}
+		else if (arg == "--benchmark" && hasValue)
+		{
+			benchmarkFrames = std::atoi(argv[++i]);
+
+			if (benchmarkFrames <= 0)
+			{
+				std::cerr << "benchmark frame count must be positive" << std::endl;
+				return false;
+			}
+		}
+		else if (arg == "--scenario" && hasValue)
+		{
+			benchmarkScenario = argv[++i];
+
+			Benchmark::Scenario scenario;
+			if (!Benchmark::FindScenario(benchmarkScenario, scenario))
+			{
+				std::cerr << "unknown benchmark scenario: " << benchmarkScenario << std::endl;
+				return false;
+			}
+		}
+		else if (arg == "--output" && hasValue)
+		{
+			benchmarkOutput = argv[++i];
+		}
+		else if (arg == "--render-stats" && hasValue)
+		{
+			renderStatsFile = argv[++i];
+		}
+		else if (arg == "--record" && hasValue)
+		{
+			recordFile = argv[++i];
+		}
+		else if (arg == "--replay" && hasValue)
+		{
+			replayFile = argv[++i];
+		}
+		else if (arg == "--replay-realtime")
+		{
+			replayRealTime = true;
+		}
+		else if (arg == "--memory-report")
+		{
+			memoryReport = true;
+		}
+		else if (arg == "--map-reloads" && hasValue)
+		{
+			mapReloads = std::atoi(argv[++i]);
+
+			if (mapReloads < 0)
+			{
+				std::cerr << "map reload count must not be negative" << std::endl;
+				return false;
+			}
+		}
+		else if (arg == "--switch-map" && hasValue)
+		{
+			switchMapFile = ResolveMapPath(argv[++i]);
+		}
+		else if (arg == "--eager-gui")
+		{
+			lazyGui = false;
+		}
+		else if (arg == "--startup-output" && hasValue)
+		{
+			startupOutput = argv[++i];
+		}
+		else if (arg == "--hud")
+		{
+			showHud = true;
+		}
+		else if (arg == "--hud-font" && hasValue)
+		{
+			hudFont = argv[++i];
+
+			if (hudFont != "sans" && hudFont != "rpg")
+			{
+				std::cerr << "unknown hud font: " << hudFont << std::endl;
+				return false;
+			}
+		}
+		else if (arg == "--minimap")
+		{
+			minimap = true;
+		}
+		else if (arg == "--minimap-scale" && hasValue)
+		{
+			minimapScale = std::atof(argv[++i]);
+
+			if (minimapScale <= 0.0 || minimapScale > 1.0)
+			{
+				std::cerr << "minimap scale must be above 0 and at most 1" << std::endl;
+				return false;
+			}
+		}
+		else if (arg == "--minimap-rate" && hasValue)
+		{
+			minimapRate = std::atof(argv[++i]);
+
+			if (minimapRate <= 0.0)
+			{
+				std::cerr << "minimap rate must be above 0" << std::endl;
+				return false;
+			}
+		}
+		else
+		{
+			std::cerr << "unknown or incomplete option: " << arg << std::endl;
+			return false;
+		}
+	}
+
+	if (!recordFile.empty() && !replayFile.empty())
+	{
+		std::cerr << "input can not be recorded and replayed at the same time" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+//!***************************************************************
+//! @details:
+//! prints the supported command line options
+//!
+//! @param[in]: program
+//! name of the executable
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void GameOptions::PrintUsage(const char* program)
+{
+	std::cout << "usage: " << program << " [options]" << std::endl
+		<< "  --map <file>        map to load, e.g. shrine.xml or tourist_beach.xml" << std::endl
+		<< "  --asset-pack <file> pack to read the assets from (default: assets.pack)" << std::endl
+		<< "  --no-asset-pack     read the loose files under assets/ only" << std::endl
+		<< "  --no-map-cache      always parse the xml map, ignore the binary cache" << std::endl
+		<< "  --stream            only keep the map chunks around the camera loaded" << std::endl
+		<< "  --no-preload        decode images on demand instead of on worker threads" << std::endl
+		<< "  --no-load-arena     allocate the loading data from the heap instead of an arena" << std::endl
+		<< "  --headless          use the SDL dummy video driver, no window is shown" << std::endl
+		<< "  --bake-static       draw static layers from textures baked per chunk" << std::endl
+		<< "  --crowd <n>         spawn n agents that walk to random spots" << std::endl
+		<< "  --fps <n>           frame rate limit, 0 runs unlimited (default: 60)" << std::endl
+		<< "  --vsync             wait for the display refresh instead of sleeping" << std::endl
+		<< "  --no-idle-skip      draw every frame even when nothing changed" << std::endl
+		<< "  --benchmark <n>     run n frames along a scripted camera path and exit" << std::endl
+		<< "  --scenario <name>   benchmark camera path: tour, still, pan, zoom, rotate or switch (default: tour)" << std::endl
+		<< "  --output <file>     benchmark result file (default: benchmark.json)" << std::endl
+		<< "  --render-stats <file> write draw calls, binds and culling per layer and frame as csv" << std::endl
+		<< "  --record <file>     record the key and mouse input" << std::endl
+		<< "  --replay <file>     play a recording back instead of the live input and exit" << std::endl
+		<< "  --replay-realtime   replay at the recorded times, not as fast as possible" << std::endl
+		<< "  --memory-report     print the memory use per subsystem on exit" << std::endl
+		<< "  --map-reloads <n>   load the map n more times first to find what a map switch leaks" << std::endl
+		<< "  --switch-map <file> map F3 and the switch benchmark load in the background (default: tourist_beach.xml)" << std::endl
+		<< "  --eager-gui         create the gui and its font at startup instead of on first use" << std::endl
+		<< "  --startup-output <file> write the time of every startup step as json" << std::endl
+		<< "  --hud               draw live counters over the view" << std::endl
+		<< "  --hud-font <name>   font of the counters: sans or rpg (default: sans)" << std::endl
+		<< "  --minimap           show the small camera as a minimap rendered now and then" << std::endl
+		<< "  --minimap-scale <f> resolution of the minimap relative to its viewport (default: 0.5)" << std::endl
+		<< "  --minimap-rate <n>  most minimap renders per second (default: 2)" << std::endl;
+}
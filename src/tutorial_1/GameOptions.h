@@ -0,0 +1,106 @@
+//*****************************************************************************
+// FILE NAME:  GameOptions.h
+//
+//*****************************************************************************
+#ifndef GAME_OPTIONS_H_
+#define GAME_OPTIONS_H_
+
+#include <string>
+
+//! options that can be changed from the command line
+struct GameOptions
+{
+	GameOptions();
+
+	bool Parse(int argc, char* argv[]);
+	static void PrintUsage(const char* program);
+
+	// map file to load, relative to the working directory
+	std::string mapFile;
+
+	// asset pack the files are read from, loose files are used if it is missing
+	std::string assetPack;
+
+	// load the map from its binary cache when it is up to date
+	bool useMapCache;
+
+	// instantiate only the map chunks around the camera, needs the map cache
+	bool streamMap;
+
+	// decode the map's images on worker threads while the map loads
+	bool preloadImages;
+
+	// allocate the data only needed while loading from one arena
+	bool loadArena;
+
+	// run without a visible window using the SDL dummy video driver
+	bool headless;
+
+	// draw layers without animated instances from textures baked per chunk
+	bool bakeStaticLayers;
+
+	// number of agents walking around the map, 0 disables the crowd
+	int crowdSize;
+
+	// frames per second the interactive loop is held to, 0 does not limit it
+	int targetFps;
+
+	// let the display's refresh pace the frames instead of the sleep timer
+	bool vsync;
+
+	// wait for input instead of drawing frames that would not change
+	bool skipIdleFrames;
+
+	// number of frames to run in benchmark mode, 0 runs interactively
+	int benchmarkFrames;
+
+	// camera path of the benchmark: tour, still, pan, zoom, rotate or switch
+	std::string benchmarkScenario;
+
+	// file the benchmark results are written to
+	std::string benchmarkOutput;
+
+	// csv file the render counters of every frame are written to, empty writes none
+	std::string renderStatsFile;
+
+	// file the key and mouse input is recorded to, empty records nothing
+	std::string recordFile;
+
+	// recording that replaces the live input, the game quits when it ends
+	std::string replayFile;
+
+	// replay at the recorded times instead of as fast as possible
+	bool replayRealTime;
+
+	// print the memory use per subsystem when the game exits
+	bool memoryReport;
+
+	// times the map is deleted and loaded again before the game starts
+	int mapReloads;
+
+	// map loaded in the background and switched to with F3 or by the switch benchmark
+	std::string switchMapFile;
+
+	// create the gui and rasterize its font when the console or a widget is first shown
+	bool lazyGui;
+
+	// json file the startup timeline is written to, empty writes none
+	std::string startupOutput;
+
+	// draw live counters over the view from a glyph atlas
+	bool showHud;
+
+	// font of the counters: sans for the default true type font, rpg for rpgfont.png
+	std::string hudFont;
+
+	// show the map's small camera as a minimap rendered into a cached texture
+	bool minimap;
+
+	// resolution of the minimap texture relative to the small camera's viewport
+	double minimapScale;
+
+	// most times per second the minimap texture is rendered again
+	double minimapRate;
+};
+
+#endif
@@ -0,0 +1,518 @@
+//*****************************************************************************
+// FILE NAME:  GlyphAtlas.cpp
+//
+//*****************************************************************************
+#include "GlyphAtlas.h"
+#include "AssetPackFormat.h"
+#include "MemoryTracker.h"
+
+// fife includes
+#include "video/imagemanager.h"
+
+// 3rd party includes
+#include "SDL_image.h"
+#include "SDL_ttf.h"
+
+// standard includes
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+	// the printable ascii characters are rasterized from true type fonts
+	const int FirstPrintable = 32;
+	const int LastPrintable = 126;
+
+	// glyphs are packed into rows no wider than this
+	const int AtlasWidth = 512;
+
+	// empty pixels between glyphs so filtering does not bleed
+	const int GlyphPadding = 1;
+
+	// drawn for characters the font does not have
+	const char MissingGlyph = '?';
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//!***************************************************************
+Glyph::Glyph()
+: width(0), height(0), advance(0)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: imageManager
+//! image manager that owns the atlas texture and the glyph images
+//!
+//! @param[in]: assetPack
+//! pack the font is read from before the loose files, may be 0
+//!
+//!***************************************************************
+GlyphAtlas::GlyphAtlas(FIFE::ImageManager* imageManager, const AssetPack::Reader* assetPack)
+: m_imageManager(imageManager), m_assetPack(assetPack), m_lineHeight(0), m_glyphCount(0), m_width(0), m_height(0)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! destructor, frees the atlas texture
+//!
+//!***************************************************************
+GlyphAtlas::~GlyphAtlas()
+{
+	Release();
+}
+
+//!***************************************************************
+//! @details:
+//! rasterizes the printable ascii characters of a true type font
+//!
+//! @param[in]: path
+//! the .ttf file
+//!
+//! @param[in]: size
+//! point size of the font
+//!
+//! @return:
+//! bool - false if the font could not be read
+//!
+//!***************************************************************
+bool GlyphAtlas::LoadTrueType(const std::string& path, int size)
+{
+	MemoryScope memoryScope(MEMORY_GUI);
+
+	Release();
+
+	if (!TTF_WasInit() && TTF_Init() != 0)
+	{
+		std::cerr << "glyph atlas: " << TTF_GetError() << std::endl;
+		return false;
+	}
+
+	SDL_RWops* file = OpenFile(path);
+	if (!file)
+	{
+		return false;
+	}
+
+	TTF_Font* font = TTF_OpenFontRW(file, 1, size);
+	if (!font)
+	{
+		std::cerr << path << ": " << TTF_GetError() << std::endl;
+		return false;
+	}
+
+	SDL_Color white = { 255, 255, 255, 255 };
+	std::vector<Pending> pending;
+
+	for (int code = FirstPrintable; code <= LastPrintable; ++code)
+	{
+		int minX, maxX, minY, maxY, advance;
+		if (TTF_GlyphMetrics(font, static_cast<Uint16>(code), &minX, &maxX, &minY, &maxY, &advance) != 0)
+		{
+			continue;
+		}
+
+		Pending glyph;
+		glyph.code = static_cast<unsigned char>(code);
+		glyph.advance = advance;
+		glyph.surface = (code == ' ') ? 0 : TTF_RenderGlyph_Blended(font, static_cast<Uint16>(code), white);
+
+		SDL_Rect area = { 0, 0, glyph.surface ? glyph.surface->w : 0, glyph.surface ? glyph.surface->h : 0 };
+		glyph.area = area;
+
+		pending.push_back(glyph);
+	}
+
+	m_lineHeight = TTF_FontLineSkip(font);
+	TTF_CloseFont(font);
+
+	bool packed = Pack(path, pending);
+
+	for (std::vector<Pending>::iterator it = pending.begin(); it != pending.end(); ++it)
+	{
+		if (it->surface)
+		{
+			SDL_FreeSurface(it->surface);
+		}
+	}
+
+	return packed;
+}
+
+//!***************************************************************
+//! @details:
+//! cuts the glyphs out of a bitmap font image. the glyphs sit side
+//! by side, separated by columns of the color of the first pixel.
+//! the second pixel has the background color, both are made
+//! transparent
+//!
+//! @param[in]: path
+//! the font image
+//!
+//! @param[in]: glyphs
+//! the characters in the order they appear in the image
+//!
+//! @return:
+//! bool - false if the image could not be read or does not hold
+//! as many glyphs as given
+//!
+//!***************************************************************
+bool GlyphAtlas::LoadImageFont(const std::string& path, const std::string& glyphs)
+{
+	MemoryScope memoryScope(MEMORY_GUI);
+
+	Release();
+
+	SDL_RWops* file = OpenFile(path);
+	if (!file)
+	{
+		return false;
+	}
+
+	SDL_Surface* loaded = IMG_Load_RW(file, 1);
+	if (!loaded)
+	{
+		std::cerr << path << ": " << IMG_GetError() << std::endl;
+		return false;
+	}
+
+	SDL_Surface* sheet = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+	SDL_FreeSurface(loaded);
+	if (!sheet || sheet->w < 2)
+	{
+		std::cerr << path << ": " << SDL_GetError() << std::endl;
+		if (sheet)
+		{
+			SDL_FreeSurface(sheet);
+		}
+		return false;
+	}
+
+	const Uint32* top = static_cast<const Uint32*>(sheet->pixels);
+	Uint32 separator = top[0];
+	Uint32 background = top[1];
+
+	std::vector<Pending> pending;
+	int x = 0;
+
+	for (std::string::const_iterator it = glyphs.begin(); it != glyphs.end(); ++it)
+	{
+		while (x < sheet->w && top[x] == separator)
+		{
+			++x;
+		}
+
+		int width = 0;
+		while (x + width < sheet->w && top[x + width] != separator)
+		{
+			++width;
+		}
+
+		if (width == 0)
+		{
+			break;
+		}
+
+		Pending glyph;
+		glyph.code = static_cast<unsigned char>(*it);
+		glyph.surface = sheet;
+		glyph.advance = width;
+
+		SDL_Rect area = { x, 0, width, sheet->h };
+		glyph.area = area;
+
+		pending.push_back(glyph);
+		x += width;
+	}
+
+	bool packed = false;
+
+	if (pending.size() == glyphs.size())
+	{
+		for (int y = 0; y < sheet->h; ++y)
+		{
+			Uint32* row = reinterpret_cast<Uint32*>(static_cast<Uint8*>(sheet->pixels) + y * sheet->pitch);
+			for (int column = 0; column < sheet->w; ++column)
+			{
+				if (row[column] == separator || row[column] == background)
+				{
+					row[column] = 0;
+				}
+			}
+		}
+
+		m_lineHeight = sheet->h;
+		packed = Pack(path, pending);
+	}
+	else
+	{
+		std::cerr << path << ": found " << pending.size() << " glyphs, expected " << glyphs.size() << std::endl;
+	}
+
+	SDL_FreeSurface(sheet);
+
+	return packed;
+}
+
+//!***************************************************************
+//! @details:
+//! glyph of a character, characters the font does not have get
+//! the glyph of a question mark
+//!
+//! @param[in]: c
+//! the character
+//!
+//! @return:
+//! const Glyph&
+//!
+//!***************************************************************
+const Glyph& GlyphAtlas::Find(char c) const
+{
+	const Glyph& glyph = m_glyphs[static_cast<unsigned char>(c)];
+	return (glyph.advance > 0) ? glyph : m_missing;
+}
+
+//!***************************************************************
+//! @details:
+//! checks if a font has been loaded
+//!
+//! @return:
+//! bool
+//!
+//!***************************************************************
+bool GlyphAtlas::IsLoaded() const
+{
+	return m_texture.get() != 0;
+}
+
+//!***************************************************************
+//! @details:
+//! distance between two lines of text in pixels
+//!
+//! @return:
+//! int
+//!
+//!***************************************************************
+int GlyphAtlas::GetLineHeight() const
+{
+	return m_lineHeight;
+}
+
+//!***************************************************************
+//! @details:
+//! number of characters the font has glyphs for
+//!
+//! @return:
+//! int
+//!
+//!***************************************************************
+int GlyphAtlas::GetGlyphCount() const
+{
+	return m_glyphCount;
+}
+
+//!***************************************************************
+//! @details:
+//! width of the atlas texture in pixels
+//!
+//! @return:
+//! int
+//!
+//!***************************************************************
+int GlyphAtlas::GetWidth() const
+{
+	return m_width;
+}
+
+//!***************************************************************
+//! @details:
+//! height of the atlas texture in pixels
+//!
+//! @return:
+//! int
+//!
+//!***************************************************************
+int GlyphAtlas::GetHeight() const
+{
+	return m_height;
+}
+
+//!***************************************************************
+//! @details:
+//! opens a font file from the asset pack, or from the loose
+//! files when it is not packed
+//!
+//! @param[in]: path
+//! the font file
+//!
+//! @return:
+//! SDL_RWops* - 0 if the file could not be opened
+//!
+//!***************************************************************
+SDL_RWops* GlyphAtlas::OpenFile(const std::string& path) const
+{
+	const unsigned char* data = 0;
+	size_t size = 0;
+
+	SDL_RWops* file = 0;
+	if (m_assetPack && m_assetPack->Find(path, data, size))
+	{
+		file = SDL_RWFromConstMem(data, static_cast<int>(size));
+	}
+	else
+	{
+		file = SDL_RWFromFile(path.c_str(), "rb");
+	}
+
+	if (!file)
+	{
+		std::cerr << path << ": " << SDL_GetError() << std::endl;
+	}
+
+	return file;
+}
+
+//!***************************************************************
+//! @details:
+//! copies the rasterized glyphs into one texture, row by row, and
+//! makes every glyph an image sharing that texture
+//!
+//! @param[in]: name
+//! the font file, for error messages
+//!
+//! @param[in]: pending
+//! the rasterized glyphs, their surfaces stay with the caller
+//!
+//! @return:
+//! bool - false if the texture could not be created
+//!
+//!***************************************************************
+bool GlyphAtlas::Pack(const std::string& name, std::vector<Pending>& pending)
+{
+	std::vector<SDL_Rect> targets(pending.size());
+
+	int x = 0;
+	int y = 0;
+	int rowHeight = 0;
+	int width = 0;
+
+	for (size_t i = 0; i < pending.size(); ++i)
+	{
+		const SDL_Rect& area = pending[i].area;
+
+		if (x > 0 && x + area.w > AtlasWidth)
+		{
+			x = 0;
+			y += rowHeight + GlyphPadding;
+			rowHeight = 0;
+		}
+
+		SDL_Rect target = { x, y, area.w, area.h };
+		targets[i] = target;
+
+		x += area.w + GlyphPadding;
+		rowHeight = std::max(rowHeight, static_cast<int>(area.h));
+		width = std::max(width, x);
+	}
+
+	int height = y + rowHeight;
+	if (width == 0 || height == 0)
+	{
+		std::cerr << name << ": no glyphs to draw" << std::endl;
+		return false;
+	}
+
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+	if (!surface)
+	{
+		std::cerr << name << ": " << SDL_GetError() << std::endl;
+		return false;
+	}
+	SDL_FillRect(surface, 0, SDL_MapRGBA(surface->format, 0, 0, 0, 0));
+
+	for (size_t i = 0; i < pending.size(); ++i)
+	{
+		if (pending[i].surface && pending[i].area.w > 0)
+		{
+			// copy the glyph's alpha as it is
+			SDL_SetSurfaceBlendMode(pending[i].surface, SDL_BLENDMODE_NONE);
+			SDL_BlitSurface(pending[i].surface, &pending[i].area, surface, &targets[i]);
+		}
+	}
+
+	// the image takes ownership of the surface
+	m_texture = m_imageManager->loadBlank(width, height);
+	m_texture->setSurface(surface);
+	m_texture->forceLoadInternal();
+
+	for (size_t i = 0; i < pending.size(); ++i)
+	{
+		Glyph& glyph = m_glyphs[pending[i].code];
+		glyph.width = targets[i].w;
+		glyph.height = targets[i].h;
+		glyph.advance = pending[i].advance;
+
+		if (glyph.width > 0 && glyph.height > 0)
+		{
+			glyph.image = m_imageManager->create();
+			glyph.image->useSharedImage(m_texture, FIFE::Rect(targets[i].x, targets[i].y, targets[i].w, targets[i].h));
+		}
+
+		if (glyph.advance > 0)
+		{
+			++m_glyphCount;
+		}
+	}
+
+	m_missing = m_glyphs[static_cast<unsigned char>(MissingGlyph)];
+	if (m_missing.advance <= 0)
+	{
+		m_missing.advance = std::max(1, m_lineHeight / 2);
+	}
+
+	m_width = width;
+	m_height = height;
+
+	return true;
+}
+
+//!***************************************************************
+//! @details:
+//! frees the atlas texture and the glyph images
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void GlyphAtlas::Release()
+{
+	for (int i = 0; i < 256; ++i)
+	{
+		if (m_glyphs[i].image.get())
+		{
+			m_imageManager->remove(m_glyphs[i].image);
+		}
+		m_glyphs[i] = Glyph();
+	}
+	m_missing = Glyph();
+
+	if (m_texture.get())
+	{
+		m_imageManager->remove(m_texture);
+		m_texture.reset();
+	}
+
+	m_lineHeight = 0;
+	m_glyphCount = 0;
+	m_width = 0;
+	m_height = 0;
+}
@@ -0,0 +1,82 @@
+//*****************************************************************************
+// FILE NAME:  GlyphAtlas.h
+//
+//*****************************************************************************
+#ifndef GLYPH_ATLAS_H_
+#define GLYPH_ATLAS_H_
+
+#include <string>
+#include <vector>
+
+#include "SDL.h"
+
+#include "video/image.h"
+
+namespace FIFE
+{
+	class ImageManager;
+}
+
+namespace AssetPack
+{
+	class Reader;
+}
+
+//! one glyph of the atlas, the image is a part of the atlas texture
+struct Glyph
+{
+	Glyph();
+
+	FIFE::ImagePtr image;
+	int width;
+	int height;
+	int advance;
+};
+
+//! the glyphs of one font rasterized once into a single texture. every
+//! glyph is an image sharing that texture, so text drawn from it needs
+//! no rasterizing and the OpenGL backend batches it into one draw call
+class GlyphAtlas
+{
+public:
+	GlyphAtlas(FIFE::ImageManager* imageManager, const AssetPack::Reader* assetPack = 0);
+	~GlyphAtlas();
+
+	bool LoadTrueType(const std::string& path, int size);
+	bool LoadImageFont(const std::string& path, const std::string& glyphs);
+
+	const Glyph& Find(char c) const;
+	bool IsLoaded() const;
+	int GetLineHeight() const;
+	int GetGlyphCount() const;
+	int GetWidth() const;
+	int GetHeight() const;
+private:
+	//! a rasterized glyph waiting to be packed into the atlas
+	struct Pending
+	{
+		unsigned char code;
+		SDL_Surface* surface;
+		SDL_Rect area;
+		int advance;
+	};
+
+	GlyphAtlas(const GlyphAtlas&);
+	GlyphAtlas& operator=(const GlyphAtlas&);
+
+	SDL_RWops* OpenFile(const std::string& path) const;
+	bool Pack(const std::string& name, std::vector<Pending>& pending);
+	void Release();
+private:
+	FIFE::ImageManager* m_imageManager;
+	const AssetPack::Reader* m_assetPack;
+	FIFE::ImagePtr m_texture;
+	Glyph m_glyphs[256];
+	Glyph m_missing;
+	int m_lineHeight;
+	int m_glyphCount;
+	int m_width;
+	int m_height;
+};
+
+#endif
@@ -0,0 +1,484 @@
+//*****************************************************************************
+// FILE NAME:  HudText.cpp
+//
+//*****************************************************************************
+#include "HudText.h"
+#include "GlyphAtlas.h"
+
+// fife includes
+#include "model/structures/layer.h"
+#include "model/structures/map.h"
+#include "video/renderbackend.h"
+#include "view/camera.h"
+
+// standard includes
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	// draws after every other renderer on the top layer
+	const int PipelinePosition = 2000;
+
+	// distance of the text from the top left corner of the view
+	const int Margin = 6;
+
+	// pixels between a counter's label and its value
+	const int ValueGap = 8;
+
+	// digits after the decimal point a counter can show
+	const int MaxDecimals = 6;
+
+	// digits of the longest number, larger values are clamped. doubles
+	// hold whole numbers of up to 15 digits exactly
+	const int MaxDigits = 15;
+
+	//!***************************************************************
+	//! @details:
+	//! writes a number with a fixed count of decimals, without the
+	//! stream and the strings that formatting it every frame would
+	//! otherwise allocate
+	//!
+	//! @param[in]: value
+	//! the number
+	//!
+	//! @param[in]: decimals
+	//! digits after the decimal point
+	//!
+	//! @param[in]: buffer
+	//! receives the text, room for MaxDigits + 3 characters
+	//!
+	//! @return:
+	//! void
+	//!
+	//!***************************************************************
+	void FormatNumber(double value, int decimals, char* buffer)
+	{
+		decimals = std::max(0, std::min(decimals, MaxDecimals));
+
+		double scaled = std::floor(std::fabs(value) * std::pow(10.0, decimals) + 0.5);
+		scaled = std::min(scaled, std::pow(10.0, MaxDigits) - 1.0);
+
+		// values that round to zero get no sign
+		bool negative = value < 0.0 && scaled > 0.0;
+
+		// digits from the last one backwards
+		char digits[MaxDigits + 1];
+		int count = 0;
+		do
+		{
+			double rest = std::floor(scaled / 10.0);
+			digits[count++] = static_cast<char>('0' + static_cast<int>(scaled - rest * 10.0));
+			scaled = rest;
+		}
+		while ((scaled > 0.0 || count <= decimals) && count < MaxDigits);
+
+		char* out = buffer;
+		if (negative)
+		{
+			*out++ = '-';
+		}
+
+		while (count > 0)
+		{
+			if (count == decimals)
+			{
+				*out++ = '.';
+			}
+			*out++ = digits[--count];
+		}
+		*out = '\0';
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! constructor, the text belongs to the camera it is added to
+//!
+//! @param[in]: renderBackend
+//! backend the glyphs are drawn with
+//!
+//! @param[in]: atlas
+//! glyphs the text is drawn from, has to outlive the text
+//!
+//!***************************************************************
+HudText::HudText(FIFE::RenderBackend* renderBackend, const GlyphAtlas* atlas)
+: FIFE::RendererBase(renderBackend, PipelinePosition), m_atlas(atlas), m_valueColumn(0),
+  m_batched(renderBackend->getName() == "OpenGL"), m_textUpdates(0), m_quadUpdates(0), m_renderStats(0)
+{
+	assert(m_atlas);
+
+	setEnabled(true);
+}
+
+//!***************************************************************
+//! @details:
+//! destructor
+//!
+//!***************************************************************
+HudText::~HudText()
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! draws the text once per frame, after the map's top layer
+//!
+//! @param[in]: map
+//! map shown by the camera the text was added to
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void HudText::Attach(FIFE::Map* map)
+{
+	const std::list<FIFE::Layer*>& layers = map->getLayers();
+	if (!layers.empty())
+	{
+		addActiveLayer(layers.back());
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! hands the cost of drawing the text to the render statistics
+//!
+//! @param[in]: renderStats
+//! the camera's render statistics, may be 0
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void HudText::SetRenderStats(RenderStats* renderStats)
+{
+	m_renderStats = renderStats;
+}
+
+//!***************************************************************
+//! @details:
+//! adds a line of text
+//!
+//! @param[in]: x
+//! left edge relative to the view
+//!
+//! @param[in]: y
+//! top edge relative to the view
+//!
+//! @param[in]: text
+//! the first text of the run
+//!
+//! @return:
+//! int - id of the run
+//!
+//!***************************************************************
+int HudText::AddRun(int x, int y, const std::string& text)
+{
+	Run run;
+	run.x = x;
+	run.y = y;
+	m_runs.push_back(run);
+
+	int id = static_cast<int>(m_runs.size()) - 1;
+	SetText(id, text.c_str());
+
+	return id;
+}
+
+//!***************************************************************
+//! @details:
+//! adds a labelled value below the previous ones. the values of
+//! all counters line up to the right of the widest label
+//!
+//! @param[in]: label
+//! text in front of the value
+//!
+//! @return:
+//! int - id of the run showing the value
+//!
+//!***************************************************************
+int HudText::AddCounter(const std::string& label)
+{
+	int y = Margin + static_cast<int>(m_valueRuns.size()) * m_atlas->GetLineHeight();
+
+	int labelRun = AddRun(Margin, y, label);
+	m_valueColumn = std::max(m_valueColumn, Margin + GetWidth(m_runs[labelRun]) + ValueGap);
+
+	int valueRun = AddRun(m_valueColumn, y, "");
+	m_valueRuns.push_back(valueRun);
+
+	// moving a run leaves its quads as they are
+	for (std::vector<int>::const_iterator it = m_valueRuns.begin(); it != m_valueRuns.end(); ++it)
+	{
+		m_runs[*it].x = m_valueColumn;
+	}
+
+	return valueRun;
+}
+
+//!***************************************************************
+//! @details:
+//! changes the text of a run. the characters in front of the
+//! first change keep their quads, after it only the quads whose
+//! glyph or place changed are set again
+//!
+//! @param[in]: run
+//! id of the run
+//!
+//! @param[in]: text
+//! the new text
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void HudText::SetText(int run, const char* text)
+{
+	assert(run >= 0 && run < static_cast<int>(m_runs.size()));
+	Run& line = m_runs[run];
+
+	size_t length = std::strlen(text);
+	size_t first = 0;
+	while (first < length && first < line.text.size() && line.text[first] == text[first])
+	{
+		++first;
+	}
+
+	if (first == length && first == line.text.size())
+	{
+		return;
+	}
+
+	++m_textUpdates;
+
+	size_t previousLength = line.quads.size();
+	line.quads.resize(length);
+
+	// a glyph of another width moves the glyphs behind it
+	for (size_t i = first; i < length; ++i)
+	{
+		Quad quad;
+		quad.glyph = &m_atlas->Find(text[i]);
+		quad.x = (i == 0) ? 0 : line.quads[i - 1].x + line.quads[i - 1].glyph->advance;
+
+		if (i < previousLength && line.quads[i].glyph == quad.glyph && line.quads[i].x == quad.x)
+		{
+			continue;
+		}
+
+		line.quads[i] = quad;
+		++m_quadUpdates;
+	}
+
+	line.text.assign(text, length);
+}
+
+//!***************************************************************
+//! @details:
+//! shows a number in a run
+//!
+//! @param[in]: run
+//! id of the run
+//!
+//! @param[in]: value
+//! the number
+//!
+//! @param[in]: decimals
+//! digits after the decimal point
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void HudText::SetValue(int run, double value, int decimals)
+{
+	char buffer[MaxDigits + 3];
+	FormatNumber(value, decimals, buffer);
+
+	SetText(run, buffer);
+}
+
+//!***************************************************************
+//! @details:
+//! removes every run. the quads point into the atlas, so the text
+//! is cleared before the atlas is deleted
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void HudText::Clear()
+{
+	m_runs.clear();
+	m_valueRuns.clear();
+	m_valueColumn = 0;
+}
+
+//!***************************************************************
+//! @details:
+//! number of runs, labels included
+//!
+//! @return:
+//! int
+//!
+//!***************************************************************
+int HudText::GetRunCount() const
+{
+	return static_cast<int>(m_runs.size());
+}
+
+//!***************************************************************
+//! @details:
+//! number of glyph quads of all runs
+//!
+//! @return:
+//! unsigned long
+//!
+//!***************************************************************
+unsigned long HudText::GetQuadCount() const
+{
+	unsigned long count = 0;
+	for (std::vector<Run>::const_iterator it = m_runs.begin(); it != m_runs.end(); ++it)
+	{
+		count += static_cast<unsigned long>(it->quads.size());
+	}
+
+	return count;
+}
+
+//!***************************************************************
+//! @details:
+//! number of times a run got a different text
+//!
+//! @return:
+//! unsigned long
+//!
+//!***************************************************************
+unsigned long HudText::GetTextUpdates() const
+{
+	return m_textUpdates;
+}
+
+//!***************************************************************
+//! @details:
+//! number of glyph quads set again because their text changed
+//!
+//! @return:
+//! unsigned long
+//!
+//!***************************************************************
+unsigned long HudText::GetQuadUpdates() const
+{
+	return m_quadUpdates;
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @return:
+//! FIFE::RendererBase*
+//!
+//!***************************************************************
+FIFE::RendererBase* HudText::clone()
+{
+	return new HudText(m_renderbackend, m_atlas);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, draws every quad from the atlas.
+//! the glyphs share the atlas texture, so the OpenGL backend
+//! draws them all in one batch
+//!
+//! @param[in]: camera
+//! camera that is rendering
+//!
+//! @param[in]: layer
+//! the top layer of the map
+//!
+//! @param[in]: instances
+//! visible instances of the layer, not used
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void HudText::render(FIFE::Camera* camera, FIFE::Layer* layer, FIFE::RenderList& instances)
+{
+	if (!m_atlas->IsLoaded())
+	{
+		return;
+	}
+
+	const FIFE::Rect& viewport = camera->getViewPort();
+	m_counters = RenderCounters();
+
+	for (std::vector<Run>::const_iterator run = m_runs.begin(); run != m_runs.end(); ++run)
+	{
+		for (std::vector<Quad>::const_iterator quad = run->quads.begin(); quad != run->quads.end(); ++quad)
+		{
+			const Glyph& glyph = *quad->glyph;
+			if (!glyph.image.get())
+			{
+				continue;
+			}
+
+			glyph.image->render(FIFE::Rect(viewport.x + run->x + quad->x, viewport.y + run->y, glyph.width, glyph.height));
+			++m_counters.drawn;
+		}
+	}
+
+	if (m_counters.drawn > 0)
+	{
+		m_counters.considered = m_counters.drawn;
+		m_counters.drawCalls = m_batched ? 1 : m_counters.drawn;
+		m_counters.textureBinds = m_batched ? 1 : m_counters.drawn;
+		m_counters.stateSwitches = 1;
+		m_counters.vertices = RenderCounters::VerticesPerQuad * m_counters.drawn;
+	}
+
+	if (m_renderStats)
+	{
+		m_renderStats->Record("HudText", layer, m_counters);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @return:
+//! std::string
+//!
+//!***************************************************************
+std::string HudText::getName()
+{
+	return "HudText";
+}
+
+//!***************************************************************
+//! @details:
+//! width of a run's text in pixels
+//!
+//! @param[in]: run
+//! the run
+//!
+//! @return:
+//! int
+//!
+//!***************************************************************
+int HudText::GetWidth(const Run& run) const
+{
+	if (run.quads.empty())
+	{
+		return 0;
+	}
+
+	const Quad& last = run.quads.back();
+	return last.x + last.glyph->advance;
+}
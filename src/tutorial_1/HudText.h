@@ -0,0 +1,87 @@
+//*****************************************************************************
+// FILE NAME:  HudText.h
+//
+//*****************************************************************************
+#ifndef HUD_TEXT_H_
+#define HUD_TEXT_H_
+
+#include <string>
+#include <vector>
+
+#include "view/rendererbase.h"
+
+#include "RenderStats.h"
+
+namespace FIFE
+{
+	class Camera;
+	class Layer;
+	class Map;
+	class RenderBackend;
+}
+
+class GlyphAtlas;
+struct Glyph;
+
+//! draws text on top of the camera's view from the glyphs of a glyph
+//! atlas. every run of text keeps its laid out glyph quads and a new
+//! text is only laid out from its first changed character on, so a
+//! counter whose last digit ticks over moves a single quad
+class HudText : public FIFE::RendererBase
+{
+public:
+	HudText(FIFE::RenderBackend* renderBackend, const GlyphAtlas* atlas);
+	~HudText();
+
+	void Attach(FIFE::Map* map);
+	void SetRenderStats(RenderStats* renderStats);
+
+	int AddRun(int x, int y, const std::string& text);
+	int AddCounter(const std::string& label);
+	void SetText(int run, const char* text);
+	void SetValue(int run, double value, int decimals = 0);
+	void Clear();
+
+	int GetRunCount() const;
+	unsigned long GetQuadCount() const;
+	unsigned long GetTextUpdates() const;
+	unsigned long GetQuadUpdates() const;
+
+	// overridden from base class
+	virtual FIFE::RendererBase* clone();
+	virtual void render(FIFE::Camera* camera, FIFE::Layer* layer, FIFE::RenderList& instances);
+	virtual std::string getName();
+private:
+	//! a glyph placed at a pen position along its run
+	struct Quad
+	{
+		const Glyph* glyph;
+		int x;
+	};
+
+	//! a line of text and its laid out quads
+	struct Run
+	{
+		int x;
+		int y;
+		std::string text;
+		std::vector<Quad> quads;
+	};
+
+	HudText(const HudText&);
+	HudText& operator=(const HudText&);
+
+	int GetWidth(const Run& run) const;
+private:
+	const GlyphAtlas* m_atlas;
+	std::vector<Run> m_runs;
+	std::vector<int> m_valueRuns;
+	int m_valueColumn;
+	bool m_batched;
+	unsigned long m_textUpdates;
+	unsigned long m_quadUpdates;
+	RenderStats* m_renderStats;
+	RenderCounters m_counters;
+};
+
+#endif
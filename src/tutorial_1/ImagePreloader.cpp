@@ -0,0 +1,541 @@
+//*****************************************************************************
+// FILE NAME:  ImagePreloader.cpp
+//
+//*****************************************************************************
+#include "ImagePreloader.h"
+#include "AssetPackFormat.h"
+#include "MemoryTracker.h"
+
+// fife includes
+#include "video/image.h"
+#include "video/imagemanager.h"
+
+// 3rd party includes
+#include "boost/filesystem.hpp"
+#include "SDL_image.h"
+
+// standard includes
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+	//!***************************************************************
+	//! @details:
+	//! reads the value of an attribute from a line of xml text
+	//!
+	//! @param[in]: line
+	//! text of the element
+	//!
+	//! @param[in]: name
+	//! attribute name including the '=' and opening quote
+	//!
+	//! @param[out]: value
+	//! the attribute value
+	//!
+	//! @return:
+	//! bool - false if the attribute is not present
+	//!
+	//!***************************************************************
+	bool FindAttribute(const std::string& line, const std::string& name, std::string& value)
+	{
+		std::string::size_type start = line.find(name);
+		if (start == std::string::npos)
+		{
+			return false;
+		}
+
+		start += name.size();
+		std::string::size_type end = line.find('"', start);
+		if (end == std::string::npos)
+		{
+			return false;
+		}
+
+		value = line.substr(start, end - start);
+		return true;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: imageManager
+//! the engine's image manager the decoded images are handed to
+//!
+//! @param[in]: workerPool
+//! threads the images are decoded on
+//!
+//! @param[in]: assetPack
+//! optional, files found in the pack are read from it instead
+//! of the disk
+//!
+//! @param[in]: arena
+//! optional, the jobs and paths are allocated from it instead
+//! of the heap, it must outlive the preloader
+//!
+//!***************************************************************
+ImagePreloader::ImagePreloader(FIFE::ImageManager* imageManager, WorkerPool* workerPool, const AssetPack::Reader* assetPack,
+	LoadArena* arena)
+: m_imageManager(imageManager), m_workerPool(workerPool), m_assetPack(assetPack), m_arena(arena),
+  m_jobs(ArenaAllocator<DecodeJob*>(arena)), m_queuedPaths(std::less<ArenaString>(), ArenaAllocator<ArenaString>(arena)),
+  m_pending(0), m_uploaded(0), m_unused(0)
+{
+	assert(m_imageManager && m_workerPool);
+
+	m_mutex = SDL_CreateMutex();
+	m_done = SDL_CreateCond();
+}
+
+//!***************************************************************
+//! @details:
+//! destructor, waits for outstanding decodes and frees surfaces
+//! that were never handed to the engine
+//!
+//!***************************************************************
+ImagePreloader::~ImagePreloader()
+{
+	WaitForJobs();
+
+	ArenaAllocator<DecodeJob> jobAllocator(m_arena);
+	for (JobList::iterator it = m_jobs.begin(); it != m_jobs.end(); ++it)
+	{
+		if ((*it)->surface)
+		{
+			SDL_FreeSurface((*it)->surface);
+		}
+		jobAllocator.destroy(*it);
+		jobAllocator.deallocate(*it, 1);
+	}
+
+	SDL_DestroyCond(m_done);
+	SDL_DestroyMutex(m_mutex);
+}
+
+//!***************************************************************
+//! @details:
+//! queues the images of everything the map imports, only the
+//! import header of the map is scanned, the full document is
+//! parsed by the map loader while the images decode
+//!
+//! directory imports are scanned recursively, file imports only
+//! contribute the images next to them, e.g. their atlas
+//!
+//! @param[in]: mapFile
+//! path of the map
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ImagePreloader::AddMapImports(const std::string& mapFile)
+{
+	std::ifstream file;
+	std::istringstream packed;
+	std::istream* in = &file;
+
+	const unsigned char* data = 0;
+	size_t size = 0;
+	if (m_assetPack && m_assetPack->Find(mapFile, data, size))
+	{
+		// only the text before the first layer holds imports
+		static const char LayerTag[] = "<layer";
+		const char* begin = reinterpret_cast<const char*>(data);
+		const char* end = std::search(begin, begin + size, LayerTag, LayerTag + sizeof(LayerTag) - 1);
+
+		packed.str(std::string(begin, end));
+		in = &packed;
+	}
+	else
+	{
+		file.open(mapFile.c_str());
+	}
+
+	fs::path mapDirectory = fs::path(mapFile).parent_path();
+
+	std::string line;
+	while (std::getline(*in, line))
+	{
+		// imports always come before the first layer
+		if (line.find("<layer") != std::string::npos)
+		{
+			break;
+		}
+
+		if (line.find("<import") == std::string::npos)
+		{
+			continue;
+		}
+
+		std::string value;
+		if (FindAttribute(line, "file=\"", value))
+		{
+			fs::path directory = mapDirectory;
+			std::string dir;
+			if (FindAttribute(line, "dir=\"", dir))
+			{
+				directory /= dir;
+			}
+
+			// the same path the map loader builds for the import
+			AddDirectory((directory / value).parent_path().string(), false);
+		}
+		else if (FindAttribute(line, "dir=\"", value))
+		{
+			AddDirectory((mapDirectory / value).string(), true);
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! queues all png images in a directory for decoding
+//!
+//! @param[in]: directory
+//! the directory to scan
+//!
+//! @param[in]: recursive
+//! true - include sub directories
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ImagePreloader::AddDirectory(const std::string& directory, bool recursive)
+{
+	ArenaAllocator<char> allocator(m_arena);
+	PathList files(allocator);
+
+	if (m_assetPack)
+	{
+		std::vector<std::string> names;
+		m_assetPack->List(directory, recursive, names);
+
+		// keep the directory as given, the image manager names
+		// the images by the path the map loader builds
+		for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+		{
+			fs::path file = fs::path(directory) / *it;
+			if (file.extension() == ".png")
+			{
+				files.push_back(ArenaString(file.string().c_str(), allocator));
+			}
+		}
+	}
+
+	// directories the pack does not have are scanned on disk
+	boost::system::error_code error;
+	if (files.empty() && fs::is_directory(directory, error))
+	{
+		if (recursive)
+		{
+			for (fs::recursive_directory_iterator it(directory, error), end; it != end; it.increment(error))
+			{
+				if (fs::is_regular_file(it->path()) && it->path().extension() == ".png")
+				{
+					files.push_back(ArenaString(it->path().string().c_str(), allocator));
+				}
+			}
+		}
+		else
+		{
+			for (fs::directory_iterator it(directory, error), end; it != end; it.increment(error))
+			{
+				if (fs::is_regular_file(it->path()) && it->path().extension() == ".png")
+				{
+					files.push_back(ArenaString(it->path().string().c_str(), allocator));
+				}
+			}
+		}
+	}
+
+	for (PathList::const_iterator it = files.begin(); it != files.end(); ++it)
+	{
+		Queue(*it);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! queues one image unless it is queued already, the same image
+//! can be reached through several imports
+//!
+//! @param[in]: path
+//! image file
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ImagePreloader::Queue(const ArenaString& path)
+{
+	std::pair<PathSet::iterator, bool> queued = m_queuedPaths.insert(path);
+	if (!queued.second)
+	{
+		return;
+	}
+
+	// the job points at the path kept in the set
+	ArenaAllocator<DecodeJob> jobAllocator(m_arena);
+	DecodeJob* job = new (jobAllocator.allocate(1)) DecodeJob(this, queued.first->c_str());
+	m_jobs.push_back(job);
+
+	if (m_assetPack)
+	{
+		m_assetPack->Find(queued.first->c_str(), job->data, job->size);
+	}
+
+	SDL_LockMutex(m_mutex);
+	++m_pending;
+	SDL_UnlockMutex(m_mutex);
+
+	m_workerPool->Submit(job);
+}
+
+//!***************************************************************
+//! @details:
+//! called on the worker thread once an image is decoded
+//!
+//! @param[in]: job
+//! the finished job
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ImagePreloader::OnDecoded(DecodeJob* job)
+{
+	SDL_LockMutex(m_mutex);
+	m_decoded.push_back(job);
+	--m_pending;
+	SDL_CondSignal(m_done);
+	SDL_UnlockMutex(m_mutex);
+}
+
+//!***************************************************************
+//! @details:
+//! blocks until all queued images are decoded
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ImagePreloader::WaitForJobs()
+{
+	SDL_LockMutex(m_mutex);
+	while (m_pending > 0)
+	{
+		SDL_CondWait(m_done, m_mutex);
+	}
+	SDL_UnlockMutex(m_mutex);
+}
+
+//!***************************************************************
+//! @details:
+//! hands decoded images to the engine as they become ready, must
+//! be called on the main thread after the map is loaded since the
+//! images are created by the map loader
+//!
+//! @param[in]: batchSize
+//! number of decoded images uploaded per pass
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ImagePreloader::Upload(int batchSize)
+{
+	MemoryScope memoryScope(MEMORY_IMAGES);
+	std::vector<DecodeJob*> batch;
+
+	for (;;)
+	{
+		SDL_LockMutex(m_mutex);
+
+		while (m_decoded.empty() && m_pending > 0)
+		{
+			SDL_CondWait(m_done, m_mutex);
+		}
+
+		// take whatever is ready, up to one batch
+		while (!m_decoded.empty() && static_cast<int>(batch.size()) < batchSize)
+		{
+			batch.push_back(m_decoded.front());
+			m_decoded.pop_front();
+		}
+
+		SDL_UnlockMutex(m_mutex);
+
+		if (batch.empty())
+		{
+			break;
+		}
+
+		for (std::vector<DecodeJob*>::iterator it = batch.begin(); it != batch.end(); ++it)
+		{
+			Apply(*it);
+		}
+
+		batch.clear();
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! hands the images decoded so far to the engine without waiting
+//! for the rest, so the upload can be spread over frames while a
+//! map loads in the background
+//!
+//! @param[in]: maxCount
+//! number of decoded images uploaded at most
+//!
+//! @return: 
+//! bool - true once every queued image has been handled
+//! 
+//!***************************************************************
+bool ImagePreloader::UploadReady(int maxCount)
+{
+	MemoryScope memoryScope(MEMORY_IMAGES);
+	std::vector<DecodeJob*> batch;
+
+	SDL_LockMutex(m_mutex);
+
+	while (!m_decoded.empty() && static_cast<int>(batch.size()) < maxCount)
+	{
+		batch.push_back(m_decoded.front());
+		m_decoded.pop_front();
+	}
+
+	bool finished = m_decoded.empty() && m_pending == 0;
+
+	SDL_UnlockMutex(m_mutex);
+
+	for (std::vector<DecodeJob*>::iterator it = batch.begin(); it != batch.end(); ++it)
+	{
+		Apply(*it);
+	}
+
+	return finished;
+}
+
+//!***************************************************************
+//! @details:
+//! gives a decoded surface to the matching engine image and
+//! creates its texture, images the engine does not know or has
+//! loaded already are dropped
+//!
+//! @param[in]: job
+//! the decoded job
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ImagePreloader::Apply(DecodeJob* job)
+{
+	if (!job->surface)
+	{
+		++m_unused;
+		return;
+	}
+
+	// the image manager names images by the path they were loaded from
+	FIFE::ImagePtr image = m_imageManager->getPtr(job->path);
+
+	if (image.get() && image->getState() != FIFE::IResource::RES_LOADED)
+	{
+		// the image takes ownership of the surface
+		image->setSurface(job->surface);
+		image->setState(FIFE::IResource::RES_LOADED);
+		image->forceLoadInternal();
+		++m_uploaded;
+	}
+	else
+	{
+		SDL_FreeSurface(job->surface);
+		++m_unused;
+	}
+
+	job->surface = 0;
+}
+
+//!***************************************************************
+//! @details:
+//! number of images queued for decoding
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int ImagePreloader::GetQueuedCount() const
+{
+	return static_cast<int>(m_jobs.size());
+}
+
+//!***************************************************************
+//! @details:
+//! number of images handed to the engine
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int ImagePreloader::GetUploadedCount() const
+{
+	return m_uploaded;
+}
+
+//!***************************************************************
+//! @details:
+//! number of decoded images the engine did not need
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int ImagePreloader::GetUnusedCount() const
+{
+	return m_unused;
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//!***************************************************************
+ImagePreloader::DecodeJob::DecodeJob(ImagePreloader* parent, const char* file)
+: owner(parent), path(file), surface(0), data(0), size(0)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! decodes the image, runs on a worker thread. packed images
+//! are decoded straight from the mapped pack
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ImagePreloader::DecodeJob::Run()
+{
+	MemoryScope memoryScope(MEMORY_IMAGES);
+
+	if (data)
+	{
+		surface = IMG_Load_RW(SDL_RWFromConstMem(data, static_cast<int>(size)), 1);
+	}
+	else
+	{
+		surface = IMG_Load(path);
+	}
+
+	owner->OnDecoded(this);
+}
@@ -0,0 +1,91 @@
+//*****************************************************************************
+// FILE NAME:  ImagePreloader.h
+//
+//*****************************************************************************
+#ifndef IMAGE_PRELOADER_H_
+#define IMAGE_PRELOADER_H_
+
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "SDL.h"
+
+#include "LoadArena.h"
+#include "WorkerPool.h"
+
+namespace FIFE
+{
+	class ImageManager;
+}
+
+namespace AssetPack
+{
+	class Reader;
+}
+
+//! decodes the images a map will use on the worker pool while the map
+//! itself is still being loaded, then hands the decoded surfaces to
+//! the engine and uploads them in batches on the main thread
+class ImagePreloader
+{
+public:
+	ImagePreloader(FIFE::ImageManager* imageManager, WorkerPool* workerPool, const AssetPack::Reader* assetPack = 0,
+		LoadArena* arena = 0);
+	~ImagePreloader();
+
+	void AddMapImports(const std::string& mapFile);
+	void AddDirectory(const std::string& directory, bool recursive);
+	void Upload(int batchSize);
+	bool UploadReady(int maxCount);
+
+	int GetQueuedCount() const;
+	int GetUploadedCount() const;
+	int GetUnusedCount() const;
+private:
+	//! decodes one image file on a worker thread
+	class DecodeJob : public WorkerJob
+	{
+	public:
+		DecodeJob(ImagePreloader* parent, const char* file);
+		virtual void Run();
+
+		ImagePreloader* owner;
+		const char* path;
+		SDL_Surface* surface;
+
+		// the image inside the asset pack, 0 if it is a loose file
+		const unsigned char* data;
+		size_t size;
+	};
+
+	typedef std::set<ArenaString, std::less<ArenaString>, ArenaAllocator<ArenaString> > PathSet;
+	typedef std::vector<ArenaString, ArenaAllocator<ArenaString> > PathList;
+	typedef std::vector<DecodeJob*, ArenaAllocator<DecodeJob*> > JobList;
+
+	void Queue(const ArenaString& path);
+	void OnDecoded(DecodeJob* job);
+	void Apply(DecodeJob* job);
+	void WaitForJobs();
+private:
+	FIFE::ImageManager* m_imageManager;
+	WorkerPool* m_workerPool;
+	const AssetPack::Reader* m_assetPack;
+
+	// the jobs and their paths are only needed while the map loads
+	LoadArena* m_arena;
+	JobList m_jobs;
+	PathSet m_queuedPaths;
+
+	// decoded jobs waiting for the main thread, guarded by m_mutex
+	std::deque<DecodeJob*> m_decoded;
+	int m_pending;
+	SDL_mutex* m_mutex;
+	SDL_cond* m_done;
+
+	int m_uploaded;
+	int m_unused;
+};
+
+#endif
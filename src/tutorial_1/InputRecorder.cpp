@@ -0,0 +1,348 @@
+//*****************************************************************************
+// FILE NAME:  InputRecorder.cpp
+//
+//*****************************************************************************
+#include "InputRecorder.h"
+
+// fife includes
+#include "eventchannel/key/keyevent.h"
+#include "eventchannel/mouse/mouseevent.h"
+
+// standard includes
+#include <cassert>
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: keyTarget
+//! listener the key events are handed on to
+//!
+//! @param[in]: mouseTarget
+//! listener the mouse events are handed on to
+//!
+//!***************************************************************
+InputRecorder::InputRecorder(FIFE::IKeyListener* keyTarget, FIFE::IMouseListener* mouseTarget)
+: m_keyTarget(keyTarget), m_mouseTarget(mouseTarget), m_frame(0), m_startTime(0), m_time(0), m_started(false),
+  m_recordedEvents(0)
+{
+	assert(m_keyTarget && m_mouseTarget);
+}
+
+//!***************************************************************
+//! @details:
+//! destructor, the recording is complete once it is closed
+//!
+//!***************************************************************
+InputRecorder::~InputRecorder()
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! creates the recording
+//!
+//! @param[in]: path
+//! file to record to
+//!
+//! @return: 
+//! bool - false if the file could not be created
+//! 
+//!***************************************************************
+bool InputRecorder::Open(const std::string& path)
+{
+	m_out.open(path.c_str(), std::ios::binary | std::ios::trunc);
+	if (!m_out)
+	{
+		return false;
+	}
+
+	InputRecording::Header header;
+	header.magic = InputRecording::Magic;
+	header.version = InputRecording::Version;
+	m_out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	return m_out.good();
+}
+
+//!***************************************************************
+//! @details:
+//! called before the engine processes the input of a frame, the
+//! first frame starts the recording's clock
+//!
+//! @param[in]: time
+//! current engine time in ms
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InputRecorder::BeginFrame(uint32_t time)
+{
+	if (!m_started)
+	{
+		m_startTime = time;
+		m_started = true;
+	}
+	else
+	{
+		++m_frame;
+	}
+
+	m_time = time - m_startTime;
+}
+
+//!***************************************************************
+//! @details:
+//! number of events written so far
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int InputRecorder::GetRecordedEvents() const
+{
+	return m_recordedEvents;
+}
+
+//!***************************************************************
+//! @details:
+//! stamps an event with the current frame and time and writes it
+//!
+//! @param[in]: event
+//! the event to write
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InputRecorder::Record(InputRecording::Event event)
+{
+	event.frame = m_frame;
+	event.time = m_time;
+
+	m_out.write(reinterpret_cast<const char*>(&event), sizeof(event));
+	++m_recordedEvents;
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, records and forwards the event
+//!
+//! @param[in]: evt
+//! the key event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InputRecorder::keyPressed(FIFE::KeyEvent& evt)
+{
+	Record(InputRecording::FromKeyEvent(evt));
+	m_keyTarget->keyPressed(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, records and forwards the event
+//!
+//! @param[in]: evt
+//! the key event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InputRecorder::keyReleased(FIFE::KeyEvent& evt)
+{
+	Record(InputRecording::FromKeyEvent(evt));
+	m_keyTarget->keyReleased(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, records and forwards the event
+//!
+//! @param[in]: evt
+//! the mouse event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InputRecorder::mouseEntered(FIFE::MouseEvent& evt)
+{
+	Record(InputRecording::FromMouseEvent(evt));
+	m_mouseTarget->mouseEntered(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, records and forwards the event
+//!
+//! @param[in]: evt
+//! the mouse event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InputRecorder::mouseExited(FIFE::MouseEvent& evt)
+{
+	Record(InputRecording::FromMouseEvent(evt));
+	m_mouseTarget->mouseExited(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, records and forwards the event
+//!
+//! @param[in]: evt
+//! the mouse event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InputRecorder::mousePressed(FIFE::MouseEvent& evt)
+{
+	Record(InputRecording::FromMouseEvent(evt));
+	m_mouseTarget->mousePressed(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, records and forwards the event
+//!
+//! @param[in]: evt
+//! the mouse event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InputRecorder::mouseReleased(FIFE::MouseEvent& evt)
+{
+	Record(InputRecording::FromMouseEvent(evt));
+	m_mouseTarget->mouseReleased(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, records and forwards the event
+//!
+//! @param[in]: evt
+//! the mouse event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InputRecorder::mouseClicked(FIFE::MouseEvent& evt)
+{
+	Record(InputRecording::FromMouseEvent(evt));
+	m_mouseTarget->mouseClicked(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, records and forwards the event
+//!
+//! @param[in]: evt
+//! the mouse event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InputRecorder::mouseWheelMovedUp(FIFE::MouseEvent& evt)
+{
+	Record(InputRecording::FromMouseEvent(evt));
+	m_mouseTarget->mouseWheelMovedUp(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, records and forwards the event
+//!
+//! @param[in]: evt
+//! the mouse event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InputRecorder::mouseWheelMovedDown(FIFE::MouseEvent& evt)
+{
+	Record(InputRecording::FromMouseEvent(evt));
+	m_mouseTarget->mouseWheelMovedDown(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, records and forwards the event
+//!
+//! @param[in]: evt
+//! the mouse event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InputRecorder::mouseWheelMovedRight(FIFE::MouseEvent& evt)
+{
+	Record(InputRecording::FromMouseEvent(evt));
+	m_mouseTarget->mouseWheelMovedRight(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, records and forwards the event
+//!
+//! @param[in]: evt
+//! the mouse event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InputRecorder::mouseWheelMovedLeft(FIFE::MouseEvent& evt)
+{
+	Record(InputRecording::FromMouseEvent(evt));
+	m_mouseTarget->mouseWheelMovedLeft(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, records and forwards the event
+//!
+//! @param[in]: evt
+//! the mouse event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InputRecorder::mouseMoved(FIFE::MouseEvent& evt)
+{
+	Record(InputRecording::FromMouseEvent(evt));
+	m_mouseTarget->mouseMoved(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, records and forwards the event
+//!
+//! @param[in]: evt
+//! the mouse event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InputRecorder::mouseDragged(FIFE::MouseEvent& evt)
+{
+	Record(InputRecording::FromMouseEvent(evt));
+	m_mouseTarget->mouseDragged(evt);
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+//*****************************************************************************
+// FILE NAME:  InputRecorder.h
+//
+//*****************************************************************************
+#ifndef INPUT_RECORDER_H_
+#define INPUT_RECORDER_H_
+
+#include <fstream>
+#include <string>
+
+#include "eventchannel/key/ikeylistener.h"
+#include "eventchannel/mouse/imouselistener.h"
+#include "util/base/fife_stdint.h"
+
+#include "InputRecording.h"
+
+//! sits between the event manager and the game's listeners, every key
+//! and mouse event is written to a recording with its frame and engine
+//! time and then handed on unchanged
+class InputRecorder : public FIFE::IKeyListener, public FIFE::IMouseListener
+{
+public:
+	InputRecorder(FIFE::IKeyListener* keyTarget, FIFE::IMouseListener* mouseTarget);
+	~InputRecorder();
+
+	bool Open(const std::string& path);
+	void BeginFrame(uint32_t time);
+	int GetRecordedEvents() const;
+
+	// overridden from base class
+	virtual void keyPressed(FIFE::KeyEvent& evt);
+	virtual void keyReleased(FIFE::KeyEvent& evt);
+
+	virtual void mouseEntered(FIFE::MouseEvent& evt);
+	virtual void mouseExited(FIFE::MouseEvent& evt);
+	virtual void mousePressed(FIFE::MouseEvent& evt);
+	virtual void mouseReleased(FIFE::MouseEvent& evt);
+	virtual void mouseClicked(FIFE::MouseEvent& evt);
+	virtual void mouseWheelMovedUp(FIFE::MouseEvent& evt);
+	virtual void mouseWheelMovedDown(FIFE::MouseEvent& evt);
+	virtual void mouseWheelMovedRight(FIFE::MouseEvent& evt);
+	virtual void mouseWheelMovedLeft(FIFE::MouseEvent& evt);
+	virtual void mouseMoved(FIFE::MouseEvent& evt);
+	virtual void mouseDragged(FIFE::MouseEvent& evt);
+private:
+	InputRecorder(const InputRecorder&);
+	InputRecorder& operator=(const InputRecorder&);
+
+	void Record(InputRecording::Event event);
+private:
+	FIFE::IKeyListener* m_keyTarget;
+	FIFE::IMouseListener* m_mouseTarget;
+	std::ofstream m_out;
+	uint32_t m_frame;
+	uint32_t m_startTime;
+	uint32_t m_time;
+	bool m_started;
+	int m_recordedEvents;
+};
+
+#endif
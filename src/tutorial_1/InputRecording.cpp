@@ -0,0 +1,192 @@
+//*****************************************************************************
+// FILE NAME:  InputRecording.cpp
+//
+//*****************************************************************************
+#include "InputRecording.h"
+
+// fife includes
+#include "eventchannel/key/key.h"
+#include "eventchannel/key/keyevent.h"
+#include "eventchannel/mouse/mouseevent.h"
+
+// standard includes
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+	//!***************************************************************
+	//! @details:
+	//! packs the modifier keys held during an event
+	//!
+	//! @param[in]: evt
+	//! key or mouse event
+	//!
+	//! @return:
+	//! uint8_t - InputRecording::Modifier flags
+	//!
+	//!***************************************************************
+	uint8_t GetModifiers(const FIFE::InputEvent& evt)
+	{
+		uint8_t modifiers = 0;
+		modifiers |= evt.isShiftPressed() ? InputRecording::MOD_SHIFT : 0;
+		modifiers |= evt.isControlPressed() ? InputRecording::MOD_CONTROL : 0;
+		modifiers |= evt.isAltPressed() ? InputRecording::MOD_ALT : 0;
+		modifiers |= evt.isMetaPressed() ? InputRecording::MOD_META : 0;
+		return modifiers;
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! restores the modifier keys of an event
+	//!
+	//! @param[in]: modifiers
+	//! InputRecording::Modifier flags
+	//!
+	//! @param[out]: evt
+	//! key or mouse event
+	//!
+	//! @return:
+	//! void
+	//!
+	//!***************************************************************
+	void SetModifiers(uint8_t modifiers, FIFE::InputEvent& evt)
+	{
+		evt.setShiftPressed((modifiers & InputRecording::MOD_SHIFT) != 0);
+		evt.setControlPressed((modifiers & InputRecording::MOD_CONTROL) != 0);
+		evt.setAltPressed((modifiers & InputRecording::MOD_ALT) != 0);
+		evt.setMetaPressed((modifiers & InputRecording::MOD_META) != 0);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! record of a key event, frame and time are filled in by the
+//! recorder
+//!
+//! @param[in]: evt
+//! the key event
+//!
+//! @return:
+//! InputRecording::Event
+//!
+//!***************************************************************
+InputRecording::Event InputRecording::FromKeyEvent(const FIFE::KeyEvent& evt)
+{
+	Event event;
+	std::memset(&event, 0, sizeof(event));
+
+	event.device = DEVICE_KEY;
+	event.type = static_cast<uint8_t>(evt.getType());
+	event.key = static_cast<int32_t>(evt.getKey().getValue());
+	event.modifiers = GetModifiers(evt);
+	event.modifiers |= evt.isNumericPad() ? MOD_NUMERIC_PAD : 0;
+
+	return event;
+}
+
+//!***************************************************************
+//! @details:
+//! record of a mouse event, frame and time are filled in by the
+//! recorder
+//!
+//! @param[in]: evt
+//! the mouse event
+//!
+//! @return:
+//! InputRecording::Event
+//!
+//!***************************************************************
+InputRecording::Event InputRecording::FromMouseEvent(const FIFE::MouseEvent& evt)
+{
+	Event event;
+	std::memset(&event, 0, sizeof(event));
+
+	event.device = DEVICE_MOUSE;
+	event.type = static_cast<uint8_t>(evt.getType());
+	event.button = static_cast<uint8_t>(evt.getButton());
+	event.x = static_cast<int16_t>(evt.getX());
+	event.y = static_cast<int16_t>(evt.getY());
+	event.modifiers = GetModifiers(evt);
+
+	return event;
+}
+
+//!***************************************************************
+//! @details:
+//! rebuilds a recorded key event
+//!
+//! @param[in]: event
+//! the record
+//!
+//! @param[out]: evt
+//! the key event
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void InputRecording::ToKeyEvent(const Event& event, FIFE::KeyEvent& evt)
+{
+	evt.setType(static_cast<FIFE::KeyEvent::KeyEventType>(event.type));
+	evt.setKey(FIFE::Key(static_cast<FIFE::Key::KeyType>(event.key)));
+	evt.setNumericPad((event.modifiers & MOD_NUMERIC_PAD) != 0);
+	SetModifiers(event.modifiers, evt);
+}
+
+//!***************************************************************
+//! @details:
+//! rebuilds a recorded mouse event
+//!
+//! @param[in]: event
+//! the record
+//!
+//! @param[out]: evt
+//! the mouse event
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void InputRecording::ToMouseEvent(const Event& event, FIFE::MouseEvent& evt)
+{
+	evt.setType(static_cast<FIFE::MouseEvent::MouseEventType>(event.type));
+	evt.setButton(static_cast<FIFE::MouseEvent::MouseButtonType>(event.button));
+	evt.setX(event.x);
+	evt.setY(event.y);
+	SetModifiers(event.modifiers, evt);
+}
+
+//!***************************************************************
+//! @details:
+//! reads all events of a recording
+//!
+//! @param[in]: path
+//! the recording
+//!
+//! @param[out]: events
+//! the events in the order they were recorded
+//!
+//! @return:
+//! bool - false if the file is missing or not a recording
+//!
+//!***************************************************************
+bool InputRecording::Load(const std::string& path, std::vector<Event>& events)
+{
+	std::ifstream in(path.c_str(), std::ios::binary);
+
+	Header header;
+	if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != Magic || header.version != Version)
+	{
+		return false;
+	}
+
+	Event event;
+	while (in.read(reinterpret_cast<char*>(&event), sizeof(event)))
+	{
+		events.push_back(event);
+	}
+
+	// a recording cut short keeps its complete events
+	return true;
+}
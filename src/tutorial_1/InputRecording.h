@@ -0,0 +1,77 @@
+//*****************************************************************************
+// FILE NAME:  InputRecording.h
+//
+//*****************************************************************************
+#ifndef INPUT_RECORDING_H_
+#define INPUT_RECORDING_H_
+
+#include "util/base/fife_stdint.h"
+
+#include <string>
+#include <vector>
+
+namespace FIFE
+{
+	class KeyEvent;
+	class MouseEvent;
+}
+
+//! input recording layout, a header followed by one fixed size record
+//! per key or mouse event in the order the events arrived. written in
+//! native byte order
+namespace InputRecording
+{
+	const uint32_t Magic = 0x504e4946; // "FINP"
+	const uint32_t Version = 1;
+
+	enum Device
+	{
+		DEVICE_KEY = 0,
+		DEVICE_MOUSE = 1
+	};
+
+	enum Modifier
+	{
+		MOD_SHIFT = 1,
+		MOD_CONTROL = 2,
+		MOD_ALT = 4,
+		MOD_META = 8,
+		MOD_NUMERIC_PAD = 16
+	};
+
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t version;
+	};
+
+	struct Event
+	{
+		// frame the event arrived in, counted from the first recorded frame
+		uint32_t frame;
+
+		// engine time in ms since the recording started
+		uint32_t time;
+
+		// key value of key events
+		int32_t key;
+
+		// screen position of mouse events
+		int16_t x;
+		int16_t y;
+
+		uint8_t device;
+		uint8_t type;
+		uint8_t button;
+		uint8_t modifiers;
+	};
+
+	Event FromKeyEvent(const FIFE::KeyEvent& evt);
+	Event FromMouseEvent(const FIFE::MouseEvent& evt);
+	void ToKeyEvent(const Event& event, FIFE::KeyEvent& evt);
+	void ToMouseEvent(const Event& event, FIFE::MouseEvent& evt);
+
+	bool Load(const std::string& path, std::vector<Event>& events);
+}
+
+#endif
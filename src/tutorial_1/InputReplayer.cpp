@@ -0,0 +1,240 @@
+//*****************************************************************************
+// FILE NAME:  InputReplayer.cpp
+//
+//*****************************************************************************
+#include "InputReplayer.h"
+
+// fife includes
+#include "eventchannel/key/ikeylistener.h"
+#include "eventchannel/key/keyevent.h"
+#include "eventchannel/mouse/imouselistener.h"
+#include "eventchannel/mouse/mouseevent.h"
+
+// standard includes
+#include <cassert>
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: keyTarget
+//! listener the key events are handed to
+//!
+//! @param[in]: mouseTarget
+//! listener the mouse events are handed to
+//!
+//! @param[in]: realTime
+//! true - replay at the recorded engine times
+//! false - replay in the recorded frames, as fast as possible
+//!
+//!***************************************************************
+InputReplayer::InputReplayer(FIFE::IKeyListener* keyTarget, FIFE::IMouseListener* mouseTarget, bool realTime)
+: m_keyTarget(keyTarget), m_mouseTarget(mouseTarget), m_realTime(realTime), m_next(0), m_frame(0), m_startTime(0),
+  m_started(false)
+{
+	assert(m_keyTarget && m_mouseTarget);
+}
+
+//!***************************************************************
+//! @details:
+//! destructor
+//!
+//!***************************************************************
+InputReplayer::~InputReplayer()
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! reads the recording
+//!
+//! @param[in]: path
+//! recording written by the input recorder
+//!
+//! @return: 
+//! bool - false if the file is missing or not a recording
+//! 
+//!***************************************************************
+bool InputReplayer::Open(const std::string& path)
+{
+	m_events.clear();
+	m_next = 0;
+
+	return InputRecording::Load(path, m_events);
+}
+
+//!***************************************************************
+//! @details:
+//! called before the engine processes the input of a frame, hands
+//! on the events that are due. the first frame starts the clock
+//!
+//! @param[in]: time
+//! current engine time in ms
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InputReplayer::BeginFrame(uint32_t time)
+{
+	if (!m_started)
+	{
+		m_startTime = time;
+		m_started = true;
+	}
+	else
+	{
+		++m_frame;
+	}
+
+	uint32_t elapsed = time - m_startTime;
+
+	while (m_next < m_events.size())
+	{
+		const InputRecording::Event& event = m_events[m_next];
+		if (m_realTime ? event.time > elapsed : event.frame > m_frame)
+		{
+			break;
+		}
+
+		Dispatch(event);
+		++m_next;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! whether every recorded event has been handed on
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+bool InputReplayer::IsFinished() const
+{
+	return m_next >= m_events.size();
+}
+
+//!***************************************************************
+//! @details:
+//! number of events in the recording
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int InputReplayer::GetEventCount() const
+{
+	return static_cast<int>(m_events.size());
+}
+
+//!***************************************************************
+//! @details:
+//! number of frames replayed so far
+//!
+//! @return: 
+//! uint32_t
+//! 
+//!***************************************************************
+uint32_t InputReplayer::GetFrame() const
+{
+	return m_started ? m_frame + 1 : 0;
+}
+
+//!***************************************************************
+//! @details:
+//! hands one recorded event to its listener the way the event
+//! manager would
+//!
+//! @param[in]: event
+//! the recorded event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InputReplayer::Dispatch(const InputRecording::Event& event)
+{
+	if (event.device == InputRecording::DEVICE_KEY)
+	{
+		FIFE::KeyEvent evt;
+		InputRecording::ToKeyEvent(event, evt);
+
+		if (evt.getType() == FIFE::KeyEvent::PRESSED)
+		{
+			m_keyTarget->keyPressed(evt);
+		}
+		else if (evt.getType() == FIFE::KeyEvent::RELEASED)
+		{
+			m_keyTarget->keyReleased(evt);
+		}
+		return;
+	}
+
+	FIFE::MouseEvent evt;
+	InputRecording::ToMouseEvent(event, evt);
+
+	switch (evt.getType())
+	{
+		case FIFE::MouseEvent::MOVED:
+		{
+			m_mouseTarget->mouseMoved(evt);
+			break;
+		}
+		case FIFE::MouseEvent::PRESSED:
+		{
+			m_mouseTarget->mousePressed(evt);
+			break;
+		}
+		case FIFE::MouseEvent::RELEASED:
+		{
+			m_mouseTarget->mouseReleased(evt);
+			break;
+		}
+		case FIFE::MouseEvent::WHEEL_MOVED_DOWN:
+		{
+			m_mouseTarget->mouseWheelMovedDown(evt);
+			break;
+		}
+		case FIFE::MouseEvent::WHEEL_MOVED_UP:
+		{
+			m_mouseTarget->mouseWheelMovedUp(evt);
+			break;
+		}
+		case FIFE::MouseEvent::WHEEL_MOVED_RIGHT:
+		{
+			m_mouseTarget->mouseWheelMovedRight(evt);
+			break;
+		}
+		case FIFE::MouseEvent::WHEEL_MOVED_LEFT:
+		{
+			m_mouseTarget->mouseWheelMovedLeft(evt);
+			break;
+		}
+		case FIFE::MouseEvent::CLICKED:
+		{
+			m_mouseTarget->mouseClicked(evt);
+			break;
+		}
+		case FIFE::MouseEvent::ENTERED:
+		{
+			m_mouseTarget->mouseEntered(evt);
+			break;
+		}
+		case FIFE::MouseEvent::EXITED:
+		{
+			m_mouseTarget->mouseExited(evt);
+			break;
+		}
+		case FIFE::MouseEvent::DRAGGED:
+		{
+			m_mouseTarget->mouseDragged(evt);
+			break;
+		}
+		default:
+		{
+			break;
+		}
+	}
+}
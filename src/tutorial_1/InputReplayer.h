@@ -0,0 +1,50 @@
+//*****************************************************************************
+// FILE NAME:  InputReplayer.h
+//
+//*****************************************************************************
+#ifndef INPUT_REPLAYER_H_
+#define INPUT_REPLAYER_H_
+
+#include <string>
+#include <vector>
+
+#include "util/base/fife_stdint.h"
+
+#include "InputRecording.h"
+
+namespace FIFE
+{
+	class IKeyListener;
+	class IMouseListener;
+}
+
+//! feeds a recording back to the game's listeners in place of the live
+//! input. events are handed on in the frame they were recorded in, so
+//! the run is as fast as the frames can be drawn, or at the engine time
+//! they were recorded at to replay in real time
+class InputReplayer
+{
+public:
+	InputReplayer(FIFE::IKeyListener* keyTarget, FIFE::IMouseListener* mouseTarget, bool realTime);
+	~InputReplayer();
+
+	bool Open(const std::string& path);
+	void BeginFrame(uint32_t time);
+
+	bool IsFinished() const;
+	int GetEventCount() const;
+	uint32_t GetFrame() const;
+private:
+	void Dispatch(const InputRecording::Event& event);
+private:
+	FIFE::IKeyListener* m_keyTarget;
+	FIFE::IMouseListener* m_mouseTarget;
+	bool m_realTime;
+	std::vector<InputRecording::Event> m_events;
+	size_t m_next;
+	uint32_t m_frame;
+	uint32_t m_startTime;
+	bool m_started;
+};
+
+#endif
@@ -0,0 +1,268 @@
+//*****************************************************************************
+// FILE NAME:  InstancePicker.cpp
+//
+//*****************************************************************************
+#include "InstancePicker.h"
+#include "SpatialGrid.h"
+
+// fife includes
+#include "model/metamodel/grids/cellgrid.h"
+#include "model/structures/instance.h"
+#include "model/structures/location.h"
+
+// standard includes
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	// how far from the click an instance may stand, in layer cells
+	const double PickRadius = 1.5;
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: camera
+//! camera the screen coordinates are relative to
+//!
+//!***************************************************************
+InstancePicker::InstancePicker(FIFE::Camera* camera)
+: m_camera(camera)
+{
+	assert(m_camera);
+}
+
+//!***************************************************************
+//! @details:
+//! destructor, stops listening to the layers
+//!
+//!***************************************************************
+InstancePicker::~InstancePicker()
+{
+	for (LayerGrids::iterator it = m_grids.begin(); it != m_grids.end(); ++it)
+	{
+		it->first->removeChangeListener(this);
+		delete it->second;
+	}
+	m_grids.clear();
+}
+
+//!***************************************************************
+//! @details:
+//! indexes the instances of a layer and keeps the index up to
+//! date from then on
+//!
+//! @param[in]: layer
+//! layer to pick instances from
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InstancePicker::AddLayer(FIFE::Layer* layer)
+{
+	if (!layer || m_grids.find(layer) != m_grids.end())
+	{
+		return;
+	}
+
+	SpatialGrid* grid = new SpatialGrid();
+	m_grids.insert(std::make_pair(layer, grid));
+
+	const std::vector<FIFE::Instance*>& instances = layer->getInstances();
+	for (std::vector<FIFE::Instance*>::const_iterator it = instances.begin(); it != instances.end(); ++it)
+	{
+		FIFE::ExactModelCoordinate position = (*it)->getLocationRef().getExactLayerCoordinates();
+		grid->Insert(*it, position.x, position.y);
+	}
+
+	layer->addChangeListener(this);
+}
+
+//!***************************************************************
+//! @details:
+//! finds the instance closest to a screen point
+//!
+//! @param[in]: point
+//! screen position, e.g. of a mouse click
+//!
+//! @param[in]: ignore
+//! instance that is never picked, e.g. the player
+//!
+//! @return: 
+//! FIFE::Instance* - 0 if nothing is close enough
+//! 
+//!***************************************************************
+FIFE::Instance* InstancePicker::PickAt(const FIFE::ScreenPoint& point, FIFE::Instance* ignore)
+{
+	std::vector<FIFE::Instance*> candidates;
+
+	m_transform.Update(m_camera);
+
+	for (LayerGrids::const_iterator it = m_grids.begin(); it != m_grids.end(); ++it)
+	{
+		FIFE::ExactModelCoordinate position = ToLayerCoordinates(it->first, point.x, point.y);
+		it->second->QueryPoint(position.x, position.y, PickRadius, candidates);
+
+		// candidates come closest first
+		for (std::vector<FIFE::Instance*>::const_iterator candidate = candidates.begin(); candidate != candidates.end(); ++candidate)
+		{
+			if (*candidate != ignore)
+			{
+				return *candidate;
+			}
+		}
+	}
+
+	return 0;
+}
+
+//!***************************************************************
+//! @details:
+//! finds the instances standing inside a screen rectangle
+//!
+//! @param[in]: area
+//! screen rectangle, e.g. dragged out with the mouse
+//!
+//! @param[out]: result
+//! receives the instances found, it is cleared first
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InstancePicker::PickRect(const FIFE::Rect& area, std::vector<FIFE::Instance*>& result)
+{
+	result.clear();
+
+	m_transform.Update(m_camera);
+
+	std::vector<FIFE::Instance*> candidates;
+
+	for (LayerGrids::const_iterator it = m_grids.begin(); it != m_grids.end(); ++it)
+	{
+		// the camera is rotated and tilted, so the screen rectangle
+		// is a quad on the layer, query its bounding box
+		FIFE::ExactModelCoordinate corners[4] = {
+			ToLayerCoordinates(it->first, area.x, area.y),
+			ToLayerCoordinates(it->first, area.right(), area.y),
+			ToLayerCoordinates(it->first, area.x, area.bottom()),
+			ToLayerCoordinates(it->first, area.right(), area.bottom())
+		};
+
+		double minX = corners[0].x;
+		double maxX = corners[0].x;
+		double minY = corners[0].y;
+		double maxY = corners[0].y;
+		for (int i = 1; i < 4; ++i)
+		{
+			minX = std::min(minX, corners[i].x);
+			maxX = std::max(maxX, corners[i].x);
+			minY = std::min(minY, corners[i].y);
+			maxY = std::max(maxY, corners[i].y);
+		}
+
+		it->second->QueryRect(minX, minY, maxX, maxY, candidates);
+
+		// keep the ones that are inside the rectangle on screen,
+		// all candidates are projected in one batch
+		m_pointsX.resize(candidates.size());
+		m_pointsY.resize(candidates.size());
+		for (size_t i = 0; i < candidates.size(); ++i)
+		{
+			FIFE::ExactModelCoordinate position = candidates[i]->getLocationRef().getMapCoordinates();
+			m_pointsX[i] = position.x;
+			m_pointsY[i] = position.y;
+		}
+
+		if (!candidates.empty())
+		{
+			m_transform.ToScreen(&m_pointsX[0], &m_pointsY[0], candidates.size(), &m_pointsX[0], &m_pointsY[0]);
+		}
+
+		for (size_t i = 0; i < candidates.size(); ++i)
+		{
+			if (m_pointsX[i] >= area.x && m_pointsX[i] <= area.right() &&
+				m_pointsY[i] >= area.y && m_pointsY[i] <= area.bottom())
+			{
+				result.push_back(candidates[i]);
+			}
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, called once per engine update
+//! with the instances that changed in it
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InstancePicker::onLayerChanged(FIFE::Layer* layer, std::vector<FIFE::Instance*>& changedInstances)
+{
+	LayerGrids::iterator it = m_grids.find(layer);
+	if (it == m_grids.end())
+	{
+		return;
+	}
+
+	for (std::vector<FIFE::Instance*>::const_iterator instance = changedInstances.begin(); instance != changedInstances.end(); ++instance)
+	{
+		FIFE::ExactModelCoordinate position = (*instance)->getLocationRef().getExactLayerCoordinates();
+		it->second->Move(*instance, position.x, position.y);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InstancePicker::onInstanceCreate(FIFE::Layer* layer, FIFE::Instance* instance)
+{
+	LayerGrids::iterator it = m_grids.find(layer);
+	if (it != m_grids.end())
+	{
+		FIFE::ExactModelCoordinate position = instance->getLocationRef().getExactLayerCoordinates();
+		it->second->Insert(instance, position.x, position.y);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void InstancePicker::onInstanceDelete(FIFE::Layer* layer, FIFE::Instance* instance)
+{
+	LayerGrids::iterator it = m_grids.find(layer);
+	if (it != m_grids.end())
+	{
+		it->second->Remove(instance);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! converts a screen position to exact coordinates on a layer
+//!
+//! @return: 
+//! FIFE::ExactModelCoordinate
+//! 
+//!***************************************************************
+FIFE::ExactModelCoordinate InstancePicker::ToLayerCoordinates(FIFE::Layer* layer, int x, int y) const
+{
+	FIFE::ExactModelCoordinate mapCoords = m_transform.ToMap(FIFE::ScreenPoint(x, y));
+
+	return layer->getCellGrid()->toExactLayerCoordinates(mapCoords);
+}
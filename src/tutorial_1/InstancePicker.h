@@ -0,0 +1,52 @@
+//*****************************************************************************
+// FILE NAME:  InstancePicker.h
+//
+//*****************************************************************************
+#ifndef INSTANCE_PICKER_H_
+#define INSTANCE_PICKER_H_
+
+#include <map>
+#include <vector>
+
+#include "model/structures/layer.h"
+#include "util/structures/rect.h"
+#include "view/camera.h"
+
+#include "CameraTransform.h"
+
+class SpatialGrid;
+
+//! finds the instances under a screen point or inside a screen rectangle,
+//! each registered layer is kept in a spatial grid that follows the
+//! instances as they are created, moved and deleted
+class InstancePicker : public FIFE::LayerChangeListener
+{
+public:
+	explicit InstancePicker(FIFE::Camera* camera);
+	~InstancePicker();
+
+	void AddLayer(FIFE::Layer* layer);
+
+	FIFE::Instance* PickAt(const FIFE::ScreenPoint& point, FIFE::Instance* ignore = 0);
+	void PickRect(const FIFE::Rect& area, std::vector<FIFE::Instance*>& result);
+
+	// overridden from base class
+	virtual void onLayerChanged(FIFE::Layer* layer, std::vector<FIFE::Instance*>& changedInstances);
+	virtual void onInstanceCreate(FIFE::Layer* layer, FIFE::Instance* instance);
+	virtual void onInstanceDelete(FIFE::Layer* layer, FIFE::Instance* instance);
+private:
+	InstancePicker(const InstancePicker&);
+	InstancePicker& operator=(const InstancePicker&);
+
+	FIFE::ExactModelCoordinate ToLayerCoordinates(FIFE::Layer* layer, int x, int y) const;
+private:
+	typedef std::map<FIFE::Layer*, SpatialGrid*> LayerGrids;
+
+	FIFE::Camera* m_camera;
+	LayerGrids m_grids;
+	CameraTransform m_transform;
+	std::vector<double> m_pointsX;
+	std::vector<double> m_pointsY;
+};
+
+#endif
@@ -0,0 +1,55 @@
+//*****************************************************************************
+// FILE NAME:  LayerWalkGrid.cpp
+//
+//*****************************************************************************
+#include "LayerWalkGrid.h"
+
+// fife includes
+#include "model/structures/cell.h"
+#include "model/structures/cellcache.h"
+#include "model/structures/layer.h"
+
+//!***************************************************************
+//! @details:
+//! copies the static blockers of a layer's cell cache, moving
+//! instances do not block, the engine steers around them
+//!
+//! @param[in]: layer
+//! walkable layer with a finalized cell cache
+//!
+//! @param[out]: grid
+//! reset to the area of the cell cache
+//!
+//! @return: 
+//! bool - false if the layer has no cell cache
+//! 
+//!***************************************************************
+bool LayerWalkGrid::Build(FIFE::Layer* layer, WalkGrid& grid)
+{
+	FIFE::CellCache* cache = layer ? layer->getCellCache() : 0;
+	if (!cache)
+	{
+		return false;
+	}
+
+	// the cache rectangle starts at the smallest cell of the layer
+	const FIFE::Rect& size = cache->getSize();
+	int width = static_cast<int>(cache->getWidth());
+	int height = static_cast<int>(cache->getHeight());
+	grid.Reset(size.x, size.y, width, height);
+
+	for (int y = size.y; y < size.y + height; ++y)
+	{
+		for (int x = size.x; x < size.x + width; ++x)
+		{
+			FIFE::Cell* cell = cache->getCell(FIFE::ModelCoordinate(x, y));
+			bool blocked = !cell ||
+				cell->getCellType() == FIFE::CTYPE_STATIC_BLOCKER ||
+				cell->getCellType() == FIFE::CTYPE_CELL_BLOCKER;
+
+			grid.SetBlocked(x, y, blocked);
+		}
+	}
+
+	return true;
+}
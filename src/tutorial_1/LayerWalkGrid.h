@@ -0,0 +1,21 @@
+//*****************************************************************************
+// FILE NAME:  LayerWalkGrid.h
+//
+//*****************************************************************************
+#ifndef LAYER_WALK_GRID_H_
+#define LAYER_WALK_GRID_H_
+
+#include "WalkGrid.h"
+
+namespace FIFE
+{
+	class Layer;
+}
+
+//! fills walk grids from the engine's layers
+namespace LayerWalkGrid
+{
+	bool Build(FIFE::Layer* layer, WalkGrid& grid);
+}
+
+#endif
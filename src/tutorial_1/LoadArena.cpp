@@ -0,0 +1,190 @@
+//*****************************************************************************
+// FILE NAME:  LoadArena.cpp
+//
+//*****************************************************************************
+#include "LoadArena.h"
+
+// standard includes
+#include <cassert>
+#include <cstdlib>
+
+namespace
+{
+	// start of a block's memory, aligned for any type
+	const size_t BlockAlignment = 16;
+}
+
+//!***************************************************************
+//! @details:
+//! constructor, no memory is taken until the first allocation
+//!
+//! @param[in]: blockSize
+//! bytes reserved per block, larger allocations get a block
+//! of their own
+//!
+//!***************************************************************
+LoadArena::LoadArena(size_t blockSize)
+: m_blockSize(blockSize), m_blocks(0), m_current(0), m_end(0), m_allocations(0), m_blockCount(0),
+  m_usedBytes(0), m_reservedBytes(0)
+{
+	assert(m_blockSize > 0);
+}
+
+//!***************************************************************
+//! @details:
+//! destructor, frees every block
+//!
+//!***************************************************************
+LoadArena::~LoadArena()
+{
+	Release();
+}
+
+//!***************************************************************
+//! @details:
+//! takes memory from the current block, a new block is started
+//! when it does not fit
+//!
+//! @param[in]: size
+//! bytes needed
+//!
+//! @param[in]: alignment
+//! alignment of the memory, a power of two up to 16
+//!
+//! @return:
+//! void* - never 0, throws std::bad_alloc if no block can be had
+//!
+//!***************************************************************
+void* LoadArena::Allocate(size_t size, size_t alignment)
+{
+	assert(alignment > 0 && alignment <= BlockAlignment && (alignment & (alignment - 1)) == 0);
+
+	size_t padding = static_cast<size_t>(-reinterpret_cast<ptrdiff_t>(m_current)) & (alignment - 1);
+
+	if (!m_current || size + padding > static_cast<size_t>(m_end - m_current))
+	{
+		AddBlock(size);
+		padding = 0;
+	}
+
+	char* memory = m_current + padding;
+	m_current = memory + size;
+
+	++m_allocations;
+	m_usedBytes += size;
+
+	return memory;
+}
+
+//!***************************************************************
+//! @details:
+//! frees every block at once, nothing allocated from the arena
+//! may be used afterwards. the counts start over, so an arena that
+//! is reused for the next load only reports that load
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void LoadArena::Release()
+{
+	while (m_blocks)
+	{
+		Block* next = m_blocks->next;
+		std::free(m_blocks);
+		m_blocks = next;
+	}
+
+	m_current = 0;
+	m_end = 0;
+
+	m_allocations = 0;
+	m_blockCount = 0;
+	m_usedBytes = 0;
+	m_reservedBytes = 0;
+}
+
+//!***************************************************************
+//! @details:
+//! number of allocations served, none of them touched the heap
+//!
+//! @return:
+//! size_t
+//!
+//!***************************************************************
+size_t LoadArena::GetAllocationCount() const
+{
+	return m_allocations;
+}
+
+//!***************************************************************
+//! @details:
+//! number of blocks taken from the heap
+//!
+//! @return:
+//! size_t
+//!
+//!***************************************************************
+size_t LoadArena::GetBlockCount() const
+{
+	return m_blockCount;
+}
+
+//!***************************************************************
+//! @details:
+//! bytes handed out, without alignment padding
+//!
+//! @return:
+//! size_t
+//!
+//!***************************************************************
+size_t LoadArena::GetUsedBytes() const
+{
+	return m_usedBytes;
+}
+
+//!***************************************************************
+//! @details:
+//! bytes of all blocks taken from the heap
+//!
+//! @return:
+//! size_t
+//!
+//!***************************************************************
+size_t LoadArena::GetReservedBytes() const
+{
+	return m_reservedBytes;
+}
+
+//!***************************************************************
+//! @details:
+//! starts a new block, the rest of the current one stays unused
+//!
+//! @param[in]: minimumSize
+//! bytes the new block must hold
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void LoadArena::AddBlock(size_t minimumSize)
+{
+	size_t headerSize = (sizeof(Block) + BlockAlignment - 1) & ~(BlockAlignment - 1);
+	size_t size = minimumSize > m_blockSize ? minimumSize : m_blockSize;
+
+	Block* block = static_cast<Block*>(std::malloc(headerSize + size));
+	if (!block)
+	{
+		throw std::bad_alloc();
+	}
+
+	block->next = m_blocks;
+	block->size = size;
+	m_blocks = block;
+
+	m_current = reinterpret_cast<char*>(block) + headerSize;
+	m_end = m_current + size;
+
+	++m_blockCount;
+	m_reservedBytes += headerSize + size;
+}
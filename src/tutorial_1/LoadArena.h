@@ -0,0 +1,168 @@
+//*****************************************************************************
+// FILE NAME:  LoadArena.h
+//
+//*****************************************************************************
+#ifndef LOAD_ARENA_H_
+#define LOAD_ARENA_H_
+
+#include <cstddef>
+#include <new>
+#include <string>
+
+//! monotonic allocator for data that only lives while a map loads,
+//! blocks are filled front to back and all freed at once when the
+//! arena is released, must only be used from one thread
+class LoadArena
+{
+public:
+	static const size_t DefaultBlockSize = 64 * 1024;
+
+	explicit LoadArena(size_t blockSize = DefaultBlockSize);
+	~LoadArena();
+
+	void* Allocate(size_t size, size_t alignment);
+	void Release();
+
+	size_t GetAllocationCount() const;
+	size_t GetBlockCount() const;
+	size_t GetUsedBytes() const;
+	size_t GetReservedBytes() const;
+private:
+	LoadArena(const LoadArena&);
+	LoadArena& operator=(const LoadArena&);
+
+	//! header in front of the memory of every block
+	struct Block
+	{
+		Block* next;
+		size_t size;
+	};
+
+	void AddBlock(size_t minimumSize);
+private:
+	size_t m_blockSize;
+	Block* m_blocks;
+	char* m_current;
+	char* m_end;
+	size_t m_allocations;
+	size_t m_blockCount;
+	size_t m_usedBytes;
+	size_t m_reservedBytes;
+};
+
+//! standard allocator handing out memory of a load arena, memory is
+//! only given back when the arena is released, without an arena it
+//! uses the global heap
+template <typename T>
+class ArenaAllocator
+{
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+
+	template <typename U>
+	struct rebind
+	{
+		typedef ArenaAllocator<U> other;
+	};
+
+	explicit ArenaAllocator(LoadArena* arena = 0)
+	: m_arena(arena)
+	{
+
+	}
+
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U>& other)
+	: m_arena(other.GetArena())
+	{
+
+	}
+
+	pointer address(reference value) const
+	{
+		return &value;
+	}
+
+	const_pointer address(const_reference value) const
+	{
+		return &value;
+	}
+
+	pointer allocate(size_type count, const void* = 0)
+	{
+		if (m_arena)
+		{
+			return static_cast<pointer>(m_arena->Allocate(count * sizeof(T), AlignmentOf()));
+		}
+
+		return static_cast<pointer>(::operator new(count * sizeof(T)));
+	}
+
+	void deallocate(pointer p, size_type)
+	{
+		// arena memory is freed with the arena
+		if (!m_arena)
+		{
+			::operator delete(p);
+		}
+	}
+
+	size_type max_size() const
+	{
+		return static_cast<size_type>(-1) / sizeof(T);
+	}
+
+	void construct(pointer p, const T& value)
+	{
+		new (static_cast<void*>(p)) T(value);
+	}
+
+	void destroy(pointer p)
+	{
+		p->~T();
+	}
+
+	LoadArena* GetArena() const
+	{
+		return m_arena;
+	}
+
+private:
+	//! the alignment of T, worked out without alignof
+	struct Probe
+	{
+		char offset;
+		T value;
+	};
+
+	static size_t AlignmentOf()
+	{
+		return sizeof(Probe) - sizeof(T);
+	}
+
+private:
+	LoadArena* m_arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+{
+	return lhs.GetArena() == rhs.GetArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+{
+	return lhs.GetArena() != rhs.GetArena();
+}
+
+//! string whose characters live in a load arena
+typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char> > ArenaString;
+
+#endif
@@ -0,0 +1,710 @@
+//*****************************************************************************
+// FILE NAME:  MapCacheFormat.cpp
+//
+//*****************************************************************************
+#include "MapCacheFormat.h"
+
+// standard includes
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+	// every section starts on this boundary so it can be read in place
+	const uint32_t SectionAlignment = 8;
+
+	//!***************************************************************
+	//! @details:
+	//! rounds an offset up to the section alignment
+	//!
+	//! @param[in]: offset
+	//! byte offset
+	//!
+	//! @return:
+	//! uint32_t
+	//!
+	//!***************************************************************
+	uint32_t Align(uint32_t offset)
+	{
+		return (offset + SectionAlignment - 1) & ~(SectionAlignment - 1);
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! orders the instances of a layer: named instances first, they
+	//! are always resident, then the others chunk by chunk
+	//!
+	//!***************************************************************
+	class ChunkOrder
+	{
+	public:
+		explicit ChunkOrder(uint32_t chunkSize)
+		: m_chunkSize(static_cast<double>(chunkSize))
+		{
+
+		}
+
+		int32_t ChunkX(const MapCache::Instance& instance) const
+		{
+			return static_cast<int32_t>(std::floor(instance.x / m_chunkSize));
+		}
+
+		int32_t ChunkY(const MapCache::Instance& instance) const
+		{
+			return static_cast<int32_t>(std::floor(instance.y / m_chunkSize));
+		}
+
+		bool IsResident(const MapCache::Instance& instance) const
+		{
+			return instance.id != MapCache::NoString;
+		}
+
+		bool operator()(const MapCache::Instance& lhs, const MapCache::Instance& rhs) const
+		{
+			if (IsResident(lhs) != IsResident(rhs))
+			{
+				return IsResident(lhs);
+			}
+			if (IsResident(lhs))
+			{
+				return false;
+			}
+			if (ChunkY(lhs) != ChunkY(rhs))
+			{
+				return ChunkY(lhs) < ChunkY(rhs);
+			}
+			return ChunkX(lhs) < ChunkX(rhs);
+		}
+	private:
+		double m_chunkSize;
+	};
+
+	//!***************************************************************
+	//! @details:
+	//! appends raw bytes to the output buffer
+	//!
+	//! @return:
+	//! void
+	//!
+	//!***************************************************************
+	void Append(std::vector<unsigned char>& buffer, const void* data, size_t size)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		buffer.insert(buffer.end(), bytes, bytes + size);
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! pads the output buffer to the next section boundary and
+	//! returns the offset the next section starts at
+	//!
+	//! @return:
+	//! uint32_t
+	//!
+	//!***************************************************************
+	uint32_t BeginSection(std::vector<unsigned char>& buffer)
+	{
+		buffer.resize(Align(static_cast<uint32_t>(buffer.size())), 0);
+		return static_cast<uint32_t>(buffer.size());
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! writes a whole vector of records as one section
+	//!
+	//! @return:
+	//! uint32_t - offset of the section
+	//!
+	//!***************************************************************
+	template<typename T>
+	uint32_t AppendSection(std::vector<unsigned char>& buffer, const std::vector<T>& records)
+	{
+		uint32_t offset = BeginSection(buffer);
+		if (!records.empty())
+		{
+			Append(buffer, &records[0], records.size() * sizeof(T));
+		}
+		return offset;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! 64 bit FNV-1a hash, used to detect a cache that no longer
+//! matches its source map
+//!
+//! @param[in]: data
+//! bytes to hash
+//!
+//! @param[in]: size
+//! number of bytes
+//!
+//! @param[in]: hash
+//! running hash to continue from
+//!
+//! @return: 
+//! uint64_t
+//! 
+//!***************************************************************
+uint64_t MapCache::HashBytes(const void* data, size_t size, uint64_t hash)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+//!***************************************************************
+//! @details:
+//! hashes the contents of a file
+//!
+//! @param[in]: path
+//! the file to hash
+//!
+//! @param[out]: hash
+//! content hash
+//!
+//! @param[out]: size
+//! file size in bytes
+//!
+//! @return: 
+//! bool - false if the file could not be read
+//! 
+//!***************************************************************
+bool MapCache::HashFile(const std::string& path, uint64_t& hash, uint64_t& size)
+{
+	std::ifstream in(path.c_str(), std::ios::binary);
+
+	if (!in)
+	{
+		return false;
+	}
+
+	char buffer[64 * 1024];
+	hash = 14695981039346656037ULL;
+	size = 0;
+
+	while (in)
+	{
+		in.read(buffer, sizeof(buffer));
+		std::streamsize count = in.gcount();
+		hash = HashBytes(buffer, static_cast<size_t>(count), hash);
+		size += static_cast<uint64_t>(count);
+	}
+
+	return in.eof();
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//!***************************************************************
+MapCache::Writer::Writer()
+{
+	std::memset(&m_header, 0, sizeof(m_header));
+	m_header.magic = Magic;
+	m_header.version = Version;
+	m_header.mapId = NoString;
+	m_header.mapFormat = NoString;
+	m_header.chunkSize = DefaultChunkSize;
+}
+
+//!***************************************************************
+//! @details:
+//! interns a string
+//!
+//! @param[in]: value
+//! the string to store
+//!
+//! @return: 
+//! uint32_t - index into the string table
+//! 
+//!***************************************************************
+uint32_t MapCache::Writer::AddString(const std::string& value)
+{
+	std::map<std::string, uint32_t>::const_iterator it = m_stringIndex.find(value);
+	if (it != m_stringIndex.end())
+	{
+		return it->second;
+	}
+
+	uint32_t index = static_cast<uint32_t>(m_strings.size());
+	m_strings.push_back(value);
+	m_stringIndex.insert(std::make_pair(value, index));
+
+	return index;
+}
+
+//!***************************************************************
+//! @details:
+//! interns an object reference
+//!
+//! @param[in]: id
+//! object id
+//!
+//! @param[in]: nameSpace
+//! object namespace
+//!
+//! @return: 
+//! uint32_t - index into the object table
+//! 
+//!***************************************************************
+uint32_t MapCache::Writer::AddObject(const std::string& id, const std::string& nameSpace)
+{
+	Object object;
+	object.id = AddString(id);
+	object.nameSpace = AddString(nameSpace);
+
+	std::pair<uint32_t, uint32_t> key(object.id, object.nameSpace);
+	std::map<std::pair<uint32_t, uint32_t>, uint32_t>::const_iterator it = m_objectIndex.find(key);
+	if (it != m_objectIndex.end())
+	{
+		return it->second;
+	}
+
+	uint32_t index = static_cast<uint32_t>(m_objects.size());
+	m_objects.push_back(object);
+	m_objectIndex.insert(std::make_pair(key, index));
+
+	return index;
+}
+
+//!***************************************************************
+//! @details:
+//! stores the map attributes
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapCache::Writer::SetMap(const std::string& id, const std::string& format)
+{
+	m_header.mapId = AddString(id);
+	m_header.mapFormat = AddString(format);
+}
+
+//!***************************************************************
+//! @details:
+//! stores the hash and size of the map file the cache was built from
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapCache::Writer::SetSource(uint64_t hash, uint64_t size)
+{
+	m_header.sourceHash = hash;
+	m_header.sourceSize = size;
+}
+
+//!***************************************************************
+//! @details:
+//! adds an object import, imports are replayed in order
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapCache::Writer::AddImport(const Import& import)
+{
+	m_imports.push_back(import);
+}
+
+//!***************************************************************
+//! @details:
+//! starts a new layer, the following instances belong to it
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapCache::Writer::BeginLayer(const Layer& layer)
+{
+	m_layers.push_back(layer);
+	m_layers.back().firstInstance = static_cast<uint32_t>(m_instances.size());
+	m_layers.back().instanceCount = 0;
+}
+
+//!***************************************************************
+//! @details:
+//! adds an instance to the current layer, it remembers its place
+//! in the layer before the layer is sorted into chunks
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapCache::Writer::AddInstance(const Instance& instance)
+{
+	m_instances.push_back(instance);
+	m_instances.back().sourceIndex = m_layers.back().instanceCount;
+	++m_layers.back().instanceCount;
+}
+
+//!***************************************************************
+//! @details:
+//! finishes the current layer, sorts its instances so that every
+//! chunk is one contiguous range and builds the chunk table, the
+//! sort is stable so instances keep their order within a chunk.
+//! the order of the xml stays in the instances' source index
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapCache::Writer::EndLayer()
+{
+	Layer& layer = m_layers.back();
+	ChunkOrder order(m_header.chunkSize);
+
+	std::vector<Instance>::iterator begin = m_instances.begin() + layer.firstInstance;
+	std::vector<Instance>::iterator end = begin + layer.instanceCount;
+	std::stable_sort(begin, end, order);
+
+	layer.residentCount = 0;
+	layer.firstChunk = static_cast<uint32_t>(m_chunks.size());
+	layer.chunkCount = 0;
+
+	for (uint32_t i = layer.firstInstance; i < layer.firstInstance + layer.instanceCount; ++i)
+	{
+		const Instance& instance = m_instances[i];
+
+		if (order.IsResident(instance))
+		{
+			++layer.residentCount;
+			continue;
+		}
+
+		int32_t x = order.ChunkX(instance);
+		int32_t y = order.ChunkY(instance);
+
+		if (layer.chunkCount == 0 || m_chunks.back().x != x || m_chunks.back().y != y)
+		{
+			Chunk chunk;
+			chunk.x = x;
+			chunk.y = y;
+			chunk.firstInstance = i;
+			chunk.instanceCount = 0;
+			m_chunks.push_back(chunk);
+			++layer.chunkCount;
+		}
+
+		++m_chunks.back().instanceCount;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! adds a camera
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapCache::Writer::AddCamera(const Camera& camera)
+{
+	m_cameras.push_back(camera);
+}
+
+//!***************************************************************
+//! @details:
+//! number of distinct objects referenced by the instances
+//!
+//! @return: 
+//! uint32_t
+//! 
+//!***************************************************************
+uint32_t MapCache::Writer::GetObjectCount() const
+{
+	return static_cast<uint32_t>(m_objects.size());
+}
+
+//!***************************************************************
+//! @details:
+//! number of instances over all layers
+//!
+//! @return: 
+//! uint32_t
+//! 
+//!***************************************************************
+uint32_t MapCache::Writer::GetInstanceCount() const
+{
+	return static_cast<uint32_t>(m_instances.size());
+}
+
+//!***************************************************************
+//! @details:
+//! lays out all sections and writes the cache file
+//!
+//! @param[in]: path
+//! the cache file to write
+//!
+//! @return: 
+//! bool - false if the file could not be written
+//! 
+//!***************************************************************
+bool MapCache::Writer::Write(const std::string& path) const
+{
+	Header header = m_header;
+	std::vector<unsigned char> buffer;
+
+	// the header is patched in once all offsets are known
+	buffer.resize(sizeof(Header), 0);
+
+	// string offsets followed by the null terminated string bytes
+	std::vector<uint32_t> stringOffsets;
+	std::vector<unsigned char> stringData;
+	for (std::vector<std::string>::const_iterator it = m_strings.begin(); it != m_strings.end(); ++it)
+	{
+		stringOffsets.push_back(static_cast<uint32_t>(stringData.size()));
+		Append(stringData, it->c_str(), it->size() + 1);
+	}
+
+	header.stringCount = static_cast<uint32_t>(m_strings.size());
+	header.stringOffsetTable = AppendSection(buffer, stringOffsets);
+	header.stringData = AppendSection(buffer, stringData);
+	header.stringDataSize = static_cast<uint32_t>(stringData.size());
+
+	header.importCount = static_cast<uint32_t>(m_imports.size());
+	header.imports = AppendSection(buffer, m_imports);
+	header.objectCount = static_cast<uint32_t>(m_objects.size());
+	header.objects = AppendSection(buffer, m_objects);
+	header.layerCount = static_cast<uint32_t>(m_layers.size());
+	header.layers = AppendSection(buffer, m_layers);
+	header.instanceCount = static_cast<uint32_t>(m_instances.size());
+	header.instances = AppendSection(buffer, m_instances);
+	header.cameraCount = static_cast<uint32_t>(m_cameras.size());
+	header.cameras = AppendSection(buffer, m_cameras);
+	header.chunkCount = static_cast<uint32_t>(m_chunks.size());
+	header.chunks = AppendSection(buffer, m_chunks);
+
+	std::memcpy(&buffer[0], &header, sizeof(Header));
+
+	std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+	if (!out)
+	{
+		return false;
+	}
+
+	out.write(reinterpret_cast<const char*>(&buffer[0]), buffer.size());
+	return out.good();
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//!***************************************************************
+MapCache::Reader::Reader()
+: m_data(0), m_size(0), m_header(0), m_stringOffsets(0), m_stringData(0)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! checks the header and that every section lies inside the data,
+//! the data must stay valid for as long as the reader is used
+//!
+//! @param[in]: data
+//! start of the cache, aligned at least to 8 bytes
+//!
+//! @param[in]: size
+//! size of the cache in bytes
+//!
+//! @return: 
+//! bool - false if the data is not a valid cache of this version
+//! 
+//!***************************************************************
+bool MapCache::Reader::Open(const unsigned char* data, size_t size)
+{
+	m_data = data;
+	m_size = size;
+	m_header = 0;
+
+	if (!data || size < sizeof(Header))
+	{
+		return false;
+	}
+
+	const Header* header = reinterpret_cast<const Header*>(data);
+	if (header->magic != Magic || header->version != Version)
+	{
+		return false;
+	}
+
+	m_header = header;
+
+	if (!CheckSection(header->stringOffsetTable, header->stringCount, sizeof(uint32_t)) ||
+		!CheckSection(header->stringData, header->stringDataSize, 1) ||
+		!CheckSection(header->imports, header->importCount, sizeof(Import)) ||
+		!CheckSection(header->objects, header->objectCount, sizeof(Object)) ||
+		!CheckSection(header->layers, header->layerCount, sizeof(Layer)) ||
+		!CheckSection(header->instances, header->instanceCount, sizeof(Instance)) ||
+		!CheckSection(header->cameras, header->cameraCount, sizeof(Camera)) ||
+		!CheckSection(header->chunks, header->chunkCount, sizeof(Chunk)) ||
+		header->chunkSize == 0)
+	{
+		m_header = 0;
+		return false;
+	}
+
+	m_stringOffsets = reinterpret_cast<const uint32_t*>(data + header->stringOffsetTable);
+	m_stringData = reinterpret_cast<const char*>(data + header->stringData);
+
+	// strings must be terminated inside the string data
+	if (header->stringDataSize > 0 && m_stringData[header->stringDataSize - 1] != '\0')
+	{
+		m_header = 0;
+		return false;
+	}
+
+	for (uint32_t i = 0; i < header->stringCount; ++i)
+	{
+		if (m_stringOffsets[i] >= header->stringDataSize)
+		{
+			m_header = 0;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//!***************************************************************
+//! @details:
+//! tests whether a section of records fits into the data
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+bool MapCache::Reader::CheckSection(uint32_t offset, uint32_t count, size_t elementSize) const
+{
+	if (offset % SectionAlignment != 0 || offset > m_size)
+	{
+		return false;
+	}
+
+	return static_cast<uint64_t>(count) * elementSize <= m_size - offset;
+}
+
+//!***************************************************************
+//! @details:
+//! accessor for the header
+//!
+//! @return: 
+//! const Header&
+//! 
+//!***************************************************************
+const MapCache::Header& MapCache::Reader::GetHeader() const
+{
+	return *m_header;
+}
+
+//!***************************************************************
+//! @details:
+//! resolves a string index
+//!
+//! @param[in]: index
+//! index into the string table or NoString
+//!
+//! @return: 
+//! const char* - empty string for NoString or bad indices
+//! 
+//!***************************************************************
+const char* MapCache::Reader::GetString(uint32_t index) const
+{
+	if (index >= m_header->stringCount)
+	{
+		return "";
+	}
+
+	return m_stringData + m_stringOffsets[index];
+}
+
+//!***************************************************************
+//! @details:
+//! the import table, importCount entries, the count is in the header
+//!
+//! @return: 
+//! const MapCache::Import*
+//! 
+//!***************************************************************
+const MapCache::Import* MapCache::Reader::GetImports() const
+{
+	return reinterpret_cast<const Import*>(m_data + m_header->imports);
+}
+
+//!***************************************************************
+//! @details:
+//! the interned object table, objectCount entries, the count is in the header
+//!
+//! @return: 
+//! const MapCache::Object*
+//! 
+//!***************************************************************
+const MapCache::Object* MapCache::Reader::GetObjects() const
+{
+	return reinterpret_cast<const Object*>(m_data + m_header->objects);
+}
+
+//!***************************************************************
+//! @details:
+//! the layer table, layerCount entries, the count is in the header
+//!
+//! @return: 
+//! const MapCache::Layer*
+//! 
+//!***************************************************************
+const MapCache::Layer* MapCache::Reader::GetLayers() const
+{
+	return reinterpret_cast<const Layer*>(m_data + m_header->layers);
+}
+
+//!***************************************************************
+//! @details:
+//! the instance table of all layers, instanceCount entries, the count is in the header
+//!
+//! @return: 
+//! const MapCache::Instance*
+//! 
+//!***************************************************************
+const MapCache::Instance* MapCache::Reader::GetInstances() const
+{
+	return reinterpret_cast<const Instance*>(m_data + m_header->instances);
+}
+
+//!***************************************************************
+//! @details:
+//! the camera table, cameraCount entries, the count is in the header
+//!
+//! @return: 
+//! const MapCache::Camera*
+//! 
+//!***************************************************************
+const MapCache::Camera* MapCache::Reader::GetCameras() const
+{
+	return reinterpret_cast<const Camera*>(m_data + m_header->cameras);
+}
+
+//!***************************************************************
+//! @details:
+//! the chunk table of all layers, chunkCount entries, the count is in the header
+//!
+//! @return: 
+//! const MapCache::Chunk*
+//! 
+//!***************************************************************
+const MapCache::Chunk* MapCache::Reader::GetChunks() const
+{
+	return reinterpret_cast<const Chunk*>(m_data + m_header->chunks);
+}
@@ -0,0 +1,225 @@
+//*****************************************************************************
+// FILE NAME:  MapCacheFormat.h
+//
+//*****************************************************************************
+#ifndef MAP_CACHE_FORMAT_H_
+#define MAP_CACHE_FORMAT_H_
+
+// this file is shared with the offline map compiler and must not
+// depend on the engine
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+//! binary map cache layout, the cache is written in native byte order
+//! by the map compiler and read in place from a memory mapping
+//!
+//! every string (object ids, namespaces, layer ids, ...) is stored once
+//! in a string table and referenced by index, instances reference an
+//! interned object table so each object is looked up only once
+//!
+//! the instances of a layer start with the named ones, the rest is
+//! grouped into square chunks of the layer grid so a chunk is one
+//! contiguous range that can be streamed in on its own. every instance
+//! keeps its place in the xml, a map that is not streamed creates its
+//! instances in that order
+namespace MapCache
+{
+	const uint32_t Magic = 0x31434d46; // "FMC1"
+	const uint32_t Version = 3;
+	const uint32_t NoString = 0xffffffff;
+
+	// chunk edge length in layer cells
+	const uint32_t DefaultChunkSize = 16;
+
+	enum ImportKind
+	{
+		IMPORT_FILE = 0,
+		IMPORT_DIRECTORY
+	};
+
+	enum LayerType
+	{
+		LAYER_DEFAULT = 0,
+		LAYER_WALKABLE,
+		LAYER_INTERACT
+	};
+
+	enum InstanceFlags
+	{
+		INSTANCE_HAS_STACKPOS = 1 << 0,
+		INSTANCE_VISITOR = 1 << 1
+	};
+
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t sourceHash;
+		uint64_t sourceSize;
+		uint32_t mapId;
+		uint32_t mapFormat;
+		uint32_t stringCount;
+		uint32_t stringOffsetTable;
+		uint32_t stringData;
+		uint32_t stringDataSize;
+		uint32_t importCount;
+		uint32_t imports;
+		uint32_t objectCount;
+		uint32_t objects;
+		uint32_t layerCount;
+		uint32_t layers;
+		uint32_t instanceCount;
+		uint32_t instances;
+		uint32_t cameraCount;
+		uint32_t cameras;
+		uint32_t chunkSize;
+		uint32_t chunkCount;
+		uint32_t chunks;
+		uint32_t reserved;
+	};
+
+	struct Import
+	{
+		uint32_t kind;
+		uint32_t file;
+		uint32_t directory;
+		uint32_t reserved;
+	};
+
+	struct Object
+	{
+		uint32_t id;
+		uint32_t nameSpace;
+	};
+
+	struct Layer
+	{
+		uint32_t id;
+		uint32_t gridType;
+		uint32_t pathing;
+		uint32_t layerType;
+		uint32_t layerTypeId;
+		uint32_t transparency;
+		uint32_t firstInstance;
+		uint32_t instanceCount;
+		uint32_t residentCount;
+		uint32_t firstChunk;
+		uint32_t chunkCount;
+		uint32_t reserved;
+		double xOffset;
+		double yOffset;
+		double zOffset;
+		double xScale;
+		double yScale;
+		double zScale;
+		double rotation;
+	};
+
+	struct Instance
+	{
+		uint32_t object;
+		uint32_t id;
+		double x;
+		double y;
+		double z;
+		int32_t rotation;
+		int32_t stackPos;
+		int32_t visitorRadius;
+		uint32_t visitorShape;
+		uint32_t flags;
+
+		// position among the layer's instances in the xml
+		uint32_t sourceIndex;
+	};
+
+	struct Chunk
+	{
+		int32_t x;
+		int32_t y;
+		uint32_t firstInstance;
+		uint32_t instanceCount;
+	};
+
+	struct Camera
+	{
+		uint32_t id;
+		uint32_t refLayer;
+		int32_t refCellWidth;
+		int32_t refCellHeight;
+		double tilt;
+		double zoom;
+		double rotation;
+		int32_t viewport[4];
+		uint32_t hasViewport;
+		uint32_t reserved;
+	};
+
+	uint64_t HashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ULL);
+	bool HashFile(const std::string& path, uint64_t& hash, uint64_t& size);
+
+	//! collects the map contents and writes the cache file
+	class Writer
+	{
+	public:
+		Writer();
+
+		uint32_t AddString(const std::string& value);
+		uint32_t AddObject(const std::string& id, const std::string& nameSpace);
+
+		void SetMap(const std::string& id, const std::string& format);
+		void SetSource(uint64_t hash, uint64_t size);
+		void AddImport(const Import& import);
+		void BeginLayer(const Layer& layer);
+		void AddInstance(const Instance& instance);
+		void EndLayer();
+		void AddCamera(const Camera& camera);
+
+		uint32_t GetObjectCount() const;
+		uint32_t GetInstanceCount() const;
+
+		bool Write(const std::string& path) const;
+	private:
+		Header m_header;
+		std::vector<std::string> m_strings;
+		std::map<std::string, uint32_t> m_stringIndex;
+		std::vector<Object> m_objects;
+		std::map<std::pair<uint32_t, uint32_t>, uint32_t> m_objectIndex;
+		std::vector<Import> m_imports;
+		std::vector<Layer> m_layers;
+		std::vector<Instance> m_instances;
+		std::vector<Camera> m_cameras;
+		std::vector<Chunk> m_chunks;
+	};
+
+	//! validates and gives typed access to a cache held in memory
+	class Reader
+	{
+	public:
+		Reader();
+
+		bool Open(const unsigned char* data, size_t size);
+
+		const Header& GetHeader() const;
+		const char* GetString(uint32_t index) const;
+		const Import* GetImports() const;
+		const Object* GetObjects() const;
+		const Layer* GetLayers() const;
+		const Instance* GetInstances() const;
+		const Camera* GetCameras() const;
+		const Chunk* GetChunks() const;
+	private:
+		bool CheckSection(uint32_t offset, uint32_t count, size_t elementSize) const;
+	private:
+		const unsigned char* m_data;
+		size_t m_size;
+		const Header* m_header;
+		const uint32_t* m_stringOffsets;
+		const char* m_stringData;
+	};
+}
+
+#endif
@@ -0,0 +1,687 @@
+//*****************************************************************************
+// FILE NAME:  MapCacheLoader.cpp
+//
+//*****************************************************************************
+#include "MapCacheLoader.h"
+#include "AssetPackFormat.h"
+#include "MapCacheFormat.h"
+#include "MemoryTracker.h"
+#include "MapStreamer.h"
+#include "Stopwatch.h"
+
+// fife includes
+#include "loaders/native/map/maploader.h"
+#include "model/model.h"
+#include "model/metamodel/grids/cellgrid.h"
+#include "model/metamodel/object.h"
+#include "model/structures/instance.h"
+#include "model/structures/layer.h"
+#include "model/structures/location.h"
+#include "model/structures/map.h"
+#include "util/structures/rect.h"
+#include "video/renderbackend.h"
+#include "view/camera.h"
+#include "view/visual.h"
+
+// 3rd party includes
+#include "boost/filesystem.hpp"
+
+// standard includes
+#include <algorithm>
+#include <cassert>
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+	// instances created in one build step before the time is checked
+	const uint32_t InstancesPerStep = 256;
+
+	//!***************************************************************
+	//! @details:
+	//! translates the pathing attribute the same way the xml loader does
+	//!
+	//! @param[in]: pathing
+	//! value of the pathing attribute
+	//!
+	//! @return:
+	//! FIFE::PathingStrategy
+	//!
+	//!***************************************************************
+	FIFE::PathingStrategy GetPathingStrategy(const std::string& pathing)
+	{
+		if (pathing == "cell_edges_and_diagonals")
+		{
+			return FIFE::CELL_EDGES_AND_DIAGONALS;
+		}
+		else if (pathing == "freeform")
+		{
+			return FIFE::FREEFORM;
+		}
+
+		return FIFE::CELL_EDGES_ONLY;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: model
+//! the model the map is created in
+//!
+//! @param[in]: mapLoader
+//! xml loader used for the object imports the map depends on
+//!
+//! @param[in]: renderBackend
+//! used for the default camera viewport
+//!
+//! @param[in]: assetPack
+//! optional, a map and cache found in the pack are read from it
+//!
+//!***************************************************************
+MapCacheLoader::MapCacheLoader(FIFE::Model* model, FIFE::MapLoader* mapLoader, FIFE::RenderBackend* renderBackend,
+	const AssetPack::Reader* assetPack)
+: m_model(model), m_mapLoader(mapLoader), m_renderBackend(renderBackend), m_assetPack(assetPack), m_streamer(0),
+  m_stage(STAGE_DONE), m_map(0), m_layer(0), m_layerIndex(0), m_next(0), m_end(0)
+{
+	assert(m_model && m_mapLoader && m_renderBackend);
+}
+
+//!***************************************************************
+//! @details:
+//! destructor
+//!
+//!***************************************************************
+MapCacheLoader::~MapCacheLoader()
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! location of the cache belonging to a map file
+//!
+//! @param[in]: mapFile
+//! path of the xml map
+//!
+//! @return: 
+//! std::string
+//! 
+//!***************************************************************
+std::string MapCacheLoader::GetCachePath(const std::string& mapFile)
+{
+	return mapFile + ".cache";
+}
+
+//!***************************************************************
+//! @details:
+//! loads the map from its cache in one go, the content hash stored
+//! in the cache must match the current xml file, otherwise the
+//! cache is stale and nothing is created
+//!
+//! @param[in]: mapFile
+//! path of the xml map the cache was compiled from
+//!
+//! @param[in]: cacheFile
+//! path of the cache
+//!
+//! @param[in]: streamer
+//! optional, if given only the named instances are created and
+//! the chunked instances are handed to the streamer
+//!
+//! @return: 
+//! FIFE::Map* - 0 if the cache is missing, invalid or stale
+//! 
+//!***************************************************************
+FIFE::Map* MapCacheLoader::Load(const std::string& mapFile, const std::string& cacheFile, MapStreamer* streamer)
+{
+	if (!Open(mapFile, cacheFile, streamer))
+	{
+		return 0;
+	}
+
+	Build(0.0);
+
+	return m_map;
+}
+
+//!***************************************************************
+//! @details:
+//! maps the cache and checks it against the xml file, nothing is
+//! created yet. does not touch the model, so it may run on a
+//! worker thread while the main thread keeps drawing
+//!
+//! @param[in]: mapFile
+//! path of the xml map the cache was compiled from
+//!
+//! @param[in]: cacheFile
+//! path of the cache
+//!
+//! @param[in]: streamer
+//! optional, if given only the named instances are created and
+//! the chunked instances are handed to the streamer
+//!
+//! @return: 
+//! bool - false if the cache is missing, invalid or stale
+//! 
+//!***************************************************************
+bool MapCacheLoader::Open(const std::string& mapFile, const std::string& cacheFile, MapStreamer* streamer)
+{
+	m_stage = STAGE_DONE;
+	m_map = 0;
+
+	// the streamer keeps the cache mapped for as long as the map lives,
+	// a cache inside the asset pack stays mapped with the pack
+	MappedFile& file = streamer ? streamer->GetCacheFile() : m_cacheFile;
+
+	const unsigned char* data = 0;
+	size_t dataSize = 0;
+	if (m_assetPack && m_assetPack->Find(cacheFile, data, dataSize))
+	{
+		if (!m_reader.Open(data, dataSize))
+		{
+			return false;
+		}
+	}
+	else if (!file.Open(cacheFile) || !m_reader.Open(file.GetData(), file.GetSize()))
+	{
+		return false;
+	}
+
+	// hashing the xml is much cheaper than parsing it
+	uint64_t hash = 0;
+	uint64_t size = 0;
+	const MapCache::Header& header = m_reader.GetHeader();
+	if (m_assetPack && m_assetPack->Find(mapFile, data, dataSize))
+	{
+		hash = MapCache::HashBytes(data, dataSize);
+		size = dataSize;
+	}
+	else if (!MapCache::HashFile(mapFile, hash, size))
+	{
+		return false;
+	}
+
+	if (hash != header.sourceHash || size != header.sourceSize)
+	{
+		return false;
+	}
+
+	m_streamer = streamer;
+	m_mapFile = mapFile;
+
+	// imports are relative to the map file
+	m_mapDirectory = fs::path(mapFile).parent_path().string();
+
+	m_stage = STAGE_CHECK;
+	return true;
+}
+
+//!***************************************************************
+//! @details:
+//! builds the opened map on the main thread, a step at a time
+//! until the time budget is used up. a single step, such as one
+//! import or linking the cell caches, may overrun the budget
+//!
+//! @param[in]: budgetMs
+//! time the call may take, 0 builds the whole map
+//!
+//! @return: 
+//! bool - true once the map is done or could not be created
+//! 
+//!***************************************************************
+bool MapCacheLoader::Build(double budgetMs)
+{
+	Stopwatch timer;
+
+	while (m_stage != STAGE_DONE)
+	{
+		Step();
+
+		if (budgetMs > 0.0 && timer.ElapsedMs() >= budgetMs)
+		{
+			break;
+		}
+	}
+
+	return m_stage == STAGE_DONE;
+}
+
+//!***************************************************************
+//! @details:
+//! the built map
+//!
+//! @return: 
+//! FIFE::Map* - 0 while it is being built or if its id is in use
+//! 
+//!***************************************************************
+FIFE::Map* MapCacheLoader::GetMap() const
+{
+	return m_stage == STAGE_DONE ? m_map : 0;
+}
+
+//!***************************************************************
+//! @details:
+//! does the next bounded piece of building the map
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapCacheLoader::Step()
+{
+	const MapCache::Header& header = m_reader.GetHeader();
+
+	switch (m_stage)
+	{
+		case STAGE_CHECK:
+		{
+			// the map id must be unused, same as for the xml loader
+			m_stage = m_model->getMap(m_reader.GetString(header.mapId)) ? STAGE_DONE : STAGE_IMPORTS;
+			m_next = 0;
+			break;
+		}
+		case STAGE_IMPORTS:
+		{
+			if (m_next < header.importCount)
+			{
+				LoadImport(m_reader.GetImports()[m_next++]);
+			}
+			else
+			{
+				m_stage = STAGE_MAP;
+			}
+			break;
+		}
+		case STAGE_MAP:
+		{
+			m_map = m_model->createMap(m_reader.GetString(header.mapId));
+			m_map->setFilename(m_mapFile);
+
+			m_objects.clear();
+
+			if (m_streamer)
+			{
+				m_streamer->Attach(m_reader);
+			}
+
+			m_layerIndex = 0;
+			m_stage = STAGE_LAYER;
+			break;
+		}
+		case STAGE_LAYER:
+		{
+			if (m_layerIndex >= header.layerCount)
+			{
+				m_stage = STAGE_CELL_CACHES;
+				break;
+			}
+
+			const MapCache::Layer& cached = m_reader.GetLayers()[m_layerIndex];
+			m_layer = CreateLayer(m_map, m_reader, cached);
+
+			if (!m_layer)
+			{
+				++m_layerIndex;
+				break;
+			}
+
+			OrderInstances(cached);
+			m_next = 0;
+			m_end = static_cast<uint32_t>(m_order.size());
+			m_stage = STAGE_INSTANCES;
+			break;
+		}
+		case STAGE_INSTANCES:
+		{
+			uint32_t count = std::min(InstancesPerStep, m_end - m_next);
+			if (count > 0)
+			{
+				CreateInstances(m_layer, m_reader, &m_order[m_next], count);
+			}
+			m_next += count;
+
+			if (m_next >= m_end)
+			{
+				if (m_streamer)
+				{
+					m_streamer->AddLayer(m_layer, m_reader.GetLayers()[m_layerIndex]);
+				}
+
+				++m_layerIndex;
+				m_stage = STAGE_LAYER;
+			}
+			break;
+		}
+		case STAGE_CELL_CACHES:
+		{
+			// walkable and interact layers are linked through the cell caches
+			m_map->initializeCellCaches();
+			m_map->finalizeCellCaches();
+			m_stage = STAGE_CAMERAS;
+			break;
+		}
+		case STAGE_CAMERAS:
+		{
+			CreateCameras(m_map, m_reader);
+			m_stage = STAGE_DONE;
+			break;
+		}
+		default:
+		{
+			break;
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! loads one object file or directory the map imports
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapCacheLoader::LoadImport(const MapCache::Import& import)
+{
+	std::string directory(m_reader.GetString(import.directory));
+
+	if (import.kind == MapCache::IMPORT_DIRECTORY)
+	{
+		fs::path fullPath(m_mapDirectory);
+		fullPath /= directory;
+		m_mapLoader->loadImportDirectory(fullPath.string());
+	}
+	else if (import.directory != MapCache::NoString)
+	{
+		// file relative to the import directory
+		fs::path fullDirPath(m_mapDirectory);
+		fullDirPath /= directory;
+		m_mapLoader->loadImportFile(m_reader.GetString(import.file), fullDirPath.string());
+	}
+	else
+	{
+		fs::path fullFilePath(m_mapDirectory);
+		fullFilePath /= m_reader.GetString(import.file);
+		m_mapLoader->loadImportFile(fullFilePath.string());
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! creates a layer with the cached grid and pathing settings
+//!
+//! @return: 
+//! FIFE::Layer* - 0 if the grid type is unknown
+//! 
+//!***************************************************************
+FIFE::Layer* MapCacheLoader::CreateLayer(FIFE::Map* map, const MapCache::Reader& reader, const MapCache::Layer& cached)
+{
+	FIFE::CellGrid* grid = m_model->getCellGrid(reader.GetString(cached.gridType));
+	if (!grid)
+	{
+		return 0;
+	}
+
+	grid->setXShift(cached.xOffset);
+	grid->setYShift(cached.yOffset);
+	grid->setZShift(cached.zOffset);
+	grid->setXScale(cached.xScale);
+	grid->setYScale(cached.yScale);
+	grid->setZScale(cached.zScale);
+	grid->setRotation(cached.rotation);
+
+	FIFE::Layer* layer = map->createLayer(reader.GetString(cached.id), grid);
+	if (!layer)
+	{
+		return 0;
+	}
+
+	layer->setPathingStrategy(GetPathingStrategy(reader.GetString(cached.pathing)));
+	layer->setLayerTransparency(static_cast<uint8_t>(cached.transparency));
+
+	if (cached.layerType == MapCache::LAYER_WALKABLE)
+	{
+		layer->setWalkable(true);
+	}
+	else if (cached.layerType == MapCache::LAYER_INTERACT)
+	{
+		layer->setInteract(true, reader.GetString(cached.layerTypeId));
+	}
+
+	return layer;
+}
+
+//!***************************************************************
+//! @details:
+//! picks the instances of a layer to create and their order. with
+//! a streamer only the named instances are created, they come
+//! first and are always resident. otherwise every instance is
+//! created in the order of the xml, so the map is the same as the
+//! one the xml loader builds
+//!
+//! @param[in]: cached
+//! the cached layer
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapCacheLoader::OrderInstances(const MapCache::Layer& cached)
+{
+	m_order.clear();
+
+	uint32_t end = std::min(cached.firstInstance + cached.instanceCount, m_reader.GetHeader().instanceCount);
+	uint32_t first = std::min(cached.firstInstance, end);
+
+	if (m_streamer)
+	{
+		end = std::min(end, first + cached.residentCount);
+		for (uint32_t i = first; i < end; ++i)
+		{
+			m_order.push_back(i);
+		}
+		return;
+	}
+
+	const uint32_t unset = 0xffffffff;
+	const MapCache::Instance* instances = m_reader.GetInstances();
+	m_order.assign(end - first, unset);
+
+	for (uint32_t i = first; i < end; ++i)
+	{
+		uint32_t index = instances[i].sourceIndex;
+
+		// a broken source order leaves the table order as it is
+		if (index >= m_order.size() || m_order[index] != unset)
+		{
+			for (uint32_t j = first; j < end; ++j)
+			{
+				m_order[j - first] = j;
+			}
+			return;
+		}
+
+		m_order[index] = i;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! creates instances of the instance table
+//!
+//! @param[in]: layer
+//! the layer to create the instances on
+//!
+//! @param[in]: reader
+//! the cache
+//!
+//! @param[in]: indices
+//! instance table indices, in the order the instances are created
+//!
+//! @param[in]: count
+//! number of indices
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapCacheLoader::CreateInstances(FIFE::Layer* layer, const MapCache::Reader& reader, const uint32_t* indices, uint32_t count)
+{
+	MemoryScope memoryScope(MEMORY_INSTANCES);
+	const MapCache::Instance* instances = reader.GetInstances();
+
+	// one buffer for all ids, instead of a string per instance
+	std::string id;
+
+	for (uint32_t n = 0; n < count; ++n)
+	{
+		uint32_t i = indices[n];
+		FIFE::Object* object = ResolveObject(m_model, reader, instances[i].object, m_objects);
+
+		// the xml loader skips instances of unknown objects as well
+		if (object)
+		{
+			id.assign(reader.GetString(instances[i].id));
+			CreateInstance(layer, object, instances[i], id);
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! looks up an entry of the interned object table, every distinct
+//! object is only resolved once through the model
+//!
+//! @param[in]: model
+//! the model owning the objects
+//!
+//! @param[in]: reader
+//! the cache
+//!
+//! @param[in]: index
+//! index into the object table
+//!
+//! @param[in,out]: resolved
+//! objects resolved so far, indexed like the object table
+//!
+//! @return: 
+//! FIFE::Object* - 0 if the object is unknown
+//! 
+//!***************************************************************
+FIFE::Object* MapCacheLoader::ResolveObject(FIFE::Model* model, const MapCache::Reader& reader, uint32_t index,
+	std::vector<FIFE::Object*>& resolved)
+{
+	const MapCache::Header& header = reader.GetHeader();
+	if (index >= header.objectCount)
+	{
+		return 0;
+	}
+
+	if (resolved.size() != header.objectCount)
+	{
+		resolved.assign(header.objectCount, static_cast<FIFE::Object*>(0));
+	}
+
+	if (!resolved[index])
+	{
+		const MapCache::Object& object = reader.GetObjects()[index];
+		resolved[index] = model->getObject(reader.GetString(object.id), reader.GetString(object.nameSpace));
+	}
+
+	return resolved[index];
+}
+
+//!***************************************************************
+//! @details:
+//! creates one instance the way the xml loader does
+//!
+//! @param[in]: layer
+//! the layer to create the instance on
+//!
+//! @param[in]: object
+//! the resolved object of the instance
+//!
+//! @param[in]: instance
+//! the cached instance
+//!
+//! @param[in]: id
+//! instance id, may be empty
+//!
+//! @return: 
+//! FIFE::Instance* - 0 if the layer refused the instance
+//! 
+//!***************************************************************
+FIFE::Instance* MapCacheLoader::CreateInstance(FIFE::Layer* layer, FIFE::Object* object, const MapCache::Instance& instance,
+	const std::string& id)
+{
+	FIFE::ExactModelCoordinate position(instance.x, instance.y, instance.z);
+	FIFE::Instance* inst = layer->createInstance(object, position, id);
+	if (!inst)
+	{
+		return 0;
+	}
+
+	inst->setRotation(instance.rotation);
+
+	FIFE::InstanceVisual* visual = FIFE::InstanceVisual::create(inst);
+	if (visual && (instance.flags & MapCache::INSTANCE_HAS_STACKPOS))
+	{
+		visual->setStackPosition(instance.stackPos);
+	}
+
+	if (instance.flags & MapCache::INSTANCE_VISITOR)
+	{
+		inst->setVisitor(true);
+		inst->setVisitorRadius(static_cast<uint16_t>(instance.visitorRadius));
+		inst->setVisitorShape(instance.visitorShape == 1 ? FIFE::ITYPE_QUAD_SHAPE : FIFE::ITYPE_CIRCLE_SHAPE);
+	}
+
+	if (object->getAction("default"))
+	{
+		FIFE::Location target(layer);
+		inst->act("default", target, true);
+	}
+
+	return inst;
+}
+
+//!***************************************************************
+//! @details:
+//! creates the cameras, a camera without viewport covers the screen
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapCacheLoader::CreateCameras(FIFE::Map* map, const MapCache::Reader& reader)
+{
+	const MapCache::Camera* cameras = reader.GetCameras();
+
+	for (uint32_t i = 0; i < reader.GetHeader().cameraCount; ++i)
+	{
+		const MapCache::Camera& cached = cameras[i];
+
+		FIFE::Layer* layer = map->getLayer(reader.GetString(cached.refLayer));
+		if (!layer)
+		{
+			continue;
+		}
+
+		FIFE::Rect viewport(0, 0, m_renderBackend->getScreenWidth(), m_renderBackend->getScreenHeight());
+		if (cached.hasViewport)
+		{
+			viewport = FIFE::Rect(cached.viewport[0], cached.viewport[1], cached.viewport[2], cached.viewport[3]);
+		}
+
+		FIFE::Camera* camera = map->addCamera(reader.GetString(cached.id), layer, viewport);
+		if (camera)
+		{
+			camera->setCellImageDimensions(cached.refCellWidth, cached.refCellHeight);
+			camera->setRotation(cached.rotation);
+			camera->setTilt(cached.tilt);
+			camera->setZoom(cached.zoom);
+		}
+	}
+}
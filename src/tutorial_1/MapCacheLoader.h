@@ -0,0 +1,105 @@
+//*****************************************************************************
+// FILE NAME:  MapCacheLoader.h
+//
+//*****************************************************************************
+#ifndef MAP_CACHE_LOADER_H_
+#define MAP_CACHE_LOADER_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "MapCacheFormat.h"
+#include "MappedFile.h"
+
+namespace FIFE
+{
+	class Model;
+	class MapLoader;
+	class RenderBackend;
+	class Map;
+	class Layer;
+	class Object;
+	class Instance;
+}
+
+namespace AssetPack
+{
+	class Reader;
+}
+
+class MapStreamer;
+
+//! rebuilds a map from the binary map cache written by the map compiler,
+//! a missing or stale cache is reported so the caller can fall back to xml.
+//! the cache can be opened on a worker thread and the map built over
+//! several frames, or both done at once by Load
+class MapCacheLoader
+{
+public:
+	MapCacheLoader(FIFE::Model* model, FIFE::MapLoader* mapLoader, FIFE::RenderBackend* renderBackend,
+		const AssetPack::Reader* assetPack = 0);
+	~MapCacheLoader();
+
+	FIFE::Map* Load(const std::string& mapFile, const std::string& cacheFile, MapStreamer* streamer = 0);
+
+	bool Open(const std::string& mapFile, const std::string& cacheFile, MapStreamer* streamer = 0);
+	bool Build(double budgetMs);
+	FIFE::Map* GetMap() const;
+
+	static std::string GetCachePath(const std::string& mapFile);
+	static FIFE::Object* ResolveObject(FIFE::Model* model, const MapCache::Reader& reader, uint32_t index,
+		std::vector<FIFE::Object*>& resolved);
+	static FIFE::Instance* CreateInstance(FIFE::Layer* layer, FIFE::Object* object, const MapCache::Instance& instance,
+		const std::string& id);
+private:
+	//! the steps a map is built in, in order
+	enum Stage
+	{
+		STAGE_CHECK,
+		STAGE_IMPORTS,
+		STAGE_MAP,
+		STAGE_LAYER,
+		STAGE_INSTANCES,
+		STAGE_CELL_CACHES,
+		STAGE_CAMERAS,
+		STAGE_DONE
+	};
+
+	MapCacheLoader(const MapCacheLoader&);
+	MapCacheLoader& operator=(const MapCacheLoader&);
+
+	void Step();
+	void LoadImport(const MapCache::Import& import);
+	FIFE::Layer* CreateLayer(FIFE::Map* map, const MapCache::Reader& reader, const MapCache::Layer& cached);
+	void OrderInstances(const MapCache::Layer& cached);
+	void CreateInstances(FIFE::Layer* layer, const MapCache::Reader& reader, const uint32_t* indices, uint32_t count);
+	void CreateCameras(FIFE::Map* map, const MapCache::Reader& reader);
+private:
+	FIFE::Model* m_model;
+	FIFE::MapLoader* m_mapLoader;
+	FIFE::RenderBackend* m_renderBackend;
+	const AssetPack::Reader* m_assetPack;
+	std::vector<FIFE::Object*> m_objects;
+
+	// the opened cache, a streamer keeps its own mapping of it
+	MappedFile m_cacheFile;
+	MapCache::Reader m_reader;
+	MapStreamer* m_streamer;
+	std::string m_mapFile;
+	std::string m_mapDirectory;
+
+	// how far the map is built
+	Stage m_stage;
+	FIFE::Map* m_map;
+	FIFE::Layer* m_layer;
+	uint32_t m_layerIndex;
+	uint32_t m_next;
+	uint32_t m_end;
+
+	// instance table indices of the current layer in creation order
+	std::vector<uint32_t> m_order;
+};
+
+#endif
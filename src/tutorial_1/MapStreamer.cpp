@@ -0,0 +1,505 @@
+//*****************************************************************************
+// FILE NAME:  MapStreamer.cpp
+//
+//*****************************************************************************
+#include "MapStreamer.h"
+#include "MapCacheLoader.h"
+#include "MemoryTracker.h"
+
+// fife includes
+#include "model/metamodel/grids/cellgrid.h"
+#include "model/structures/instance.h"
+#include "model/structures/layer.h"
+#include "model/structures/location.h"
+
+// standard includes
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+	// instances created per frame before the rest waits for the next frame
+	const int InstanceBudgetPerFrame = 2000;
+
+	// page size used to touch mapped memory
+	const size_t PageSize = 4096;
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: model
+//! the model the streamed objects belong to
+//!
+//! @param[in]: workerPool
+//! threads the chunk data is paged in on
+//!
+//!***************************************************************
+MapStreamer::MapStreamer(FIFE::Model* model, WorkerPool* workerPool)
+: m_model(model), m_workerPool(workerPool), m_loadRadius(2), m_evictRadius(3),
+  m_loadedChunks(0), m_streamedInstances(0), m_dirty(true)
+{
+	assert(m_model && m_workerPool);
+
+	SDL_AtomicSet(&m_pendingJobs, 0);
+}
+
+//!***************************************************************
+//! @details:
+//! destructor, waits for outstanding prefetches since they read
+//! from the mapped cache, the streamed instances belong to their
+//! layers and are deleted with the map
+//!
+//!***************************************************************
+MapStreamer::~MapStreamer()
+{
+	while (SDL_AtomicGet(&m_pendingJobs) > 0)
+	{
+		SDL_Delay(1);
+	}
+
+	for (std::vector<StreamLayer>::iterator layer = m_layers.begin(); layer != m_layers.end(); ++layer)
+	{
+		for (std::vector<Chunk>::iterator chunk = layer->chunks.begin(); chunk != layer->chunks.end(); ++chunk)
+		{
+			delete chunk->job;
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! the cache file stays mapped as long as the streamer lives
+//!
+//! @return: 
+//! MappedFile&
+//! 
+//!***************************************************************
+MappedFile& MapStreamer::GetCacheFile()
+{
+	return m_cacheFile;
+}
+
+//!***************************************************************
+//! @details:
+//! keeps the reader of the validated cache
+//!
+//! @param[in]: reader
+//! reader over GetCacheFile()
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapStreamer::Attach(const MapCache::Reader& reader)
+{
+	m_reader = reader;
+}
+
+//!***************************************************************
+//! @details:
+//! registers the chunks of a created layer, none of them are
+//! instantiated until the first update
+//!
+//! @param[in]: layer
+//! the created layer
+//!
+//! @param[in]: cached
+//! the layer in the cache
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapStreamer::AddLayer(FIFE::Layer* layer, const MapCache::Layer& cached)
+{
+	StreamLayer streamLayer;
+	streamLayer.layer = layer;
+	streamLayer.focusX = 0;
+	streamLayer.focusY = 0;
+
+	const MapCache::Chunk* chunks = m_reader.GetChunks();
+	uint32_t end = cached.firstChunk + cached.chunkCount;
+
+	for (uint32_t i = cached.firstChunk; i < end && i < m_reader.GetHeader().chunkCount; ++i)
+	{
+		Chunk chunk;
+		chunk.cached = &chunks[i];
+		chunk.job = 0;
+		SDL_AtomicSet(&chunk.state, CHUNK_UNLOADED);
+		streamLayer.chunks.push_back(chunk);
+	}
+
+	m_layers.push_back(streamLayer);
+	m_dirty = true;
+}
+
+//!***************************************************************
+//! @details:
+//! sets how far from the focus chunks are kept, in chunks, the
+//! evict radius is larger so moving back and forth over a chunk
+//! border does not reload chunks
+//!
+//! @param[in]: loadRadius
+//! chunks closer than this are loaded
+//!
+//! @param[in]: evictRadius
+//! chunks further away than this are unloaded
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapStreamer::SetRadius(int loadRadius, int evictRadius)
+{
+	m_loadRadius = loadRadius;
+	m_evictRadius = std::max(loadRadius, evictRadius);
+	m_dirty = true;
+}
+
+//!***************************************************************
+//! @details:
+//! called once per frame with the camera location, chunks are
+//! only re-evaluated when the focus moves to another chunk or
+//! chunks are still in flight
+//!
+//! @param[in]: focus
+//! the location the streaming is centered on
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapStreamer::Update(const FIFE::Location& focus)
+{
+	UpdateFocus(focus);
+
+	if (!m_dirty)
+	{
+		return;
+	}
+
+	m_dirty = false;
+
+	int budget = InstanceBudgetPerFrame;
+	for (size_t i = 0; i < m_layers.size(); ++i)
+	{
+		UpdateLayer(i, budget, false);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! loads every chunk in range of the focus right away on the
+//! calling thread, used once after the map is loaded so the first
+//! frame is complete
+//!
+//! @param[in]: focus
+//! the location the streaming is centered on
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapStreamer::LoadAround(const FIFE::Location& focus)
+{
+	UpdateFocus(focus);
+
+	m_dirty = false;
+
+	int budget = INT_MAX;
+	for (size_t i = 0; i < m_layers.size(); ++i)
+	{
+		UpdateLayer(i, budget, true);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! checks whether every chunk in range of the last focus has its
+//! instances created, false until the first update
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+bool MapStreamer::IsSettled() const
+{
+	return !m_dirty;
+}
+
+//!***************************************************************
+//! @details:
+//! works out the focus chunk of every layer and flags a change
+//!
+//! @param[in]: focus
+//! the location the streaming is centered on
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapStreamer::UpdateFocus(const FIFE::Location& focus)
+{
+	FIFE::ExactModelCoordinate mapCoords = focus.getMapCoordinates();
+	double chunkSize = static_cast<double>(m_reader.GetHeader().chunkSize);
+
+	for (std::vector<StreamLayer>::iterator it = m_layers.begin(); it != m_layers.end(); ++it)
+	{
+		// every layer has its own grid, the chunks are in layer cells
+		FIFE::ExactModelCoordinate layerCoords = it->layer->getCellGrid()->toExactLayerCoordinates(mapCoords);
+		int focusX = static_cast<int>(std::floor(layerCoords.x / chunkSize));
+		int focusY = static_cast<int>(std::floor(layerCoords.y / chunkSize));
+
+		if (focusX != it->focusX || focusY != it->focusY)
+		{
+			it->focusX = focusX;
+			it->focusY = focusY;
+			m_dirty = true;
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! prefetches, instantiates and evicts the chunks of one layer
+//!
+//! @param[in]: layerIndex
+//! the layer to update
+//!
+//! @param[in,out]: budget
+//! instances that may still be created this frame
+//!
+//! @param[in]: synchronous
+//! true - page in the chunks on the calling thread
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapStreamer::UpdateLayer(size_t layerIndex, int& budget, bool synchronous)
+{
+	StreamLayer& layer = m_layers[layerIndex];
+
+	for (size_t i = 0; i < layer.chunks.size(); ++i)
+	{
+		Chunk& chunk = layer.chunks[i];
+		int distance = std::max(std::abs(chunk.cached->x - layer.focusX), std::abs(chunk.cached->y - layer.focusY));
+		int state = SDL_AtomicGet(&chunk.state);
+
+		if (distance <= m_loadRadius)
+		{
+			if (state == CHUNK_UNLOADED)
+			{
+				Prefetch(layerIndex, i, synchronous);
+				state = SDL_AtomicGet(&chunk.state);
+			}
+
+			if (state == CHUNK_PREFETCHING)
+			{
+				// look again next frame
+				m_dirty = true;
+			}
+			else if (state == CHUNK_READY)
+			{
+				if (budget > 0)
+				{
+					budget -= static_cast<int>(chunk.cached->instanceCount);
+					LoadChunk(layer, chunk);
+				}
+				else
+				{
+					m_dirty = true;
+				}
+			}
+		}
+		else if (distance > m_evictRadius && state == CHUNK_LOADED)
+		{
+			UnloadChunk(layer, chunk);
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! hands a chunk to the worker pool to page in its data, the job
+//! is kept with the chunk and reused for later prefetches
+//!
+//! @param[in]: synchronous
+//! true - run the job right away on the calling thread
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapStreamer::Prefetch(size_t layerIndex, size_t chunkIndex, bool synchronous)
+{
+	Chunk& chunk = m_layers[layerIndex].chunks[chunkIndex];
+
+	if (!chunk.job)
+	{
+		chunk.job = new PrefetchJob(this, layerIndex, chunkIndex);
+	}
+
+	SDL_AtomicSet(&chunk.state, CHUNK_PREFETCHING);
+	SDL_AtomicAdd(&m_pendingJobs, 1);
+
+	if (synchronous)
+	{
+		chunk.job->Run();
+	}
+	else
+	{
+		m_workerPool->Submit(chunk.job);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! creates the instances of a prefetched chunk
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapStreamer::LoadChunk(StreamLayer& layer, Chunk& chunk)
+{
+	MemoryScope memoryScope(MEMORY_INSTANCES);
+	const MapCache::Instance* instances = m_reader.GetInstances();
+	uint32_t end = chunk.cached->firstInstance + chunk.cached->instanceCount;
+
+	chunk.instances.reserve(chunk.cached->instanceCount);
+
+	for (uint32_t i = chunk.cached->firstInstance; i < end && i < m_reader.GetHeader().instanceCount; ++i)
+	{
+		FIFE::Object* object = MapCacheLoader::ResolveObject(m_model, m_reader, instances[i].object, m_objects);
+		if (!object)
+		{
+			continue;
+		}
+
+		// streamed instances never have an id, named ones are resident
+		FIFE::Instance* instance = MapCacheLoader::CreateInstance(layer.layer, object, instances[i], "");
+		if (instance)
+		{
+			chunk.instances.push_back(instance);
+		}
+	}
+
+	m_streamedInstances += static_cast<int>(chunk.instances.size());
+	++m_loadedChunks;
+
+	SDL_AtomicSet(&chunk.state, CHUNK_LOADED);
+}
+
+//!***************************************************************
+//! @details:
+//! deletes the instances of a chunk, its data stays in the mapped
+//! cache and is paged in again when the chunk comes back in range
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapStreamer::UnloadChunk(StreamLayer& layer, Chunk& chunk)
+{
+	for (std::vector<FIFE::Instance*>::iterator it = chunk.instances.begin(); it != chunk.instances.end(); ++it)
+	{
+		layer.layer->deleteInstance(*it);
+	}
+
+	m_streamedInstances -= static_cast<int>(chunk.instances.size());
+	--m_loadedChunks;
+
+	// release the memory, not just the elements
+	std::vector<FIFE::Instance*>().swap(chunk.instances);
+
+	SDL_AtomicSet(&chunk.state, CHUNK_UNLOADED);
+}
+
+//!***************************************************************
+//! @details:
+//! number of chunks with created instances
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int MapStreamer::GetLoadedChunkCount() const
+{
+	return m_loadedChunks;
+}
+
+//!***************************************************************
+//! @details:
+//! number of chunks over all streamed layers
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int MapStreamer::GetChunkCount() const
+{
+	int count = 0;
+	for (std::vector<StreamLayer>::const_iterator it = m_layers.begin(); it != m_layers.end(); ++it)
+	{
+		count += static_cast<int>(it->chunks.size());
+	}
+	return count;
+}
+
+//!***************************************************************
+//! @details:
+//! number of instances currently created by the streamer
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int MapStreamer::GetStreamedInstanceCount() const
+{
+	return m_streamedInstances;
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//!***************************************************************
+MapStreamer::PrefetchJob::PrefetchJob(MapStreamer* parent, size_t layerIndex, size_t chunkIndex)
+: owner(parent), layer(layerIndex), chunk(chunkIndex)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! reads one byte per page of the chunk's instance records, runs
+//! on a worker thread and must not touch the engine
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MapStreamer::PrefetchJob::Run()
+{
+	Chunk& target = owner->m_layers[layer].chunks[chunk];
+
+	const unsigned char* begin = reinterpret_cast<const unsigned char*>(
+		owner->m_reader.GetInstances() + target.cached->firstInstance);
+	size_t size = target.cached->instanceCount * sizeof(MapCache::Instance);
+
+	volatile unsigned char sink = 0;
+	for (size_t offset = 0; offset < size; offset += PageSize)
+	{
+		sink ^= begin[offset];
+	}
+	(void)sink;
+
+	SDL_AtomicSet(&target.state, CHUNK_READY);
+	SDL_AtomicAdd(&owner->m_pendingJobs, -1);
+}
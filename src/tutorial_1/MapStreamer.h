@@ -0,0 +1,104 @@
+//*****************************************************************************
+// FILE NAME:  MapStreamer.h
+//
+//*****************************************************************************
+#ifndef MAP_STREAMER_H_
+#define MAP_STREAMER_H_
+
+#include <vector>
+
+#include "SDL.h"
+
+#include "MapCacheFormat.h"
+#include "MappedFile.h"
+#include "WorkerPool.h"
+
+namespace FIFE
+{
+	class Model;
+	class Layer;
+	class Object;
+	class Instance;
+	class Location;
+}
+
+//! keeps only the chunks of a cached map around the camera instantiated,
+//! chunks are paged in from the mapped cache on the worker pool and
+//! turned into instances on the main thread under a per frame budget
+class MapStreamer
+{
+public:
+	MapStreamer(FIFE::Model* model, WorkerPool* workerPool);
+	~MapStreamer();
+
+	// used by the map cache loader while the map is created
+	MappedFile& GetCacheFile();
+	void Attach(const MapCache::Reader& reader);
+	void AddLayer(FIFE::Layer* layer, const MapCache::Layer& cached);
+
+	void SetRadius(int loadRadius, int evictRadius);
+	void Update(const FIFE::Location& focus);
+	void LoadAround(const FIFE::Location& focus);
+	bool IsSettled() const;
+
+	int GetLoadedChunkCount() const;
+	int GetChunkCount() const;
+	int GetStreamedInstanceCount() const;
+private:
+	enum ChunkState
+	{
+		CHUNK_UNLOADED = 0,
+		CHUNK_PREFETCHING,
+		CHUNK_READY,
+		CHUNK_LOADED
+	};
+
+	//! touches the pages of a chunk so the main thread does not fault
+	class PrefetchJob : public WorkerJob
+	{
+	public:
+		PrefetchJob(MapStreamer* parent, size_t layerIndex, size_t chunkIndex);
+		virtual void Run();
+
+		MapStreamer* owner;
+		size_t layer;
+		size_t chunk;
+	};
+
+	struct Chunk
+	{
+		const MapCache::Chunk* cached;
+		SDL_atomic_t state;
+		PrefetchJob* job;
+		std::vector<FIFE::Instance*> instances;
+	};
+
+	struct StreamLayer
+	{
+		FIFE::Layer* layer;
+		std::vector<Chunk> chunks;
+		int focusX;
+		int focusY;
+	};
+
+	void UpdateFocus(const FIFE::Location& focus);
+	void UpdateLayer(size_t layerIndex, int& budget, bool synchronous);
+	void LoadChunk(StreamLayer& layer, Chunk& chunk);
+	void UnloadChunk(StreamLayer& layer, Chunk& chunk);
+	void Prefetch(size_t layerIndex, size_t chunkIndex, bool synchronous);
+private:
+	FIFE::Model* m_model;
+	WorkerPool* m_workerPool;
+	MappedFile m_cacheFile;
+	MapCache::Reader m_reader;
+	std::vector<StreamLayer> m_layers;
+	std::vector<FIFE::Object*> m_objects;
+	SDL_atomic_t m_pendingJobs;
+	int m_loadRadius;
+	int m_evictRadius;
+	int m_loadedChunks;
+	int m_streamedInstances;
+	bool m_dirty;
+};
+
+#endif
@@ -0,0 +1,576 @@
+//*****************************************************************************
+// FILE NAME:  MapSwitcher.cpp
+//
+//*****************************************************************************
+#include "MapSwitcher.h"
+#include "ImagePreloader.h"
+#include "MapCacheLoader.h"
+#include "MapStreamer.h"
+#include "MemoryTracker.h"
+
+// fife includes
+#include "controller/engine.h"
+#include "loaders/native/map/maploader.h"
+#include "model/model.h"
+#include "model/structures/layer.h"
+#include "model/structures/map.h"
+#include "video/renderbackend.h"
+#include "view/camera.h"
+
+// standard includes
+#include <cassert>
+#include <iostream>
+
+namespace
+{
+	// decoded images handed to the engine between two looks at the clock
+	const int UploadBatchSize = 4;
+
+	// instances of the old map deleted between two looks at the clock
+	const int RetireBatchSize = 256;
+
+	// camera the streamed chunks are loaded around before the switch
+	const char* MainCameraId = "main";
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: engine
+//! the engine the maps are loaded into
+//!
+//! @param[in]: workerPool
+//! threads the cache is checked and the images decoded on
+//!
+//! @param[in]: assetPack
+//! optional, files found in the pack are read from it
+//!
+//!***************************************************************
+MapSwitcher::MapSwitcher(FIFE::Engine* engine, WorkerPool* workerPool, const AssetPack::Reader* assetPack)
+: m_engine(engine), m_workerPool(workerPool), m_assetPack(assetPack), m_stage(STAGE_IDLE), m_mapLoader(0),
+  m_cacheLoader(0), m_streamer(0), m_preloader(0), m_map(0), m_loadTimeMs(0.0), m_loadFrames(0), m_retiredMap(0)
+{
+	assert(m_engine && m_workerPool);
+}
+
+//!***************************************************************
+//! @details:
+//! destructor, waits for the cache check since it writes to the
+//! loader, a map that was loaded but never taken is deleted
+//!
+//!***************************************************************
+MapSwitcher::~MapSwitcher()
+{
+	if (m_stage == STAGE_OPENING)
+	{
+		while (!SDL_AtomicGet(&m_openJob.done))
+		{
+			SDL_Delay(1);
+		}
+	}
+
+	Cleanup();
+
+	delete m_streamer;
+	m_streamer = 0;
+
+	if (m_map)
+	{
+		m_engine->getModel()->deleteMap(m_map);
+		m_map = 0;
+	}
+
+	if (m_retiredMap)
+	{
+		m_engine->getModel()->deleteMap(m_retiredMap);
+		m_retiredMap = 0;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! starts loading a map in the background, nothing is created
+//! in the model until the first update
+//!
+//! @param[in]: mapFile
+//! path of the xml map
+//!
+//! @param[in]: useMapCache
+//! build the map from its binary cache, without it the xml is
+//! parsed in one step and the frame it happens in stalls
+//!
+//! @param[in]: streamMap
+//! only instantiate the chunks around the camera
+//!
+//! @param[in]: preloadImages
+//! decode the map's images on the worker threads
+//!
+//! @return:
+//! bool - false if a switch is still in progress
+//!
+//!***************************************************************
+bool MapSwitcher::Start(const std::string& mapFile, bool useMapCache, bool streamMap, bool preloadImages)
+{
+	if (m_stage != STAGE_IDLE)
+	{
+		return false;
+	}
+
+	m_mapFile = mapFile;
+	m_loadTimer.Start();
+	m_loadTimeMs = 0.0;
+	m_loadFrames = 0;
+
+	FIFE::Model* model = m_engine->getModel();
+	m_mapLoader = new FIFE::MapLoader(model, m_engine->getVFS(), m_engine->getImageManager(), m_engine->getRenderBackend());
+
+	if (preloadImages)
+	{
+		m_preloader = new ImagePreloader(m_engine->getImageManager(), m_workerPool, m_assetPack, &m_arena);
+		m_preloader->AddMapImports(mapFile);
+	}
+
+	m_openJob.opened = false;
+	m_stage = STAGE_OPENING;
+
+	if (!useMapCache)
+	{
+		// falls back to the xml on the first update
+		SDL_AtomicSet(&m_openJob.done, 1);
+		return true;
+	}
+
+	if (streamMap)
+	{
+		m_streamer = new MapStreamer(model, m_workerPool);
+	}
+
+	m_cacheLoader = new MapCacheLoader(model, m_mapLoader, m_engine->getRenderBackend(), m_assetPack);
+
+	m_openJob.loader = m_cacheLoader;
+	m_openJob.streamer = m_streamer;
+	m_openJob.mapFile = mapFile;
+	m_openJob.cacheFile = MapCacheLoader::GetCachePath(mapFile);
+	SDL_AtomicSet(&m_openJob.done, 0);
+
+	m_workerPool->Submit(&m_openJob);
+
+	return true;
+}
+
+//!***************************************************************
+//! @details:
+//! called once per frame, loads or deletes a part of the map
+//! until the time budget is used up
+//!
+//! @param[in]: budgetMs
+//! time the call should take at most, a single step such as
+//! one object import may take longer
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void MapSwitcher::Update(double budgetMs)
+{
+	if (m_stage == STAGE_IDLE || m_stage == STAGE_READY)
+	{
+		return;
+	}
+
+	if (m_stage != STAGE_RETIRING)
+	{
+		++m_loadFrames;
+	}
+
+	Stopwatch timer;
+	double remainingMs = budgetMs;
+
+	while (remainingMs > 0.0 && Advance(remainingMs))
+	{
+		remainingMs = budgetMs - timer.ElapsedMs();
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! hands the loaded map over to the game, its cameras are still
+//! disabled and the streamer has loaded the chunks around the
+//! main camera
+//!
+//! @param[out]: streamer
+//! the map's streamer, 0 if it is not streamed
+//!
+//! @return:
+//! FIFE::Map* - 0 if no map is ready
+//!
+//!***************************************************************
+FIFE::Map* MapSwitcher::TakeMap(MapStreamer*& streamer)
+{
+	streamer = 0;
+
+	if (m_stage != STAGE_READY)
+	{
+		return 0;
+	}
+
+	FIFE::Map* map = m_map;
+	streamer = m_streamer;
+
+	m_map = 0;
+	m_streamer = 0;
+	m_stage = STAGE_IDLE;
+
+	return map;
+}
+
+//!***************************************************************
+//! @details:
+//! takes over the map the game no longer shows and deletes it
+//! over the next updates, its cameras are disabled right away
+//!
+//! @param[in]: map
+//! the old map, nothing may refer to it any more
+//!
+//! @param[in]: streamer
+//! the old map's streamer, may be 0
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void MapSwitcher::Retire(FIFE::Map* map, MapStreamer* streamer)
+{
+	assert(m_stage == STAGE_IDLE);
+
+	// the streamer only waits for its prefetches, its instances
+	// belong to the layers
+	delete streamer;
+
+	if (!map)
+	{
+		return;
+	}
+
+	const std::vector<FIFE::Camera*>& cameras = map->getCameras();
+	for (std::vector<FIFE::Camera*>::const_iterator it = cameras.begin(); it != cameras.end(); ++it)
+	{
+		(*it)->setEnabled(false);
+	}
+
+	const std::list<FIFE::Layer*>& layers = map->getLayers();
+	m_retiredLayers.assign(layers.begin(), layers.end());
+	m_retiredMap = map;
+	m_stage = STAGE_RETIRING;
+}
+
+//!***************************************************************
+//! @details:
+//! checks whether nothing is being loaded or deleted
+//!
+//! @return:
+//! bool
+//!
+//!***************************************************************
+bool MapSwitcher::IsIdle() const
+{
+	return m_stage == STAGE_IDLE;
+}
+
+//!***************************************************************
+//! @details:
+//! checks whether the loaded map can be taken
+//!
+//! @return:
+//! bool
+//!
+//!***************************************************************
+bool MapSwitcher::IsReady() const
+{
+	return m_stage == STAGE_READY;
+}
+
+//!***************************************************************
+//! @details:
+//! the map file of the last switch
+//!
+//! @return:
+//! const std::string&
+//!
+//!***************************************************************
+const std::string& MapSwitcher::GetMapFile() const
+{
+	return m_mapFile;
+}
+
+//!***************************************************************
+//! @details:
+//! wall time from the start of the last load until the map was
+//! ready, the frames kept running in the meantime
+//!
+//! @return:
+//! double
+//!
+//!***************************************************************
+double MapSwitcher::GetLoadTimeMs() const
+{
+	return m_loadTimeMs;
+}
+
+//!***************************************************************
+//! @details:
+//! number of frames the last load was spread over
+//!
+//! @return:
+//! int
+//!
+//!***************************************************************
+int MapSwitcher::GetLoadFrames() const
+{
+	return m_loadFrames;
+}
+
+//!***************************************************************
+//! @details:
+//! does the next piece of the load or of deleting the old map
+//!
+//! @param[in]: budgetMs
+//! time left this frame
+//!
+//! @return:
+//! bool - false if there is nothing more to do this frame
+//!
+//!***************************************************************
+bool MapSwitcher::Advance(double budgetMs)
+{
+	switch (m_stage)
+	{
+		case STAGE_OPENING:
+		{
+			if (!SDL_AtomicGet(&m_openJob.done))
+			{
+				return false;
+			}
+
+			if (m_openJob.opened)
+			{
+				m_stage = STAGE_BUILDING;
+			}
+			else
+			{
+				LoadXml();
+			}
+			return true;
+		}
+		case STAGE_BUILDING:
+		{
+			MemoryScope memoryScope(MEMORY_MAP);
+
+			if (!m_cacheLoader->Build(budgetMs))
+			{
+				return false;
+			}
+
+			FinishBuild(m_cacheLoader->GetMap());
+			return true;
+		}
+		case STAGE_UPLOADING:
+		{
+			int handled = m_preloader->GetUploadedCount() + m_preloader->GetUnusedCount();
+			if (m_preloader->UploadReady(UploadBatchSize))
+			{
+				Cleanup();
+				m_stage = STAGE_STREAMING;
+				return true;
+			}
+
+			// wait for the workers if nothing was decoded yet
+			return m_preloader->GetUploadedCount() + m_preloader->GetUnusedCount() != handled;
+		}
+		case STAGE_STREAMING:
+		{
+			FIFE::Camera* camera = m_map->getCamera(MainCameraId);
+			if (m_streamer && camera)
+			{
+				// the streamer keeps to its own budget, once per frame
+				m_streamer->Update(camera->getLocationRef());
+				if (!m_streamer->IsSettled())
+				{
+					return false;
+				}
+			}
+
+			m_loadTimeMs = m_loadTimer.ElapsedMs();
+			m_stage = STAGE_READY;
+			return false;
+		}
+		case STAGE_RETIRING:
+		{
+			return RetireInstances(budgetMs);
+		}
+		default:
+		{
+			return false;
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! loads the xml map in one step, used when there is no up to
+//! date cache. the frame it happens in stalls for the whole load
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void MapSwitcher::LoadXml()
+{
+	std::cerr << "no up to date map cache for " << m_mapFile << ", the switch loads the xml in one frame" << std::endl;
+
+	// streaming needs the cache
+	delete m_streamer;
+	m_streamer = 0;
+
+	MemoryScope memoryScope(MEMORY_MAP);
+	FinishBuild(m_mapLoader->load(m_mapFile));
+}
+
+//!***************************************************************
+//! @details:
+//! hides the built map until the switch and moves on to its
+//! images, a map that could not be created ends the load
+//!
+//! @param[in]: map
+//! the built map, may be 0
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void MapSwitcher::FinishBuild(FIFE::Map* map)
+{
+	m_map = map;
+
+	// the loaders are only needed for the imports
+	delete m_cacheLoader;
+	m_cacheLoader = 0;
+	delete m_mapLoader;
+	m_mapLoader = 0;
+
+	if (!m_map)
+	{
+		std::cerr << "could not load " << m_mapFile << std::endl;
+
+		Cleanup();
+		delete m_streamer;
+		m_streamer = 0;
+		m_stage = STAGE_IDLE;
+		return;
+	}
+
+	// the engine draws every enabled camera of every map
+	const std::vector<FIFE::Camera*>& cameras = m_map->getCameras();
+	for (std::vector<FIFE::Camera*>::const_iterator it = cameras.begin(); it != cameras.end(); ++it)
+	{
+		(*it)->setEnabled(false);
+	}
+
+	m_stage = m_preloader ? STAGE_UPLOADING : STAGE_STREAMING;
+}
+
+//!***************************************************************
+//! @details:
+//! deletes a batch of the old map's instances, front to back so
+//! the layer does not search for them, and the map itself once
+//! its layers are empty
+//!
+//! @param[in]: budgetMs
+//! time left this frame
+//!
+//! @return:
+//! bool - false once the old map is gone
+//!
+//!***************************************************************
+bool MapSwitcher::RetireInstances(double budgetMs)
+{
+	Stopwatch timer;
+
+	while (!m_retiredLayers.empty())
+	{
+		FIFE::Layer* layer = m_retiredLayers.back();
+		const std::vector<FIFE::Instance*>& instances = layer->getInstances();
+
+		if (instances.empty())
+		{
+			m_retiredLayers.pop_back();
+			continue;
+		}
+
+		for (int i = 0; i < RetireBatchSize && !instances.empty(); ++i)
+		{
+			layer->deleteInstance(instances.front());
+		}
+
+		if (timer.ElapsedMs() >= budgetMs)
+		{
+			return true;
+		}
+	}
+
+	// only the empty layers, cameras and cell caches are left
+	m_engine->getModel()->deleteMap(m_retiredMap);
+	m_retiredMap = 0;
+	m_stage = STAGE_IDLE;
+
+	return false;
+}
+
+//!***************************************************************
+//! @details:
+//! frees what was only needed while loading
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void MapSwitcher::Cleanup()
+{
+	delete m_preloader;
+	m_preloader = 0;
+
+	delete m_cacheLoader;
+	m_cacheLoader = 0;
+
+	delete m_mapLoader;
+	m_mapLoader = 0;
+
+	m_arena.Release();
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//!***************************************************************
+MapSwitcher::OpenJob::OpenJob()
+: loader(0), streamer(0), opened(false)
+{
+	SDL_AtomicSet(&done, 1);
+}
+
+//!***************************************************************
+//! @details:
+//! maps the cache and compares its hash with the xml, runs on a
+//! worker thread and must not touch the engine
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void MapSwitcher::OpenJob::Run()
+{
+	opened = loader->Open(mapFile, cacheFile, streamer);
+	SDL_AtomicSet(&done, 1);
+}
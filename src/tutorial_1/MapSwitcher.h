@@ -0,0 +1,113 @@
+//*****************************************************************************
+// FILE NAME:  MapSwitcher.h
+//
+//*****************************************************************************
+#ifndef MAP_SWITCHER_H_
+#define MAP_SWITCHER_H_
+
+#include <string>
+#include <vector>
+
+#include "SDL.h"
+
+#include "LoadArena.h"
+#include "Stopwatch.h"
+#include "WorkerPool.h"
+
+namespace FIFE
+{
+	class Engine;
+	class Map;
+	class MapLoader;
+	class Layer;
+}
+
+namespace AssetPack
+{
+	class Reader;
+}
+
+class MapCacheLoader;
+class MapStreamer;
+class ImagePreloader;
+
+//! loads another map while the current one keeps running. the cache is
+//! checked on the worker pool, then the map is built and its images are
+//! uploaded on the main thread a little every frame. once the game has
+//! switched over, the old map is deleted the same way
+class MapSwitcher
+{
+public:
+	MapSwitcher(FIFE::Engine* engine, WorkerPool* workerPool, const AssetPack::Reader* assetPack = 0);
+	~MapSwitcher();
+
+	bool Start(const std::string& mapFile, bool useMapCache, bool streamMap, bool preloadImages);
+	void Update(double budgetMs);
+	FIFE::Map* TakeMap(MapStreamer*& streamer);
+	void Retire(FIFE::Map* map, MapStreamer* streamer);
+
+	bool IsIdle() const;
+	bool IsReady() const;
+	const std::string& GetMapFile() const;
+	double GetLoadTimeMs() const;
+	int GetLoadFrames() const;
+private:
+	enum Stage
+	{
+		STAGE_IDLE,
+		STAGE_OPENING,
+		STAGE_BUILDING,
+		STAGE_UPLOADING,
+		STAGE_STREAMING,
+		STAGE_READY,
+		STAGE_RETIRING
+	};
+
+	//! maps and checks the cache on a worker thread
+	class OpenJob : public WorkerJob
+	{
+	public:
+		OpenJob();
+		virtual void Run();
+
+		MapCacheLoader* loader;
+		MapStreamer* streamer;
+		std::string mapFile;
+		std::string cacheFile;
+		bool opened;
+		SDL_atomic_t done;
+	};
+
+	MapSwitcher(const MapSwitcher&);
+	MapSwitcher& operator=(const MapSwitcher&);
+
+	bool Advance(double budgetMs);
+	void LoadXml();
+	void FinishBuild(FIFE::Map* map);
+	bool RetireInstances(double budgetMs);
+	void Cleanup();
+private:
+	FIFE::Engine* m_engine;
+	WorkerPool* m_workerPool;
+	const AssetPack::Reader* m_assetPack;
+	Stage m_stage;
+
+	// the map being loaded
+	std::string m_mapFile;
+	FIFE::MapLoader* m_mapLoader;
+	MapCacheLoader* m_cacheLoader;
+	MapStreamer* m_streamer;
+	ImagePreloader* m_preloader;
+	LoadArena m_arena;
+	OpenJob m_openJob;
+	FIFE::Map* m_map;
+	Stopwatch m_loadTimer;
+	double m_loadTimeMs;
+	int m_loadFrames;
+
+	// the map being deleted
+	FIFE::Map* m_retiredMap;
+	std::vector<FIFE::Layer*> m_retiredLayers;
+};
+
+#endif
@@ -0,0 +1,193 @@
+//*****************************************************************************
+// FILE NAME:  MappedFile.cpp
+//
+//*****************************************************************************
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//!***************************************************************
+MappedFile::MappedFile()
+: m_data(0), m_size(0),
+#if defined(_WIN32)
+  m_file(INVALID_HANDLE_VALUE), m_mapping(0)
+#else
+  m_file(-1)
+#endif
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! destructor, unmaps the file
+//!
+//!***************************************************************
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+//!***************************************************************
+//! @details:
+//! maps the file into memory, empty files can not be mapped
+//!
+//! @param[in]: path
+//! file to map
+//!
+//! @return: 
+//! bool - false if the file could not be mapped
+//! 
+//!***************************************************************
+bool MappedFile::Open(const std::string& path)
+{
+	Close();
+
+#if defined(_WIN32)
+	m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, 0);
+	if (m_file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+
+	m_mapping = CreateFileMappingA(m_file, 0, PAGE_READONLY, 0, 0, 0);
+	if (!m_mapping)
+	{
+		Close();
+		return false;
+	}
+
+	m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+	m_size = static_cast<size_t>(size.QuadPart);
+#else
+	m_file = open(path.c_str(), O_RDONLY);
+	if (m_file < 0)
+	{
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(m_file, &info) != 0 || info.st_size == 0)
+	{
+		Close();
+		return false;
+	}
+
+	void* data = mmap(0, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, m_file, 0);
+	if (data == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+
+	m_data = static_cast<const unsigned char*>(data);
+	m_size = static_cast<size_t>(info.st_size);
+#endif
+
+	if (!m_data)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+//!***************************************************************
+//! @details:
+//! unmaps the file, pointers returned by GetData become invalid
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MappedFile::Close()
+{
+#if defined(_WIN32)
+	if (m_data)
+	{
+		UnmapViewOfFile(m_data);
+	}
+	if (m_mapping)
+	{
+		CloseHandle(m_mapping);
+		m_mapping = 0;
+	}
+	if (m_file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (m_data)
+	{
+		munmap(const_cast<unsigned char*>(m_data), m_size);
+	}
+	if (m_file >= 0)
+	{
+		close(m_file);
+		m_file = -1;
+	}
+#endif
+
+	m_data = 0;
+	m_size = 0;
+}
+
+//!***************************************************************
+//! @details:
+//! checks whether a file is mapped
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+bool MappedFile::IsOpen() const
+{
+	return m_data != 0;
+}
+
+//!***************************************************************
+//! @details:
+//! start of the mapped file contents
+//!
+//! @return: 
+//! const unsigned char*
+//! 
+//!***************************************************************
+const unsigned char* MappedFile::GetData() const
+{
+	return m_data;
+}
+
+//!***************************************************************
+//! @details:
+//! size of the mapped file
+//!
+//! @return: 
+//! size_t - bytes
+//! 
+//!***************************************************************
+size_t MappedFile::GetSize() const
+{
+	return m_size;
+}
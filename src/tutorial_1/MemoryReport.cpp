@@ -0,0 +1,322 @@
+//*****************************************************************************
+// FILE NAME:  MemoryReport.cpp
+//
+//*****************************************************************************
+#include "MemoryReport.h"
+#include "ProcessMemory.h"
+
+// fife includes
+#include "video/animationmanager.h"
+#include "video/imagemanager.h"
+
+// standard includes
+#include <cassert>
+#include <iomanip>
+#include <ostream>
+
+namespace
+{
+	const double BytesPerKiB = 1024.0;
+
+	//!***************************************************************
+	//! @details:
+	//! bytes as kibibytes for the report
+	//!
+	//! @param[in]: bytes
+	//! byte count
+	//!
+	//! @return:
+	//! double
+	//!
+	//!***************************************************************
+	double ToKiB(size_t bytes)
+	{
+		return static_cast<double>(bytes) / BytesPerKiB;
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! change between two byte counts as kibibytes, negative
+	//! when memory was given back
+	//!
+	//! @param[in]: from
+	//! earlier byte count
+	//!
+	//! @param[in]: to
+	//! later byte count
+	//!
+	//! @return:
+	//! double
+	//!
+	//!***************************************************************
+	double DeltaKiB(size_t from, size_t to)
+	{
+		return (static_cast<double>(to) - static_cast<double>(from)) / BytesPerKiB;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: imageManager
+//! engine image manager, its decoded pixels are reported
+//!
+//! @param[in]: animationManager
+//! engine animation manager, its frames are reported
+//!
+//!***************************************************************
+MemoryReport::MemoryReport(FIFE::ImageManager* imageManager, FIFE::AnimationManager* animationManager)
+: m_imageManager(imageManager), m_animationManager(animationManager)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! records the memory counters under a label, a label that
+//! is taken again replaces the earlier snapshot
+//!
+//! @param[in]: label
+//! name of the point of the run, e.g. "after load"
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void MemoryReport::Snapshot(const std::string& label)
+{
+	Sample sample;
+	sample.label = label;
+
+	for (int i = 0; i < MEMORY_CATEGORY_COUNT; ++i)
+	{
+		MemoryCategory category = static_cast<MemoryCategory>(i);
+		sample.liveBytes[i] = MemoryTracker::GetLiveBytes(category);
+		sample.peakBytes[i] = MemoryTracker::GetPeakBytes(category);
+		sample.allocations[i] = MemoryTracker::GetAllocationCount(category);
+	}
+
+	// pixels and frames live in SDL surfaces and textures, which
+	// the heap counters do not see, so the engine is asked for them
+	sample.imageBytes = m_imageManager ? m_imageManager->getMemoryUsed() : 0;
+	sample.animationBytes = m_animationManager ? m_animationManager->getMemoryUsed() : 0;
+	sample.residentBytes = ProcessMemory::GetCurrentResidentBytes();
+	sample.peakResidentBytes = ProcessMemory::GetPeakResidentBytes();
+
+	std::vector<Sample>::iterator it;
+	for (it = m_samples.begin(); it != m_samples.end(); ++it)
+	{
+		if (it->label == label)
+		{
+			*it = sample;
+			return;
+		}
+	}
+
+	m_samples.push_back(sample);
+}
+
+//!***************************************************************
+//! @details:
+//! whether a snapshot was taken under the label
+//!
+//! @param[in]: label
+//! name of the snapshot
+//!
+//! @return:
+//! bool
+//!
+//!***************************************************************
+bool MemoryReport::HasSnapshot(const std::string& label) const
+{
+	return Find(label) != 0;
+}
+
+//!***************************************************************
+//! @details:
+//! number of snapshots taken so far
+//!
+//! @return:
+//! size_t
+//!
+//!***************************************************************
+size_t MemoryReport::GetSnapshotCount() const
+{
+	return m_samples.size();
+}
+
+//!***************************************************************
+//! @details:
+//! label of a snapshot in the order they were taken
+//!
+//! @param[in]: index
+//! index of the snapshot
+//!
+//! @return:
+//! const std::string&
+//!
+//!***************************************************************
+const std::string& MemoryReport::GetLabel(size_t index) const
+{
+	assert(index < m_samples.size());
+	return m_samples[index].label;
+}
+
+//!***************************************************************
+//! @details:
+//! writes the live and peak bytes of every category of one
+//! snapshot
+//!
+//! @param[in]: out
+//! stream the report is written to
+//!
+//! @param[in]: label
+//! name of the snapshot
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void MemoryReport::Print(std::ostream& out, const std::string& label) const
+{
+	const Sample* sample = Find(label);
+	if (!sample)
+	{
+		return;
+	}
+
+	std::ios::fmtflags flags = out.flags();
+	std::streamsize precision = out.precision();
+
+	out << std::fixed << std::setprecision(1);
+	out << "memory " << sample->label << ":" << std::endl;
+
+	if (MemoryTracker::IsEnabled())
+	{
+		for (int i = 0; i < MEMORY_CATEGORY_COUNT; ++i)
+		{
+			out << "  " << std::left << std::setw(12) << MemoryTracker::GetCategoryName(static_cast<MemoryCategory>(i))
+				<< std::right << std::setw(12) << ToKiB(sample->liveBytes[i]) << " KiB live, "
+				<< std::setw(12) << ToKiB(sample->peakBytes[i]) << " KiB peak, "
+				<< sample->allocations[i] << " blocks" << std::endl;
+		}
+	}
+	else
+	{
+		out << "  heap categories are not tracked, configure with TUTORIAL1_TRACK_MEMORY=ON" << std::endl;
+	}
+
+	out << "  " << std::left << std::setw(12) << "pixels" << std::right << std::setw(12)
+		<< ToKiB(sample->imageBytes) << " KiB decoded images" << std::endl;
+	out << "  " << std::left << std::setw(12) << "animations" << std::right << std::setw(12)
+		<< ToKiB(sample->animationBytes) << " KiB animation frames" << std::endl;
+	out << "  " << std::left << std::setw(12) << "process" << std::right << std::setw(12)
+		<< ToKiB(sample->residentBytes) << " KiB resident, "
+		<< std::setw(12) << ToKiB(sample->peakResidentBytes) << " KiB peak" << std::endl;
+
+	out.flags(flags);
+	out.precision(precision);
+}
+
+//!***************************************************************
+//! @details:
+//! writes every snapshot in the order they were taken
+//!
+//! @param[in]: out
+//! stream the report is written to
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void MemoryReport::PrintAll(std::ostream& out) const
+{
+	std::vector<Sample>::const_iterator it;
+	for (it = m_samples.begin(); it != m_samples.end(); ++it)
+	{
+		Print(out, it->label);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! writes how much every category grew between two snapshots,
+//! memory that keeps growing between two loads of the same map
+//! is what leaked
+//!
+//! @param[in]: out
+//! stream the report is written to
+//!
+//! @param[in]: from
+//! label of the earlier snapshot
+//!
+//! @param[in]: to
+//! label of the later snapshot
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void MemoryReport::PrintDelta(std::ostream& out, const std::string& from, const std::string& to) const
+{
+	const Sample* first = Find(from);
+	const Sample* second = Find(to);
+	if (!first || !second)
+	{
+		return;
+	}
+
+	std::ios::fmtflags flags = out.flags();
+	std::streamsize precision = out.precision();
+
+	out << std::fixed << std::setprecision(1) << std::showpos;
+	out << "memory delta " << first->label << " -> " << second->label << ":" << std::endl;
+
+	if (MemoryTracker::IsEnabled())
+	{
+		for (int i = 0; i < MEMORY_CATEGORY_COUNT; ++i)
+		{
+			long blocks = static_cast<long>(second->allocations[i]) - static_cast<long>(first->allocations[i]);
+
+			out << "  " << std::left << std::setw(12) << MemoryTracker::GetCategoryName(static_cast<MemoryCategory>(i))
+				<< std::right << std::setw(12) << DeltaKiB(first->liveBytes[i], second->liveBytes[i]) << " KiB live, "
+				<< blocks << " blocks" << std::endl;
+		}
+	}
+
+	out << "  " << std::left << std::setw(12) << "pixels" << std::right << std::setw(12)
+		<< DeltaKiB(first->imageBytes, second->imageBytes) << " KiB decoded images" << std::endl;
+	out << "  " << std::left << std::setw(12) << "animations" << std::right << std::setw(12)
+		<< DeltaKiB(first->animationBytes, second->animationBytes) << " KiB animation frames" << std::endl;
+	out << "  " << std::left << std::setw(12) << "process" << std::right << std::setw(12)
+		<< DeltaKiB(first->residentBytes, second->residentBytes) << " KiB resident" << std::endl;
+
+	out.flags(flags);
+	out.precision(precision);
+}
+
+//!***************************************************************
+//! @details:
+//! looks up a snapshot by its label
+//!
+//! @param[in]: label
+//! name of the snapshot
+//!
+//! @return:
+//! const Sample* - 0 if no snapshot has the label
+//!
+//!***************************************************************
+const MemoryReport::Sample* MemoryReport::Find(const std::string& label) const
+{
+	std::vector<Sample>::const_iterator it;
+	for (it = m_samples.begin(); it != m_samples.end(); ++it)
+	{
+		if (it->label == label)
+		{
+			return &(*it);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,59 @@
+//*****************************************************************************
+// FILE NAME:  MemoryReport.h
+//
+//*****************************************************************************
+#ifndef MEMORY_REPORT_H_
+#define MEMORY_REPORT_H_
+
+#include "MemoryTracker.h"
+
+// standard includes
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// forward declarations for fife classes
+namespace FIFE
+{
+	class ImageManager;
+	class AnimationManager;
+}
+
+//! memory use per subsystem taken at labelled points of the run
+class MemoryReport
+{
+public:
+	MemoryReport(FIFE::ImageManager* imageManager, FIFE::AnimationManager* animationManager);
+
+	void Snapshot(const std::string& label);
+	bool HasSnapshot(const std::string& label) const;
+	size_t GetSnapshotCount() const;
+	const std::string& GetLabel(size_t index) const;
+
+	void Print(std::ostream& out, const std::string& label) const;
+	void PrintAll(std::ostream& out) const;
+	void PrintDelta(std::ostream& out, const std::string& from, const std::string& to) const;
+
+private:
+	//! memory counters at one point of the run
+	struct Sample
+	{
+		std::string label;
+		size_t liveBytes[MEMORY_CATEGORY_COUNT];
+		size_t peakBytes[MEMORY_CATEGORY_COUNT];
+		size_t allocations[MEMORY_CATEGORY_COUNT];
+		size_t imageBytes;
+		size_t animationBytes;
+		size_t residentBytes;
+		size_t peakResidentBytes;
+	};
+
+	const Sample* Find(const std::string& label) const;
+
+private:
+	FIFE::ImageManager* m_imageManager;
+	FIFE::AnimationManager* m_animationManager;
+	std::vector<Sample> m_samples;
+};
+
+#endif
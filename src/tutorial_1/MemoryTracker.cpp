@@ -0,0 +1,340 @@
+//*****************************************************************************
+// FILE NAME:  MemoryTracker.cpp
+//
+//*****************************************************************************
+#include "MemoryTracker.h"
+
+// standard includes
+#include <cstdlib>
+#include <new>
+
+// 3rd party includes
+#include "SDL.h"
+
+#if defined(_MSC_VER)
+#define TRACKER_THREAD_LOCAL __declspec(thread)
+#else
+#define TRACKER_THREAD_LOCAL __thread
+#endif
+
+#if __cplusplus >= 201103L || defined(_MSC_VER)
+#define TRACKER_NEW_THROWS
+#define TRACKER_NO_THROW noexcept
+#else
+#define TRACKER_NEW_THROWS throw(std::bad_alloc)
+#define TRACKER_NO_THROW throw()
+#endif
+
+namespace
+{
+	const char* CategoryNames[MEMORY_CATEGORY_COUNT] =
+	{
+		"other",
+		"map",
+		"instances",
+		"images",
+		"gui"
+	};
+
+	// counters of one category, guarded by CounterLock
+	struct CategoryCounters
+	{
+		size_t live;
+		size_t peak;
+		size_t allocations;
+	};
+
+	// zero initialized before any constructor runs, so allocations
+	// made during static initialization are counted as well
+	CategoryCounters Counters[MEMORY_CATEGORY_COUNT];
+	size_t TotalAllocations = 0;
+	SDL_SpinLock CounterLock = 0;
+
+	TRACKER_THREAD_LOCAL MemoryCategory CurrentCategory = MEMORY_OTHER;
+
+#if defined(TUTORIAL1_TRACK_MEMORY)
+	// stored in front of every block, sized so the block after it
+	// keeps the alignment malloc gives
+	struct AllocationHeader
+	{
+		size_t size;
+		size_t category;
+	};
+
+	const size_t HeaderSize = (sizeof(AllocationHeader) + 15) & ~static_cast<size_t>(15);
+
+	void* Allocate(size_t size)
+	{
+		char* block = static_cast<char*>(std::malloc(size + HeaderSize));
+		if (!block)
+		{
+			return 0;
+		}
+
+		AllocationHeader* header = reinterpret_cast<AllocationHeader*>(block);
+		header->size = size;
+		header->category = CurrentCategory;
+
+		CategoryCounters& counters = Counters[CurrentCategory];
+		SDL_AtomicLock(&CounterLock);
+		counters.live += size;
+		counters.allocations++;
+		TotalAllocations++;
+		if (counters.live > counters.peak)
+		{
+			counters.peak = counters.live;
+		}
+		SDL_AtomicUnlock(&CounterLock);
+
+		return block + HeaderSize;
+	}
+
+	void Release(void* pointer)
+	{
+		if (!pointer)
+		{
+			return;
+		}
+
+		// charged to the category it was allocated in, which
+		// may differ from the one of the releasing thread
+		char* block = static_cast<char*>(pointer) - HeaderSize;
+		const AllocationHeader* header = reinterpret_cast<const AllocationHeader*>(block);
+
+		CategoryCounters& counters = Counters[header->category];
+		SDL_AtomicLock(&CounterLock);
+		counters.live -= header->size;
+		counters.allocations--;
+		SDL_AtomicUnlock(&CounterLock);
+
+		std::free(block);
+	}
+
+	void* AllocateOrThrow(size_t size)
+	{
+		for (;;)
+		{
+			void* pointer = Allocate(size);
+			if (pointer)
+			{
+				return pointer;
+			}
+
+			std::new_handler handler = std::set_new_handler(0);
+			std::set_new_handler(handler);
+			if (!handler)
+			{
+				throw std::bad_alloc();
+			}
+			handler();
+		}
+	}
+#endif
+}
+
+#if defined(TUTORIAL1_TRACK_MEMORY)
+void* operator new(std::size_t size) TRACKER_NEW_THROWS
+{
+	return AllocateOrThrow(size);
+}
+
+void* operator new[](std::size_t size) TRACKER_NEW_THROWS
+{
+	return AllocateOrThrow(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) TRACKER_NO_THROW
+{
+	return Allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) TRACKER_NO_THROW
+{
+	return Allocate(size);
+}
+
+void operator delete(void* pointer) TRACKER_NO_THROW
+{
+	Release(pointer);
+}
+
+void operator delete[](void* pointer) TRACKER_NO_THROW
+{
+	Release(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) TRACKER_NO_THROW
+{
+	Release(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) TRACKER_NO_THROW
+{
+	Release(pointer);
+}
+#endif
+
+//!***************************************************************
+//! @details:
+//! whether the allocations are counted in this build
+//!
+//! @return:
+//! bool
+//!
+//!***************************************************************
+bool MemoryTracker::IsEnabled()
+{
+#if defined(TUTORIAL1_TRACK_MEMORY)
+	return true;
+#else
+	return false;
+#endif
+}
+
+//!***************************************************************
+//! @details:
+//! name the category is reported under
+//!
+//! @param[in]: category
+//! the category
+//!
+//! @return:
+//! const char*
+//!
+//!***************************************************************
+const char* MemoryTracker::GetCategoryName(MemoryCategory category)
+{
+	return CategoryNames[category];
+}
+
+//!***************************************************************
+//! @details:
+//! heap bytes of the category that are allocated right now
+//!
+//! @param[in]: category
+//! the category
+//!
+//! @return:
+//! size_t
+//!
+//!***************************************************************
+size_t MemoryTracker::GetLiveBytes(MemoryCategory category)
+{
+	SDL_AtomicLock(&CounterLock);
+	size_t bytes = Counters[category].live;
+	SDL_AtomicUnlock(&CounterLock);
+
+	return bytes;
+}
+
+//!***************************************************************
+//! @details:
+//! most heap bytes the category had allocated at once
+//!
+//! @param[in]: category
+//! the category
+//!
+//! @return:
+//! size_t
+//!
+//!***************************************************************
+size_t MemoryTracker::GetPeakBytes(MemoryCategory category)
+{
+	SDL_AtomicLock(&CounterLock);
+	size_t bytes = Counters[category].peak;
+	SDL_AtomicUnlock(&CounterLock);
+
+	return bytes;
+}
+
+//!***************************************************************
+//! @details:
+//! number of blocks of the category that are not freed yet
+//!
+//! @param[in]: category
+//! the category
+//!
+//! @return:
+//! size_t
+//!
+//!***************************************************************
+size_t MemoryTracker::GetAllocationCount(MemoryCategory category)
+{
+	SDL_AtomicLock(&CounterLock);
+	size_t count = Counters[category].allocations;
+	SDL_AtomicUnlock(&CounterLock);
+
+	return count;
+}
+
+//!***************************************************************
+//! @details:
+//! number of allocations made since the start of the program,
+//! including the ones that are freed already
+//!
+//! @return:
+//! size_t
+//!
+//!***************************************************************
+size_t MemoryTracker::GetTotalAllocations()
+{
+	SDL_AtomicLock(&CounterLock);
+	size_t count = TotalAllocations;
+	SDL_AtomicUnlock(&CounterLock);
+
+	return count;
+}
+
+//!***************************************************************
+//! @details:
+//! category new allocations of this thread are charged to
+//!
+//! @return:
+//! MemoryCategory
+//!
+//!***************************************************************
+MemoryCategory MemoryTracker::GetCurrentCategory()
+{
+	return CurrentCategory;
+}
+
+//!***************************************************************
+//! @details:
+//! changes the category new allocations of this thread
+//! are charged to
+//!
+//! @param[in]: category
+//! the category
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void MemoryTracker::SetCurrentCategory(MemoryCategory category)
+{
+	CurrentCategory = category;
+}
+
+//!***************************************************************
+//! @details:
+//! constructor, switches this thread to the category
+//!
+//! @param[in]: category
+//! category the allocations in the scope are charged to
+//!
+//!***************************************************************
+MemoryScope::MemoryScope(MemoryCategory category)
+: m_previous(MemoryTracker::GetCurrentCategory())
+{
+	MemoryTracker::SetCurrentCategory(category);
+}
+
+//!***************************************************************
+//! @details:
+//! destructor, switches back to the enclosing category
+//!
+//!***************************************************************
+MemoryScope::~MemoryScope()
+{
+	MemoryTracker::SetCurrentCategory(m_previous);
+}
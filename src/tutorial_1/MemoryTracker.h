@@ -0,0 +1,54 @@
+//*****************************************************************************
+// FILE NAME:  MemoryTracker.h
+//
+//*****************************************************************************
+#ifndef MEMORY_TRACKER_H_
+#define MEMORY_TRACKER_H_
+
+#include <cstddef>
+
+//! subsystems the heap allocations are charged to
+enum MemoryCategory
+{
+	MEMORY_OTHER,
+	MEMORY_MAP,
+	MEMORY_INSTANCES,
+	MEMORY_IMAGES,
+	MEMORY_GUI,
+	MEMORY_CATEGORY_COUNT
+};
+
+//! live and peak heap bytes per category, only counted when the
+//! game is built with TUTORIAL1_TRACK_MEMORY, which replaces the
+//! global operator new and delete
+namespace MemoryTracker
+{
+	bool IsEnabled();
+	const char* GetCategoryName(MemoryCategory category);
+
+	size_t GetLiveBytes(MemoryCategory category);
+	size_t GetPeakBytes(MemoryCategory category);
+	size_t GetAllocationCount(MemoryCategory category);
+	size_t GetTotalAllocations();
+
+	MemoryCategory GetCurrentCategory();
+	void SetCurrentCategory(MemoryCategory category);
+}
+
+//! charges the allocations made on this thread while it
+//! exists to one category, scopes may be nested
+class MemoryScope
+{
+public:
+	explicit MemoryScope(MemoryCategory category);
+	~MemoryScope();
+
+private:
+	MemoryScope(const MemoryScope&);
+	MemoryScope& operator=(const MemoryScope&);
+
+private:
+	MemoryCategory m_previous;
+};
+
+#endif
@@ -0,0 +1,604 @@
+//*****************************************************************************
+// FILE NAME:  Minimap.cpp
+//
+//*****************************************************************************
+#include "Minimap.h"
+
+// fife includes
+#include "model/structures/instance.h"
+#include "model/structures/map.h"
+#include "util/structures/point.h"
+#include "video/imagemanager.h"
+#include "video/renderbackend.h"
+#include "view/camera.h"
+
+// 3rd party library includes
+#include "SDL.h"
+
+// standard includes
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	// draws after the other renderers of the top layer, below the hud
+	const int PipelinePosition = 1500;
+
+	// side of a character marker in pixels
+	const int MarkerSize = 4;
+
+	// colour of each marker kind
+	const uint8_t MarkerColors[Minimap::MARKER_KIND_COUNT][3] =
+	{
+		{ 64, 224, 64 },
+		{ 240, 200, 64 },
+		{ 224, 64, 64 }
+	};
+
+	// frame around the minimap
+	const uint8_t BorderAlpha = 192;
+}
+
+//!***************************************************************
+//! @details:
+//! constructor, the minimap belongs to the camera it is added to.
+//! the small camera is switched off so the engine never renders
+//! it and its viewport is shrunk to the texture it renders into
+//!
+//! @param[in]: renderBackend
+//! backend the minimap is drawn with
+//!
+//! @param[in]: imageManager
+//! image manager that owns the minimap texture
+//!
+//! @param[in]: camera
+//! the map's small camera, its viewport is where the minimap shows
+//!
+//! @param[in]: scale
+//! resolution of the texture relative to the viewport
+//!
+//! @param[in]: refreshRate
+//! most times per second the texture is rendered again
+//!
+//!***************************************************************
+Minimap::Minimap(FIFE::RenderBackend* renderBackend, FIFE::ImageManager* imageManager, FIFE::Camera* camera,
+	double scale, double refreshRate)
+: FIFE::RendererBase(renderBackend, PipelinePosition), m_imageManager(imageManager), m_camera(camera),
+  m_area(camera->getViewPort()), m_textureWidth(1), m_textureHeight(1), m_scale(scale), m_refreshRate(refreshRate),
+  m_refreshPeriod(0), m_lastRefresh(0), m_classified(false), m_staticChanged(true),
+  m_batched(renderBackend->getName() == "OpenGL"), m_refreshes(0), m_staticRefreshes(0), m_frames(0),
+  m_renderStats(0)
+{
+	assert(m_scale > 0.0 && m_refreshRate > 0.0);
+
+	m_textureWidth = std::max(1, static_cast<int>(m_area.w * m_scale + 0.5));
+	m_textureHeight = std::max(1, static_cast<int>(m_area.h * m_scale + 0.5));
+	m_refreshPeriod = static_cast<uint32_t>(1000.0 / m_refreshRate);
+
+	// the zoom shrinks with the viewport so the texture shows the
+	// same part of the map the viewport would
+	m_camera->setEnabled(false);
+	m_camera->setViewPort(FIFE::Rect(0, 0, m_textureWidth, m_textureHeight));
+	if (m_area.w > 0)
+	{
+		m_camera->setZoom(m_camera->getZoom() * m_textureWidth / m_area.w);
+	}
+
+	setEnabled(true);
+}
+
+//!***************************************************************
+//! @details:
+//! destructor, frees the texture and stops listening to the layers
+//!
+//!***************************************************************
+Minimap::~Minimap()
+{
+	if (m_texture.get())
+	{
+		m_imageManager->remove(m_texture);
+	}
+
+	for (std::vector<FIFE::Layer*>::const_iterator it = m_layers.begin(); it != m_layers.end(); ++it)
+	{
+		(*it)->removeChangeListener(this);
+	}
+	m_layers.clear();
+}
+
+//!***************************************************************
+//! @details:
+//! draws the minimap once per frame, after the map's top layer,
+//! and listens to the layers the texture is rendered from
+//!
+//! @param[in]: map
+//! map shown by the camera the minimap was added to
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void Minimap::Attach(FIFE::Map* map)
+{
+	const std::list<FIFE::Layer*>& layers = map->getLayers();
+	if (!layers.empty())
+	{
+		addActiveLayer(layers.back());
+	}
+
+	for (std::list<FIFE::Layer*>::const_iterator it = layers.begin(); it != layers.end(); ++it)
+	{
+		(*it)->addChangeListener(this);
+		m_layers.push_back(*it);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! shows a character as a marker on top of the texture. a layer
+//! holding a marked character is left out of the texture
+//!
+//! @param[in]: instance
+//! the character
+//!
+//! @param[in]: kind
+//! picks the colour of the marker
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void Minimap::AddMarker(FIFE::Instance* instance, MarkerKind kind)
+{
+	if (!instance)
+	{
+		return;
+	}
+
+	Marker marker;
+	marker.instance = instance;
+	marker.kind = kind;
+	m_markers.push_back(marker);
+}
+
+//!***************************************************************
+//! @details:
+//! hands the cost of drawing the minimap to the render statistics
+//!
+//! @param[in]: renderStats
+//! the camera's render statistics, may be 0
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void Minimap::SetRenderStats(RenderStats* renderStats)
+{
+	m_renderStats = renderStats;
+}
+
+//!***************************************************************
+//! @details:
+//! whether a static layer changed since the texture was rendered,
+//! the next refresh shows the change
+//!
+//! @return:
+//! bool
+//!
+//!***************************************************************
+bool Minimap::HasPendingChanges() const
+{
+	return m_staticChanged;
+}
+
+//!***************************************************************
+//! @details:
+//! width of the texture in pixels
+//!
+//! @return:
+//! int
+//!
+//!***************************************************************
+int Minimap::GetTextureWidth() const
+{
+	return m_textureWidth;
+}
+
+//!***************************************************************
+//! @details:
+//! height of the texture in pixels
+//!
+//! @return:
+//! int
+//!
+//!***************************************************************
+int Minimap::GetTextureHeight() const
+{
+	return m_textureHeight;
+}
+
+//!***************************************************************
+//! @details:
+//! number of layers rendered into the texture
+//!
+//! @return:
+//! int
+//!
+//!***************************************************************
+int Minimap::GetStaticLayerCount() const
+{
+	return static_cast<int>(m_staticLayers.size());
+}
+
+//!***************************************************************
+//! @details:
+//! number of characters shown as markers
+//!
+//! @return:
+//! int
+//!
+//!***************************************************************
+int Minimap::GetMarkerCount() const
+{
+	return static_cast<int>(m_markers.size());
+}
+
+//!***************************************************************
+//! @details:
+//! number of times the texture was rendered
+//!
+//! @return:
+//! unsigned long
+//!
+//!***************************************************************
+unsigned long Minimap::GetRefreshes() const
+{
+	return m_refreshes;
+}
+
+//!***************************************************************
+//! @details:
+//! number of times the texture was rendered because a static
+//! layer changed
+//!
+//! @return:
+//! unsigned long
+//!
+//!***************************************************************
+unsigned long Minimap::GetStaticRefreshes() const
+{
+	return m_staticRefreshes;
+}
+
+//!***************************************************************
+//! @details:
+//! number of frames the minimap was drawn in
+//!
+//! @return:
+//! unsigned long
+//!
+//!***************************************************************
+unsigned long Minimap::GetFrames() const
+{
+	return m_frames;
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @return:
+//! FIFE::RendererBase*
+//!
+//!***************************************************************
+FIFE::RendererBase* Minimap::clone()
+{
+	return new Minimap(m_renderbackend, m_imageManager, m_camera, m_scale, m_refreshRate);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, renders the texture again when it
+//! is due and draws it with the markers into the small camera's
+//! viewport
+//!
+//! @param[in]: camera
+//! camera that is rendering
+//!
+//! @param[in]: layer
+//! the top layer of the map
+//!
+//! @param[in]: instances
+//! visible instances of the layer, not used
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void Minimap::render(FIFE::Camera* camera, FIFE::Layer* layer, FIFE::RenderList& instances)
+{
+	m_counters = RenderCounters();
+
+	uint32_t now = SDL_GetTicks();
+	if (IsDue(camera, now))
+	{
+		Refresh(camera, now);
+	}
+
+	if (!m_texture.get())
+	{
+		return;
+	}
+
+	m_texture->render(m_area);
+	++m_counters.considered;
+	++m_counters.drawn;
+	++m_counters.drawCalls;
+	++m_counters.textureBinds;
+	m_counters.vertices += RenderCounters::VerticesPerQuad;
+
+	DrawMarkers();
+
+	m_renderbackend->drawRectangle(FIFE::Point(m_area.x, m_area.y), static_cast<uint16_t>(m_area.w),
+		static_cast<uint16_t>(m_area.h), 255, 255, 255, BorderAlpha);
+
+	++m_frames;
+
+	if (m_renderStats)
+	{
+		m_renderStats->Record("Minimap", layer, m_counters);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @return:
+//! std::string
+//!
+//!***************************************************************
+std::string Minimap::getName()
+{
+	return "Minimap";
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, a change to a static layer renders
+//! the texture again at the next refresh
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void Minimap::onLayerChanged(FIFE::Layer* layer, std::vector<FIFE::Instance*>& changedInstances)
+{
+	if (m_staticLayers.find(layer) != m_staticLayers.end())
+	{
+		m_staticChanged = true;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void Minimap::onInstanceCreate(FIFE::Layer* layer, FIFE::Instance* instance)
+{
+	if (m_staticLayers.find(layer) != m_staticLayers.end())
+	{
+		m_staticChanged = true;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, a deleted character loses its
+//! marker
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void Minimap::onInstanceDelete(FIFE::Layer* layer, FIFE::Instance* instance)
+{
+	if (m_staticLayers.find(layer) != m_staticLayers.end())
+	{
+		m_staticChanged = true;
+	}
+
+	for (std::vector<Marker>::iterator it = m_markers.begin(); it != m_markers.end();)
+	{
+		if (it->instance == instance)
+		{
+			it = m_markers.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! picks the layers the texture is rendered from. a layer is
+//! static when it holds no marked character and none of its
+//! instances plays an action. this waits for the first refresh
+//! so the characters have their markers and actions by then
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void Minimap::Classify()
+{
+	m_classified = true;
+
+	std::set<FIFE::Layer*> markedLayers;
+	for (std::vector<Marker>::const_iterator it = m_markers.begin(); it != m_markers.end(); ++it)
+	{
+		markedLayers.insert(it->instance->getLocationRef().getLayer());
+	}
+
+	FIFE::RendererBase* instanceRenderer = m_camera->getRenderer("InstanceRenderer");
+	if (!instanceRenderer)
+	{
+		return;
+	}
+
+	for (std::vector<FIFE::Layer*>::const_iterator layer = m_layers.begin(); layer != m_layers.end(); ++layer)
+	{
+		if (markedLayers.find(*layer) != markedLayers.end())
+		{
+			continue;
+		}
+
+		bool animated = false;
+		const std::vector<FIFE::Instance*>& instances = (*layer)->getInstances();
+		for (std::vector<FIFE::Instance*>::const_iterator it = instances.begin(); it != instances.end() && !animated; ++it)
+		{
+			animated = ((*it)->getCurrentAction() != 0);
+		}
+
+		if (!animated)
+		{
+			m_staticLayers.insert(*layer);
+			instanceRenderer->addActiveLayer(*layer);
+		}
+	}
+
+	instanceRenderer->setEnabled(true);
+}
+
+//!***************************************************************
+//! @details:
+//! whether the texture has to be rendered again. it is rendered
+//! at most once per refresh period, and then only when the main
+//! camera moved or a static layer changed
+//!
+//! @param[in]: mainCamera
+//! the camera the minimap follows
+//!
+//! @param[in]: time
+//! ticks of this frame
+//!
+//! @return:
+//! bool
+//!
+//!***************************************************************
+bool Minimap::IsDue(FIFE::Camera* mainCamera, uint32_t time) const
+{
+	if (m_refreshes > 0 && time - m_lastRefresh < m_refreshPeriod)
+	{
+		return false;
+	}
+
+	if (m_staticChanged)
+	{
+		return true;
+	}
+
+	FIFE::ExactModelCoordinate position = mainCamera->getLocationRef().getMapCoordinates();
+	return position.x != m_followed.x || position.y != m_followed.y;
+}
+
+//!***************************************************************
+//! @details:
+//! centres the small camera on the main camera and renders its
+//! static layers into the texture
+//!
+//! @param[in]: mainCamera
+//! the camera the minimap follows
+//!
+//! @param[in]: time
+//! ticks of this frame
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void Minimap::Refresh(FIFE::Camera* mainCamera, uint32_t time)
+{
+	if (!m_classified)
+	{
+		Classify();
+	}
+
+	if (!m_texture.get())
+	{
+		m_texture = m_imageManager->loadBlank(m_textureWidth, m_textureHeight);
+	}
+
+	m_followed = mainCamera->getLocationRef().getMapCoordinates();
+
+	FIFE::Location location = m_camera->getLocation();
+	location.setMapCoordinates(m_followed);
+	m_camera->setLocation(location);
+
+	// the engine skips the disabled camera, it is updated and
+	// rendered here instead
+	m_camera->update();
+	m_renderbackend->attachRenderTarget(m_texture, true);
+	m_camera->render();
+	m_renderbackend->detachRenderTarget();
+
+	if (m_staticChanged && m_refreshes > 0)
+	{
+		++m_staticRefreshes;
+	}
+
+	m_staticChanged = false;
+	m_lastRefresh = time;
+	++m_refreshes;
+
+	// switching to the texture and back
+	m_counters.stateSwitches += 2;
+}
+
+//!***************************************************************
+//! @details:
+//! draws a marker where each character stands in the texture,
+//! scaled up to the viewport. markers outside of it are culled
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void Minimap::DrawMarkers()
+{
+	unsigned long drawn = 0;
+
+	for (std::vector<Marker>::const_iterator it = m_markers.begin(); it != m_markers.end(); ++it)
+	{
+		++m_counters.considered;
+
+		// the small camera keeps the transform of the last refresh
+		FIFE::ScreenPoint point = m_camera->toScreenCoordinates(it->instance->getLocationRef().getMapCoordinates());
+		int x = m_area.x + point.x * m_area.w / m_textureWidth - MarkerSize / 2;
+		int y = m_area.y + point.y * m_area.h / m_textureHeight - MarkerSize / 2;
+
+		if (x < m_area.x || y < m_area.y || x + MarkerSize > m_area.right() || y + MarkerSize > m_area.bottom())
+		{
+			++m_counters.culled;
+			continue;
+		}
+
+		const uint8_t* color = MarkerColors[it->kind];
+		m_renderbackend->fillRectangle(FIFE::Point(x, y), MarkerSize, MarkerSize, color[0], color[1], color[2]);
+		++drawn;
+	}
+
+	if (drawn > 0)
+	{
+		// untextured quads, the OpenGL backend batches them together
+		m_counters.drawn += drawn;
+		m_counters.drawCalls += m_batched ? 1 : drawn;
+		m_counters.vertices += RenderCounters::VerticesPerQuad * drawn;
+	}
+}
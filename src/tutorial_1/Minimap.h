@@ -0,0 +1,110 @@
+//*****************************************************************************
+// FILE NAME:  Minimap.h
+//
+//*****************************************************************************
+#ifndef MINIMAP_H_
+#define MINIMAP_H_
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "model/structures/layer.h"
+#include "model/structures/location.h"
+#include "util/structures/rect.h"
+#include "video/image.h"
+#include "view/rendererbase.h"
+
+#include "RenderStats.h"
+
+namespace FIFE
+{
+	class Camera;
+	class ImageManager;
+	class Instance;
+	class Map;
+	class RenderBackend;
+}
+
+//! shows the map's small camera in its viewport without the engine
+//! rendering a second view every frame. the static layers are rendered
+//! through the small camera into a texture of reduced resolution, at
+//! most a few times a second and only once the main camera moved or a
+//! static layer changed. every frame draws that texture scaled up and
+//! a small marker for each character on top of it
+class Minimap : public FIFE::RendererBase, public FIFE::LayerChangeListener
+{
+public:
+	enum MarkerKind
+	{
+		MARKER_PLAYER,
+		MARKER_NPC,
+		MARKER_AGENT,
+		MARKER_KIND_COUNT
+	};
+
+	Minimap(FIFE::RenderBackend* renderBackend, FIFE::ImageManager* imageManager, FIFE::Camera* camera,
+		double scale, double refreshRate);
+	~Minimap();
+
+	void Attach(FIFE::Map* map);
+	void AddMarker(FIFE::Instance* instance, MarkerKind kind);
+	void SetRenderStats(RenderStats* renderStats);
+
+	bool HasPendingChanges() const;
+	int GetTextureWidth() const;
+	int GetTextureHeight() const;
+	int GetStaticLayerCount() const;
+	int GetMarkerCount() const;
+	unsigned long GetRefreshes() const;
+	unsigned long GetStaticRefreshes() const;
+	unsigned long GetFrames() const;
+
+	// overridden from base class
+	virtual FIFE::RendererBase* clone();
+	virtual void render(FIFE::Camera* camera, FIFE::Layer* layer, FIFE::RenderList& instances);
+	virtual std::string getName();
+
+	virtual void onLayerChanged(FIFE::Layer* layer, std::vector<FIFE::Instance*>& changedInstances);
+	virtual void onInstanceCreate(FIFE::Layer* layer, FIFE::Instance* instance);
+	virtual void onInstanceDelete(FIFE::Layer* layer, FIFE::Instance* instance);
+private:
+	struct Marker
+	{
+		FIFE::Instance* instance;
+		MarkerKind kind;
+	};
+
+	Minimap(const Minimap&);
+	Minimap& operator=(const Minimap&);
+
+	void Classify();
+	bool IsDue(FIFE::Camera* mainCamera, uint32_t time) const;
+	void Refresh(FIFE::Camera* mainCamera, uint32_t time);
+	void DrawMarkers();
+private:
+	FIFE::ImageManager* m_imageManager;
+	FIFE::Camera* m_camera;
+	FIFE::Rect m_area;
+	FIFE::ImagePtr m_texture;
+	int m_textureWidth;
+	int m_textureHeight;
+	double m_scale;
+	double m_refreshRate;
+	uint32_t m_refreshPeriod;
+	uint32_t m_lastRefresh;
+	std::vector<FIFE::Layer*> m_layers;
+	std::set<FIFE::Layer*> m_staticLayers;
+	std::vector<Marker> m_markers;
+	FIFE::ExactModelCoordinate m_followed;
+	bool m_classified;
+	bool m_staticChanged;
+	bool m_batched;
+	unsigned long m_refreshes;
+	unsigned long m_staticRefreshes;
+	unsigned long m_frames;
+	RenderStats* m_renderStats;
+	RenderCounters m_counters;
+};
+
+#endif
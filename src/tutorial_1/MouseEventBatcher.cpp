@@ -0,0 +1,322 @@
+//*****************************************************************************
+// FILE NAME:  MouseEventBatcher.cpp
+//
+//*****************************************************************************
+#include "MouseEventBatcher.h"
+
+// standard includes
+#include <cassert>
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: target
+//! the listener the events are handed on to
+//!
+//!***************************************************************
+MouseEventBatcher::MouseEventBatcher(FIFE::IMouseListener* target)
+: m_target(target), m_hasPending(false), m_coalescedEvents(0)
+{
+	assert(m_target);
+
+	// flush every frame, after the input events were processed
+	setPeriod(0);
+}
+
+//!***************************************************************
+//! @details:
+//! destructor
+//!
+//!***************************************************************
+MouseEventBatcher::~MouseEventBatcher()
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! hands the held motion or drag event on
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseEventBatcher::Flush()
+{
+	if (!m_hasPending)
+	{
+		return;
+	}
+
+	m_hasPending = false;
+
+	if (m_pending.getType() == FIFE::MouseEvent::DRAGGED)
+	{
+		m_target->mouseDragged(m_pending);
+	}
+	else
+	{
+		m_target->mouseMoved(m_pending);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! number of motion and drag events that were replaced by a later
+//! one of the same frame
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int MouseEventBatcher::GetCoalescedEvents() const
+{
+	return m_coalescedEvents;
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, the held motion is handed on
+//! first so the target sees the events in order
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseEventBatcher::mouseEntered(FIFE::MouseEvent& evt)
+{
+	Flush();
+	m_target->mouseEntered(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, the held motion is handed on
+//! first so the target sees the events in order
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseEventBatcher::mouseExited(FIFE::MouseEvent& evt)
+{
+	Flush();
+	m_target->mouseExited(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, the held motion is handed on
+//! first so the target sees the events in order
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseEventBatcher::mousePressed(FIFE::MouseEvent& evt)
+{
+	Flush();
+	m_target->mousePressed(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, the held motion is handed on
+//! first so the target sees the events in order
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseEventBatcher::mouseReleased(FIFE::MouseEvent& evt)
+{
+	Flush();
+	m_target->mouseReleased(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, the held motion is handed on
+//! first so the target sees the events in order
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseEventBatcher::mouseClicked(FIFE::MouseEvent& evt)
+{
+	Flush();
+	m_target->mouseClicked(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, the held motion is handed on
+//! first so the target sees the events in order
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseEventBatcher::mouseWheelMovedUp(FIFE::MouseEvent& evt)
+{
+	Flush();
+	m_target->mouseWheelMovedUp(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, the held motion is handed on
+//! first so the target sees the events in order
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseEventBatcher::mouseWheelMovedDown(FIFE::MouseEvent& evt)
+{
+	Flush();
+	m_target->mouseWheelMovedDown(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, the held motion is handed on
+//! first so the target sees the events in order
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseEventBatcher::mouseWheelMovedRight(FIFE::MouseEvent& evt)
+{
+	Flush();
+	m_target->mouseWheelMovedRight(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, the held motion is handed on
+//! first so the target sees the events in order
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseEventBatcher::mouseWheelMovedLeft(FIFE::MouseEvent& evt)
+{
+	Flush();
+	m_target->mouseWheelMovedLeft(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, motion is held until the end of
+//! the frame
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseEventBatcher::mouseMoved(FIFE::MouseEvent& evt)
+{
+	Hold(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, drags are held until the end of
+//! the frame, the target works out the drag distance from the
+//! last position it saw, so the latest drag covers all of them
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseEventBatcher::mouseDragged(FIFE::MouseEvent& evt)
+{
+	Hold(evt);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, called by the time manager once
+//! per frame
+//!
+//! @param[in]: time
+//! current engine time in ms
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseEventBatcher::updateEvent(uint32_t time)
+{
+	Flush();
+}
+
+//!***************************************************************
+//! @details:
+//! keeps a motion or drag event, replacing a held event of the
+//! same kind, a different kind is handed on first
+//!
+//! @param[in]: evt
+//! motion or drag event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseEventBatcher::Hold(FIFE::MouseEvent& evt)
+{
+	if (m_hasPending)
+	{
+		// a drag that turns into a move and the other way round
+		// are kept apart, the target treats them differently
+		if (m_pending.getType() == evt.getType() && m_pending.getButton() == evt.getButton())
+		{
+			++m_coalescedEvents;
+		}
+		else
+		{
+			Flush();
+		}
+	}
+
+	m_pending = evt;
+	m_hasPending = true;
+}
@@ -0,0 +1,49 @@
+//*****************************************************************************
+// FILE NAME:  MouseEventBatcher.h
+//
+//*****************************************************************************
+#ifndef MOUSE_EVENT_BATCHER_H_
+#define MOUSE_EVENT_BATCHER_H_
+
+#include "eventchannel/mouse/imouselistener.h"
+#include "eventchannel/mouse/mouseevent.h"
+#include "util/base/fife_stdint.h"
+#include "util/time/timeevent.h"
+
+//! sits between the event manager and a mouse listener, motion and
+//! drag events of a frame are collapsed to the latest one and handed
+//! on once per frame, all other events pass straight through
+class MouseEventBatcher : public FIFE::IMouseListener, public FIFE::TimeEvent
+{
+public:
+	explicit MouseEventBatcher(FIFE::IMouseListener* target);
+	~MouseEventBatcher();
+
+	void Flush();
+	int GetCoalescedEvents() const;
+
+	// overridden from base class
+	virtual void mouseEntered(FIFE::MouseEvent& evt);
+	virtual void mouseExited(FIFE::MouseEvent& evt);
+	virtual void mousePressed(FIFE::MouseEvent& evt);
+	virtual void mouseReleased(FIFE::MouseEvent& evt);
+	virtual void mouseClicked(FIFE::MouseEvent& evt);
+	virtual void mouseWheelMovedUp(FIFE::MouseEvent& evt);
+	virtual void mouseWheelMovedDown(FIFE::MouseEvent& evt);
+	virtual void mouseWheelMovedRight(FIFE::MouseEvent& evt);
+	virtual void mouseWheelMovedLeft(FIFE::MouseEvent& evt);
+	virtual void mouseMoved(FIFE::MouseEvent& evt);
+	virtual void mouseDragged(FIFE::MouseEvent& evt);
+protected:
+	// overridden from base class
+	virtual void updateEvent(uint32_t time);
+private:
+	void Hold(FIFE::MouseEvent& evt);
+private:
+	FIFE::IMouseListener* m_target;
+	FIFE::MouseEvent m_pending;
+	bool m_hasPending;
+	int m_coalescedEvents;
+};
+
+#endif
@@ -1,330 +1,487 @@
-//*****************************************************************************
-// FILE NAME:  MouseListener.cpp
-//
-//*****************************************************************************
-// standard includes
-#include <iostream>
-
-// fife includes
-#include "eventchannel/mouse/mouseevent.h"
-#include "model/metamodel/modelcoords.h"
-#include "model/structures/location.h"
-#include "util/structures/rect.h"
-#include "model/structures/instance.h"
-#include "view/camera.h"
-
-#include "Game.h"
-#include "ViewController.h"
-#include "MouseListener.h"
-
-//!***************************************************************
-//! @details:
-//! constructor
-//!
-//! @param[in]: parent
-//! the game object that created this listener
-//!
-//! @param[in]: cam
-//! the camera for manipulation
-//!
-//! @param[in]: eventManager
-//! the engine event manager for registering for events
-//! 
-//!***************************************************************
-MouseListener::MouseListener(Game* parent, FIFE::Camera *cam, FIFE::EventManager* eventManager, FIFE::TimeManager* timeManager)
-: m_parent(parent), m_dragX(0), m_dragY(0), m_camera(cam), m_autoscreenscroller(cam, eventManager, timeManager),
-  m_controller(0), m_prevEventType(FIFE::MouseEvent::UNKNOWN_EVENT)
-{
-
-}
-
-//!***************************************************************
-//! @details:
-//! destructor
-//!
-//!***************************************************************
-MouseListener::~MouseListener()
-{
-
-}
-
-//!***************************************************************
-//! @details:
-//! overridden from base class
-//!
-//! @param[in]: evt
-//! signaled event
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void MouseListener::mouseEntered(FIFE::MouseEvent& evt)
-{
-	SetPreviousMouseEvent(evt.getType());
-}
-
-//!***************************************************************
-//! @details:
-//! overridden from base class
-//!
-//! @param[in]: evt
-//! signaled event
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void MouseListener::mouseExited(FIFE::MouseEvent& evt)
-{
-	SetPreviousMouseEvent(evt.getType());
-}
-
-//!***************************************************************
-//! @details:
-//! overridden from base class
-//!
-//! @param[in]: evt
-//! signaled event
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void MouseListener::mousePressed(FIFE::MouseEvent& evt)
-{
-	if (evt.getButton() == FIFE::MouseEvent::LEFT)
-	{
-		// save mouse position
-		m_dragX = evt.getX();
-		m_dragY = evt.getY();
-	}
-
-	SetPreviousMouseEvent(evt.getType());
-}
-
-//!***************************************************************
-//! @details:
-//! overridden from base class
-//!
-//! @param[in]: evt
-//! signaled event
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void MouseListener::mouseReleased(FIFE::MouseEvent& evt)
-{
-	// only activate the move action if the mouse was pressed and released without dragging
-	if (m_controller && evt.getButton() == FIFE::MouseEvent::LEFT && m_prevEventType != FIFE::MouseEvent::DRAGGED)
-	{
-		// move controller to clicked spot
-		FIFE::Location destination(m_controller->getLocation());
-		FIFE::ScreenPoint screenPoint(evt.getX(), evt.getY());
-		FIFE::ExactModelCoordinate mapCoords = m_camera->toMapCoordinates(screenPoint, false);
-		mapCoords.z = 0.0;
-		destination.setMapCoordinates(mapCoords);
-		m_controller->move("walk", destination, m_controller->getTotalTimeMultiplier());
-	}
-
-	SetPreviousMouseEvent(evt.getType());
-}
-
-//!***************************************************************
-//! @details:
-//! overridden from base class
-//!
-//! @param[in]: evt
-//! signaled event
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void MouseListener::mouseClicked(FIFE::MouseEvent& evt)
-{
-	// this event never seems to fire, not sure if it works properly
-	// I suspect this would remove the need for my keeping track of the previous
-	// event for dragging vs. releasing if this event signifies what I think
-
-	SetPreviousMouseEvent(evt.getType());
-}
-
-//!***************************************************************
-//! @details:
-//! overridden from base class
-//!
-//! @param[in]: evt
-//! signaled event
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void MouseListener::mouseWheelMovedUp(FIFE::MouseEvent& evt)
-{
-	// zoom in
-	m_parent->GetViewController()->ZoomIn();
-
-	// save mouse position
-	m_dragX = evt.getX();
-	m_dragY = evt.getY();
-
-	SetPreviousMouseEvent(evt.getType());
-}
-
-//!***************************************************************
-//! @details:
-//! overridden from base class
-//!
-//! @param[in]: evt
-//! signaled event
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void MouseListener::mouseWheelMovedDown(FIFE::MouseEvent& evt)
-{
-	// zoom out
-	m_parent->GetViewController()->ZoomOut();
-
-	SetPreviousMouseEvent(evt.getType());
-}
-
-//!***************************************************************
-//! @details:
-//! overridden from base class
-//!
-//! @param[in]: evt
-//! signaled event
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void MouseListener::mouseWheelMovedRight(FIFE::MouseEvent& evt)
-{
-	SetPreviousMouseEvent(evt.getType());
-}
-
-//!***************************************************************
-//! @details:
-//! overridden from base class
-//!
-//! @param[in]: evt
-//! signaled event
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void MouseListener::mouseWheelMovedLeft(FIFE::MouseEvent& evt)
-{
-	SetPreviousMouseEvent(evt.getType());
-}
-
-//!***************************************************************
-//! @details:
-//! overridden from base class
-//!
-//! @param[in]: evt
-//! signaled event
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void MouseListener::mouseMoved(FIFE::MouseEvent& evt)
-{
-	m_autoscreenscroller.updateLocation(evt.getX(), evt.getY());
-
-	SetPreviousMouseEvent(evt.getType());
-}
-
-//!***************************************************************
-//! @details:
-//! overridden from base class
-//!
-//! @param[in]: evt
-//! signaled event
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void MouseListener::mouseDragged(FIFE::MouseEvent& evt)
-{
-	if (evt.getButton() == FIFE::MouseEvent::LEFT)
-	{
-		// unregister the auto-scrolling event
-		// we are now scrolling manually and do not
-		// want both trying to do it at the same time
-		m_autoscreenscroller.unregisterEvent();
-
-		// get the screen coordinates of the mouse
-		int currX = evt.getX();
-		int currY = evt.getY();
-
-		// get the mouse delta for camera movement
-		FIFE::ScreenPoint delta(m_dragX - currX, m_dragY - currY);
-
-		// get the current camera location
-		FIFE::ScreenPoint cameraScreenCoords = m_camera->toScreenCoordinates(m_camera->getLocation().getMapCoordinates());
-		cameraScreenCoords += delta;
-
-		// set the new coordinates
-		FIFE::Location camLocation(m_camera->getLocation());
-		FIFE::ExactModelCoordinate mapCoords = m_camera->toMapCoordinates(cameraScreenCoords, false);
-		mapCoords.z = 0.0;
-		camLocation.setMapCoordinates(mapCoords);
-		m_camera->setLocation(camLocation);
-
-		// update last saved x,y values for dragging
-		m_dragX = currX;
-		m_dragY = currY;
-	}
-
-	// make sure to save that the last event was drag
-	// this is important to get around the drag & click problem
-	SetPreviousMouseEvent(evt.getType());
-}
-
-//!***************************************************************
-//! @details:
-//! store the character we want to move with our mouse
-//!
-//! @param[in]: controller
-//! the character to manipulate
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void MouseListener::SetController(FIFE::Instance* controller)
-{
-	m_controller = controller;
-}
-
-//!***************************************************************
-//! @details:
-//! saves the last action that was received
-//! this is done to make sure we can distinguish between dragging
-//! and clicking since they do 2 different things
-//!
-//! if we do not keep track we will drag and then when we release
-//! it will perform the action for the mouse release as well as
-//! the mouse dragged
-//!
-//! @param[in]: type
-//! event type
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void MouseListener::SetPreviousMouseEvent(FIFE::MouseEvent::MouseEventType type)
-{
-	m_prevEventType = type;
+//*****************************************************************************
+// FILE NAME:  MouseListener.cpp
+//
+//*****************************************************************************
+// standard includes
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// fife includes
+#include "eventchannel/mouse/mouseevent.h"
+#include "model/metamodel/modelcoords.h"
+#include "model/structures/location.h"
+#include "util/structures/rect.h"
+#include "model/structures/instance.h"
+#include "view/camera.h"
+#include "view/renderers/instancerenderer.h"
+
+#include "Game.h"
+#include "ViewController.h"
+#include "MouseListener.h"
+#include "Profiler.h"
+#include "InstancePicker.h"
+#include "RouteFollower.h"
+
+namespace
+{
+	// mouse travel in pixels below which a box select counts as a click
+	const int BoxSelectThreshold = 4;
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: parent
+//! the game object that created this listener
+//!
+//! @param[in]: cam
+//! the camera for manipulation
+//!
+//! @param[in]: eventManager
+//! the engine event manager for registering for events
+//! 
+//!***************************************************************
+MouseListener::MouseListener(Game* parent, FIFE::Camera *cam, FIFE::EventManager* eventManager, FIFE::TimeManager* timeManager)
+: m_parent(parent), m_dragX(0), m_dragY(0), m_camera(cam), m_autoscreenscroller(cam, parent->GetViewController(), eventManager, timeManager),
+  m_controller(0), m_picker(0), m_routeFollower(0), m_selectX(0), m_selectY(0), m_prevEventType(FIFE::MouseEvent::UNKNOWN_EVENT)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! destructor
+//!
+//!***************************************************************
+MouseListener::~MouseListener()
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseListener::mouseEntered(FIFE::MouseEvent& evt)
+{
+	SetPreviousMouseEvent(evt.getType());
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseListener::mouseExited(FIFE::MouseEvent& evt)
+{
+	SetPreviousMouseEvent(evt.getType());
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseListener::mousePressed(FIFE::MouseEvent& evt)
+{
+	ScopedTimer timer(PHASE_INPUT);
+
+	if (evt.getButton() == FIFE::MouseEvent::LEFT)
+	{
+		// save mouse position
+		m_dragX = evt.getX();
+		m_dragY = evt.getY();
+	}
+	else if (evt.getButton() == FIFE::MouseEvent::RIGHT)
+	{
+		// start of a box selection
+		m_selectX = evt.getX();
+		m_selectY = evt.getY();
+	}
+
+	SetPreviousMouseEvent(evt.getType());
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseListener::mouseReleased(FIFE::MouseEvent& evt)
+{
+	ScopedTimer timer(PHASE_INPUT);
+
+	// only activate the move action if the mouse was pressed and released without dragging
+	if (m_controller && evt.getButton() == FIFE::MouseEvent::LEFT && m_prevEventType != FIFE::MouseEvent::DRAGGED)
+	{
+		FIFE::Location destination(m_controller->getLocation());
+		FIFE::ScreenPoint screenPoint(evt.getX(), evt.getY());
+		const CameraTransform& transform = m_parent->GetViewController()->GetTransform();
+
+		// select the instance that was clicked on, if any
+		std::vector<FIFE::Instance*> selection;
+		FIFE::Instance* target = m_picker ? m_picker->PickAt(screenPoint, m_controller) : 0;
+		if (target)
+		{
+			selection.push_back(target);
+		}
+		Select(selection);
+
+		if (target)
+		{
+			// walk up to the selected instance
+			destination.setMapCoordinates(target->getLocationRef().getMapCoordinates());
+		}
+		else
+		{
+			// move controller to clicked spot
+			destination.setMapCoordinates(transform.ToMap(screenPoint));
+		}
+
+		// follow a cached or re-planned route, the engine searches
+		// the way itself if there is none, e.g. to a blocked spot
+		double speed = m_controller->getTotalTimeMultiplier();
+		if (!m_routeFollower || !m_routeFollower->MoveTo(destination, speed))
+		{
+			m_controller->move("walk", destination, speed);
+		}
+	}
+	else if (m_picker && evt.getButton() == FIFE::MouseEvent::RIGHT)
+	{
+		std::vector<FIFE::Instance*> selection;
+
+		if (std::abs(evt.getX() - m_selectX) < BoxSelectThreshold && std::abs(evt.getY() - m_selectY) < BoxSelectThreshold)
+		{
+			FIFE::Instance* target = m_picker->PickAt(FIFE::ScreenPoint(evt.getX(), evt.getY()));
+			if (target)
+			{
+				selection.push_back(target);
+			}
+		}
+		else
+		{
+			// select everything inside the dragged out box
+			FIFE::Rect area(std::min(m_selectX, evt.getX()), std::min(m_selectY, evt.getY()),
+				std::abs(evt.getX() - m_selectX), std::abs(evt.getY() - m_selectY));
+			m_picker->PickRect(area, selection);
+		}
+
+		Select(selection);
+	}
+
+	SetPreviousMouseEvent(evt.getType());
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseListener::mouseClicked(FIFE::MouseEvent& evt)
+{
+	// this event never seems to fire, not sure if it works properly
+	// I suspect this would remove the need for my keeping track of the previous
+	// event for dragging vs. releasing if this event signifies what I think
+
+	SetPreviousMouseEvent(evt.getType());
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseListener::mouseWheelMovedUp(FIFE::MouseEvent& evt)
+{
+	ScopedTimer timer(PHASE_INPUT);
+
+	// zoom in
+	m_parent->GetViewController()->ZoomIn();
+
+	// save mouse position
+	m_dragX = evt.getX();
+	m_dragY = evt.getY();
+
+	SetPreviousMouseEvent(evt.getType());
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseListener::mouseWheelMovedDown(FIFE::MouseEvent& evt)
+{
+	ScopedTimer timer(PHASE_INPUT);
+
+	// zoom out
+	m_parent->GetViewController()->ZoomOut();
+
+	SetPreviousMouseEvent(evt.getType());
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseListener::mouseWheelMovedRight(FIFE::MouseEvent& evt)
+{
+	SetPreviousMouseEvent(evt.getType());
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseListener::mouseWheelMovedLeft(FIFE::MouseEvent& evt)
+{
+	SetPreviousMouseEvent(evt.getType());
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseListener::mouseMoved(FIFE::MouseEvent& evt)
+{
+	ScopedTimer timer(PHASE_INPUT);
+
+	m_autoscreenscroller.updateLocation(evt.getX(), evt.getY());
+
+	SetPreviousMouseEvent(evt.getType());
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @param[in]: evt
+//! signaled event
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseListener::mouseDragged(FIFE::MouseEvent& evt)
+{
+	ScopedTimer timer(PHASE_INPUT);
+
+	if (evt.getButton() == FIFE::MouseEvent::LEFT)
+	{
+		// unregister the auto-scrolling event
+		// we are now scrolling manually and do not
+		// want both trying to do it at the same time
+		m_autoscreenscroller.unregisterEvent();
+
+		// get the screen coordinates of the mouse
+		int currX = evt.getX();
+		int currY = evt.getY();
+
+		// move the camera by the mouse delta, the view controller
+		// applies all drags of a frame in one camera update
+		m_parent->GetViewController()->Pan(m_dragX - currX, m_dragY - currY);
+
+		// update last saved x,y values for dragging
+		m_dragX = currX;
+		m_dragY = currY;
+	}
+
+	// make sure to save that the last event was drag
+	// this is important to get around the drag & click problem
+	SetPreviousMouseEvent(evt.getType());
+}
+
+//!***************************************************************
+//! @details:
+//! store the character we want to move with our mouse
+//!
+//! @param[in]: controller
+//! the character to manipulate
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseListener::SetController(FIFE::Instance* controller)
+{
+	m_controller = controller;
+}
+
+//!***************************************************************
+//! @details:
+//! store the picker used to find the instances under the mouse
+//!
+//! @param[in]: picker
+//! instance picker for the map's layers
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseListener::SetPicker(InstancePicker* picker)
+{
+	m_picker = picker;
+}
+
+//!***************************************************************
+//! @details:
+//! store the route follower that walks the controller to clicks
+//!
+//! @param[in]: routeFollower
+//! route follower of the controller
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseListener::SetRouteFollower(RouteFollower* routeFollower)
+{
+	m_routeFollower = routeFollower;
+}
+
+//!***************************************************************
+//! @details:
+//! store the camera the selection is outlined in, used when
+//! the game switches to another map
+//!
+//! @param[in]: camera
+//! main camera of the current map
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseListener::SetCamera(FIFE::Camera* camera)
+{
+	m_camera = camera;
+}
+
+//!***************************************************************
+//! @details:
+//! whether the cursor at the screen edge keeps the view scrolling
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+bool MouseListener::IsScrolling() const
+{
+	return m_autoscreenscroller.IsScrolling();
+}
+
+//!***************************************************************
+//! @details:
+//! saves the last action that was received
+//! this is done to make sure we can distinguish between dragging
+//! and clicking since they do 2 different things
+//!
+//! if we do not keep track we will drag and then when we release
+//! it will perform the action for the mouse release as well as
+//! the mouse dragged
+//!
+//! @param[in]: type
+//! event type
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseListener::SetPreviousMouseEvent(FIFE::MouseEvent::MouseEventType type)
+{
+	m_prevEventType = type;
+}
+
+//!***************************************************************
+//! @details:
+//! outlines the selected instances, replacing the previous
+//! selection
+//!
+//! @param[in]: instances
+//! the new selection, may be empty
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void MouseListener::Select(const std::vector<FIFE::Instance*>& instances)
+{
+	FIFE::InstanceRenderer* renderer = FIFE::InstanceRenderer::getInstance(m_camera);
+	if (!renderer)
+	{
+		return;
+	}
+
+	renderer->removeAllOutlines();
+
+	for (std::vector<FIFE::Instance*>::const_iterator it = instances.begin(); it != instances.end(); ++it)
+	{
+		renderer->addOutlined(*it, 255, 255, 0, 2);
+	}
 }
\ No newline at end of file
@@ -1,57 +1,70 @@
-//*****************************************************************************
-// FILE NAME:  MouseListener.h
-//
-//*****************************************************************************
-#ifndef MOUSE_LISTENER_H_
-#define MOUSE_LISTENER_H_
-
-#include "eventchannel/mouse/imouselistener.h"
-#include "eventchannel/mouse/mouseevent.h"
-
-#include "ScreenScroller.h"
-
-namespace FIFE
-{
-	class Command;
-	class Camera;
-	class EventManager;
-	class TimeManager;
-	class Instance;
-}
-
-class Game;
-
-//! handles listening to mouse events
-class MouseListener : public FIFE::IMouseListener
-{
-public:
-	MouseListener(Game* parent, FIFE::Camera* cam, FIFE::EventManager* eventManager, FIFE::TimeManager* timeManager);
-	~MouseListener();
-
-	// overridden from base class
-	virtual void mouseEntered(FIFE::MouseEvent& evt);
-	virtual void mouseExited(FIFE::MouseEvent& evt);
-	virtual void mousePressed(FIFE::MouseEvent& evt);
-	virtual void mouseReleased(FIFE::MouseEvent& evt);
-	virtual void mouseClicked(FIFE::MouseEvent& evt);
-	virtual void mouseWheelMovedUp(FIFE::MouseEvent& evt);
-	virtual void mouseWheelMovedDown(FIFE::MouseEvent& evt);
-	virtual void mouseWheelMovedRight(FIFE::MouseEvent& evt);
-	virtual void mouseWheelMovedLeft(FIFE::MouseEvent& evt);
-	virtual void mouseMoved(FIFE::MouseEvent& evt);
-	virtual void mouseDragged(FIFE::MouseEvent& evt);
-
-	void SetController(FIFE::Instance* controller);
-private:
-	void SetPreviousMouseEvent(FIFE::MouseEvent::MouseEventType type);
-private:
-	Game* m_parent;
-	int m_dragX;
-	int m_dragY;
-	FIFE::Camera* m_camera;
-	ScreenScroller m_autoscreenscroller;
-	FIFE::Instance* m_controller;
-	FIFE::MouseEvent::MouseEventType m_prevEventType;
-};
-
-#endif
+//*****************************************************************************
+// FILE NAME:  MouseListener.h
+//
+//*****************************************************************************
+#ifndef MOUSE_LISTENER_H_
+#define MOUSE_LISTENER_H_
+
+#include "eventchannel/mouse/imouselistener.h"
+#include "eventchannel/mouse/mouseevent.h"
+
+#include "ScreenScroller.h"
+
+#include <vector>
+
+namespace FIFE
+{
+	class Command;
+	class Camera;
+	class EventManager;
+	class TimeManager;
+	class Instance;
+}
+
+class Game;
+class InstancePicker;
+class RouteFollower;
+
+//! handles listening to mouse events
+class MouseListener : public FIFE::IMouseListener
+{
+public:
+	MouseListener(Game* parent, FIFE::Camera* cam, FIFE::EventManager* eventManager, FIFE::TimeManager* timeManager);
+	~MouseListener();
+
+	// overridden from base class
+	virtual void mouseEntered(FIFE::MouseEvent& evt);
+	virtual void mouseExited(FIFE::MouseEvent& evt);
+	virtual void mousePressed(FIFE::MouseEvent& evt);
+	virtual void mouseReleased(FIFE::MouseEvent& evt);
+	virtual void mouseClicked(FIFE::MouseEvent& evt);
+	virtual void mouseWheelMovedUp(FIFE::MouseEvent& evt);
+	virtual void mouseWheelMovedDown(FIFE::MouseEvent& evt);
+	virtual void mouseWheelMovedRight(FIFE::MouseEvent& evt);
+	virtual void mouseWheelMovedLeft(FIFE::MouseEvent& evt);
+	virtual void mouseMoved(FIFE::MouseEvent& evt);
+	virtual void mouseDragged(FIFE::MouseEvent& evt);
+
+	void SetController(FIFE::Instance* controller);
+	void SetPicker(InstancePicker* picker);
+	void SetRouteFollower(RouteFollower* routeFollower);
+	void SetCamera(FIFE::Camera* camera);
+	bool IsScrolling() const;
+private:
+	void SetPreviousMouseEvent(FIFE::MouseEvent::MouseEventType type);
+	void Select(const std::vector<FIFE::Instance*>& instances);
+private:
+	Game* m_parent;
+	int m_dragX;
+	int m_dragY;
+	FIFE::Camera* m_camera;
+	ScreenScroller m_autoscreenscroller;
+	FIFE::Instance* m_controller;
+	InstancePicker* m_picker;
+	RouteFollower* m_routeFollower;
+	int m_selectX;
+	int m_selectY;
+	FIFE::MouseEvent::MouseEventType m_prevEventType;
+};
+
+#endif
@@ -0,0 +1,233 @@
+//*****************************************************************************
+// FILE NAME:  PathCache.cpp
+//
+//*****************************************************************************
+#include "PathCache.h"
+
+// standard includes
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+	// cells a splice search may expand per cell of splice radius,
+	// a bridge that needs more than that is searched in full
+	const int SpliceExpandedPerCell = 64;
+
+	//!***************************************************************
+	//! @details:
+	//! grid distance allowing diagonal steps
+	//!
+	//!***************************************************************
+	int Distance(const GridPoint& a, const GridPoint& b)
+	{
+		return std::max(std::abs(a.x - b.x), std::abs(a.y - b.y));
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! orders keys for the map, start first
+//!
+//!***************************************************************
+bool PathCache::Key::operator<(const Key& other) const
+{
+	if (start.x != other.start.x) return start.x < other.start.x;
+	if (start.y != other.start.y) return start.y < other.start.y;
+	if (goal.x != other.goal.x) return goal.x < other.goal.x;
+	return goal.y < other.goal.y;
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: grid
+//! the grid searched on a miss, it must not change while cached
+//! paths are in use, Clear() the cache if it does
+//!
+//! @param[in]: capacity
+//! number of paths kept, the least recently used goes first
+//!
+//!***************************************************************
+PathCache::PathCache(const WalkGrid& grid, size_t capacity)
+: m_grid(grid), m_capacity(std::max<size_t>(capacity, 1)), m_hits(0), m_misses(0), m_splices(0)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! looks up the path from start to goal, searching the grid and
+//! remembering the result if it is not cached yet
+//!
+//! @param[in]: start
+//! cell to start from
+//!
+//! @param[in]: goal
+//! cell to reach
+//!
+//! @param[out]: path
+//! cells from start to goal, start included
+//!
+//! @return: 
+//! bool - false if there is no path
+//! 
+//!***************************************************************
+bool PathCache::FindPath(const GridPoint& start, const GridPoint& goal, std::vector<GridPoint>& path)
+{
+	Key key = { start, goal };
+
+	Entries::iterator it = m_entries.find(key);
+	if (it != m_entries.end())
+	{
+		++m_hits;
+
+		// move to the front of the recently used list
+		m_order.splice(m_order.begin(), m_order, it->second.order);
+		path = it->second.path;
+
+		return true;
+	}
+
+	++m_misses;
+
+	if (!m_grid.FindPath(start, goal, m_scratch, path))
+	{
+		return false;
+	}
+
+	if (m_entries.size() >= m_capacity)
+	{
+		m_entries.erase(m_order.back());
+		m_order.pop_back();
+	}
+
+	m_order.push_front(key);
+
+	Entry& entry = m_entries[key];
+	entry.path = path;
+	entry.order = m_order.begin();
+
+	return true;
+}
+
+//!***************************************************************
+//! @details:
+//! plans a new route for a walker that is following a route,
+//! if the new goal is close to the old one only the way from the
+//! nearest cell of the remaining route to the new goal is searched
+//!
+//! @param[in]: route
+//! the route being followed
+//!
+//! @param[in]: position
+//! index of the route cell the walker is heading to
+//!
+//! @param[in]: goal
+//! the new goal
+//!
+//! @param[in]: spliceRadius
+//! how close, in cells, the new goal must be to the old goal
+//!
+//! @param[out]: path
+//! cells from route[position] to the goal
+//!
+//! @return: 
+//! bool - false if there is no path
+//! 
+//!***************************************************************
+bool PathCache::Replan(const std::vector<GridPoint>& route, size_t position, const GridPoint& goal,
+	int spliceRadius, std::vector<GridPoint>& path)
+{
+	if (position >= route.size())
+	{
+		return false;
+	}
+
+	if (Distance(route.back(), goal) > spliceRadius)
+	{
+		return FindPath(route[position], goal, path);
+	}
+
+	// branch off where the remaining route comes closest
+	size_t branch = position;
+	int best = Distance(route[position], goal);
+	for (size_t i = position + 1; i < route.size(); ++i)
+	{
+		int distance = Distance(route[i], goal);
+		if (distance < best)
+		{
+			best = distance;
+			branch = i;
+		}
+	}
+
+	std::vector<GridPoint> bridge;
+	int maxExpanded = std::max(spliceRadius, 1) * SpliceExpandedPerCell;
+
+	if (!m_grid.FindPath(route[branch], goal, m_scratch, bridge, maxExpanded))
+	{
+		return FindPath(route[position], goal, path);
+	}
+
+	++m_splices;
+
+	path.assign(route.begin() + position, route.begin() + branch);
+	path.insert(path.end(), bridge.begin(), bridge.end());
+
+	return true;
+}
+
+//!***************************************************************
+//! @details:
+//! forgets all cached paths
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void PathCache::Clear()
+{
+	m_entries.clear();
+	m_order.clear();
+}
+
+//!***************************************************************
+//! @details:
+//! number of lookups answered from the cache
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int PathCache::GetHits() const
+{
+	return m_hits;
+}
+
+//!***************************************************************
+//! @details:
+//! number of lookups that searched the grid
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int PathCache::GetMisses() const
+{
+	return m_misses;
+}
+
+//!***************************************************************
+//! @details:
+//! number of re-plans that were spliced onto the old route
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int PathCache::GetSplices() const
+{
+	return m_splices;
+}
@@ -0,0 +1,60 @@
+//*****************************************************************************
+// FILE NAME:  PathCache.h
+//
+//*****************************************************************************
+#ifndef PATH_CACHE_H_
+#define PATH_CACHE_H_
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <vector>
+
+#include "WalkGrid.h"
+
+//! remembers recent paths by start and goal cell, and re-plans a
+//! route whose goal moved a little by splicing a short search onto
+//! the part of the route that is still ahead
+class PathCache
+{
+public:
+	explicit PathCache(const WalkGrid& grid, size_t capacity = 64);
+
+	bool FindPath(const GridPoint& start, const GridPoint& goal, std::vector<GridPoint>& path);
+	bool Replan(const std::vector<GridPoint>& route, size_t position, const GridPoint& goal,
+		int spliceRadius, std::vector<GridPoint>& path);
+	void Clear();
+
+	int GetHits() const;
+	int GetMisses() const;
+	int GetSplices() const;
+private:
+	struct Key
+	{
+		GridPoint start;
+		GridPoint goal;
+
+		bool operator<(const Key& other) const;
+	};
+
+	typedef std::list<Key> Order;
+
+	struct Entry
+	{
+		std::vector<GridPoint> path;
+		Order::iterator order;
+	};
+
+	typedef std::map<Key, Entry> Entries;
+private:
+	const WalkGrid& m_grid;
+	PathScratch m_scratch;
+	size_t m_capacity;
+	Entries m_entries;
+	Order m_order;
+	int m_hits;
+	int m_misses;
+	int m_splices;
+};
+
+#endif
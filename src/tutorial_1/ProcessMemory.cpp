@@ -0,0 +1,91 @@
+//*****************************************************************************
+// FILE NAME:  ProcessMemory.cpp
+//
+//*****************************************************************************
+#include "ProcessMemory.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <sys/resource.h>
+#else
+#include <cstdio>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+//!***************************************************************
+//! @details:
+//! resident set size of the process right now
+//!
+//! @return: 
+//! size_t - bytes, 0 if the platform does not report it
+//! 
+//!***************************************************************
+size_t ProcessMemory::GetCurrentResidentBytes()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return counters.WorkingSetSize;
+	}
+	return 0;
+#elif defined(__APPLE__)
+	mach_task_basic_info info;
+	mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+	if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS)
+	{
+		return static_cast<size_t>(info.resident_size);
+	}
+	return 0;
+#else
+	// second field of statm is the resident page count
+	long pages = 0;
+	FILE* file = std::fopen("/proc/self/statm", "r");
+	if (file)
+	{
+		if (std::fscanf(file, "%*s %ld", &pages) != 1)
+		{
+			pages = 0;
+		}
+		std::fclose(file);
+	}
+	return static_cast<size_t>(pages) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+//!***************************************************************
+//! @details:
+//! highest resident set size the process reached so far
+//!
+//! @return: 
+//! size_t - bytes, 0 if the platform does not report it
+//! 
+//!***************************************************************
+size_t ProcessMemory::GetPeakResidentBytes()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return counters.PeakWorkingSetSize;
+	}
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return 0;
+	}
+#if defined(__APPLE__)
+	// macOS reports bytes
+	return static_cast<size_t>(usage.ru_maxrss);
+#else
+	// linux reports kilobytes
+	return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
@@ -0,0 +1,17 @@
+//*****************************************************************************
+// FILE NAME:  ProcessMemory.h
+//
+//*****************************************************************************
+#ifndef PROCESS_MEMORY_H_
+#define PROCESS_MEMORY_H_
+
+#include <cstddef>
+
+//! queries the operating system for the memory used by this process
+namespace ProcessMemory
+{
+	size_t GetCurrentResidentBytes();
+	size_t GetPeakResidentBytes();
+}
+
+#endif
@@ -0,0 +1,303 @@
+//*****************************************************************************
+// FILE NAME:  Profiler.cpp
+//
+//*****************************************************************************
+#include "Profiler.h"
+#include "Stopwatch.h"
+
+// standard includes
+#include <algorithm>
+#include <cassert>
+
+const int Profiler::HistorySize;
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//!***************************************************************
+Profiler::Profiler()
+: m_enabled(false), m_historyIndex(0), m_historyCount(0)
+{
+	SDL_AtomicSet(&m_head, 0);
+	SDL_AtomicSet(&m_tail, 0);
+	SDL_AtomicSet(&m_dropped, 0);
+
+	for (int phase = 0; phase < PHASE_COUNT; ++phase)
+	{
+		std::fill(m_history[phase], m_history[phase] + HistorySize, 0.0);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! the profiler is shared by all listeners, they do not have
+//! access to the game object
+//!
+//! @return: 
+//! Profiler&
+//! 
+//!***************************************************************
+Profiler& Profiler::Instance()
+{
+	static Profiler profiler;
+	return profiler;
+}
+
+//!***************************************************************
+//! @details:
+//! turns recording on or off, scoped timers cost a single branch
+//! while the profiler is disabled
+//!
+//! @param[in]: enable
+//! true - record timings
+//! false - ignore timings
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Profiler::SetEnabled(bool enable)
+{
+	m_enabled = enable;
+}
+
+//!***************************************************************
+//! @details:
+//! checks whether timings are being recorded
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+bool Profiler::IsEnabled() const
+{
+	return m_enabled;
+}
+
+//!***************************************************************
+//! @details:
+//! pushes one measurement into the ring buffer, this is the only
+//! call made from timed code and it never blocks or allocates,
+//! the sample is dropped if the buffer is full
+//!
+//! there must be a single recording thread, which is the main
+//! thread since the engine dispatches all events there
+//!
+//! @param[in]: phase
+//! the phase that was measured
+//!
+//! @param[in]: ticks
+//! duration in performance counter ticks
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Profiler::Record(ProfilePhase phase, Uint64 ticks)
+{
+	int head = SDL_AtomicGet(&m_head);
+	int tail = SDL_AtomicGet(&m_tail);
+
+	if (head - tail >= RingSize)
+	{
+		SDL_AtomicAdd(&m_dropped, 1);
+		return;
+	}
+
+	Sample& sample = m_ring[head & (RingSize - 1)];
+	sample.phase = phase;
+	sample.ticks = ticks;
+
+	// publish the sample before moving the head past it
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(&m_head, head + 1);
+}
+
+//!***************************************************************
+//! @details:
+//! drains the ring buffer into the totals of the frame that just
+//! finished and moves on to the next history slot
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Profiler::EndFrame()
+{
+	double frame[PHASE_COUNT];
+	std::fill(frame, frame + PHASE_COUNT, 0.0);
+
+	int head = SDL_AtomicGet(&m_head);
+	SDL_MemoryBarrierAcquire();
+
+	int tail = SDL_AtomicGet(&m_tail);
+	for (; tail != head; ++tail)
+	{
+		const Sample& sample = m_ring[tail & (RingSize - 1)];
+		assert(sample.phase >= 0 && sample.phase < PHASE_COUNT);
+
+		frame[sample.phase] += Stopwatch::TicksToMs(sample.ticks);
+	}
+
+	// release the drained slots to the recorder
+	SDL_AtomicSet(&m_tail, tail);
+
+	if (!m_enabled)
+	{
+		return;
+	}
+
+	for (int phase = 0; phase < PHASE_COUNT; ++phase)
+	{
+		m_history[phase][m_historyIndex] = frame[phase];
+	}
+
+	m_historyIndex = (m_historyIndex + 1) % HistorySize;
+	m_historyCount = std::min(m_historyCount + 1, static_cast<int>(HistorySize));
+}
+
+//!***************************************************************
+//! @details:
+//! time spent in a phase during the last completed frame
+//!
+//! @param[in]: phase
+//! the phase to query
+//!
+//! @return: 
+//! double - milliseconds
+//! 
+//!***************************************************************
+double Profiler::GetLastMs(ProfilePhase phase) const
+{
+	if (m_historyCount == 0)
+	{
+		return 0.0;
+	}
+
+	int last = (m_historyIndex + HistorySize - 1) % HistorySize;
+	return m_history[phase][last];
+}
+
+//!***************************************************************
+//! @details:
+//! average time per frame spent in a phase over the history
+//!
+//! @param[in]: phase
+//! the phase to query
+//!
+//! @return: 
+//! double - milliseconds
+//! 
+//!***************************************************************
+double Profiler::GetAverageMs(ProfilePhase phase) const
+{
+	if (m_historyCount == 0)
+	{
+		return 0.0;
+	}
+
+	double total = 0.0;
+	for (int i = 0; i < m_historyCount; ++i)
+	{
+		total += m_history[phase][i];
+	}
+
+	return total / m_historyCount;
+}
+
+//!***************************************************************
+//! @details:
+//! worst frame for a phase over the history
+//!
+//! @param[in]: phase
+//! the phase to query
+//!
+//! @return: 
+//! double - milliseconds
+//! 
+//!***************************************************************
+double Profiler::GetMaxMs(ProfilePhase phase) const
+{
+	if (m_historyCount == 0)
+	{
+		return 0.0;
+	}
+
+	return *std::max_element(m_history[phase], m_history[phase] + m_historyCount);
+}
+
+//!***************************************************************
+//! @details:
+//! number of samples lost because the ring buffer was full
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int Profiler::GetDroppedSamples() const
+{
+	return SDL_AtomicGet(const_cast<SDL_atomic_t*>(&m_dropped));
+}
+
+//!***************************************************************
+//! @details:
+//! display name of a phase
+//!
+//! @param[in]: phase
+//! the phase
+//!
+//! @return: 
+//! const char*
+//! 
+//!***************************************************************
+const char* Profiler::GetPhaseName(ProfilePhase phase)
+{
+	switch (phase)
+	{
+		case PHASE_ENGINE_PUMP:
+			return "engine pump";
+		case PHASE_INPUT:
+			return "input";
+		case PHASE_SCREEN_SCROLL:
+			return "screen scroll";
+		case PHASE_CAMERA:
+			return "camera";
+		case PHASE_CROWD:
+			return "crowd";
+		case PHASE_MAP_SWITCH:
+			return "map switch";
+		default:
+			return "unknown";
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! constructor, starts the measurement if the profiler is on
+//!
+//! @param[in]: phase
+//! the phase the enclosing scope belongs to
+//!
+//!***************************************************************
+ScopedTimer::ScopedTimer(ProfilePhase phase)
+: m_phase(phase), m_start(0)
+{
+	if (Profiler::Instance().IsEnabled())
+	{
+		m_start = SDL_GetPerformanceCounter();
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! destructor, records the time since construction
+//!
+//!***************************************************************
+ScopedTimer::~ScopedTimer()
+{
+	if (m_start != 0)
+	{
+		Profiler::Instance().Record(m_phase, SDL_GetPerformanceCounter() - m_start);
+	}
+}
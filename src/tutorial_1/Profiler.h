@@ -0,0 +1,84 @@
+//*****************************************************************************
+// FILE NAME:  Profiler.h
+//
+//*****************************************************************************
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include "SDL.h"
+
+//! the parts of a frame that are timed, nested phases are
+//! included in the time of the phase that encloses them
+enum ProfilePhase
+{
+	PHASE_ENGINE_PUMP = 0,
+	PHASE_INPUT,
+	PHASE_SCREEN_SCROLL,
+	PHASE_CAMERA,
+	PHASE_CROWD,
+	PHASE_MAP_SWITCH,
+	PHASE_COUNT
+};
+
+//! collects phase timings through a lock-free ring buffer and
+//! keeps a short per-frame history of them
+class Profiler
+{
+public:
+	// number of frames kept for the rolling averages
+	static const int HistorySize = 120;
+
+	static Profiler& Instance();
+
+	void SetEnabled(bool enable);
+	bool IsEnabled() const;
+
+	void Record(ProfilePhase phase, Uint64 ticks);
+	void EndFrame();
+
+	double GetLastMs(ProfilePhase phase) const;
+	double GetAverageMs(ProfilePhase phase) const;
+	double GetMaxMs(ProfilePhase phase) const;
+	int GetDroppedSamples() const;
+
+	static const char* GetPhaseName(ProfilePhase phase);
+private:
+	Profiler();
+	Profiler(const Profiler&);
+	Profiler& operator=(const Profiler&);
+private:
+	// must be a power of two so the indices can be masked
+	static const int RingSize = 1024;
+
+	struct Sample
+	{
+		int phase;
+		Uint64 ticks;
+	};
+
+	bool m_enabled;
+
+	// written by the recording thread, read by EndFrame
+	Sample m_ring[RingSize];
+	SDL_atomic_t m_head;
+	SDL_atomic_t m_tail;
+	SDL_atomic_t m_dropped;
+
+	// per frame totals, only touched by EndFrame and the getters
+	double m_history[PHASE_COUNT][HistorySize];
+	int m_historyIndex;
+	int m_historyCount;
+};
+
+//! measures the lifetime of the object and hands it to the profiler
+class ScopedTimer
+{
+public:
+	explicit ScopedTimer(ProfilePhase phase);
+	~ScopedTimer();
+private:
+	ProfilePhase m_phase;
+	Uint64 m_start;
+};
+
+#endif
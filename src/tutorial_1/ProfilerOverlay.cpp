@@ -0,0 +1,238 @@
+//*****************************************************************************
+// FILE NAME:  ProfilerOverlay.cpp
+//
+//*****************************************************************************
+#include "ProfilerOverlay.h"
+#include "RenderStats.h"
+
+// fife includes
+#include "gui/fifechan/fifechanmanager.h"
+
+// 3rd party includes
+#include "fifechan.hpp"
+
+// standard includes
+#include <cassert>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+	// the frame budget the bars are scaled to, 60 fps
+	const double FrameBudgetMs = 1e3 / 60.0;
+
+	// number of characters of a full budget bar
+	const int BarWidth = 20;
+
+	// how often the text is rebuilt, in ms
+	const uint32_t RefreshPeriod = 250;
+
+	const int LineHeight = 16;
+	const int OverlayWidth = 420;
+
+	//!***************************************************************
+	//! @details:
+	//! builds a text bar showing a time relative to the frame budget
+	//!
+	//! @param[in]: ms
+	//! the time to show
+	//!
+	//! @return:
+	//! std::string
+	//!
+	//!***************************************************************
+	std::string MakeBar(double ms)
+	{
+		int length = static_cast<int>(ms / FrameBudgetMs * BarWidth + 0.5);
+		if (length > BarWidth)
+		{
+			// mark the overrun instead of growing past the budget
+			return std::string(BarWidth, '|') + "!";
+		}
+
+		return std::string(length, '|');
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! constructor, builds the hidden overlay widgets
+//!
+//! @param[in]: guiManager
+//! the gui the overlay is shown in
+//!
+//!***************************************************************
+ProfilerOverlay::ProfilerOverlay(FIFE::FifechanManager* guiManager)
+: m_guiManager(guiManager), m_renderStats(0), m_visible(false), m_lastRefresh(0)
+{
+	assert(m_guiManager);
+
+	m_container = new fcn::Container();
+	m_container->setOpaque(true);
+	m_container->setBaseColor(fcn::Color(0, 0, 0, 160));
+	m_container->setPosition(5, 5);
+	m_container->setSize(OverlayWidth, (PHASE_COUNT + 2) * LineHeight + 4);
+
+	for (int phase = 0; phase < PHASE_COUNT; ++phase)
+	{
+		m_labels[phase] = new fcn::Label();
+		m_container->add(m_labels[phase], 2, 2 + phase * LineHeight);
+	}
+
+	m_summary = new fcn::Label();
+	m_container->add(m_summary, 2, 2 + PHASE_COUNT * LineHeight);
+
+	m_render = new fcn::Label();
+	m_container->add(m_render, 2, 2 + (PHASE_COUNT + 1) * LineHeight);
+}
+
+//!***************************************************************
+//! @details:
+//! destructor
+//!
+//!***************************************************************
+ProfilerOverlay::~ProfilerOverlay()
+{
+	if (m_visible)
+	{
+		m_guiManager->remove(m_container);
+	}
+
+	for (int phase = 0; phase < PHASE_COUNT; ++phase)
+	{
+		delete m_labels[phase];
+	}
+
+	delete m_summary;
+	delete m_render;
+	delete m_container;
+}
+
+//!***************************************************************
+//! @details:
+//! shows or hides the overlay, the profiler only records while
+//! the overlay is visible
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ProfilerOverlay::Toggle()
+{
+	m_visible = !m_visible;
+
+	if (m_visible)
+	{
+		m_guiManager->add(m_container);
+	}
+	else
+	{
+		m_guiManager->remove(m_container);
+	}
+
+	// force a refresh on the next update
+	m_lastRefresh = 0;
+
+	Profiler::Instance().SetEnabled(m_visible);
+}
+
+//!***************************************************************
+//! @details:
+//! checks whether the overlay is shown
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+bool ProfilerOverlay::IsVisible() const
+{
+	return m_visible;
+}
+
+//!***************************************************************
+//! @details:
+//! rebuilds the overlay text from the profiler history, this is
+//! throttled so the overlay itself does not show up in the timings
+//!
+//! @param[in]: time
+//! current engine time in ms
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ProfilerOverlay::Update(uint32_t time)
+{
+	if (!m_visible || (m_lastRefresh != 0 && time - m_lastRefresh < RefreshPeriod))
+	{
+		return;
+	}
+
+	m_lastRefresh = time;
+
+	const Profiler& profiler = Profiler::Instance();
+
+	for (int phase = 0; phase < PHASE_COUNT; ++phase)
+	{
+		ProfilePhase current = static_cast<ProfilePhase>(phase);
+		double average = profiler.GetAverageMs(current);
+		double worst = profiler.GetMaxMs(current);
+
+		std::ostringstream oss;
+		oss << std::fixed << std::setprecision(2)
+			<< Profiler::GetPhaseName(current) << ": "
+			<< average << " ms avg, " << worst << " ms max  "
+			<< MakeBar(average);
+
+		m_labels[phase]->setCaption(oss.str());
+		m_labels[phase]->adjustSize();
+
+		// highlight phases whose worst frame blew the budget
+		if (worst > FrameBudgetMs)
+		{
+			m_labels[phase]->setForegroundColor(fcn::Color(255, 80, 80));
+		}
+		else
+		{
+			m_labels[phase]->setForegroundColor(fcn::Color(255, 255, 255));
+		}
+	}
+
+	std::ostringstream oss;
+	oss << "last " << Profiler::HistorySize << " frames, budget "
+		<< std::fixed << std::setprecision(1) << FrameBudgetMs << " ms, dropped samples: "
+		<< profiler.GetDroppedSamples();
+
+	m_summary->setCaption(oss.str());
+	m_summary->adjustSize();
+	m_summary->setForegroundColor(fcn::Color(255, 255, 255));
+
+	if (m_renderStats)
+	{
+		const RenderCounters& frame = m_renderStats->GetLastFrame();
+
+		std::ostringstream render;
+		render << "draw calls: " << frame.drawCalls << ", binds: " << frame.textureBinds
+			<< ", drawn: " << frame.drawn << ", culled: " << frame.culled;
+
+		m_render->setCaption(render.str());
+		m_render->adjustSize();
+		m_render->setForegroundColor(fcn::Color(255, 255, 255));
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! shows the counters of the last rendered frame below the timings
+//!
+//! @param[in]: renderStats
+//! the main camera's render stats
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ProfilerOverlay::SetRenderStats(const RenderStats* renderStats)
+{
+	m_renderStats = renderStats;
+}
@@ -0,0 +1,47 @@
+//*****************************************************************************
+// FILE NAME:  ProfilerOverlay.h
+//
+//*****************************************************************************
+#ifndef PROFILER_OVERLAY_H_
+#define PROFILER_OVERLAY_H_
+
+#include "util/base/fife_stdint.h"
+
+#include "Profiler.h"
+
+class RenderStats;
+
+namespace FIFE
+{
+	class FifechanManager;
+}
+
+namespace fcn
+{
+	class Container;
+	class Label;
+}
+
+//! rolling on-screen view of the profiler phase timings
+class ProfilerOverlay
+{
+public:
+	ProfilerOverlay(FIFE::FifechanManager* guiManager);
+	~ProfilerOverlay();
+
+	void Toggle();
+	bool IsVisible() const;
+	void Update(uint32_t time);
+	void SetRenderStats(const RenderStats* renderStats);
+private:
+	FIFE::FifechanManager* m_guiManager;
+	fcn::Container* m_container;
+	fcn::Label* m_labels[PHASE_COUNT];
+	fcn::Label* m_summary;
+	fcn::Label* m_render;
+	const RenderStats* m_renderStats;
+	bool m_visible;
+	uint32_t m_lastRefresh;
+};
+
+#endif
@@ -0,0 +1,387 @@
+//*****************************************************************************
+// FILE NAME:  RenderStats.cpp
+//
+//*****************************************************************************
+#include "RenderStats.h"
+
+// fife includes
+#include "model/structures/layer.h"
+#include "model/structures/map.h"
+#include "video/opengl/glimage.h"
+#include "video/renderbackend.h"
+#include "view/camera.h"
+#include "view/renderitem.h"
+
+namespace
+{
+	// runs after all renderers that draw instances
+	const int PipelinePosition = 1000;
+
+	// no texture has been bound yet in this frame
+	const unsigned int NoTexture = 0;
+}
+
+//!***************************************************************
+//! @details:
+//! constructor, all counters start at zero
+//!
+//!***************************************************************
+RenderCounters::RenderCounters()
+: considered(0), culled(0), drawn(0), drawCalls(0), textureBinds(0), stateSwitches(0), vertices(0)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! adds the counters of another renderer, layer or frame
+//!
+//! @param[in]: other
+//! the counters to add
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void RenderCounters::Add(const RenderCounters& other)
+{
+	considered += other.considered;
+	culled += other.culled;
+	drawn += other.drawn;
+	drawCalls += other.drawCalls;
+	textureBinds += other.textureBinds;
+	stateSwitches += other.stateSwitches;
+	vertices += other.vertices;
+}
+
+//!***************************************************************
+//! @details:
+//! constructor, the stats belong to the camera they are added to
+//!
+//! @param[in]: renderBackend
+//! backend the frames are drawn with
+//!
+//!***************************************************************
+RenderStats::RenderStats(FIFE::RenderBackend* renderBackend)
+: FIFE::RendererBase(renderBackend, PipelinePosition), m_instanceRenderer(0), m_openGL(renderBackend->getName() == "OpenGL"),
+  m_lastTexture(NoTexture), m_frames(0)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! destructor, closes the csv file
+//!
+//!***************************************************************
+RenderStats::~RenderStats()
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! starts measuring the layers of a map the instance renderer draws
+//!
+//! @param[in]: camera
+//! camera the stats were added to
+//!
+//! @param[in]: map
+//! map shown by the camera
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void RenderStats::Attach(FIFE::Camera* camera, FIFE::Map* map)
+{
+	m_instanceRenderer = camera->getRenderer("InstanceRenderer");
+	activateAllLayers(map);
+}
+
+//!***************************************************************
+//! @details:
+//! writes one csv row per renderer and layer of every frame from
+//! now on
+//!
+//! @param[in]: path
+//! the csv file
+//!
+//! @param[in]: append
+//! true - add to the rows already in the file, without a header
+//!
+//! @return: 
+//! bool - false if the file could not be created
+//! 
+//!***************************************************************
+bool RenderStats::OpenCsv(const std::string& path, bool append)
+{
+	m_csv.open(path.c_str(), append ? std::ios::out | std::ios::app : std::ios::out);
+	if (!m_csv)
+	{
+		return false;
+	}
+
+	if (!append)
+	{
+		m_csv << "frame,renderer,layer,considered,culled,drawn,draw_calls,texture_binds,state_switches,vertices" << std::endl;
+	}
+	return true;
+}
+
+//!***************************************************************
+//! @details:
+//! carries the frame count and totals over from the stats of the
+//! map shown before, so a map switch does not restart them. the
+//! csv of the previous stats is closed so it can be appended to
+//!
+//! @param[in]: previous
+//! stats of the camera that is no longer drawn
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void RenderStats::ContinueFrom(RenderStats& previous)
+{
+	m_frames = previous.m_frames;
+	m_totals = previous.m_totals;
+	m_lastFrame = previous.m_lastFrame;
+
+	previous.m_csv.close();
+}
+
+//!***************************************************************
+//! @details:
+//! adds what a renderer cost on a layer to the current frame
+//!
+//! @param[in]: renderer
+//! name of the renderer, must outlive the frame
+//!
+//! @param[in]: layer
+//! layer that was drawn
+//!
+//! @param[in]: counters
+//! the renderer's counters for the layer
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void RenderStats::Record(const char* renderer, FIFE::Layer* layer, const RenderCounters& counters)
+{
+	Row row;
+	row.renderer = renderer;
+	row.layer = layer;
+	row.counters = counters;
+	m_rows.push_back(row);
+}
+
+//!***************************************************************
+//! @details:
+//! called after each frame, sums up the frame's rows, writes them
+//! and starts the next frame unbound
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void RenderStats::EndFrame()
+{
+	m_lastTexture = NoTexture;
+
+	if (m_rows.empty())
+	{
+		return;
+	}
+
+	m_lastFrame = RenderCounters();
+
+	for (std::vector<Row>::const_iterator it = m_rows.begin(); it != m_rows.end(); ++it)
+	{
+		m_lastFrame.Add(it->counters);
+
+		if (m_csv.is_open())
+		{
+			const RenderCounters& counters = it->counters;
+			m_csv << m_frames << ',' << it->renderer << ',' << it->layer->getId() << ','
+				<< counters.considered << ',' << counters.culled << ',' << counters.drawn << ','
+				<< counters.drawCalls << ',' << counters.textureBinds << ',' << counters.stateSwitches << ','
+				<< counters.vertices << '\n';
+		}
+	}
+
+	m_totals.Add(m_lastFrame);
+	++m_frames;
+	m_rows.clear();
+}
+
+//!***************************************************************
+//! @details:
+//! whether the backend binds textures, the software backend
+//! blits every image on its own
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+bool RenderStats::UsesTextures() const
+{
+	return m_openGL;
+}
+
+//!***************************************************************
+//! @details:
+//! number of frames that drew anything
+//!
+//! @return: 
+//! unsigned long
+//! 
+//!***************************************************************
+unsigned long RenderStats::GetFrameCount() const
+{
+	return m_frames;
+}
+
+//!***************************************************************
+//! @details:
+//! counters of the most recent frame over all renderers and layers
+//!
+//! @return: 
+//! const RenderCounters&
+//! 
+//!***************************************************************
+const RenderCounters& RenderStats::GetLastFrame() const
+{
+	return m_lastFrame;
+}
+
+//!***************************************************************
+//! @details:
+//! counters summed over all frames
+//!
+//! @return: 
+//! const RenderCounters&
+//! 
+//!***************************************************************
+const RenderCounters& RenderStats::GetTotals() const
+{
+	return m_totals;
+}
+
+//!***************************************************************
+//! @details:
+//! average of a total over the measured frames
+//!
+//! @param[in]: total
+//! one of the counters of GetTotals()
+//!
+//! @return: 
+//! double
+//! 
+//!***************************************************************
+double RenderStats::PerFrame(unsigned long total) const
+{
+	return (m_frames > 0) ? static_cast<double>(total) / static_cast<double>(m_frames) : 0.0;
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @return: 
+//! FIFE::RendererBase*
+//! 
+//!***************************************************************
+FIFE::RendererBase* RenderStats::clone()
+{
+	return new RenderStats(m_renderbackend);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, measures what the instance renderer
+//! did for the layer. the camera already culled the layer's
+//! instances into the render list, the backend batches quads until
+//! the texture changes and sets up the layer's blending once
+//!
+//! @param[in]: camera
+//! camera that is rendering
+//!
+//! @param[in]: layer
+//! layer that is rendered
+//!
+//! @param[in]: instances
+//! visible instances of the layer in drawing order
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void RenderStats::render(FIFE::Camera* camera, FIFE::Layer* layer, FIFE::RenderList& instances)
+{
+	// layers drawn some other way do not go through the instance renderer
+	if (!m_instanceRenderer || !m_instanceRenderer->isActivedLayer(layer))
+	{
+		return;
+	}
+
+	RenderCounters counters;
+	counters.considered = static_cast<unsigned long>(layer->getInstances().size());
+	counters.drawn = static_cast<unsigned long>(instances.size());
+	counters.culled = (counters.considered > counters.drawn) ? counters.considered - counters.drawn : 0;
+	counters.vertices = counters.drawn * RenderCounters::VerticesPerQuad;
+
+	if (counters.drawn > 0)
+	{
+		++counters.stateSwitches;
+	}
+
+	// the layer's state setup ends the previous batch
+	bool batchOpen = false;
+
+	for (FIFE::RenderList::const_iterator it = instances.begin(); it != instances.end(); ++it)
+	{
+		FIFE::Image* image = (*it)->image.get();
+		if (!image)
+		{
+			continue;
+		}
+
+		if (!m_openGL)
+		{
+			++counters.drawCalls;
+			continue;
+		}
+
+		// atlas sub-images share the texture of their atlas
+		unsigned int texture = static_cast<FIFE::GLImage*>(image)->getTexId();
+		if (texture != m_lastTexture)
+		{
+			++counters.textureBinds;
+			m_lastTexture = texture;
+			batchOpen = false;
+		}
+
+		if (!batchOpen)
+		{
+			++counters.drawCalls;
+			batchOpen = true;
+		}
+	}
+
+	Record("InstanceRenderer", layer, counters);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @return: 
+//! std::string
+//! 
+//!***************************************************************
+std::string RenderStats::getName()
+{
+	return "RenderStats";
+}
@@ -0,0 +1,96 @@
+//*****************************************************************************
+// FILE NAME:  RenderStats.h
+//
+//*****************************************************************************
+#ifndef RENDER_STATS_H_
+#define RENDER_STATS_H_
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "view/rendererbase.h"
+
+namespace FIFE
+{
+	class Camera;
+	class Layer;
+	class Map;
+	class RenderBackend;
+}
+
+//! what one renderer cost on one layer, or a sum of those
+struct RenderCounters
+{
+	// every image is drawn as one quad
+	static const unsigned long VerticesPerQuad = 4;
+
+	RenderCounters();
+
+	void Add(const RenderCounters& other);
+
+	// instances the renderer looked at, skipped as off screen and drew
+	unsigned long considered;
+	unsigned long culled;
+	unsigned long drawn;
+
+	// batches handed to the backend, the OpenGL backend starts a new
+	// batch whenever the texture changes
+	unsigned long drawCalls;
+	unsigned long textureBinds;
+
+	// blend, alpha or render target changes
+	unsigned long stateSwitches;
+
+	unsigned long vertices;
+};
+
+//! collects the render counters of a frame by renderer and layer. it
+//! measures the instance renderer itself, walking the instances in the
+//! order they are drawn without drawing anything, other renderers hand
+//! it their own counters. the rows of every frame can be written to csv
+class RenderStats : public FIFE::RendererBase
+{
+public:
+	explicit RenderStats(FIFE::RenderBackend* renderBackend);
+	~RenderStats();
+
+	void Attach(FIFE::Camera* camera, FIFE::Map* map);
+	bool OpenCsv(const std::string& path, bool append = false);
+	void ContinueFrom(RenderStats& previous);
+
+	void Record(const char* renderer, FIFE::Layer* layer, const RenderCounters& counters);
+	void EndFrame();
+
+	bool UsesTextures() const;
+	unsigned long GetFrameCount() const;
+	const RenderCounters& GetLastFrame() const;
+	const RenderCounters& GetTotals() const;
+	double PerFrame(unsigned long total) const;
+
+	// overridden from base class
+	virtual FIFE::RendererBase* clone();
+	virtual void render(FIFE::Camera* camera, FIFE::Layer* layer, FIFE::RenderList& instances);
+	virtual std::string getName();
+private:
+	struct Row
+	{
+		const char* renderer;
+		FIFE::Layer* layer;
+		RenderCounters counters;
+	};
+
+	RenderStats(const RenderStats&);
+	RenderStats& operator=(const RenderStats&);
+private:
+	FIFE::RendererBase* m_instanceRenderer;
+	bool m_openGL;
+	unsigned int m_lastTexture;
+	std::vector<Row> m_rows;
+	RenderCounters m_lastFrame;
+	RenderCounters m_totals;
+	unsigned long m_frames;
+	std::ofstream m_csv;
+};
+
+#endif
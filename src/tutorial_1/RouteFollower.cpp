@@ -0,0 +1,199 @@
+//*****************************************************************************
+// FILE NAME:  RouteFollower.cpp
+//
+//*****************************************************************************
+#include "RouteFollower.h"
+#include "LayerWalkGrid.h"
+
+// fife includes
+#include "model/metamodel/action.h"
+#include "model/structures/instance.h"
+#include "model/structures/layer.h"
+#include "model/structures/location.h"
+
+// standard includes
+#include <cassert>
+
+namespace
+{
+	// a new goal this close to the current one is spliced onto the route
+	const int SpliceRadius = 6;
+
+	// the engine walks straight lines of at most this many cells
+	const int MaxWaypointCells = 8;
+}
+
+//!***************************************************************
+//! @details:
+//! constructor, takes a snapshot of the layer's blockers
+//!
+//! @param[in]: instance
+//! the instance to walk, e.g. the player
+//!
+//! @param[in]: layer
+//! the walkable layer the instance is on
+//!
+//!***************************************************************
+RouteFollower::RouteFollower(FIFE::Instance* instance, FIFE::Layer* layer)
+: m_instance(instance), m_layer(layer), m_pathCache(m_walkGrid), m_next(0), m_speed(1.0)
+{
+	assert(m_instance && m_layer);
+
+	LayerWalkGrid::Build(m_layer, m_walkGrid);
+}
+
+//!***************************************************************
+//! @details:
+//! starts walking to a destination, re-planning the current route
+//! if the instance is already on its way
+//!
+//! @param[in]: destination
+//! where to walk to
+//!
+//! @param[in]: speed
+//! walk speed handed to FIFE::Instance::move
+//!
+//! @return: 
+//! bool - false if no route was found, e.g. because the
+//! destination is blocked, the caller can leave it to the engine
+//! 
+//!***************************************************************
+bool RouteFollower::MoveTo(const FIFE::Location& destination, double speed)
+{
+	FIFE::ModelCoordinate cell = destination.getLayerCoordinates(m_layer);
+	GridPoint goal = { cell.x, cell.y };
+
+	if (!m_walkGrid.IsWalkable(goal.x, goal.y))
+	{
+		return false;
+	}
+
+	m_speed = speed;
+
+	// the same spot again, keep walking
+	if (IsFollowing() && m_route.back().x == goal.x && m_route.back().y == goal.y)
+	{
+		return true;
+	}
+
+	std::vector<GridPoint> route;
+	bool found = false;
+
+	if (IsFollowing())
+	{
+		found = m_pathCache.Replan(m_route, m_waypoints[m_next], goal, SpliceRadius, route);
+	}
+	else
+	{
+		FIFE::ModelCoordinate position = m_instance->getLocationRef().getLayerCoordinates();
+		GridPoint start = { position.x, position.y };
+		found = m_pathCache.FindPath(start, goal, route);
+	}
+
+	if (!found)
+	{
+		return false;
+	}
+
+	m_route.swap(route);
+	WalkGrid::FindWaypoints(m_route, 0, MaxWaypointCells, m_waypoints);
+	m_next = 0;
+
+	if (m_waypoints.empty())
+	{
+		// already standing on the goal
+		m_route.clear();
+		return true;
+	}
+
+	WalkToWaypoint();
+
+	return true;
+}
+
+//!***************************************************************
+//! @details:
+//! called once per frame, sends the instance on to the next
+//! waypoint once it stopped walking
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void RouteFollower::Update()
+{
+	if (!IsFollowing() || IsWalking())
+	{
+		return;
+	}
+
+	if (++m_next < m_waypoints.size())
+	{
+		WalkToWaypoint();
+	}
+	else
+	{
+		m_route.clear();
+		m_waypoints.clear();
+		m_next = 0;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! accessor for the cache statistics
+//!
+//! @return: 
+//! const PathCache&
+//! 
+//!***************************************************************
+const PathCache& RouteFollower::GetPathCache() const
+{
+	return m_pathCache;
+}
+
+//!***************************************************************
+//! @details:
+//! true while there are waypoints left to walk to
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+bool RouteFollower::IsFollowing() const
+{
+	return m_next < m_waypoints.size();
+}
+
+//!***************************************************************
+//! @details:
+//! true while the engine is walking the instance, the walk action
+//! is cleared when it arrives or the engine gives up
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+bool RouteFollower::IsWalking() const
+{
+	FIFE::Action* action = m_instance->getCurrentAction();
+	return action && action->getId() == "walk";
+}
+
+//!***************************************************************
+//! @details:
+//! lets the engine walk to the current waypoint
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void RouteFollower::WalkToWaypoint()
+{
+	const GridPoint& waypoint = m_route[m_waypoints[m_next]];
+
+	FIFE::Location target(m_layer);
+	target.setLayerCoordinates(FIFE::ModelCoordinate(waypoint.x, waypoint.y));
+
+	m_instance->move("walk", target, m_speed);
+}
@@ -0,0 +1,52 @@
+//*****************************************************************************
+// FILE NAME:  RouteFollower.h
+//
+//*****************************************************************************
+#ifndef ROUTE_FOLLOWER_H_
+#define ROUTE_FOLLOWER_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "PathCache.h"
+#include "WalkGrid.h"
+
+namespace FIFE
+{
+	class Layer;
+	class Instance;
+	class Location;
+}
+
+//! walks an instance to clicked destinations along routes from a path
+//! cache, clicking again near the current goal only searches the way
+//! from the route to the new goal instead of the whole route
+class RouteFollower
+{
+public:
+	RouteFollower(FIFE::Instance* instance, FIFE::Layer* layer);
+
+	bool MoveTo(const FIFE::Location& destination, double speed);
+	void Update();
+
+	bool IsFollowing() const;
+
+	const PathCache& GetPathCache() const;
+private:
+	RouteFollower(const RouteFollower&);
+	RouteFollower& operator=(const RouteFollower&);
+
+	bool IsWalking() const;
+	void WalkToWaypoint();
+private:
+	FIFE::Instance* m_instance;
+	FIFE::Layer* m_layer;
+	WalkGrid m_walkGrid;
+	PathCache m_pathCache;
+	std::vector<GridPoint> m_route;
+	std::vector<size_t> m_waypoints;
+	size_t m_next;
+	double m_speed;
+};
+
+#endif
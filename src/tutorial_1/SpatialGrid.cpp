@@ -0,0 +1,403 @@
+//*****************************************************************************
+// FILE NAME:  SpatialGrid.cpp
+//
+//*****************************************************************************
+#include "SpatialGrid.h"
+
+// standard includes
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+	//! orders query results by their distance to the query point
+	struct Candidate
+	{
+		double distance;
+		FIFE::Instance* instance;
+
+		bool operator<(const Candidate& other) const
+		{
+			return distance < other.distance;
+		}
+	};
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: cellSize
+//! edge length of a grid cell in layer coordinates, about the
+//! size of a typical query works best
+//!
+//! @param[in]: bucketCount
+//! number of hash buckets, rounded up to a power of two
+//!
+//!***************************************************************
+SpatialGrid::SpatialGrid(double cellSize, int bucketCount)
+: m_cellSize(cellSize), m_bucketMask(0)
+{
+	assert(cellSize > 0.0 && bucketCount > 0);
+
+	size_t buckets = 1;
+	while (buckets < static_cast<size_t>(bucketCount))
+	{
+		buckets <<= 1;
+	}
+
+	m_buckets.resize(buckets);
+	m_bucketMask = buckets - 1;
+}
+
+//!***************************************************************
+//! @details:
+//! adds an instance at the given position, an instance that is
+//! already in the grid is moved instead
+//!
+//! @param[in]: instance
+//! instance to add
+//!
+//! @param[in]: x
+//! exact layer x coordinate
+//!
+//! @param[in]: y
+//! exact layer y coordinate
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void SpatialGrid::Insert(FIFE::Instance* instance, double x, double y)
+{
+	std::map<FIFE::Instance*, Position>::iterator it = m_positions.find(instance);
+	if (it != m_positions.end())
+	{
+		Move(instance, x, y);
+		return;
+	}
+
+	Position position = { x, y };
+	m_positions.insert(std::make_pair(instance, position));
+	Add(instance, x, y);
+}
+
+//!***************************************************************
+//! @details:
+//! updates the position of an instance, an instance that stays
+//! in its cell is only updated in place
+//!
+//! @param[in]: instance
+//! instance that moved
+//!
+//! @param[in]: x
+//! new exact layer x coordinate
+//!
+//! @param[in]: y
+//! new exact layer y coordinate
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void SpatialGrid::Move(FIFE::Instance* instance, double x, double y)
+{
+	std::map<FIFE::Instance*, Position>::iterator it = m_positions.find(instance);
+	if (it == m_positions.end())
+	{
+		Insert(instance, x, y);
+		return;
+	}
+
+	Position& position = it->second;
+	if (position.x == x && position.y == y)
+	{
+		return;
+	}
+
+	int cellX = ToCell(x);
+	int cellY = ToCell(y);
+
+	if (cellX == ToCell(position.x) && cellY == ToCell(position.y))
+	{
+		std::vector<Entry>& bucket = m_buckets[GetBucket(cellX, cellY)];
+		for (std::vector<Entry>::iterator entry = bucket.begin(); entry != bucket.end(); ++entry)
+		{
+			if (entry->instance == instance)
+			{
+				entry->x = x;
+				entry->y = y;
+				break;
+			}
+		}
+	}
+	else
+	{
+		Erase(instance, position.x, position.y);
+		Add(instance, x, y);
+	}
+
+	position.x = x;
+	position.y = y;
+}
+
+//!***************************************************************
+//! @details:
+//! removes an instance from the grid
+//!
+//! @param[in]: instance
+//! instance to remove
+//!
+//! @return: 
+//! bool - false if the instance was not in the grid
+//! 
+//!***************************************************************
+bool SpatialGrid::Remove(FIFE::Instance* instance)
+{
+	std::map<FIFE::Instance*, Position>::iterator it = m_positions.find(instance);
+	if (it == m_positions.end())
+	{
+		return false;
+	}
+
+	Erase(instance, it->second.x, it->second.y);
+	m_positions.erase(it);
+
+	return true;
+}
+
+//!***************************************************************
+//! @details:
+//! removes all instances, the buckets keep their memory
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void SpatialGrid::Clear()
+{
+	for (std::vector<std::vector<Entry> >::iterator it = m_buckets.begin(); it != m_buckets.end(); ++it)
+	{
+		it->clear();
+	}
+
+	m_positions.clear();
+}
+
+//!***************************************************************
+//! @details:
+//! finds the instances within a radius of a point, the closest
+//! instance comes first
+//!
+//! @param[in]: x
+//! exact layer x coordinate of the point
+//!
+//! @param[in]: y
+//! exact layer y coordinate of the point
+//!
+//! @param[in]: radius
+//! search radius in layer coordinates
+//!
+//! @param[out]: result
+//! receives the instances found, it is cleared first
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void SpatialGrid::QueryPoint(double x, double y, double radius, std::vector<FIFE::Instance*>& result) const
+{
+	result.clear();
+
+	std::vector<Candidate> candidates;
+	double radiusSquared = radius * radius;
+
+	for (int cellY = ToCell(y - radius); cellY <= ToCell(y + radius); ++cellY)
+	{
+		for (int cellX = ToCell(x - radius); cellX <= ToCell(x + radius); ++cellX)
+		{
+			const std::vector<Entry>& bucket = m_buckets[GetBucket(cellX, cellY)];
+			for (std::vector<Entry>::const_iterator it = bucket.begin(); it != bucket.end(); ++it)
+			{
+				// other cells can share the bucket
+				if (it->cellX != cellX || it->cellY != cellY)
+				{
+					continue;
+				}
+
+				double dx = it->x - x;
+				double dy = it->y - y;
+				double distance = dx * dx + dy * dy;
+
+				if (distance <= radiusSquared)
+				{
+					Candidate candidate = { distance, it->instance };
+					candidates.push_back(candidate);
+				}
+			}
+		}
+	}
+
+	std::stable_sort(candidates.begin(), candidates.end());
+
+	result.reserve(candidates.size());
+	for (std::vector<Candidate>::const_iterator it = candidates.begin(); it != candidates.end(); ++it)
+	{
+		result.push_back(it->instance);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! finds the instances inside a rectangle, edges included
+//!
+//! @param[in]: minX
+//! smallest exact layer x coordinate
+//!
+//! @param[in]: minY
+//! smallest exact layer y coordinate
+//!
+//! @param[in]: maxX
+//! largest exact layer x coordinate
+//!
+//! @param[in]: maxY
+//! largest exact layer y coordinate
+//!
+//! @param[out]: result
+//! receives the instances found, it is cleared first
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void SpatialGrid::QueryRect(double minX, double minY, double maxX, double maxY, std::vector<FIFE::Instance*>& result) const
+{
+	result.clear();
+
+	int firstX = ToCell(minX);
+	int firstY = ToCell(minY);
+	int lastX = ToCell(maxX);
+	int lastY = ToCell(maxY);
+
+	double cellCount = (static_cast<double>(lastX) - firstX + 1.0) * (static_cast<double>(lastY) - firstY + 1.0);
+
+	if (cellCount >= static_cast<double>(m_buckets.size()))
+	{
+		// the rectangle covers more cells than there are buckets,
+		// checking every entry once is cheaper
+		for (std::vector<std::vector<Entry> >::const_iterator bucket = m_buckets.begin(); bucket != m_buckets.end(); ++bucket)
+		{
+			for (std::vector<Entry>::const_iterator it = bucket->begin(); it != bucket->end(); ++it)
+			{
+				if (it->x >= minX && it->x <= maxX && it->y >= minY && it->y <= maxY)
+				{
+					result.push_back(it->instance);
+				}
+			}
+		}
+		return;
+	}
+
+	for (int cellY = firstY; cellY <= lastY; ++cellY)
+	{
+		for (int cellX = firstX; cellX <= lastX; ++cellX)
+		{
+			const std::vector<Entry>& bucket = m_buckets[GetBucket(cellX, cellY)];
+			for (std::vector<Entry>::const_iterator it = bucket.begin(); it != bucket.end(); ++it)
+			{
+				if (it->cellX == cellX && it->cellY == cellY &&
+					it->x >= minX && it->x <= maxX && it->y >= minY && it->y <= maxY)
+				{
+					result.push_back(it->instance);
+				}
+			}
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! number of instances in the grid
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int SpatialGrid::GetSize() const
+{
+	return static_cast<int>(m_positions.size());
+}
+
+//!***************************************************************
+//! @details:
+//! cell index of a layer coordinate
+//!
+//! @param[in]: coordinate
+//! exact layer coordinate
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int SpatialGrid::ToCell(double coordinate) const
+{
+	return static_cast<int>(std::floor(coordinate / m_cellSize));
+}
+
+//!***************************************************************
+//! @details:
+//! hash bucket a cell is stored in
+//!
+//! @param[in]: cellX
+//! cell column
+//!
+//! @param[in]: cellY
+//! cell row
+//!
+//! @return: 
+//! size_t
+//! 
+//!***************************************************************
+size_t SpatialGrid::GetBucket(int cellX, int cellY) const
+{
+	unsigned int hash = (static_cast<unsigned int>(cellX) * 73856093u) ^ (static_cast<unsigned int>(cellY) * 19349663u);
+	return static_cast<size_t>(hash) & m_bucketMask;
+}
+
+//!***************************************************************
+//! @details:
+//! stores an entry in the bucket of its cell
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void SpatialGrid::Add(FIFE::Instance* instance, double x, double y)
+{
+	Entry entry = { instance, x, y, ToCell(x), ToCell(y) };
+	m_buckets[GetBucket(entry.cellX, entry.cellY)].push_back(entry);
+}
+
+//!***************************************************************
+//! @details:
+//! takes an entry out of the bucket of its cell, the last entry
+//! of the bucket fills the gap
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void SpatialGrid::Erase(FIFE::Instance* instance, double x, double y)
+{
+	std::vector<Entry>& bucket = m_buckets[GetBucket(ToCell(x), ToCell(y))];
+	for (std::vector<Entry>::iterator it = bucket.begin(); it != bucket.end(); ++it)
+	{
+		if (it->instance == instance)
+		{
+			*it = bucket.back();
+			bucket.pop_back();
+			return;
+		}
+	}
+}
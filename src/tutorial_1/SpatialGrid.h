@@ -0,0 +1,61 @@
+//*****************************************************************************
+// FILE NAME:  SpatialGrid.h
+//
+//*****************************************************************************
+#ifndef SPATIAL_GRID_H_
+#define SPATIAL_GRID_H_
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+namespace FIFE
+{
+	class Instance;
+}
+
+//! uniform grid over layer coordinates for finding instances near a
+//! point or inside a rectangle without walking the whole layer,
+//! the grid is unbounded, cells are hashed into a fixed bucket table
+class SpatialGrid
+{
+public:
+	explicit SpatialGrid(double cellSize = 4.0, int bucketCount = 16384);
+
+	void Insert(FIFE::Instance* instance, double x, double y);
+	void Move(FIFE::Instance* instance, double x, double y);
+	bool Remove(FIFE::Instance* instance);
+	void Clear();
+
+	void QueryPoint(double x, double y, double radius, std::vector<FIFE::Instance*>& result) const;
+	void QueryRect(double minX, double minY, double maxX, double maxY, std::vector<FIFE::Instance*>& result) const;
+
+	int GetSize() const;
+private:
+	struct Entry
+	{
+		FIFE::Instance* instance;
+		double x;
+		double y;
+		int cellX;
+		int cellY;
+	};
+
+	struct Position
+	{
+		double x;
+		double y;
+	};
+
+	int ToCell(double coordinate) const;
+	size_t GetBucket(int cellX, int cellY) const;
+	void Add(FIFE::Instance* instance, double x, double y);
+	void Erase(FIFE::Instance* instance, double x, double y);
+private:
+	double m_cellSize;
+	size_t m_bucketMask;
+	std::vector<std::vector<Entry> > m_buckets;
+	std::map<FIFE::Instance*, Position> m_positions;
+};
+
+#endif
@@ -0,0 +1,174 @@
+//*****************************************************************************
+// FILE NAME:  StartupTimeline.cpp
+//
+//*****************************************************************************
+#include "StartupTimeline.h"
+
+// standard includes
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+namespace
+{
+	// name of the step that ends with the first frame
+	const char* FirstFrameStep = "first frame";
+}
+
+//!***************************************************************
+//! @details:
+//! constructor, the timeline starts running immediately
+//!
+//!***************************************************************
+StartupTimeline::StartupTimeline()
+: m_lastMarkMs(0.0), m_firstFrameMs(-1.0)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! ends a startup step, it covers the time since the previous
+//! step ended
+//!
+//! @param[in]: step
+//! name of the step that just finished
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void StartupTimeline::Mark(const std::string& step)
+{
+	double now = m_clock.ElapsedMs();
+
+	Step entry;
+	entry.name = step;
+	entry.startMs = m_lastMarkMs;
+	entry.durationMs = now - m_lastMarkMs;
+	m_steps.push_back(entry);
+
+	m_lastMarkMs = now;
+}
+
+//!***************************************************************
+//! @details:
+//! ends the last step once the first frame has been drawn,
+//! later calls are ignored
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void StartupTimeline::MarkFirstFrame()
+{
+	if (HasFirstFrame())
+	{
+		return;
+	}
+
+	Mark(FirstFrameStep);
+	m_firstFrameMs = m_lastMarkMs;
+}
+
+//!***************************************************************
+//! @details:
+//! checks if the first frame has been drawn
+//!
+//! @return:
+//! bool
+//!
+//!***************************************************************
+bool StartupTimeline::HasFirstFrame() const
+{
+	return m_firstFrameMs >= 0.0;
+}
+
+//!***************************************************************
+//! @details:
+//! time from the game being created to its first frame
+//!
+//! @return:
+//! double - milliseconds, 0 before the first frame
+//!
+//!***************************************************************
+double StartupTimeline::GetFirstFrameMs() const
+{
+	return HasFirstFrame() ? m_firstFrameMs : 0.0;
+}
+
+//!***************************************************************
+//! @details:
+//! writes every step with its duration and share of the time
+//! to the first frame
+//!
+//! @param[in]: out
+//! stream the timeline is written to
+//!
+//! @return:
+//! void
+//!
+//!***************************************************************
+void StartupTimeline::Print(std::ostream& out) const
+{
+	std::ios::fmtflags flags = out.flags();
+	std::streamsize precision = out.precision();
+
+	double totalMs = HasFirstFrame() ? m_firstFrameMs : m_lastMarkMs;
+
+	out << std::fixed << std::setprecision(1);
+	out << "startup: " << totalMs << " ms to the first frame" << std::endl;
+
+	for (std::vector<Step>::const_iterator it = m_steps.begin(); it != m_steps.end(); ++it)
+	{
+		double share = (totalMs > 0.0) ? 100.0 * it->durationMs / totalMs : 0.0;
+
+		out << "  " << std::left << std::setw(16) << it->name << std::right << std::setw(10)
+			<< it->durationMs << " ms" << std::setw(8) << share << " %" << std::endl;
+	}
+
+	out.flags(flags);
+	out.precision(precision);
+}
+
+//!***************************************************************
+//! @details:
+//! writes the timeline as json
+//!
+//! @param[in]: path
+//! file the timeline is written to
+//!
+//! @return:
+//! bool - false if the file could not be written
+//!
+//!***************************************************************
+bool StartupTimeline::WriteJson(const std::string& path) const
+{
+	std::ofstream out(path.c_str());
+
+	if (!out)
+	{
+		return false;
+	}
+
+	out << "{" << std::endl
+		<< "  \"first_frame_ms\": " << GetFirstFrameMs() << "," << std::endl
+		<< "  \"steps\": [" << std::endl;
+
+	for (std::vector<Step>::const_iterator it = m_steps.begin(); it != m_steps.end(); ++it)
+	{
+		out << "    { \"name\": \"" << it->name << "\", \"start_ms\": " << it->startMs
+			<< ", \"duration_ms\": " << it->durationMs << " }";
+
+		if (it + 1 != m_steps.end())
+		{
+			out << ",";
+		}
+		out << std::endl;
+	}
+
+	out << "  ]" << std::endl
+		<< "}" << std::endl;
+
+	return out.good();
+}
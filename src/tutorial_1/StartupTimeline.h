@@ -0,0 +1,44 @@
+//*****************************************************************************
+// FILE NAME:  StartupTimeline.h
+//
+//*****************************************************************************
+#ifndef STARTUP_TIMELINE_H_
+#define STARTUP_TIMELINE_H_
+
+#include "Stopwatch.h"
+
+// standard includes
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+//! wall clock time of every startup step, from the game being
+//! created up to its first frame on screen
+class StartupTimeline
+{
+public:
+	StartupTimeline();
+
+	void Mark(const std::string& step);
+	void MarkFirstFrame();
+	bool HasFirstFrame() const;
+	double GetFirstFrameMs() const;
+
+	void Print(std::ostream& out) const;
+	bool WriteJson(const std::string& path) const;
+private:
+	//! one startup step and when it ran
+	struct Step
+	{
+		std::string name;
+		double startMs;
+		double durationMs;
+	};
+private:
+	Stopwatch m_clock;
+	double m_lastMarkMs;
+	double m_firstFrameMs;
+	std::vector<Step> m_steps;
+};
+
+#endif
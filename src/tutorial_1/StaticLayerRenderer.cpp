@@ -0,0 +1,838 @@
+//*****************************************************************************
+// FILE NAME:  StaticLayerRenderer.cpp
+//
+//*****************************************************************************
+#include "StaticLayerRenderer.h"
+
+// fife includes
+#include "model/metamodel/object.h"
+#include "model/structures/instance.h"
+#include "model/structures/location.h"
+#include "video/imagemanager.h"
+#include "video/renderbackend.h"
+#include "view/camera.h"
+#include "view/visual.h"
+
+// standard includes
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// width and height of a chunk in layer cells
+	const int ChunkSize = 16;
+
+	// chunks that would need a bigger texture are drawn instance by instance
+	const int MaxTextureSize = 2048;
+
+	// draws static layers below the instance renderer, which sits at 10
+	const int PipelinePosition = 5;
+
+	//!***************************************************************
+	//! @details:
+	//! division that rounds towards negative infinity
+	//!
+	//! @param[in]: value
+	//! cell coordinate
+	//!
+	//! @return: 
+	//! int
+	//! 
+	//!***************************************************************
+	int FloorDiv(int value)
+	{
+		return (value >= 0) ? value / ChunkSize : -((-value + ChunkSize - 1) / ChunkSize);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//!***************************************************************
+StaticLayerRenderer::Chunk::Chunk()
+: exact(false), tooLarge(false)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! constructor, the renderer belongs to the camera it is added to
+//!
+//! @param[in]: renderBackend
+//! backend the chunk textures are drawn with
+//!
+//! @param[in]: imageManager
+//! image manager that owns the chunk textures
+//!
+//!***************************************************************
+StaticLayerRenderer::StaticLayerRenderer(FIFE::RenderBackend* renderBackend, FIFE::ImageManager* imageManager)
+: FIFE::RendererBase(renderBackend, PipelinePosition), m_imageManager(imageManager), m_bakes(0), m_drawnChunks(0), m_culledChunks(0),
+  m_renderStats(0)
+{
+	setEnabled(true);
+}
+
+//!***************************************************************
+//! @details:
+//! destructor, frees the textures and stops listening to the layers
+//!
+//!***************************************************************
+StaticLayerRenderer::~StaticLayerRenderer()
+{
+	for (BakedLayers::iterator it = m_layers.begin(); it != m_layers.end(); ++it)
+	{
+		for (Chunks::iterator chunk = it->second.chunks.begin(); chunk != it->second.chunks.end(); ++chunk)
+		{
+			Reset(chunk->second);
+		}
+		it->first->removeChangeListener(this);
+	}
+	m_layers.clear();
+}
+
+//!***************************************************************
+//! @details:
+//! takes over drawing a layer from the instance renderer. only
+//! layers where no instance plays an action are taken
+//!
+//! @param[in]: camera
+//! camera the renderer was added to
+//!
+//! @param[in]: layer
+//! layer to draw from baked textures
+//!
+//! @return: 
+//! bool - true if the layer is drawn from baked textures
+//! 
+//!***************************************************************
+bool StaticLayerRenderer::AddLayer(FIFE::Camera* camera, FIFE::Layer* layer)
+{
+	if (!layer || m_layers.find(layer) != m_layers.end())
+	{
+		return false;
+	}
+
+	const std::vector<FIFE::Instance*>& instances = layer->getInstances();
+	if (instances.empty())
+	{
+		return false;
+	}
+
+	// chunk bounds are grown by the largest image so instances
+	// reaching over the chunk's edge are not culled
+	int margin = 0;
+	for (std::vector<FIFE::Instance*>::const_iterator it = instances.begin(); it != instances.end(); ++it)
+	{
+		if ((*it)->getCurrentAction())
+		{
+			return false;
+		}
+
+		FIFE::ImagePtr image = GetImage(*it, 0);
+		if (image.get())
+		{
+			margin = std::max(margin, static_cast<int>(std::max(image->getWidth(), image->getHeight())));
+		}
+	}
+
+	BakedLayer& baked = m_layers[layer];
+	baked.camera = camera;
+	baked.rebuildCount = -1;
+	baked.margin = margin;
+	baked.unbake = false;
+
+	for (std::vector<FIFE::Instance*>::const_iterator it = instances.begin(); it != instances.end(); ++it)
+	{
+		Insert(layer, baked, *it);
+	}
+
+	FIFE::RendererBase* instanceRenderer = camera->getRenderer("InstanceRenderer");
+	if (instanceRenderer)
+	{
+		instanceRenderer->removeActiveLayer(layer);
+	}
+	addActiveLayer(layer);
+
+	layer->addChangeListener(this);
+
+	return true;
+}
+
+//!***************************************************************
+//! @details:
+//! reports what each layer cost to the render stats from the next
+//! frame on
+//!
+//! @param[in]: renderStats
+//! the camera's render stats, 0 stops reporting
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void StaticLayerRenderer::SetRenderStats(RenderStats* renderStats)
+{
+	m_renderStats = renderStats;
+}
+
+//!***************************************************************
+//! @details:
+//! number of chunks on all baked layers
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int StaticLayerRenderer::GetChunkCount() const
+{
+	int count = 0;
+	for (BakedLayers::const_iterator it = m_layers.begin(); it != m_layers.end(); ++it)
+	{
+		count += static_cast<int>(it->second.chunks.size());
+	}
+
+	return count;
+}
+
+//!***************************************************************
+//! @details:
+//! number of chunk textures baked so far
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int StaticLayerRenderer::GetBakeCount() const
+{
+	return m_bakes;
+}
+
+//!***************************************************************
+//! @details:
+//! number of chunks drawn over all frames
+//!
+//! @return: 
+//! unsigned long
+//! 
+//!***************************************************************
+unsigned long StaticLayerRenderer::GetDrawnChunks() const
+{
+	return m_drawnChunks;
+}
+
+//!***************************************************************
+//! @details:
+//! number of chunks skipped outside the viewport over all frames
+//!
+//! @return: 
+//! unsigned long
+//! 
+//!***************************************************************
+unsigned long StaticLayerRenderer::GetCulledChunks() const
+{
+	return m_culledChunks;
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @return: 
+//! FIFE::RendererBase*
+//! 
+//!***************************************************************
+FIFE::RendererBase* StaticLayerRenderer::clone()
+{
+	return new StaticLayerRenderer(m_renderbackend, m_imageManager);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, draws the visible chunks of the
+//! layer and bakes the ones that are not baked for the view yet
+//!
+//! @param[in]: camera
+//! camera that is rendering
+//!
+//! @param[in]: layer
+//! layer that is rendered
+//!
+//! @param[in]: instances
+//! visible instances of the layer, not used
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void StaticLayerRenderer::render(FIFE::Camera* camera, FIFE::Layer* layer, FIFE::RenderList& instances)
+{
+	BakedLayers::iterator it = m_layers.find(layer);
+	if (it == m_layers.end())
+	{
+		return;
+	}
+
+	BakedLayer& baked = it->second;
+	m_counters = RenderCounters();
+
+	// an instance started an action, the instance renderer takes
+	// the layer back from this frame on
+	if (baked.unbake)
+	{
+		RemoveLayer(layer);
+		return;
+	}
+
+	// the textures only fit the zoom, rotation and tilt they were baked for
+	m_transform.Update(camera);
+	if (baked.rebuildCount != m_transform.GetRebuildCount())
+	{
+		for (Chunks::iterator chunk = baked.chunks.begin(); chunk != baked.chunks.end(); ++chunk)
+		{
+			Reset(chunk->second);
+			UpdateBounds(baked, chunk->second);
+		}
+		baked.rebuildCount = m_transform.GetRebuildCount();
+	}
+
+	const FIFE::Rect& viewport = camera->getViewPort();
+
+	m_visible.clear();
+	for (Chunks::iterator chunk = baked.chunks.begin(); chunk != baked.chunks.end(); ++chunk)
+	{
+		FIFE::ScreenPoint origin = m_transform.ToScreen(chunk->second.corners[0]);
+		const FIFE::Rect& bounds = chunk->second.bounds;
+
+		unsigned long instanceCount = static_cast<unsigned long>(chunk->second.instances.size());
+		m_counters.considered += instanceCount;
+
+		if (!FIFE::Rect(origin.x + bounds.x, origin.y + bounds.y, bounds.w, bounds.h).intersects(viewport))
+		{
+			m_counters.culled += instanceCount;
+			++m_culledChunks;
+			continue;
+		}
+
+		m_visible.push_back(std::make_pair(origin.y + bounds.y, &chunk->second));
+	}
+
+	// chunks overlap at their edges, draw them back to front
+	std::sort(m_visible.begin(), m_visible.end());
+
+	uint8_t alpha = static_cast<uint8_t>(255 - layer->getLayerTransparency());
+
+	for (std::vector<std::pair<int, Chunk*> >::iterator visible = m_visible.begin(); visible != m_visible.end(); ++visible)
+	{
+		Chunk& chunk = *visible->second;
+
+		if (!chunk.exact)
+		{
+			Bake(camera, chunk);
+		}
+
+		FIFE::ScreenPoint origin = m_transform.ToScreen(chunk.corners[0]);
+
+		m_counters.drawn += static_cast<unsigned long>(chunk.instances.size());
+
+		if (chunk.texture.get())
+		{
+			chunk.texture->render(FIFE::Rect(origin.x + chunk.bounds.x, origin.y + chunk.bounds.y, chunk.bounds.w, chunk.bounds.h), alpha);
+			++m_drawnChunks;
+
+			// every chunk has a texture of its own
+			++m_counters.drawCalls;
+			++m_counters.textureBinds;
+			m_counters.vertices += RenderCounters::VerticesPerQuad;
+		}
+		else if (chunk.tooLarge)
+		{
+			FIFE::Rect bounds;
+			Layout(camera, chunk, m_items, bounds);
+
+			for (std::vector<ChunkItem>::const_iterator item = m_items.begin(); item != m_items.end(); ++item)
+			{
+				item->image->render(FIFE::Rect(origin.x + item->area.x, origin.y + item->area.y, item->area.w, item->area.h), alpha);
+			}
+			++m_drawnChunks;
+
+			m_counters.drawCalls += static_cast<unsigned long>(m_items.size());
+			m_counters.textureBinds += static_cast<unsigned long>(m_items.size());
+			m_counters.vertices += RenderCounters::VerticesPerQuad * static_cast<unsigned long>(m_items.size());
+		}
+	}
+
+	if (m_counters.drawn > 0)
+	{
+		++m_counters.stateSwitches;
+	}
+
+	if (m_renderStats)
+	{
+		m_renderStats->Record("StaticLayerRenderer", layer, m_counters);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @return: 
+//! std::string
+//! 
+//!***************************************************************
+std::string StaticLayerRenderer::getName()
+{
+	return "StaticLayerRenderer";
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, moved instances change chunks and
+//! an instance that starts an action hands the layer back to the
+//! instance renderer
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void StaticLayerRenderer::onLayerChanged(FIFE::Layer* layer, std::vector<FIFE::Instance*>& changedInstances)
+{
+	BakedLayers::iterator it = m_layers.find(layer);
+	if (it == m_layers.end())
+	{
+		return;
+	}
+
+	for (std::vector<FIFE::Instance*>::const_iterator instance = changedInstances.begin(); instance != changedInstances.end(); ++instance)
+	{
+		if ((*instance)->getCurrentAction())
+		{
+			it->second.unbake = true;
+			return;
+		}
+
+		Erase(it->second, *instance);
+		Insert(layer, it->second, *instance);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void StaticLayerRenderer::onInstanceCreate(FIFE::Layer* layer, FIFE::Instance* instance)
+{
+	BakedLayers::iterator it = m_layers.find(layer);
+	if (it == m_layers.end())
+	{
+		return;
+	}
+
+	if (instance->getCurrentAction())
+	{
+		it->second.unbake = true;
+		return;
+	}
+
+	Insert(layer, it->second, instance);
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void StaticLayerRenderer::onInstanceDelete(FIFE::Layer* layer, FIFE::Instance* instance)
+{
+	BakedLayers::iterator it = m_layers.find(layer);
+	if (it != m_layers.end())
+	{
+		Erase(it->second, instance);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! gives a layer back to the instance renderer
+//!
+//! @param[in]: layer
+//! layer to stop baking
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void StaticLayerRenderer::RemoveLayer(FIFE::Layer* layer)
+{
+	BakedLayers::iterator it = m_layers.find(layer);
+	if (it == m_layers.end())
+	{
+		return;
+	}
+
+	for (Chunks::iterator chunk = it->second.chunks.begin(); chunk != it->second.chunks.end(); ++chunk)
+	{
+		Reset(chunk->second);
+	}
+
+	FIFE::RendererBase* instanceRenderer = it->second.camera->getRenderer("InstanceRenderer");
+	if (instanceRenderer)
+	{
+		instanceRenderer->addActiveLayer(layer);
+	}
+	removeActiveLayer(layer);
+
+	layer->removeChangeListener(this);
+	m_layers.erase(it);
+}
+
+//!***************************************************************
+//! @details:
+//! adds an instance to the chunk its cell lies in
+//!
+//! @param[in]: layer
+//! layer of the instance
+//!
+//! @param[in]: baked
+//! chunks of the layer
+//!
+//! @param[in]: instance
+//! instance to add
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void StaticLayerRenderer::Insert(FIFE::Layer* layer, BakedLayer& baked, FIFE::Instance* instance)
+{
+	FIFE::ModelCoordinate cell = instance->getLocationRef().getLayerCoordinates();
+	ChunkKey key(FloorDiv(cell.x), FloorDiv(cell.y));
+
+	Chunks::iterator it = baked.chunks.find(key);
+	if (it == baked.chunks.end())
+	{
+		it = baked.chunks.insert(std::make_pair(key, Chunk())).first;
+
+		// outer corners of the chunk's cells, the first one anchors the texture
+		for (int corner = 0; corner < 4; ++corner)
+		{
+			double x = key.first * ChunkSize - 0.5 + ((corner & 1) ? ChunkSize : 0);
+			double y = key.second * ChunkSize - 0.5 + ((corner & 2) ? ChunkSize : 0);
+
+			FIFE::Location location(layer);
+			location.setExactLayerCoordinates(FIFE::ExactModelCoordinate(x, y));
+			it->second.corners[corner] = location.getMapCoordinates();
+		}
+	}
+
+	it->second.instances.push_back(instance);
+	baked.owners[instance] = key;
+
+	Reset(it->second);
+	UpdateBounds(baked, it->second);
+}
+
+//!***************************************************************
+//! @details:
+//! removes an instance from its chunk
+//!
+//! @param[in]: baked
+//! chunks of the instance's layer
+//!
+//! @param[in]: instance
+//! instance to remove
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void StaticLayerRenderer::Erase(BakedLayer& baked, FIFE::Instance* instance)
+{
+	std::map<FIFE::Instance*, ChunkKey>::iterator owner = baked.owners.find(instance);
+	if (owner == baked.owners.end())
+	{
+		return;
+	}
+
+	Chunks::iterator it = baked.chunks.find(owner->second);
+	baked.owners.erase(owner);
+
+	if (it == baked.chunks.end())
+	{
+		return;
+	}
+
+	Chunk& chunk = it->second;
+	chunk.instances.erase(std::remove(chunk.instances.begin(), chunk.instances.end(), instance), chunk.instances.end());
+	Reset(chunk);
+
+	if (chunk.instances.empty())
+	{
+		baked.chunks.erase(it);
+	}
+	else
+	{
+		UpdateBounds(baked, chunk);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! frees the chunk's texture so it is baked again when drawn
+//!
+//! @param[in]: chunk
+//! chunk that changed
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void StaticLayerRenderer::Reset(Chunk& chunk)
+{
+	if (chunk.texture.get())
+	{
+		m_imageManager->remove(chunk.texture);
+		chunk.texture.reset();
+	}
+
+	chunk.exact = false;
+	chunk.tooLarge = false;
+}
+
+//!***************************************************************
+//! @details:
+//! estimates the screen area of a chunk that is not baked yet
+//! from its corners, grown by the layer's largest image
+//!
+//! @param[in]: baked
+//! layer of the chunk
+//!
+//! @param[in]: chunk
+//! chunk to measure
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void StaticLayerRenderer::UpdateBounds(BakedLayer& baked, Chunk& chunk)
+{
+	double zoom = baked.camera->getZoom();
+
+	FIFE::ScreenPoint anchor = m_transform.ToScreen(chunk.corners[0]);
+	int left = 0;
+	int top = 0;
+	int right = 0;
+	int bottom = 0;
+
+	for (int corner = 1; corner < 4; ++corner)
+	{
+		FIFE::ScreenPoint point = m_transform.ToScreen(chunk.corners[corner]);
+		left = std::min(left, point.x - anchor.x);
+		top = std::min(top, point.y - anchor.y);
+		right = std::max(right, point.x - anchor.x);
+		bottom = std::max(bottom, point.y - anchor.y);
+	}
+
+	int margin = static_cast<int>(std::ceil(baked.margin * zoom));
+	chunk.bounds = FIFE::Rect(left - margin, top - margin, right - left + 2 * margin, bottom - top + 2 * margin);
+}
+
+//!***************************************************************
+//! @details:
+//! places the images of a chunk's instances relative to the
+//! chunk's anchor in back to front order
+//!
+//! @param[in]: camera
+//! camera that is rendering
+//!
+//! @param[in]: chunk
+//! chunk to place
+//!
+//! @param[out]: items
+//! images and their screen areas
+//!
+//! @param[out]: bounds
+//! area covered by all images
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void StaticLayerRenderer::Layout(FIFE::Camera* camera, const Chunk& chunk, std::vector<ChunkItem>& items, FIFE::Rect& bounds)
+{
+	size_t count = chunk.instances.size();
+
+	// the anchor goes first, all instances are projected in one batch
+	m_pointsX.resize(count + 1);
+	m_pointsY.resize(count + 1);
+	m_pointsX[0] = chunk.corners[0].x;
+	m_pointsY[0] = chunk.corners[0].y;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		FIFE::ExactModelCoordinate position = chunk.instances[i]->getLocationRef().getMapCoordinates();
+		m_pointsX[i + 1] = position.x;
+		m_pointsY[i + 1] = position.y;
+	}
+
+	m_transform.ToScreen(&m_pointsX[0], &m_pointsY[0], count + 1, &m_pointsX[0], &m_pointsY[0]);
+
+	double zoom = camera->getZoom();
+	int angle = static_cast<int>(camera->getRotation());
+
+	items.clear();
+	for (size_t i = 0; i < count; ++i)
+	{
+		ChunkItem item;
+		item.image = GetImage(chunk.instances[i], angle);
+		if (!item.image.get())
+		{
+			continue;
+		}
+
+		// centered on the instance and moved by the image's shift, like the instance renderer does
+		double width = static_cast<double>(item.image->getWidth());
+		double height = static_cast<double>(item.image->getHeight());
+		double x = m_pointsX[i + 1] - m_pointsX[0] + (item.image->getXShift() - width / 2.0) * zoom;
+		double y = m_pointsY[i + 1] - m_pointsY[0] + (item.image->getYShift() - height / 2.0) * zoom;
+
+		item.area = FIFE::Rect(static_cast<int>(std::floor(x + 0.5)), static_cast<int>(std::floor(y + 0.5)),
+			static_cast<int>(std::ceil(width * zoom)), static_cast<int>(std::ceil(height * zoom)));
+		items.push_back(item);
+	}
+
+	std::sort(items.begin(), items.end(), IsDrawnBefore);
+
+	if (items.empty())
+	{
+		bounds = FIFE::Rect();
+		return;
+	}
+
+	int left = items[0].area.x;
+	int top = items[0].area.y;
+	int right = items[0].area.right();
+	int bottom = items[0].area.bottom();
+
+	for (std::vector<ChunkItem>::const_iterator it = items.begin(); it != items.end(); ++it)
+	{
+		left = std::min(left, it->area.x);
+		top = std::min(top, it->area.y);
+		right = std::max(right, it->area.right());
+		bottom = std::max(bottom, it->area.bottom());
+	}
+
+	bounds = FIFE::Rect(left, top, right - left, bottom - top);
+}
+
+//!***************************************************************
+//! @details:
+//! draws a chunk's instances into a texture of its own
+//!
+//! @param[in]: camera
+//! camera that is rendering
+//!
+//! @param[in]: chunk
+//! chunk to bake
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void StaticLayerRenderer::Bake(FIFE::Camera* camera, Chunk& chunk)
+{
+	Layout(camera, chunk, m_items, chunk.bounds);
+	chunk.exact = true;
+
+	if (m_items.empty())
+	{
+		return;
+	}
+
+	if (chunk.bounds.w > MaxTextureSize || chunk.bounds.h > MaxTextureSize)
+	{
+		chunk.tooLarge = true;
+		return;
+	}
+
+	chunk.texture = m_imageManager->loadBlank(chunk.bounds.w, chunk.bounds.h);
+
+	m_renderbackend->attachRenderTarget(chunk.texture, true);
+	for (std::vector<ChunkItem>::const_iterator item = m_items.begin(); item != m_items.end(); ++item)
+	{
+		item->image->render(FIFE::Rect(item->area.x - chunk.bounds.x, item->area.y - chunk.bounds.y, item->area.w, item->area.h));
+	}
+	m_renderbackend->detachRenderTarget();
+
+	++m_bakes;
+
+	// switching to the chunk's texture and back, one image at a time
+	m_counters.stateSwitches += 2;
+	m_counters.drawCalls += static_cast<unsigned long>(m_items.size());
+	m_counters.textureBinds += static_cast<unsigned long>(m_items.size());
+	m_counters.vertices += RenderCounters::VerticesPerQuad * static_cast<unsigned long>(m_items.size());
+}
+
+//!***************************************************************
+//! @details:
+//! static image an instance shows from the given view angle
+//!
+//! @param[in]: instance
+//! instance to look up
+//!
+//! @param[in]: angle
+//! rotation of the camera in degrees
+//!
+//! @return: 
+//! FIFE::ImagePtr - empty if the object has no static image
+//! 
+//!***************************************************************
+FIFE::ImagePtr StaticLayerRenderer::GetImage(FIFE::Instance* instance, int angle) const
+{
+	FIFE::ObjectVisual* visual = instance->getObject()->getVisual<FIFE::ObjectVisual>();
+	if (!visual)
+	{
+		return FIFE::ImagePtr();
+	}
+
+	int32_t index = visual->getStaticImageIndexByAngle(angle + instance->getRotation());
+	if (index == -1)
+	{
+		return FIFE::ImagePtr();
+	}
+
+	return m_imageManager->get(index);
+}
+
+//!***************************************************************
+//! @details:
+//! orders images back to front by their bottom edge
+//!
+//! @param[in]: lhs
+//! first image
+//!
+//! @param[in]: rhs
+//! second image
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+bool StaticLayerRenderer::IsDrawnBefore(const ChunkItem& lhs, const ChunkItem& rhs)
+{
+	if (lhs.area.bottom() != rhs.area.bottom())
+	{
+		return lhs.area.bottom() < rhs.area.bottom();
+	}
+
+	return lhs.area.x < rhs.area.x;
+}
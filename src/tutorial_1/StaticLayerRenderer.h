@@ -0,0 +1,118 @@
+//*****************************************************************************
+// FILE NAME:  StaticLayerRenderer.h
+//
+//*****************************************************************************
+#ifndef STATIC_LAYER_RENDERER_H_
+#define STATIC_LAYER_RENDERER_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "model/structures/layer.h"
+#include "util/structures/rect.h"
+#include "video/image.h"
+#include "view/rendererbase.h"
+
+#include "CameraTransform.h"
+#include "RenderStats.h"
+
+namespace FIFE
+{
+	class Camera;
+	class ImageManager;
+	class RenderBackend;
+}
+
+//! draws layers whose instances never change from textures baked per
+//! chunk of cells. a chunk is baked for the camera's zoom, rotation and
+//! tilt and reused while the camera pans, so a frame draws a few quads
+//! instead of every instance. a changed view bakes the chunks again
+class StaticLayerRenderer : public FIFE::RendererBase, public FIFE::LayerChangeListener
+{
+public:
+	StaticLayerRenderer(FIFE::RenderBackend* renderBackend, FIFE::ImageManager* imageManager);
+	~StaticLayerRenderer();
+
+	bool AddLayer(FIFE::Camera* camera, FIFE::Layer* layer);
+	void SetRenderStats(RenderStats* renderStats);
+
+	int GetChunkCount() const;
+	int GetBakeCount() const;
+	unsigned long GetDrawnChunks() const;
+	unsigned long GetCulledChunks() const;
+
+	// overridden from base class
+	virtual FIFE::RendererBase* clone();
+	virtual void render(FIFE::Camera* camera, FIFE::Layer* layer, FIFE::RenderList& instances);
+	virtual std::string getName();
+
+	virtual void onLayerChanged(FIFE::Layer* layer, std::vector<FIFE::Instance*>& changedInstances);
+	virtual void onInstanceCreate(FIFE::Layer* layer, FIFE::Instance* instance);
+	virtual void onInstanceDelete(FIFE::Layer* layer, FIFE::Instance* instance);
+private:
+	typedef std::pair<int, int> ChunkKey;
+
+	// instance image placed relative to the chunk's anchor
+	struct ChunkItem
+	{
+		FIFE::ImagePtr image;
+		FIFE::Rect area;
+	};
+
+	struct Chunk
+	{
+		Chunk();
+
+		std::vector<FIFE::Instance*> instances;
+		FIFE::ExactModelCoordinate corners[4];
+		FIFE::Rect bounds;
+		FIFE::ImagePtr texture;
+		bool exact;
+		bool tooLarge;
+	};
+
+	typedef std::map<ChunkKey, Chunk> Chunks;
+
+	struct BakedLayer
+	{
+		FIFE::Camera* camera;
+		Chunks chunks;
+		std::map<FIFE::Instance*, ChunkKey> owners;
+		int rebuildCount;
+		int margin;
+		bool unbake;
+	};
+
+	typedef std::map<FIFE::Layer*, BakedLayer> BakedLayers;
+
+	StaticLayerRenderer(const StaticLayerRenderer&);
+	StaticLayerRenderer& operator=(const StaticLayerRenderer&);
+
+	void RemoveLayer(FIFE::Layer* layer);
+	void Insert(FIFE::Layer* layer, BakedLayer& baked, FIFE::Instance* instance);
+	void Erase(BakedLayer& baked, FIFE::Instance* instance);
+	void Reset(Chunk& chunk);
+	void UpdateBounds(BakedLayer& baked, Chunk& chunk);
+	void Layout(FIFE::Camera* camera, const Chunk& chunk, std::vector<ChunkItem>& items, FIFE::Rect& bounds);
+	void Bake(FIFE::Camera* camera, Chunk& chunk);
+	FIFE::ImagePtr GetImage(FIFE::Instance* instance, int angle) const;
+
+	static bool IsDrawnBefore(const ChunkItem& lhs, const ChunkItem& rhs);
+private:
+	FIFE::ImageManager* m_imageManager;
+	BakedLayers m_layers;
+	CameraTransform m_transform;
+	std::vector<ChunkItem> m_items;
+	std::vector<std::pair<int, Chunk*> > m_visible;
+	std::vector<double> m_pointsX;
+	std::vector<double> m_pointsY;
+	int m_bakes;
+	unsigned long m_drawnChunks;
+	unsigned long m_culledChunks;
+	RenderStats* m_renderStats;
+	RenderCounters m_counters;
+};
+
+#endif
@@ -0,0 +1,60 @@
+//*****************************************************************************
+// FILE NAME:  Stopwatch.cpp
+//
+//*****************************************************************************
+#include "Stopwatch.h"
+
+//!***************************************************************
+//! @details:
+//! constructor, the stopwatch starts running immediately
+//!
+//!***************************************************************
+Stopwatch::Stopwatch()
+: m_start(SDL_GetPerformanceCounter())
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! restarts the measurement from the current time
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void Stopwatch::Start()
+{
+	m_start = SDL_GetPerformanceCounter();
+}
+
+//!***************************************************************
+//! @details:
+//! time passed since the last start
+//!
+//! @return: 
+//! double - milliseconds
+//! 
+//!***************************************************************
+double Stopwatch::ElapsedMs() const
+{
+	return TicksToMs(SDL_GetPerformanceCounter() - m_start);
+}
+
+//!***************************************************************
+//! @details:
+//! converts a performance counter delta into milliseconds
+//!
+//! @param[in]: ticks
+//! performance counter ticks
+//!
+//! @return: 
+//! double - milliseconds
+//! 
+//!***************************************************************
+double Stopwatch::TicksToMs(Uint64 ticks)
+{
+	static const double msPerTick = 1e3 / static_cast<double>(SDL_GetPerformanceFrequency());
+
+	return static_cast<double>(ticks) * msPerTick;
+}
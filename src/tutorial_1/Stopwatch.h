@@ -0,0 +1,24 @@
+//*****************************************************************************
+// FILE NAME:  Stopwatch.h
+//
+//*****************************************************************************
+#ifndef STOPWATCH_H_
+#define STOPWATCH_H_
+
+#include "SDL.h"
+
+//! high resolution wall clock timer based on the SDL performance counter
+class Stopwatch
+{
+public:
+	Stopwatch();
+
+	void Start();
+	double ElapsedMs() const;
+
+	static double TicksToMs(Uint64 ticks);
+private:
+	Uint64 m_start;
+};
+
+#endif
@@ -1,156 +1,316 @@
-//*****************************************************************************
-// FILE NAME:  ViewController.cpp
-//
-//*****************************************************************************
-#include "view/camera.h"
-
-#include "Game.h"
-#include "ViewController.h"
-
-//!***************************************************************
-//! @details:
-//! constructor
-//!
-//! @param[in]: parent
-//! the Game object that owns this view controller
-//!
-//! @param[in]: camera
-//! an optional camera that this view controller will manipulate
-//!
-//!***************************************************************
-ViewController::ViewController(FIFE::Camera* camera)
-: m_camera(camera), m_zoomIncrement(0.75), 
-  m_maxZoom(4), m_minZoom(0.25), m_rotateIncrement(90)
-{
-
-}
-
-//!***************************************************************
-//! @details:
-//! destructor
-//!
-//!***************************************************************
-ViewController::~ViewController()
-{
-
-}
-
-//!***************************************************************
-//! @details:
-//! associates this view controller with a camera
-//!
-//! @param[in]: camera
-//! the camera that will be controlled
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void ViewController::AttachCamera(FIFE::Camera* camera)
-{
-	m_camera = camera;
-}
-
-//!***************************************************************
-//! @details:
-//! allows user the enable or disable the camera
-//!
-//! @param[in]: enable
-//! true - enable camera
-//! false - disables camera
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void ViewController::EnableCamera(bool enable)
-{
-	if (m_camera)
-	{
-		m_camera->setEnabled(enable);
-	}
-}
-
-//!***************************************************************
-//! @details:
-//! calculates the appropriate zoom level and increase the cameras
-//! zoom
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void ViewController::ZoomIn()
-{
-	if (m_camera)
-	{
-		// calculate the zoom in level
-		double zoom = m_camera->getZoom() / m_zoomIncrement;
-
-		if (zoom <= m_maxZoom)
-		{
-			m_camera->setZoom(zoom);
-		}
-	}
-}
-
-//!***************************************************************
-//! @details:
-//! calculates the appropriate zoom and zooms the camera out
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void ViewController::ZoomOut()
-{
-	if (m_camera)
-	{
-		// calculate the zoom out level
-		double zoom = m_camera->getZoom() * m_zoomIncrement;
-
-		if (zoom >= m_minZoom)
-		{
-			m_camera->setZoom(zoom);
-		}
-	}
-}
-
-//!***************************************************************
-//! @details:
-//! rotates the camera left by a fixed rotation increment
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void ViewController::RotateLeft()
-{
-	if (m_camera)
-	{
-		// calculate rotation
-		double rotation = static_cast<int>((m_camera->getRotation() - m_rotateIncrement)) % 360;
-
-		m_camera->setRotation(rotation);
-	}
-}
-
-//!***************************************************************
-//! @details:
-//! rotates the camera right by a fixed rotation amount
-//!
-//! @return: 
-//! void
-//! 
-//!***************************************************************
-void ViewController::RotateRight()
-{
-	if (m_camera)
-	{
-		// calculate rotation
-		double rotation = static_cast<int>((m_camera->getRotation() + m_rotateIncrement)) % 360;
-
-		m_camera->setRotation(rotation);
-	}
-}
-
+//*****************************************************************************
+// FILE NAME:  ViewController.cpp
+//
+//*****************************************************************************
+#include "model/structures/location.h"
+#include "view/camera.h"
+
+#include "Game.h"
+#include "ViewController.h"
+#include "Profiler.h"
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//! @param[in]: camera
+//! an optional camera that this view controller will manipulate
+//!
+//!***************************************************************
+ViewController::ViewController(FIFE::Camera* camera)
+: m_camera(camera), m_zoomIncrement(0.75), 
+  m_maxZoom(4), m_minZoom(0.25), m_rotateIncrement(90),
+  m_panX(0), m_panY(0), m_targetZoom(1.0), m_targetRotation(0.0),
+  m_hasPan(false), m_hasZoom(false), m_hasRotation(false),
+  m_pendingRequests(0), m_coalescedRequests(0)
+{
+	// apply the collected changes every frame, the time manager runs
+	// its events after the input events and before rendering
+	setPeriod(0);
+}
+
+//!***************************************************************
+//! @details:
+//! destructor
+//!
+//!***************************************************************
+ViewController::~ViewController()
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! associates this view controller with a camera
+//!
+//! @param[in]: camera
+//! the camera that will be controlled
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ViewController::AttachCamera(FIFE::Camera* camera)
+{
+	m_camera = camera;
+}
+
+//!***************************************************************
+//! @details:
+//! allows user the enable or disable the camera
+//!
+//! @param[in]: enable
+//! true - enable camera
+//! false - disables camera
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ViewController::EnableCamera(bool enable)
+{
+	if (m_camera)
+	{
+		m_camera->setEnabled(enable);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! moves the camera by a distance in screen pixels, pans of the
+//! same frame add up
+//!
+//! @param[in]: deltaX
+//! pixels to move to the right
+//!
+//! @param[in]: deltaY
+//! pixels to move down
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ViewController::Pan(int deltaX, int deltaY)
+{
+	m_panX += deltaX;
+	m_panY += deltaY;
+	m_hasPan = true;
+	++m_pendingRequests;
+}
+
+//!***************************************************************
+//! @details:
+//! calculates the appropriate zoom level and increase the cameras
+//! zoom
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ViewController::ZoomIn()
+{
+	if (m_camera)
+	{
+		// calculate the zoom in level
+		double zoom = GetTargetZoom() / m_zoomIncrement;
+
+		if (zoom <= m_maxZoom)
+		{
+			m_targetZoom = zoom;
+			m_hasZoom = true;
+			++m_pendingRequests;
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! calculates the appropriate zoom and zooms the camera out
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ViewController::ZoomOut()
+{
+	if (m_camera)
+	{
+		// calculate the zoom out level
+		double zoom = GetTargetZoom() * m_zoomIncrement;
+
+		if (zoom >= m_minZoom)
+		{
+			m_targetZoom = zoom;
+			m_hasZoom = true;
+			++m_pendingRequests;
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! rotates the camera left by a fixed rotation increment
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ViewController::RotateLeft()
+{
+	if (m_camera)
+	{
+		// calculate rotation
+		m_targetRotation = static_cast<int>((GetTargetRotation() - m_rotateIncrement)) % 360;
+		m_hasRotation = true;
+		++m_pendingRequests;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! rotates the camera right by a fixed rotation amount
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ViewController::RotateRight()
+{
+	if (m_camera)
+	{
+		// calculate rotation
+		m_targetRotation = static_cast<int>((GetTargetRotation() + m_rotateIncrement)) % 360;
+		m_hasRotation = true;
+		++m_pendingRequests;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! hands the collected pan, zoom and rotation to the camera, each
+//! camera setter runs at most once however many requests came in
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ViewController::ApplyPendingChanges()
+{
+	if (!m_camera || m_pendingRequests == 0)
+	{
+		return;
+	}
+
+	ScopedTimer timer(PHASE_CAMERA);
+
+	// the pan was measured at the current zoom and rotation,
+	// so it goes first
+	if (m_hasPan && (m_panX != 0 || m_panY != 0))
+	{
+		// the pan in map units, from the cached transform
+		const CameraTransform& transform = GetTransform();
+		FIFE::ExactModelCoordinate origin = transform.ToMap(FIFE::ScreenPoint(0, 0));
+		FIFE::ExactModelCoordinate moved = transform.ToMap(FIFE::ScreenPoint(m_panX, m_panY));
+
+		FIFE::Location camLocation(m_camera->getLocation());
+		FIFE::ExactModelCoordinate mapCoords = camLocation.getMapCoordinates();
+		mapCoords.x += moved.x - origin.x;
+		mapCoords.y += moved.y - origin.y;
+		mapCoords.z = 0.0;
+		camLocation.setMapCoordinates(mapCoords);
+		m_camera->setLocation(camLocation);
+	}
+
+	if (m_hasZoom)
+	{
+		m_camera->setZoom(m_targetZoom);
+	}
+
+	if (m_hasRotation)
+	{
+		m_camera->setRotation(m_targetRotation);
+	}
+
+	// count the requests that did not need their own camera update
+	int applied = (m_hasPan ? 1 : 0) + (m_hasZoom ? 1 : 0) + (m_hasRotation ? 1 : 0);
+	m_coalescedRequests += m_pendingRequests - applied;
+
+	m_panX = 0;
+	m_panY = 0;
+	m_hasPan = false;
+	m_hasZoom = false;
+	m_hasRotation = false;
+	m_pendingRequests = 0;
+}
+
+//!***************************************************************
+//! @details:
+//! number of requests merged into another request's camera update
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int ViewController::GetCoalescedRequests() const
+{
+	return m_coalescedRequests;
+}
+
+//!***************************************************************
+//! @details:
+//! screen <-> map conversion of the controlled camera, brought up
+//! to date with the camera first, needs an attached camera
+//!
+//! @return: 
+//! const CameraTransform&
+//! 
+//!***************************************************************
+const CameraTransform& ViewController::GetTransform()
+{
+	m_transform.Update(m_camera);
+	return m_transform;
+}
+
+//!***************************************************************
+//! @details:
+//! overridden from base class, called by the time manager once
+//! per frame
+//!
+//! @param[in]: time
+//! current engine time in ms
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void ViewController::updateEvent(uint32_t time)
+{
+	ApplyPendingChanges();
+}
+
+//!***************************************************************
+//! @details:
+//! zoom the camera will have once the pending changes are applied
+//!
+//! @return: 
+//! double
+//! 
+//!***************************************************************
+double ViewController::GetTargetZoom() const
+{
+	return m_hasZoom ? m_targetZoom : m_camera->getZoom();
+}
+
+//!***************************************************************
+//! @details:
+//! rotation the camera will have once the pending changes are
+//! applied
+//!
+//! @return: 
+//! double
+//! 
+//!***************************************************************
+double ViewController::GetTargetRotation() const
+{
+	return m_hasRotation ? m_targetRotation : m_camera->getRotation();
+}
\ No newline at end of file
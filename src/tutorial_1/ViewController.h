@@ -1,34 +1,62 @@
-//*****************************************************************************
-// FILE NAME:  ViewController.h
-//
-//*****************************************************************************
-#ifndef VIEW_CONTROLLER_H_
-#define VIEW_CONTROLLER_H_
-
-namespace FIFE
-{
-	class Camera;
-}
-
-//! provides manipulation of camera and view
-class ViewController
-{
-public:
-	ViewController(FIFE::Camera* camera=0);
-	~ViewController();
-	void AttachCamera(FIFE::Camera* camera);
-	void EnableCamera(bool enable);
-	void ZoomIn();
-	void ZoomOut();
-	void RotateLeft();
-	void RotateRight();
-private:
-	Game* m_parent;
-	FIFE::Camera* m_camera;
-	double m_zoomIncrement;
-	double m_maxZoom;
-	double m_minZoom;
-	double m_rotateIncrement;
-};
-
-#endif
+//*****************************************************************************
+// FILE NAME:  ViewController.h
+//
+//*****************************************************************************
+#ifndef VIEW_CONTROLLER_H_
+#define VIEW_CONTROLLER_H_
+
+#include "util/base/fife_stdint.h"
+#include "util/time/timeevent.h"
+
+#include "CameraTransform.h"
+
+namespace FIFE
+{
+	class Camera;
+}
+
+class Game;
+
+//! provides manipulation of camera and view, requested pans, zooms and
+//! rotations are collected and applied to the camera once per frame
+class ViewController : public FIFE::TimeEvent
+{
+public:
+	ViewController(FIFE::Camera* camera=0);
+	~ViewController();
+	void AttachCamera(FIFE::Camera* camera);
+	void EnableCamera(bool enable);
+	void Pan(int deltaX, int deltaY);
+	void ZoomIn();
+	void ZoomOut();
+	void RotateLeft();
+	void RotateRight();
+	void ApplyPendingChanges();
+	int GetCoalescedRequests() const;
+	const CameraTransform& GetTransform();
+protected:
+	// overridden from base class
+	virtual void updateEvent(uint32_t time);
+private:
+	double GetTargetZoom() const;
+	double GetTargetRotation() const;
+private:
+	Game* m_parent;
+	FIFE::Camera* m_camera;
+	double m_zoomIncrement;
+	double m_maxZoom;
+	double m_minZoom;
+	double m_rotateIncrement;
+	int m_panX;
+	int m_panY;
+	double m_targetZoom;
+	double m_targetRotation;
+	bool m_hasPan;
+	bool m_hasZoom;
+	bool m_hasRotation;
+	int m_pendingRequests;
+	int m_coalescedRequests;
+	CameraTransform m_transform;
+};
+
+#endif
@@ -0,0 +1,392 @@
+//*****************************************************************************
+// FILE NAME:  WalkGrid.cpp
+//
+//*****************************************************************************
+#include "WalkGrid.h"
+
+// standard includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+	// step costs of the cell_edges_and_diagonals pathing
+	const float StraightCost = 1.0f;
+	const float DiagonalCost = 1.41421356f;
+
+	const int NeighbourX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+	const int NeighbourY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+	//!***************************************************************
+	//! @details:
+	//! octile distance, the exact cost on an open grid
+	//!
+	//!***************************************************************
+	float Estimate(int x, int y, const GridPoint& goal)
+	{
+		int dx = std::abs(goal.x - x);
+		int dy = std::abs(goal.y - y);
+
+		return StraightCost * std::max(dx, dy) + (DiagonalCost - StraightCost) * std::min(dx, dy);
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! constructor
+//!
+//!***************************************************************
+PathScratch::PathScratch()
+: m_search(0)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! constructor, the grid is empty until it is reset
+//!
+//!***************************************************************
+WalkGrid::WalkGrid()
+: m_originX(0), m_originY(0), m_width(0), m_height(0)
+{
+
+}
+
+//!***************************************************************
+//! @details:
+//! resizes the grid, all cells start out walkable
+//!
+//! @param[in]: originX
+//! layer x coordinate of the first column
+//!
+//! @param[in]: originY
+//! layer y coordinate of the first row
+//!
+//! @param[in]: width
+//! number of columns
+//!
+//! @param[in]: height
+//! number of rows
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void WalkGrid::Reset(int originX, int originY, int width, int height)
+{
+	m_originX = originX;
+	m_originY = originY;
+	m_width = std::max(width, 0);
+	m_height = std::max(height, 0);
+	m_blocked.assign(static_cast<size_t>(m_width) * m_height, 0);
+}
+
+//!***************************************************************
+//! @details:
+//! marks a cell as blocked or walkable, cells outside the grid
+//! are ignored
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void WalkGrid::SetBlocked(int x, int y, bool blocked)
+{
+	if (Contains(x, y))
+	{
+		m_blocked[ToIndex(x, y)] = blocked ? 1 : 0;
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! cells outside the grid are never walkable
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+bool WalkGrid::IsWalkable(int x, int y) const
+{
+	return Contains(x, y) && !m_blocked[ToIndex(x, y)];
+}
+
+//!***************************************************************
+//! @details:
+//! true until the grid is reset to a non zero size
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+bool WalkGrid::IsEmpty() const
+{
+	return m_blocked.empty();
+}
+
+//!***************************************************************
+//! @details:
+//! layer x coordinate of the grid's first column
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int WalkGrid::GetOriginX() const
+{
+	return m_originX;
+}
+
+//!***************************************************************
+//! @details:
+//! layer y coordinate of the grid's first row
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int WalkGrid::GetOriginY() const
+{
+	return m_originY;
+}
+
+//!***************************************************************
+//! @details:
+//! number of columns
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int WalkGrid::GetWidth() const
+{
+	return m_width;
+}
+
+//!***************************************************************
+//! @details:
+//! number of rows
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int WalkGrid::GetHeight() const
+{
+	return m_height;
+}
+
+//!***************************************************************
+//! @details:
+//! A* search from start to goal over the 8 neighbours of each
+//! cell, diagonal steps may not cut blocked corners, only reads
+//! the grid so searches can run on several threads at once
+//!
+//! @param[in]: start
+//! cell to start from, may be blocked (e.g. by the agent itself)
+//!
+//! @param[in]: goal
+//! cell to reach
+//!
+//! @param[in]: scratch
+//! working memory owned by the calling thread
+//!
+//! @param[out]: path
+//! cells from start to goal, start included
+//!
+//! @param[in]: maxExpanded
+//! gives up after expanding this many cells
+//!
+//! @return: 
+//! bool - false if there is no path or the search gave up
+//! 
+//!***************************************************************
+bool WalkGrid::FindPath(const GridPoint& start, const GridPoint& goal, PathScratch& scratch,
+	std::vector<GridPoint>& path, int maxExpanded) const
+{
+	path.clear();
+
+	if (!Contains(start.x, start.y) || !IsWalkable(goal.x, goal.y))
+	{
+		return false;
+	}
+
+	size_t cellCount = m_blocked.size();
+	if (scratch.m_visited.size() != cellCount)
+	{
+		scratch.m_cost.assign(cellCount, 0.0f);
+		scratch.m_parent.assign(cellCount, -1);
+		scratch.m_visited.assign(cellCount, 0);
+		scratch.m_search = 0;
+	}
+
+	// cells visited by earlier searches carry older numbers,
+	// so the arrays never have to be cleared
+	if (++scratch.m_search == 0)
+	{
+		std::fill(scratch.m_visited.begin(), scratch.m_visited.end(), 0);
+		scratch.m_search = 1;
+	}
+
+	const unsigned int search = scratch.m_search;
+	const int goalIndex = ToIndex(goal.x, goal.y);
+
+	std::vector<PathScratch::OpenNode>& open = scratch.m_open;
+	open.clear();
+
+	int startIndex = ToIndex(start.x, start.y);
+	scratch.m_cost[startIndex] = 0.0f;
+	scratch.m_parent[startIndex] = -1;
+	scratch.m_visited[startIndex] = search;
+
+	PathScratch::OpenNode first = { Estimate(start.x, start.y, goal), startIndex };
+	open.push_back(first);
+
+	int expanded = 0;
+	bool found = false;
+
+	while (!open.empty() && expanded < maxExpanded)
+	{
+		std::pop_heap(open.begin(), open.end());
+		PathScratch::OpenNode node = open.back();
+		open.pop_back();
+
+		if (node.index == goalIndex)
+		{
+			found = true;
+			break;
+		}
+
+		int x = node.index % m_width;
+		int y = node.index / m_width;
+		float cost = scratch.m_cost[node.index];
+
+		// skip stale heap entries of cells reached cheaper since
+		if (node.cost > cost + Estimate(x + m_originX, y + m_originY, goal) + 0.001f)
+		{
+			continue;
+		}
+
+		++expanded;
+
+		for (int i = 0; i < 8; ++i)
+		{
+			int nx = x + NeighbourX[i];
+			int ny = y + NeighbourY[i];
+
+			if (nx < 0 || ny < 0 || nx >= m_width || ny >= m_height || m_blocked[ny * m_width + nx])
+			{
+				continue;
+			}
+
+			bool diagonal = (NeighbourX[i] != 0 && NeighbourY[i] != 0);
+			if (diagonal && (m_blocked[y * m_width + nx] || m_blocked[ny * m_width + x]))
+			{
+				continue;
+			}
+
+			int index = ny * m_width + nx;
+			float nextCost = cost + (diagonal ? DiagonalCost : StraightCost);
+
+			if (scratch.m_visited[index] == search && scratch.m_cost[index] <= nextCost)
+			{
+				continue;
+			}
+
+			scratch.m_visited[index] = search;
+			scratch.m_cost[index] = nextCost;
+			scratch.m_parent[index] = node.index;
+
+			PathScratch::OpenNode next = { nextCost + Estimate(nx + m_originX, ny + m_originY, goal), index };
+			open.push_back(next);
+			std::push_heap(open.begin(), open.end());
+		}
+	}
+
+	if (!found)
+	{
+		return false;
+	}
+
+	for (int index = goalIndex; index != -1; index = scratch.m_parent[index])
+	{
+		GridPoint point = { index % m_width + m_originX, index / m_width + m_originY };
+		path.push_back(point);
+	}
+	std::reverse(path.begin(), path.end());
+
+	return true;
+}
+
+//!***************************************************************
+//! @details:
+//! picks the cells of a path to walk to in straight lines, the
+//! cells where the path turns, the last cell and every cell that
+//! ends a run of maxRun steps
+//!
+//! @param[in]: path
+//! cells of a path, e.g. from FindPath
+//!
+//! @param[in]: first
+//! index of the cell the walker stands on, it is not included
+//!
+//! @param[in]: maxRun
+//! longest straight run between two waypoints
+//!
+//! @param[out]: waypoints
+//! indices into path, it is cleared first
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void WalkGrid::FindWaypoints(const std::vector<GridPoint>& path, size_t first, int maxRun,
+	std::vector<size_t>& waypoints)
+{
+	waypoints.clear();
+
+	int run = 0;
+	for (size_t i = first + 1; i < path.size(); ++i)
+	{
+		++run;
+
+		bool last = (i + 1 == path.size());
+		bool turns = !last &&
+			(path[i + 1].x - path[i].x != path[i].x - path[i - 1].x ||
+			 path[i + 1].y - path[i].y != path[i].y - path[i - 1].y);
+
+		if (last || turns || run >= maxRun)
+		{
+			waypoints.push_back(i);
+			run = 0;
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! true if the layer coordinate lies inside the grid
+//!
+//! @return: 
+//! bool
+//! 
+//!***************************************************************
+bool WalkGrid::Contains(int x, int y) const
+{
+	return x >= m_originX && y >= m_originY && x < m_originX + m_width && y < m_originY + m_height;
+}
+
+//!***************************************************************
+//! @details:
+//! array index of a layer coordinate inside the grid
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int WalkGrid::ToIndex(int x, int y) const
+{
+	return (y - m_originY) * m_width + (x - m_originX);
+}
@@ -0,0 +1,79 @@
+//*****************************************************************************
+// FILE NAME:  WalkGrid.h
+//
+//*****************************************************************************
+#ifndef WALK_GRID_H_
+#define WALK_GRID_H_
+
+#include <cstddef>
+#include <vector>
+
+//! integer cell on a walk grid, in layer coordinates
+struct GridPoint
+{
+	int x;
+	int y;
+};
+
+//! working memory of one path search, every thread searching the
+//! grid needs its own
+class PathScratch
+{
+public:
+	PathScratch();
+private:
+	friend class WalkGrid;
+
+	struct OpenNode
+	{
+		float cost;
+		int index;
+
+		bool operator<(const OpenNode& other) const
+		{
+			// std::push_heap keeps the largest on top
+			return cost > other.cost;
+		}
+	};
+
+	std::vector<float> m_cost;
+	std::vector<int> m_parent;
+	std::vector<unsigned int> m_visited;
+	std::vector<OpenNode> m_open;
+	unsigned int m_search;
+};
+
+//! snapshot of which cells of a layer can be walked on, searched with
+//! A* from any thread once it is filled, the engine is not involved
+class WalkGrid
+{
+public:
+	WalkGrid();
+
+	void Reset(int originX, int originY, int width, int height);
+	void SetBlocked(int x, int y, bool blocked);
+
+	bool IsWalkable(int x, int y) const;
+	bool IsEmpty() const;
+	int GetOriginX() const;
+	int GetOriginY() const;
+	int GetWidth() const;
+	int GetHeight() const;
+
+	bool FindPath(const GridPoint& start, const GridPoint& goal, PathScratch& scratch,
+		std::vector<GridPoint>& path, int maxExpanded = 50000) const;
+
+	static void FindWaypoints(const std::vector<GridPoint>& path, size_t first, int maxRun,
+		std::vector<size_t>& waypoints);
+private:
+	bool Contains(int x, int y) const;
+	int ToIndex(int x, int y) const;
+private:
+	int m_originX;
+	int m_originY;
+	int m_width;
+	int m_height;
+	std::vector<unsigned char> m_blocked;
+};
+
+#endif
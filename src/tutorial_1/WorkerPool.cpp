@@ -0,0 +1,159 @@
+//*****************************************************************************
+// FILE NAME:  WorkerPool.cpp
+//
+//*****************************************************************************
+#include "WorkerPool.h"
+
+// standard includes
+#include <cassert>
+
+//!***************************************************************
+//! @details:
+//! constructor, starts the worker threads
+//!
+//! @param[in]: threadCount
+//! number of threads, 0 uses one thread per core but leaves
+//! a core for the main thread
+//!
+//!***************************************************************
+WorkerPool::WorkerPool(int threadCount)
+: m_stopping(false)
+{
+	if (threadCount <= 0)
+	{
+		threadCount = SDL_GetCPUCount() - 1;
+	}
+
+	if (threadCount < 1)
+	{
+		threadCount = 1;
+	}
+
+	m_mutex = SDL_CreateMutex();
+	m_wake = SDL_CreateCond();
+
+	for (int i = 0; i < threadCount; ++i)
+	{
+		SDL_Thread* thread = SDL_CreateThread(&WorkerPool::ThreadMain, "worker", this);
+
+		if (thread)
+		{
+			m_threads.push_back(thread);
+		}
+	}
+}
+
+//!***************************************************************
+//! @details:
+//! destructor, finishes the queued jobs and joins the threads
+//!
+//!***************************************************************
+WorkerPool::~WorkerPool()
+{
+	SDL_LockMutex(m_mutex);
+	m_stopping = true;
+	SDL_CondBroadcast(m_wake);
+	SDL_UnlockMutex(m_mutex);
+
+	for (std::vector<SDL_Thread*>::iterator it = m_threads.begin(); it != m_threads.end(); ++it)
+	{
+		SDL_WaitThread(*it, 0);
+	}
+
+	SDL_DestroyCond(m_wake);
+	SDL_DestroyMutex(m_mutex);
+}
+
+//!***************************************************************
+//! @details:
+//! queues a job, the caller keeps ownership and must keep the
+//! job alive until it has run
+//!
+//! @param[in]: job
+//! the job to run
+//!
+//! @return: 
+//! void
+//! 
+//!***************************************************************
+void WorkerPool::Submit(WorkerJob* job)
+{
+	assert(job);
+
+	if (m_threads.empty())
+	{
+		// no threads could be started, run synchronously
+		job->Run();
+		return;
+	}
+
+	SDL_LockMutex(m_mutex);
+	m_queue.push_back(job);
+	SDL_CondSignal(m_wake);
+	SDL_UnlockMutex(m_mutex);
+}
+
+//!***************************************************************
+//! @details:
+//! number of worker threads
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int WorkerPool::GetThreadCount() const
+{
+	return static_cast<int>(m_threads.size());
+}
+
+//!***************************************************************
+//! @details:
+//! waits for the next job
+//!
+//! @return: 
+//! WorkerJob* - 0 once the pool is stopping and the queue is empty
+//! 
+//!***************************************************************
+WorkerJob* WorkerPool::Take()
+{
+	SDL_LockMutex(m_mutex);
+
+	while (m_queue.empty() && !m_stopping)
+	{
+		SDL_CondWait(m_wake, m_mutex);
+	}
+
+	WorkerJob* job = 0;
+	if (!m_queue.empty())
+	{
+		job = m_queue.front();
+		m_queue.pop_front();
+	}
+
+	SDL_UnlockMutex(m_mutex);
+
+	return job;
+}
+
+//!***************************************************************
+//! @details:
+//! worker thread loop
+//!
+//! @param[in]: data
+//! the owning pool
+//!
+//! @return: 
+//! int
+//! 
+//!***************************************************************
+int WorkerPool::ThreadMain(void* data)
+{
+	WorkerPool* pool = static_cast<WorkerPool*>(data);
+
+	while (WorkerJob* job = pool->Take())
+	{
+		job->Run();
+	}
+
+	return 0;
+}
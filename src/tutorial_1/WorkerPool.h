@@ -0,0 +1,46 @@
+//*****************************************************************************
+// FILE NAME:  WorkerPool.h
+//
+//*****************************************************************************
+#ifndef WORKER_POOL_H_
+#define WORKER_POOL_H_
+
+#include <deque>
+#include <vector>
+
+#include "SDL.h"
+
+//! unit of work executed on a worker thread
+class WorkerJob
+{
+public:
+	virtual ~WorkerJob() {}
+
+	// called on a worker thread, must not touch the engine
+	virtual void Run() = 0;
+};
+
+//! fixed set of threads running queued jobs
+class WorkerPool
+{
+public:
+	explicit WorkerPool(int threadCount = 0);
+	~WorkerPool();
+
+	void Submit(WorkerJob* job);
+	int GetThreadCount() const;
+private:
+	WorkerPool(const WorkerPool&);
+	WorkerPool& operator=(const WorkerPool&);
+
+	static int ThreadMain(void* data);
+	WorkerJob* Take();
+private:
+	std::vector<SDL_Thread*> m_threads;
+	std::deque<WorkerJob*> m_queue;
+	SDL_mutex* m_mutex;
+	SDL_cond* m_wake;
+	bool m_stopping;
+};
+
+#endif
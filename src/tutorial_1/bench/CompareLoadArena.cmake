@@ -0,0 +1,68 @@
+#------------------------------------------------------------------------------
+#                      Tutorial 1 load arena comparison
+#------------------------------------------------------------------------------
+# run with cmake -P, expects:
+#   TUTORIAL    path of the Tutorial1 executable
+#   MAPS        list of bundled map files
+#   RUNS        number of loads per map and mode
+#
+# every map is loaded headless with the load arena and with --no-load-arena.
+# the fastest load of each mode and its allocation counts are collected into
+# load_arena.csv in the Tutorial1 folder. heap allocations are only reported by
+# a Tutorial1 built with TUTORIAL1_TRACK_MEMORY.
+
+foreach(var TUTORIAL MAPS RUNS)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "CompareLoadArena.cmake: ${var} is not set")
+    endif()
+endforeach()
+
+get_filename_component(workDir ${TUTORIAL} DIRECTORY)
+set(csv ${workDir}/load_arena.csv)
+set(report ${workDir}/load_arena.json)
+
+file(WRITE ${csv} "map,mode,load_time_ms,heap_allocations,arena_allocations\n")
+
+include(${CMAKE_CURRENT_LIST_DIR}/JsonReport.cmake)
+
+foreach(map ${MAPS})
+    foreach(mode arena heap)
+        set(args)
+        if(mode STREQUAL "heap")
+            set(args --no-load-arena)
+        endif()
+
+        set(bestTime)
+        set(bestThousandths)
+        foreach(run RANGE 1 ${RUNS})
+            execute_process(COMMAND ${TUTORIAL} --headless --map ${map} --scenario still --benchmark 1
+                                    --output ${report} ${args}
+                            WORKING_DIRECTORY ${workDir} RESULT_VARIABLE result)
+            if(NOT result EQUAL 0)
+                message(FATAL_ERROR "Tutorial1 failed to load ${map}")
+            endif()
+
+            file(READ ${report} json)
+            read_report_value("${json}" load_time_ms loadTime)
+            to_thousandths(${loadTime} loadThousandths)
+
+            if("${bestThousandths}" STREQUAL "" OR loadThousandths LESS bestThousandths)
+                set(bestTime ${loadTime})
+                set(bestThousandths ${loadThousandths})
+            endif()
+        endforeach()
+
+        # the counts do not change between runs, the last report has them
+        read_report_value("${json}" load_arena_allocations arenaAllocations)
+        read_report_value("${json}" load_heap_allocations heapAllocations)
+        if("${heapAllocations}" STREQUAL "")
+            set(heapAllocations "n/a")
+        endif()
+
+        file(APPEND ${csv} "${map},${mode},${bestTime},${heapAllocations},${arenaAllocations}\n")
+        message(STATUS "${map} ${mode}: load ${bestTime} ms, ${heapAllocations} heap allocations, "
+                       "${arenaAllocations} arena allocations")
+    endforeach()
+endforeach()
+
+message(STATUS "results written to ${csv}")
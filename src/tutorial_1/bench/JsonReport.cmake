@@ -0,0 +1,42 @@
+#------------------------------------------------------------------------------
+#                      Tutorial 1 benchmark report helpers
+#------------------------------------------------------------------------------
+# included by the benchmark scripts that read the json report Tutorial1
+# writes in benchmark mode
+
+# reads a number following "key": in the benchmark json report
+macro(read_json_number json key out)
+    string(REGEX MATCH "\"${key}\": *[0-9.eE+-]+" ${out} "${json}")
+    string(REGEX REPLACE ".*: *" "" ${out} "${${out}}")
+endmacro()
+
+# reads a value from a report, the frame time percentiles are looked up in
+# the frame time block so the keys don't clash with the other values
+macro(read_report_value json key out)
+    if("${key}" MATCHES "^(mean|p50|p95|p99|max)$")
+        string(REGEX REPLACE ".*\"frame_time_ms\"" "" _frameJson "${json}")
+        read_json_number("${_frameJson}" ${key} ${out})
+    else()
+        read_json_number("${json}" ${key} ${out})
+    endif()
+endmacro()
+
+# turns a decimal like 12.345 into an integer count of thousandths (12345)
+# since math() only knows integers, values below 0.001 round down to 0
+macro(to_thousandths value out)
+    if("${value}" MATCHES "[eE]-")
+        set(${out} 0)
+    else()
+        string(REGEX REPLACE "\\..*" "" _whole "${value}")
+        if("${_whole}" STREQUAL "")
+            set(_whole 0)
+        endif()
+        string(REGEX MATCH "[0-9]*$" _fraction "${value}")
+        if(NOT "${value}" MATCHES "\\.")
+            set(_fraction "")
+        endif()
+        set(_fraction "${_fraction}000")
+        string(SUBSTRING "${_fraction}" 0 3 _fraction)
+        math(EXPR ${out} "${_whole} * 1000 + 1${_fraction} - 1000")
+    endif()
+endmacro()
@@ -0,0 +1,93 @@
+#------------------------------------------------------------------------------
+#                    Tutorial 1 performance regression test
+#------------------------------------------------------------------------------
+# run with cmake -P, expects:
+#   TUTORIAL    path of the Tutorial1 executable
+#   MAP         bundled map to run on, e.g. shrine.xml
+#   SCENARIO    benchmark camera path, see Tutorial1 --scenario
+#   FRAMES      number of benchmark frames
+#   CROWD       number of agents to spawn, 0 for none
+#   METRICS     comma separated report values compared to the baseline, e.g. p50,p95
+#   BASELINE    baseline report of the same run
+#   TOLERANCE   allowed slowdown as a fraction of the baseline, e.g. 0.15
+#   SLACK_MS    allowed slowdown in ms on top, absorbs timer noise on small values
+#   UPDATE      if true the report replaces the baseline instead of being checked
+#   REQUIRE_BASELINE  optional, if true a missing baseline fails the test
+#   ARGS        optional, more Tutorial1 options separated by spaces, e.g. --hud
+#
+# runs Tutorial1 headless in benchmark mode and fails if any metric is more
+# than the tolerance above its baseline. a missing baseline skips the test,
+# or fails it when a baseline is required.
+
+foreach(var TUTORIAL MAP SCENARIO FRAMES CROWD METRICS BASELINE TOLERANCE SLACK_MS)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "RunPerfTest.cmake: ${var} is not set")
+    endif()
+endforeach()
+
+include(${CMAKE_CURRENT_LIST_DIR}/JsonReport.cmake)
+
+string(REPLACE "," ";" METRICS "${METRICS}")
+separate_arguments(ARGS)
+
+get_filename_component(workDir ${TUTORIAL} DIRECTORY)
+get_filename_component(baselineName ${BASELINE} NAME)
+set(report ${workDir}/perf_${baselineName})
+
+if(NOT UPDATE AND NOT EXISTS ${BASELINE} AND REQUIRE_BASELINE)
+    message(FATAL_ERROR "the baseline ${BASELINE} is missing and TUTORIAL1_PERF_REQUIRE_BASELINE is on, record one with -DTUTORIAL1_PERF_UPDATE_BASELINES=ON")
+endif()
+
+if(NOT UPDATE AND NOT EXISTS ${BASELINE})
+    message(STATUS "no baseline ${BASELINE}, configure with -DTUTORIAL1_PERF_UPDATE_BASELINES=ON and run the tests to record one")
+    return()
+endif()
+
+execute_process(COMMAND ${TUTORIAL} --headless --map ${MAP} --scenario ${SCENARIO} --benchmark ${FRAMES}
+                        --crowd ${CROWD} --output ${report} ${ARGS}
+                WORKING_DIRECTORY ${workDir} RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Tutorial1 benchmark failed on ${MAP}, scenario ${SCENARIO}")
+endif()
+
+if(UPDATE)
+    get_filename_component(baselineDir ${BASELINE} DIRECTORY)
+    file(MAKE_DIRECTORY ${baselineDir})
+    file(READ ${report} json)
+    file(WRITE ${BASELINE} "${json}")
+    message(STATUS "baseline written to ${BASELINE}")
+    return()
+endif()
+
+file(READ ${report} json)
+file(READ ${BASELINE} baselineJson)
+
+to_thousandths("${TOLERANCE}" tolerancePerMille)
+to_thousandths("${SLACK_MS}" slackUs)
+
+set(failed "")
+
+foreach(metric ${METRICS})
+    read_report_value("${json}" ${metric} value)
+    read_report_value("${baselineJson}" ${metric} baselineValue)
+
+    if("${value}" STREQUAL "" OR "${baselineValue}" STREQUAL "")
+        message(FATAL_ERROR "${metric} is missing from the report or the baseline")
+    endif()
+
+    # math() only does integers, compare in microseconds
+    to_thousandths("${value}" valueUs)
+    to_thousandths("${baselineValue}" baselineUs)
+    math(EXPR limitUs "${baselineUs} + ${baselineUs} * ${tolerancePerMille} / 1000 + ${slackUs}")
+
+    if(valueUs GREATER limitUs)
+        message(STATUS "REGRESSION ${metric}: ${value} ms, baseline ${baselineValue} ms")
+        list(APPEND failed ${metric})
+    else()
+        message(STATUS "ok ${metric}: ${value} ms, baseline ${baselineValue} ms")
+    endif()
+endforeach()
+
+if(failed)
+    message(FATAL_ERROR "${MAP} ${SCENARIO}: ${failed} slower than the baseline allows (tolerance ${TOLERANCE}, slack ${SLACK_MS} ms)")
+endif()
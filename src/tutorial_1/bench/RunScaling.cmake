@@ -0,0 +1,67 @@
+#------------------------------------------------------------------------------
+#                      Tutorial 1 map size scaling benchmark
+#------------------------------------------------------------------------------
+# run with cmake -P, expects:
+#   GENERATOR   path of the MapGenerator executable
+#   COMPILER    path of the MapCompiler executable
+#   TUTORIAL    path of the Tutorial1 executable
+#   SIZES       list of instance counts
+#   FRAMES      number of benchmark frames per map
+#
+# for every size a map is generated and compiled into the assets/maps folder
+# next to Tutorial1, then run headless along the benchmark camera path. the
+# results are collected into scaling.csv in the Tutorial1 folder. with the
+# asset pack only the fonts are copied next to Tutorial1, so the folder is
+# created here and the map's ../objects imports are read from the pack.
+
+foreach(var GENERATOR COMPILER TUTORIAL SIZES FRAMES)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "RunScaling.cmake: ${var} is not set")
+    endif()
+endforeach()
+
+get_filename_component(workDir ${TUTORIAL} DIRECTORY)
+set(mapDir ${workDir}/assets/maps)
+set(csv ${workDir}/scaling.csv)
+
+# MapGenerator does not create missing folders
+file(MAKE_DIRECTORY ${mapDir})
+
+file(WRITE ${csv} "instances,load_time_ms,peak_rss_bytes,frame_mean_ms,frame_p50_ms,frame_p99_ms\n")
+
+include(${CMAKE_CURRENT_LIST_DIR}/JsonReport.cmake)
+
+foreach(size ${SIZES})
+    set(map generated_${size}.xml)
+    set(report ${workDir}/scaling_${size}.json)
+
+    message(STATUS "generating ${size} instances")
+    execute_process(COMMAND ${GENERATOR} ${size} ${mapDir}/${map} RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "MapGenerator failed for ${size} instances")
+    endif()
+
+    execute_process(COMMAND ${COMPILER} ${mapDir}/${map} ${mapDir}/${map}.cache RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "MapCompiler failed for ${size} instances")
+    endif()
+
+    execute_process(COMMAND ${TUTORIAL} --headless --map ${map} --benchmark ${FRAMES} --output ${report}
+                    WORKING_DIRECTORY ${workDir} RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Tutorial1 benchmark failed for ${size} instances")
+    endif()
+
+    file(READ ${report} json)
+
+    read_report_value("${json}" load_time_ms loadTime)
+    read_report_value("${json}" peak_rss_bytes peakRss)
+    read_report_value("${json}" mean mean)
+    read_report_value("${json}" p50 p50)
+    read_report_value("${json}" p99 p99)
+
+    file(APPEND ${csv} "${size},${loadTime},${peakRss},${mean},${p50},${p99}\n")
+    message(STATUS "${size} instances: load ${loadTime} ms, peak ${peakRss} bytes, frame p50 ${p50} ms, p99 ${p99} ms")
+endforeach()
+
+message(STATUS "results written to ${csv}")
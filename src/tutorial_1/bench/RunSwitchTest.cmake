@@ -0,0 +1,53 @@
+#------------------------------------------------------------------------------
+#                      Tutorial 1 map switch frame budget test
+#------------------------------------------------------------------------------
+# run with cmake -P, expects:
+#   TUTORIAL    path of the Tutorial1 executable
+#   MAP         bundled map the run starts on, e.g. shrine.xml
+#   SWITCH_MAP  bundled map loaded in the background and switched to
+#   FRAMES      number of benchmark frames, the switch has to fit in them
+#   BUDGET_MS   longest frame allowed while the switch is in progress
+#
+# runs Tutorial1 headless with the switch scenario and fails if the switch did
+# not finish within the run or any frame of it took longer than the budget.
+# unlike the other performance tests it needs no baseline.
+
+foreach(var TUTORIAL MAP SWITCH_MAP FRAMES BUDGET_MS)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "RunSwitchTest.cmake: ${var} is not set")
+    endif()
+endforeach()
+
+include(${CMAKE_CURRENT_LIST_DIR}/JsonReport.cmake)
+
+get_filename_component(workDir ${TUTORIAL} DIRECTORY)
+get_filename_component(mapName ${MAP} NAME_WE)
+set(report ${workDir}/perf_${mapName}_switch.json)
+
+execute_process(COMMAND ${TUTORIAL} --headless --map ${MAP} --switch-map ${SWITCH_MAP} --scenario switch
+                        --benchmark ${FRAMES} --output ${report}
+                WORKING_DIRECTORY ${workDir} RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Tutorial1 benchmark failed switching from ${MAP} to ${SWITCH_MAP}")
+endif()
+
+file(READ ${report} json)
+
+if(NOT json MATCHES "\"switch_completed\": *true")
+    message(FATAL_ERROR "${MAP} to ${SWITCH_MAP}: the switch did not finish within ${FRAMES} frames")
+endif()
+
+read_report_value("${json}" switch_frames switchFrames)
+read_report_value("${json}" switch_ms switchTime)
+read_report_value("${json}" switch_worst_frame_ms worstFrame)
+
+# math() only does integers, compare in microseconds
+to_thousandths("${worstFrame}" worstUs)
+to_thousandths("${BUDGET_MS}" budgetUs)
+
+message(STATUS "${MAP} to ${SWITCH_MAP}: ${switchFrames} frames, ${switchTime} ms, worst frame ${worstFrame} ms")
+
+if(worstUs GREATER budgetUs)
+    message(FATAL_ERROR "${MAP} to ${SWITCH_MAP}: worst frame of the switch took ${worstFrame} ms, "
+                        "the budget is ${BUDGET_MS} ms")
+endif()
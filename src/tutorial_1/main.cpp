@@ -1,17 +1,25 @@
-//*****************************************************************************
-// FILE NAME:  main.cpp
-//
-//*****************************************************************************
-#include "Game.h"
-
-int main(int argc, char *argv[])
-{
-	// create and initialize game
-	Game game;
-	game.Init();
-
-	// run the game
-	game.Run();
-
-	return 0;
+//*****************************************************************************
+// FILE NAME:  main.cpp
+//
+//*****************************************************************************
+#include "Game.h"
+
+int main(int argc, char *argv[])
+{
+	// read the command line options
+	GameOptions options;
+	if (!options.Parse(argc, argv))
+	{
+		GameOptions::PrintUsage(argv[0]);
+		return 1;
+	}
+
+	// create and initialize game
+	Game game(options);
+	game.Init();
+
+	// run the game
+	game.Run();
+
+	return 0;
 }
\ No newline at end of file
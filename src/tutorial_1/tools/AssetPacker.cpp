@@ -0,0 +1,91 @@
+//*****************************************************************************
+// FILE NAME:  AssetPacker.cpp
+//
+//*****************************************************************************
+// offline tool that writes every file below a directory into one asset
+// pack. the files are stored under the given name prefix followed by
+// their path relative to the directory, so packing a copy of the assets
+// with the prefix "assets" keeps the paths the game already uses
+//
+// usage: AssetPacker <pack file> <name prefix> <directory>
+
+#include "../AssetPackFormat.h"
+
+// 3rd party includes
+#include "boost/filesystem.hpp"
+
+// standard includes
+#include <iostream>
+#include <string>
+
+namespace fs = boost::filesystem;
+
+//!***************************************************************
+//! @details:
+//! entry point of the asset packer
+//!
+//! @param[in]: argc
+//! number of arguments
+//!
+//! @param[in]: argv
+//! the arguments
+//!
+//! @return:
+//! int - 0 on success
+//!
+//!***************************************************************
+int main(int argc, char *argv[])
+{
+	if (argc != 4)
+	{
+		std::cerr << "usage: " << argv[0] << " <pack file> <name prefix> <directory>" << std::endl;
+		return 1;
+	}
+
+	std::string packFile(argv[1]);
+	fs::path prefix(argv[2]);
+	fs::path directory(argv[3]);
+
+	// a trailing slash would show up as a "." in the relative paths
+	if (directory.filename() == ".")
+	{
+		directory = directory.parent_path();
+	}
+
+	boost::system::error_code error;
+	if (!fs::is_directory(directory, error))
+	{
+		std::cerr << directory.string() << " is not a directory" << std::endl;
+		return 1;
+	}
+
+	AssetPack::Writer writer;
+	std::string root = directory.string();
+
+	for (fs::recursive_directory_iterator it(directory, error), end; it != end; it.increment(error))
+	{
+		if (!fs::is_regular_file(it->path(), error))
+		{
+			continue;
+		}
+
+		std::string relative = it->path().string().substr(root.size() + 1);
+		writer.AddFile((prefix / relative).string(), it->path().string());
+	}
+
+	if (error)
+	{
+		std::cerr << "could not read " << directory.string() << ": " << error.message() << std::endl;
+		return 1;
+	}
+
+	if (!writer.Write(packFile))
+	{
+		std::cerr << "could not write " << packFile << std::endl;
+		return 1;
+	}
+
+	std::cout << packFile << ": " << writer.GetFileCount() << " files" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,637 @@
+//*****************************************************************************
+// FILE NAME:  AtlasPacker.cpp
+//
+//*****************************************************************************
+// offline tool that merges the images of all objects below a directory
+// into a few large atlases. the objects' static images and the frames of
+// their per-action sprite sheets become sub-images of the atlases, the
+// atlas file uses the same <?fife type="atlas"?> format as nature.xml and
+// carries the object definitions rewritten to reference its sub-images.
+// the merged object.xml files and images are removed, so it is meant to
+// run on the copy of the assets next to the executable
+//
+// usage: AtlasPacker <object directory> <atlas name> [max atlas size]
+
+#define SDL_MAIN_HANDLED
+
+// 3rd party includes
+#include "boost/filesystem.hpp"
+#include "SDL.h"
+#include "SDL_image.h"
+#include "tinyxml.h"
+
+// standard includes
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+	// largest atlas page written, fits the texture size limit of old gpus
+	const int DefaultMaxAtlasSize = 2048;
+
+	// free space kept around each sub-image so filtering does not bleed
+	const int Padding = 1;
+
+	//! region of a source image that becomes one sub-image of an atlas
+	struct Sprite
+	{
+		std::string name;
+		SDL_Surface* surface;
+		SDL_Rect area;
+		int page;
+		int x;
+		int y;
+	};
+
+	//! fills atlas pages row by row, a row is as high as its highest sprite
+	struct ShelfPacker
+	{
+		explicit ShelfPacker(int maxSize)
+		: maxSize(maxSize), pages(0), x(0), y(0), shelfHeight(0)
+		{
+		}
+
+		bool Place(Sprite& sprite)
+		{
+			int width = sprite.area.w + Padding;
+			int height = sprite.area.h + Padding;
+
+			if (width > maxSize || height > maxSize)
+			{
+				return false;
+			}
+
+			if (pages == 0 || x + width > maxSize)
+			{
+				x = 0;
+				y += shelfHeight;
+				shelfHeight = 0;
+			}
+
+			if (pages == 0 || y + height > maxSize)
+			{
+				++pages;
+				x = 0;
+				y = 0;
+				shelfHeight = 0;
+				widths.push_back(0);
+				heights.push_back(0);
+			}
+
+			sprite.page = pages - 1;
+			sprite.x = x;
+			sprite.y = y;
+
+			x += width;
+			shelfHeight = std::max(shelfHeight, height);
+			widths.back() = std::max(widths.back(), x);
+			heights.back() = std::max(heights.back(), y + height);
+
+			return true;
+		}
+
+		int maxSize;
+		int pages;
+		int x;
+		int y;
+		int shelfHeight;
+		std::vector<int> widths;
+		std::vector<int> heights;
+	};
+
+	//!***************************************************************
+	//! @details:
+	//! sorts sprites by height, highest first, so the shelves are
+	//! filled evenly
+	//!
+	//! @return:
+	//! bool
+	//!
+	//!***************************************************************
+	bool IsTaller(const Sprite& lhs, const Sprite& rhs)
+	{
+		return lhs.area.h > rhs.area.h;
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! path of a file relative to a directory, with forward slashes
+	//! like in the xml files
+	//!
+	//! @return:
+	//! std::string
+	//!
+	//!***************************************************************
+	std::string RelativePath(const fs::path& file, const fs::path& directory)
+	{
+		std::string result;
+		fs::path::iterator base = directory.begin();
+		fs::path::iterator it = file.begin();
+
+		for (; base != directory.end() && it != file.end() && *base == *it; ++base, ++it)
+		{
+		}
+
+		for (; it != file.end(); ++it)
+		{
+			if (!result.empty())
+			{
+				result += "/";
+			}
+			result += it->string();
+		}
+
+		return result;
+	}
+
+	//! loaded source images and the sprites cut from them
+	class Packer
+	{
+	public:
+		Packer(const fs::path& directory, int maxSize)
+		: m_directory(directory), m_packer(maxSize), m_sourceImages(0)
+		{
+		}
+
+		~Packer()
+		{
+			for (std::map<std::string, SDL_Surface*>::iterator it = m_surfaces.begin(); it != m_surfaces.end(); ++it)
+			{
+				SDL_FreeSurface(it->second);
+			}
+		}
+
+		bool AddObjectFile(const fs::path& file);
+		bool Write(const std::string& atlasName);
+		void RemoveSources();
+		void PrintReport(const std::string& atlasName) const;
+	private:
+		SDL_Surface* Load(const fs::path& file);
+		bool AddSprite(const std::string& name, SDL_Surface* surface, const SDL_Rect& area);
+		bool RewriteImages(TiXmlElement* object, const fs::path& objectDirectory);
+		bool RewriteAnimations(TiXmlElement* object, const fs::path& objectDirectory);
+	private:
+		fs::path m_directory;
+		ShelfPacker m_packer;
+		std::map<std::string, SDL_Surface*> m_surfaces;
+		std::vector<Sprite> m_sprites;
+		std::set<std::string> m_spriteNames;
+		std::vector<TiXmlElement*> m_objects;
+		std::vector<fs::path> m_sources;
+		std::string m_namespace;
+		int m_sourceImages;
+	};
+
+	//!***************************************************************
+	//! @details:
+	//! loads an image once and keeps it for cutting sprites from
+	//!
+	//! @return:
+	//! SDL_Surface* - 0 if the image could not be read
+	//!
+	//!***************************************************************
+	SDL_Surface* Packer::Load(const fs::path& file)
+	{
+		std::map<std::string, SDL_Surface*>::iterator it = m_surfaces.find(file.string());
+		if (it != m_surfaces.end())
+		{
+			return it->second;
+		}
+
+		SDL_Surface* loaded = IMG_Load(file.string().c_str());
+		if (!loaded)
+		{
+			std::cerr << file.string() << ": " << IMG_GetError() << std::endl;
+			return 0;
+		}
+
+		// copy the pixels as they are, alpha included
+		SDL_Surface* surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+		SDL_FreeSurface(loaded);
+		if (!surface)
+		{
+			std::cerr << file.string() << ": " << SDL_GetError() << std::endl;
+			return 0;
+		}
+		SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+
+		m_surfaces[file.string()] = surface;
+		m_sources.push_back(file);
+		++m_sourceImages;
+
+		return surface;
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! adds a sub-image to the atlas, sprites with the same name are
+	//! only added once
+	//!
+	//! @return:
+	//! bool
+	//!
+	//!***************************************************************
+	bool Packer::AddSprite(const std::string& name, SDL_Surface* surface, const SDL_Rect& area)
+	{
+		if (!m_spriteNames.insert(name).second)
+		{
+			return true;
+		}
+
+		if (area.x < 0 || area.y < 0 || area.x + area.w > surface->w || area.y + area.h > surface->h)
+		{
+			std::cerr << name << " lies outside of its source image" << std::endl;
+			return false;
+		}
+
+		Sprite sprite;
+		sprite.name = name;
+		sprite.surface = surface;
+		sprite.area = area;
+		sprite.page = 0;
+		sprite.x = 0;
+		sprite.y = 0;
+		m_sprites.push_back(sprite);
+
+		return true;
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! points the static images of an object at atlas sub-images,
+	//! they keep their file name relative to the atlas directory
+	//!
+	//! @return:
+	//! bool
+	//!
+	//!***************************************************************
+	bool Packer::RewriteImages(TiXmlElement* object, const fs::path& objectDirectory)
+	{
+		for (TiXmlElement* image = object->FirstChildElement("image"); image; image = image->NextSiblingElement("image"))
+		{
+			const char* source = image->Attribute("source");
+			if (!source)
+			{
+				continue;
+			}
+
+			fs::path file = objectDirectory / source;
+			SDL_Surface* surface = Load(file);
+			if (!surface)
+			{
+				return false;
+			}
+
+			std::string name = RelativePath(file, m_directory);
+			SDL_Rect area = { 0, 0, surface->w, surface->h };
+			if (!AddSprite(name, surface, area))
+			{
+				return false;
+			}
+
+			image->SetAttribute("source", name.c_str());
+		}
+
+		return true;
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! splits the sprite sheet animations of an object into frames
+	//! and replaces each sheet with one animation per direction that
+	//! lists its frames as atlas sub-images
+	//!
+	//! @return:
+	//! bool
+	//!
+	//!***************************************************************
+	bool Packer::RewriteAnimations(TiXmlElement* object, const fs::path& objectDirectory)
+	{
+		for (TiXmlElement* action = object->FirstChildElement("action"); action; action = action->NextSiblingElement("action"))
+		{
+			std::vector<TiXmlElement*> sheets;
+			for (TiXmlElement* animation = action->FirstChildElement("animation"); animation; animation = animation->NextSiblingElement("animation"))
+			{
+				if (animation->Attribute("atlas"))
+				{
+					sheets.push_back(animation);
+				}
+			}
+
+			for (std::vector<TiXmlElement*>::iterator sheet = sheets.begin(); sheet != sheets.end(); ++sheet)
+			{
+				fs::path file = objectDirectory / (*sheet)->Attribute("atlas");
+				SDL_Surface* surface = Load(file);
+				if (!surface)
+				{
+					return false;
+				}
+
+				int width = 0;
+				int height = 0;
+				if ((*sheet)->QueryIntAttribute("width", &width) != TIXML_SUCCESS ||
+					(*sheet)->QueryIntAttribute("height", &height) != TIXML_SUCCESS)
+				{
+					std::cerr << file.string() << ": animation without a frame size" << std::endl;
+					return false;
+				}
+
+				// frames of the sheet are named after the sheet without
+				// its extension, e.g. walk.png -> walk/045_3.png
+				std::string prefix = RelativePath(file.parent_path() / file.stem(), m_directory);
+
+				// every direction is a row of the sheet
+				int row = 0;
+				for (TiXmlElement* direction = (*sheet)->FirstChildElement("direction"); direction; direction = direction->NextSiblingElement("direction"), ++row)
+				{
+					int dir = 0;
+					int frames = 0;
+					int delay = 0;
+					direction->QueryIntAttribute("dir", &dir);
+					direction->QueryIntAttribute("frames", &frames);
+					direction->QueryIntAttribute("delay", &delay);
+
+					TiXmlElement animation("animation");
+					animation.SetAttribute("direction", dir);
+
+					// offsets and anything else that is not about the sheet layout is kept
+					for (const TiXmlAttribute* attr = (*sheet)->FirstAttribute(); attr; attr = attr->Next())
+					{
+						if (std::strcmp(attr->Name(), "atlas") != 0 && std::strcmp(attr->Name(), "width") != 0 &&
+							std::strcmp(attr->Name(), "height") != 0)
+						{
+							animation.SetAttribute(attr->Name(), attr->Value());
+						}
+					}
+
+					for (int frame = 0; frame < frames; ++frame)
+					{
+						std::ostringstream name;
+						name << prefix << "/" << std::setw(3) << std::setfill('0') << dir << "_" << frame << ".png";
+
+						SDL_Rect area = { frame * width, row * height, width, height };
+						if (!AddSprite(name.str(), surface, area))
+						{
+							return false;
+						}
+
+						TiXmlElement frameElement("frame");
+						frameElement.SetAttribute("source", name.str().c_str());
+						frameElement.SetAttribute("delay", delay);
+						animation.InsertEndChild(frameElement);
+					}
+
+					action->InsertBeforeChild(*sheet, animation);
+				}
+
+				action->RemoveChild(*sheet);
+			}
+		}
+
+		return true;
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! reads an object file and queues its images for the atlas
+	//!
+	//! @return:
+	//! bool
+	//!
+	//!***************************************************************
+	bool Packer::AddObjectFile(const fs::path& file)
+	{
+		TiXmlDocument document;
+		if (!document.LoadFile(file.string().c_str()))
+		{
+			std::cerr << file.string() << ": " << document.ErrorDesc() << std::endl;
+			return false;
+		}
+
+		const TiXmlElement* root = document.RootElement();
+		if (!root || std::strcmp(root->Value(), "object") != 0)
+		{
+			std::cerr << file.string() << " is not an object file" << std::endl;
+			return false;
+		}
+
+		TiXmlElement* object = static_cast<TiXmlElement*>(root->Clone());
+		m_objects.push_back(object);
+		m_sources.push_back(file);
+
+		if (m_namespace.empty() && object->Attribute("namespace"))
+		{
+			m_namespace = object->Attribute("namespace");
+		}
+
+		return RewriteImages(object, file.parent_path()) && RewriteAnimations(object, file.parent_path());
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! packs the sprites into atlas pages and writes the pages and
+	//! the atlas file with the rewritten objects
+	//!
+	//! @return:
+	//! bool
+	//!
+	//!***************************************************************
+	bool Packer::Write(const std::string& atlasName)
+	{
+		// equal heights stay in the order the objects were read, so
+		// the frames of an object end up next to each other
+		std::stable_sort(m_sprites.begin(), m_sprites.end(), IsTaller);
+
+		for (std::vector<Sprite>::iterator it = m_sprites.begin(); it != m_sprites.end(); ++it)
+		{
+			if (!m_packer.Place(*it))
+			{
+				std::cerr << it->name << " does not fit into a " << m_packer.maxSize << " pixel atlas" << std::endl;
+				return false;
+			}
+		}
+
+		std::vector<std::string> pageNames;
+		for (int page = 0; page < m_packer.pages; ++page)
+		{
+			std::ostringstream pageName;
+			pageName << atlasName << page << ".png";
+			pageNames.push_back(pageName.str());
+
+			SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, m_packer.widths[page], m_packer.heights[page], 32, SDL_PIXELFORMAT_RGBA32);
+			if (!surface)
+			{
+				std::cerr << pageName.str() << ": " << SDL_GetError() << std::endl;
+				return false;
+			}
+			SDL_FillRect(surface, 0, SDL_MapRGBA(surface->format, 0, 0, 0, 0));
+
+			for (std::vector<Sprite>::iterator it = m_sprites.begin(); it != m_sprites.end(); ++it)
+			{
+				if (it->page == page)
+				{
+					SDL_Rect target = { it->x, it->y, it->area.w, it->area.h };
+					SDL_BlitSurface(it->surface, &it->area, surface, &target);
+				}
+			}
+
+			std::string path = (m_directory / pageName.str()).string();
+			bool saved = (IMG_SavePNG(surface, path.c_str()) == 0);
+			SDL_FreeSurface(surface);
+
+			if (!saved)
+			{
+				std::cerr << path << ": " << IMG_GetError() << std::endl;
+				return false;
+			}
+		}
+
+		std::string path = (m_directory / (atlasName + ".xml")).string();
+		std::ofstream out(path.c_str());
+		if (!out)
+		{
+			std::cerr << "could not write " << path << std::endl;
+			return false;
+		}
+
+		out << "<?fife type=\"atlas\"?>" << std::endl;
+		for (int page = 0; page < m_packer.pages; ++page)
+		{
+			out << "<atlas name=\"" << pageNames[page] << "\" namespace=\"" << m_namespace << "\" width=\""
+				<< m_packer.widths[page] << "\" height=\"" << m_packer.heights[page] << "\">" << std::endl;
+
+			for (std::vector<Sprite>::const_iterator it = m_sprites.begin(); it != m_sprites.end(); ++it)
+			{
+				if (it->page == page)
+				{
+					out << "\t<image source=\"" << it->name << "\" xpos=\"" << it->x << "\" ypos=\"" << it->y
+						<< "\" width=\"" << it->area.w << "\" height=\"" << it->area.h << "\"/>" << std::endl;
+				}
+			}
+			out << "</atlas>" << std::endl;
+		}
+
+		for (std::vector<TiXmlElement*>::iterator it = m_objects.begin(); it != m_objects.end(); ++it)
+		{
+			TiXmlPrinter printer;
+			printer.SetIndent("\t");
+			(*it)->Accept(&printer);
+
+			out << std::endl << printer.CStr();
+			delete *it;
+		}
+		m_objects.clear();
+
+		return out.good();
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! deletes the object files and images that went into the atlas
+	//!
+	//! @return:
+	//! void
+	//!
+	//!***************************************************************
+	void Packer::RemoveSources()
+	{
+		for (std::vector<fs::path>::const_iterator it = m_sources.begin(); it != m_sources.end(); ++it)
+		{
+			boost::system::error_code error;
+			fs::remove(*it, error);
+		}
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! prints how many textures the objects needed before and after
+	//!
+	//! @return:
+	//! void
+	//!
+	//!***************************************************************
+	void Packer::PrintReport(const std::string& atlasName) const
+	{
+		std::cout << atlasName << ": " << m_sprites.size() << " sub-images of " << m_sourceImages << " images packed into "
+			<< m_packer.pages << " atlas page(s), textures " << m_sourceImages << " -> " << m_packer.pages << std::endl;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc != 3 && argc != 4)
+	{
+		std::cerr << "usage: " << argv[0] << " <object directory> <atlas name> [max atlas size]" << std::endl;
+		return 1;
+	}
+
+	fs::path directory(argv[1]);
+	std::string atlasName(argv[2]);
+	int maxSize = (argc == 4) ? std::atoi(argv[3]) : DefaultMaxAtlasSize;
+
+	if (maxSize <= 0)
+	{
+		std::cerr << "the atlas size must be positive" << std::endl;
+		return 1;
+	}
+
+	// a trailing slash would show up as a "." in the relative paths
+	if (directory.filename() == ".")
+	{
+		directory = directory.parent_path();
+	}
+
+	boost::system::error_code error;
+	if (!fs::is_directory(directory, error))
+	{
+		std::cerr << directory.string() << " is not a directory" << std::endl;
+		return 1;
+	}
+
+	// sorted so the atlas layout does not depend on the file system
+	std::vector<fs::path> objectFiles;
+	for (fs::recursive_directory_iterator it(directory, error), end; it != end; it.increment(error))
+	{
+		if (fs::is_regular_file(it->path(), error) && it->path().filename() == "object.xml")
+		{
+			objectFiles.push_back(it->path());
+		}
+	}
+	std::sort(objectFiles.begin(), objectFiles.end());
+
+	if (objectFiles.empty())
+	{
+		std::cout << atlasName << ": no object files below " << directory.string() << std::endl;
+		return 0;
+	}
+
+	Packer packer(directory, maxSize);
+	for (std::vector<fs::path>::const_iterator it = objectFiles.begin(); it != objectFiles.end(); ++it)
+	{
+		if (!packer.AddObjectFile(*it))
+		{
+			return 1;
+		}
+	}
+
+	if (!packer.Write(atlasName))
+	{
+		return 1;
+	}
+
+	packer.RemoveSources();
+	packer.PrintReport(atlasName);
+
+	return 0;
+}
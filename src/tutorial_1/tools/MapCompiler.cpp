@@ -0,0 +1,377 @@
+//*****************************************************************************
+// FILE NAME:  MapCompiler.cpp
+//
+//*****************************************************************************
+// offline compiler that turns a FIFE xml map into the binary map cache
+// read by MapCacheLoader, it only needs TinyXML and runs without the engine
+//
+// usage: MapCompiler <map.xml> <map cache>
+
+#include "../MapCacheFormat.h"
+
+// 3rd party includes
+#include "tinyxml.h"
+
+// standard includes
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace
+{
+	//!***************************************************************
+	//! @details:
+	//! makes sure an element only carries attributes the cache can
+	//! represent, anything else would be lost silently otherwise
+	//!
+	//! @param[in]: element
+	//! the element to check
+	//!
+	//! @param[in]: known
+	//! null terminated list of supported attribute names
+	//!
+	//! @return:
+	//! bool
+	//!
+	//!***************************************************************
+	bool CheckAttributes(const TiXmlElement* element, const char* const* known)
+	{
+		for (const TiXmlAttribute* attr = element->FirstAttribute(); attr; attr = attr->Next())
+		{
+			bool found = false;
+			for (const char* const* name = known; *name && !found; ++name)
+			{
+				found = (std::strcmp(attr->Name(), *name) == 0);
+			}
+
+			if (!found)
+			{
+				std::cerr << "unsupported attribute '" << attr->Name() << "' on <" << element->Value()
+					<< "> in line " << element->Row() << std::endl;
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! reads an optional string attribute
+	//!
+	//! @return:
+	//! std::string - the fallback if the attribute is missing
+	//!
+	//!***************************************************************
+	std::string GetString(const TiXmlElement* element, const char* name, const std::string& fallback = "")
+	{
+		const char* value = element->Attribute(name);
+		return value ? std::string(value) : fallback;
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! reads an optional number attribute
+	//!
+	//! @return:
+	//! double - the fallback if the attribute is missing
+	//!
+	//!***************************************************************
+	double GetDouble(const TiXmlElement* element, const char* name, double fallback)
+	{
+		double value = fallback;
+		element->QueryDoubleAttribute(name, &value);
+		return value;
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! interns an optional string attribute
+	//!
+	//! @return:
+	//! uint32_t - MapCache::NoString if the attribute is missing
+	//!
+	//!***************************************************************
+	uint32_t AddOptionalString(MapCache::Writer& writer, const TiXmlElement* element, const char* name)
+	{
+		const char* value = element->Attribute(name);
+		return value ? writer.AddString(value) : MapCache::NoString;
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! compiles the instances of one layer
+	//!
+	//! @param[in,out]: nameSpace
+	//! namespace of the previous instance, instances without a
+	//! namespace inherit it the same way the xml loader does
+	//!
+	//! @return:
+	//! bool
+	//!
+	//!***************************************************************
+	bool CompileInstances(MapCache::Writer& writer, const TiXmlElement* instances, std::string& nameSpace)
+	{
+		static const char* const known[] = {
+			"o", "object", "ns", "namespace", "x", "y", "z", "r", "rotation",
+			"id", "stackpos", "visitor_radius", "visitor_shape", 0
+		};
+
+		for (const TiXmlElement* element = instances->FirstChildElement(); element; element = element->NextSiblingElement())
+		{
+			if (std::strcmp(element->Value(), "i") != 0 && std::strcmp(element->Value(), "instance") != 0)
+			{
+				std::cerr << "unexpected <" << element->Value() << "> in line " << element->Row() << std::endl;
+				return false;
+			}
+
+			if (!CheckAttributes(element, known))
+			{
+				return false;
+			}
+
+			std::string objectId = GetString(element, "o", GetString(element, "object"));
+			nameSpace = GetString(element, "ns", GetString(element, "namespace", nameSpace));
+
+			if (objectId.empty() || nameSpace.empty())
+			{
+				std::cerr << "instance without object or namespace in line " << element->Row() << std::endl;
+				return false;
+			}
+
+			MapCache::Instance instance;
+			std::memset(&instance, 0, sizeof(instance));
+			instance.object = writer.AddObject(objectId, nameSpace);
+			instance.id = AddOptionalString(writer, element, "id");
+			instance.x = GetDouble(element, "x", 0.0);
+			instance.y = GetDouble(element, "y", 0.0);
+			instance.z = GetDouble(element, "z", 0.0);
+			instance.rotation = static_cast<int32_t>(GetDouble(element, "r", GetDouble(element, "rotation", 0.0)));
+
+			int stackPos = 0;
+			if (element->QueryIntAttribute("stackpos", &stackPos) == TIXML_SUCCESS)
+			{
+				instance.stackPos = stackPos;
+				instance.flags |= MapCache::INSTANCE_HAS_STACKPOS;
+			}
+
+			int visitorRadius = 0;
+			if (element->QueryIntAttribute("visitor_radius", &visitorRadius) == TIXML_SUCCESS)
+			{
+				instance.visitorRadius = visitorRadius;
+				instance.visitorShape = (GetString(element, "visitor_shape") == "quad") ? 1 : 0;
+				instance.flags |= MapCache::INSTANCE_VISITOR;
+			}
+
+			writer.AddInstance(instance);
+		}
+
+		return true;
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! compiles a layer and its instances
+	//!
+	//! @return:
+	//! bool
+	//!
+	//!***************************************************************
+	bool CompileLayer(MapCache::Writer& writer, const TiXmlElement* element, std::string& nameSpace)
+	{
+		static const char* const known[] = {
+			"id", "x_offset", "y_offset", "z_offset", "x_scale", "y_scale", "z_scale", "rotation",
+			"grid_type", "transparency", "pathing", "layer_type", "layer_type_id", 0
+		};
+
+		if (!CheckAttributes(element, known) || !element->Attribute("id"))
+		{
+			return false;
+		}
+
+		MapCache::Layer layer;
+		std::memset(&layer, 0, sizeof(layer));
+		layer.id = writer.AddString(GetString(element, "id"));
+		layer.gridType = writer.AddString(GetString(element, "grid_type", "square"));
+		layer.pathing = writer.AddString(GetString(element, "pathing", "cell_edges_only"));
+		layer.layerTypeId = AddOptionalString(writer, element, "layer_type_id");
+		layer.transparency = static_cast<uint32_t>(GetDouble(element, "transparency", 0.0));
+		layer.xOffset = GetDouble(element, "x_offset", 0.0);
+		layer.yOffset = GetDouble(element, "y_offset", 0.0);
+		layer.zOffset = GetDouble(element, "z_offset", 0.0);
+		layer.xScale = GetDouble(element, "x_scale", 1.0);
+		layer.yScale = GetDouble(element, "y_scale", 1.0);
+		layer.zScale = GetDouble(element, "z_scale", 1.0);
+		layer.rotation = GetDouble(element, "rotation", 0.0);
+
+		std::string layerType = GetString(element, "layer_type");
+		if (layerType == "walkable")
+		{
+			layer.layerType = MapCache::LAYER_WALKABLE;
+		}
+		else if (layerType == "interact")
+		{
+			layer.layerType = MapCache::LAYER_INTERACT;
+		}
+
+		writer.BeginLayer(layer);
+
+		for (const TiXmlElement* child = element->FirstChildElement(); child; child = child->NextSiblingElement())
+		{
+			if (std::strcmp(child->Value(), "instances") != 0)
+			{
+				std::cerr << "unexpected <" << child->Value() << "> in line " << child->Row() << std::endl;
+				return false;
+			}
+
+			if (!CompileInstances(writer, child, nameSpace))
+			{
+				return false;
+			}
+		}
+
+		writer.EndLayer();
+		return true;
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! compiles a camera
+	//!
+	//! @return:
+	//! bool
+	//!
+	//!***************************************************************
+	bool CompileCamera(MapCache::Writer& writer, const TiXmlElement* element)
+	{
+		static const char* const known[] = {
+			"id", "ref_layer_id", "ref_cell_width", "ref_cell_height", "tilt", "zoom", "rotation", "viewport", 0
+		};
+
+		if (!CheckAttributes(element, known) || !element->Attribute("id") || !element->Attribute("ref_layer_id"))
+		{
+			return false;
+		}
+
+		MapCache::Camera camera;
+		std::memset(&camera, 0, sizeof(camera));
+		camera.id = writer.AddString(GetString(element, "id"));
+		camera.refLayer = writer.AddString(GetString(element, "ref_layer_id"));
+		camera.refCellWidth = static_cast<int32_t>(GetDouble(element, "ref_cell_width", 0.0));
+		camera.refCellHeight = static_cast<int32_t>(GetDouble(element, "ref_cell_height", 0.0));
+		camera.tilt = GetDouble(element, "tilt", 0.0);
+		camera.zoom = GetDouble(element, "zoom", 1.0);
+		camera.rotation = GetDouble(element, "rotation", 0.0);
+
+		const char* viewport = element->Attribute("viewport");
+		if (viewport)
+		{
+			int x, y, w, h;
+			if (std::sscanf(viewport, "%d,%d,%d,%d", &x, &y, &w, &h) != 4)
+			{
+				std::cerr << "malformed viewport in line " << element->Row() << std::endl;
+				return false;
+			}
+
+			camera.viewport[0] = x;
+			camera.viewport[1] = y;
+			camera.viewport[2] = w;
+			camera.viewport[3] = h;
+			camera.hasViewport = 1;
+		}
+
+		writer.AddCamera(camera);
+		return true;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc != 3)
+	{
+		std::cerr << "usage: " << argv[0] << " <map.xml> <map cache>" << std::endl;
+		return 1;
+	}
+
+	std::string source(argv[1]);
+	std::string target(argv[2]);
+
+	MapCache::Writer writer;
+
+	uint64_t hash = 0;
+	uint64_t size = 0;
+	if (!MapCache::HashFile(source, hash, size))
+	{
+		std::cerr << "could not read " << source << std::endl;
+		return 1;
+	}
+	writer.SetSource(hash, size);
+
+	TiXmlDocument document;
+	if (!document.LoadFile(source.c_str()))
+	{
+		std::cerr << source << ": " << document.ErrorDesc() << std::endl;
+		return 1;
+	}
+
+	const TiXmlElement* root = document.RootElement();
+	if (!root || std::strcmp(root->Value(), "map") != 0 || !root->Attribute("id"))
+	{
+		std::cerr << source << " is not a map file" << std::endl;
+		return 1;
+	}
+
+	writer.SetMap(GetString(root, "id"), GetString(root, "format", "1.0"));
+
+	std::string nameSpace;
+	bool ok = true;
+
+	for (const TiXmlElement* element = root->FirstChildElement(); element && ok; element = element->NextSiblingElement())
+	{
+		std::string name(element->Value());
+
+		if (name == "import")
+		{
+			static const char* const known[] = { "file", "dir", 0 };
+			ok = CheckAttributes(element, known);
+
+			MapCache::Import import;
+			std::memset(&import, 0, sizeof(import));
+			import.kind = element->Attribute("file") ? MapCache::IMPORT_FILE : MapCache::IMPORT_DIRECTORY;
+			import.file = AddOptionalString(writer, element, "file");
+			import.directory = AddOptionalString(writer, element, "dir");
+			writer.AddImport(import);
+		}
+		else if (name == "layer")
+		{
+			ok = CompileLayer(writer, element, nameSpace);
+		}
+		else if (name == "camera")
+		{
+			ok = CompileCamera(writer, element);
+		}
+		else
+		{
+			std::cerr << "unexpected <" << name << "> in line " << element->Row() << std::endl;
+			ok = false;
+		}
+	}
+
+	if (!ok)
+	{
+		std::cerr << source << " can not be cached" << std::endl;
+		return 1;
+	}
+
+	if (!writer.Write(target))
+	{
+		std::cerr << "could not write " << target << std::endl;
+		return 1;
+	}
+
+	std::cout << source << " -> " << target << ": " << writer.GetInstanceCount() << " instances, "
+		<< writer.GetObjectCount() << " distinct objects" << std::endl;
+
+	return 0;
+}
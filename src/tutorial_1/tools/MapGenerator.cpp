@@ -0,0 +1,211 @@
+//*****************************************************************************
+// FILE NAME:  MapGenerator.cpp
+//
+//*****************************************************************************
+// writes synthetic maps of a given size built from the bundled object sets,
+// used to measure how loading and rendering scale with the instance count
+//
+// usage: MapGenerator <instance count> <map.xml> [seed]
+//
+// the map has the same layers, cameras and named instances (PC, NPC:girl)
+// as shrine.xml and must be written to assets/maps so its imports resolve
+
+// standard includes
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace
+{
+	const char* Namespace = "http://www.fifengine.net/xml/rio_de_hola";
+
+	// ground tiles, water is rarer than sand
+	const char* Tiles[] = { "sands:01", "sands:01", "sands:01", "sands:02", "beach:01", "beach:02", "water" };
+
+	// static props on the object layer, trees and bushes from nature.xml,
+	// items and buildings
+	const char* Props[] = {
+		"trees:02", "trees:03", "trees:04", "trees:05", "trees:06", "bushes:05", "bushes:06",
+		"bushes:16", "bushes:17", "bushes:18", "rocks:01", "rocks:02", "rocks:03", "roots:03",
+		"sign:000", "beebox", "empty_lid", "red_chair", "blue_sunshade", "beach_bar", "priest_hut"
+	};
+
+	// agents from assets/objects/agents
+	const char* Agents[] = {
+		"boy", "girl", "bee", "beekeeper", "chemist", "hippie_priest", "merchant",
+		"tourist_female1", "tourist_female2", "tourist_male1", "tourist_male2"
+	};
+
+	// share of the instances that are props and agents, the rest are tiles
+	const double PropShare = 0.25;
+	const double AgentShare = 0.01;
+
+	//!***************************************************************
+	//! @details:
+	//! small deterministic generator so a size and seed always give
+	//! the same map on every platform
+	//!
+	//!***************************************************************
+	class Random
+	{
+	public:
+		explicit Random(unsigned long seed)
+		: m_state(seed * 2654435761UL + 1)
+		{
+
+		}
+
+		unsigned long Next()
+		{
+			m_state = (m_state * 1103515245UL + 12345UL) & 0x7fffffffUL;
+			return m_state;
+		}
+
+		int Range(int count)
+		{
+			return static_cast<int>(Next() % static_cast<unsigned long>(count));
+		}
+	private:
+		unsigned long m_state;
+	};
+
+	template<typename T, int N>
+	int CountOf(T (&)[N])
+	{
+		return N;
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! writes one instance element
+	//!
+	//!***************************************************************
+	void WriteInstance(std::ostream& out, const char* object, int x, int y, int rotation, const char* id = 0)
+	{
+		out << "\t\t\t<i x=\"" << x << ".0\" o=\"" << object << "\" y=\"" << y << ".0\" r=\"" << rotation << "\"";
+		if (id)
+		{
+			out << " id=\"" << id << "\"";
+		}
+		out << " z=\"0.0\" ns=\"" << Namespace << "\"></i>\n";
+	}
+
+	//!***************************************************************
+	//! @details:
+	//! writes a layer header with the shrine.xml grid settings
+	//!
+	//!***************************************************************
+	void BeginLayer(std::ostream& out, const char* id, const char* scale, const char* type, const char* typeId)
+	{
+		out << "\t<layer x_offset=\"0.0\" pathing=\"cell_edges_and_diagonals\" y_offset=\"0.0\" grid_type=\"square\" id=\""
+			<< id << "\" transparency=\"0\" x_scale=\"" << scale << "\" y_scale=\"" << scale
+			<< "\" rotation=\"0.0\" layer_type=\"" << type << "\"";
+		if (typeId)
+		{
+			out << " layer_type_id=\"" << typeId << "\"";
+		}
+		out << ">\n\t\t<instances>\n";
+	}
+
+	void EndLayer(std::ostream& out)
+	{
+		out << "\t\t</instances>\n\t</layer>\n";
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3)
+	{
+		std::cerr << "usage: " << argv[0] << " <instance count> <map.xml> [seed]" << std::endl;
+		return 1;
+	}
+
+	long count = std::atol(argv[1]);
+	unsigned long seed = (argc > 3) ? std::strtoul(argv[3], 0, 10) : 1;
+
+	if (count < 100)
+	{
+		std::cerr << "instance count must be at least 100" << std::endl;
+		return 1;
+	}
+
+	std::ofstream out(argv[2]);
+	if (!out)
+	{
+		std::cerr << "could not write " << argv[2] << std::endl;
+		return 1;
+	}
+
+	Random random(seed);
+
+	long agentCount = static_cast<long>(count * AgentShare);
+	long propCount = static_cast<long>(count * PropShare);
+
+	// tiles cover a square centered on the origin, the object layer
+	// has half the cell size so it spans twice the coordinates
+	int side = static_cast<int>(std::sqrt(static_cast<double>(count - propCount - agentCount)));
+	int half = side / 2;
+	long tileCount = static_cast<long>(side) * side;
+
+	// rounding leftovers become props so the total is exact
+	propCount = count - agentCount - tileCount - 2;
+
+	out << "<?xml version=\"1.0\" encoding=\"ascii\"?>\n"
+		<< "<map id=\"Generated" << count << "\" format=\"1.0\">\n"
+		<< "\t<import dir=\"../objects/agents\"/>\n"
+		<< "\t<import dir=\"../objects/clouds\"/>\n"
+		<< "\t<import dir=\"../objects/crates\"/>\n"
+		<< "\t<import file=\"../objects/buildings.xml\"/>\n"
+		<< "\t<import file=\"../objects/ground1.xml\"/>\n"
+		<< "\t<import file=\"../objects/ground2.xml\"/>\n"
+		<< "\t<import file=\"../objects/items1.xml\"/>\n"
+		<< "\t<import file=\"../objects/items2.xml\"/>\n"
+		<< "\t<import file=\"../objects/nature.xml\"/>\n";
+
+	BeginLayer(out, "TechdemoMapTileLayer", "1.0", "interact", "TechdemoMapGroundObjectLayer");
+	for (int y = -half; y < side - half; ++y)
+	{
+		for (int x = -half; x < side - half; ++x)
+		{
+			WriteInstance(out, Tiles[random.Range(CountOf(Tiles))], x, y, 0);
+		}
+	}
+	EndLayer(out);
+
+	BeginLayer(out, "TechdemoMapGroundObjectLayer", "0.5", "walkable", 0);
+	WriteInstance(out, "boy", 5, 4, 0, "PC");
+	WriteInstance(out, "girl", 8, 2, 0, "NPC:girl");
+
+	int extent = 2 * side;
+	for (long i = 0; i < propCount; ++i)
+	{
+		WriteInstance(out, Props[random.Range(CountOf(Props))], random.Range(extent) - side,
+			random.Range(extent) - side, 45 * random.Range(8));
+	}
+	for (long i = 0; i < agentCount; ++i)
+	{
+		WriteInstance(out, Agents[random.Range(CountOf(Agents))], random.Range(extent) - side,
+			random.Range(extent) - side, 45 * random.Range(8));
+	}
+	EndLayer(out);
+
+	out << "\t<camera ref_cell_width=\"62\" zoom=\"1.0\" tilt=\"-41.9\" id=\"main\" ref_layer_id=\"TechdemoMapGroundObjectLayer\" ref_cell_height=\"47\" rotation=\"45.0\">\n"
+		<< "\t</camera>\n"
+		<< "\t<camera ref_cell_width=\"126\" zoom=\"1.0\" tilt=\"-41.9\" viewport=\"10,10,400,250\" id=\"small\" ref_layer_id=\"TechdemoMapTileLayer\" ref_cell_height=\"96\" rotation=\"45.0\">\n"
+		<< "\t</camera>\n"
+		<< "</map>\n";
+
+	if (!out)
+	{
+		std::cerr << "could not write " << argv[2] << std::endl;
+		return 1;
+	}
+
+	std::cout << argv[2] << ": " << tileCount << " tiles, " << propCount << " props, "
+		<< agentCount << " agents" << std::endl;
+
+	return 0;
+}
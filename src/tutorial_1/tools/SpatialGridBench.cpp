@@ -0,0 +1,143 @@
+//*****************************************************************************
+// FILE NAME:  SpatialGridBench.cpp
+//
+//*****************************************************************************
+// measures the spatial grid used for instance picking against a linear
+// scan over all instances, the way picking on the layer lists would work
+//
+// usage: SpatialGridBench [instance count]
+
+#include "../SpatialGrid.h"
+
+// standard includes
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+	// layer cells per instance, about the density of the generated maps
+	const double CellsPerInstance = 4.0;
+
+	// radius and size of the queries, a click and a typical drag box
+	const double PointRadius = 1.5;
+	const double RectWidth = 24.0;
+	const double RectHeight = 16.0;
+
+	const int PointQueries = 20000;
+	const int RectQueries = 2000;
+	const int LinearQueries = 200;
+
+	struct Position
+	{
+		double x;
+		double y;
+	};
+
+	double Random(double range)
+	{
+		return range * (static_cast<double>(std::rand()) / RAND_MAX);
+	}
+
+	double MicrosecondsSince(std::clock_t start, int count)
+	{
+		return 1e6 * static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC / count;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int count = (argc > 1) ? std::atoi(argv[1]) : 100000;
+	if (count <= 0)
+	{
+		std::cerr << "usage: " << argv[0] << " [instance count]" << std::endl;
+		return 1;
+	}
+
+	std::srand(1);
+
+	// only the addresses are used, the grid never touches the instances
+	std::vector<char> storage(count);
+	std::vector<FIFE::Instance*> instances(count);
+	std::vector<Position> positions(count);
+
+	double extent = std::sqrt(count * CellsPerInstance);
+	for (int i = 0; i < count; ++i)
+	{
+		instances[i] = reinterpret_cast<FIFE::Instance*>(&storage[i]);
+		positions[i].x = Random(extent);
+		positions[i].y = Random(extent);
+	}
+
+	SpatialGrid grid;
+	std::vector<FIFE::Instance*> result;
+	size_t found = 0;
+
+	std::clock_t start = std::clock();
+	for (int i = 0; i < count; ++i)
+	{
+		grid.Insert(instances[i], positions[i].x, positions[i].y);
+	}
+	double insertUs = MicrosecondsSince(start, count);
+
+	start = std::clock();
+	for (int i = 0; i < count; ++i)
+	{
+		positions[i].x += Random(2.0) - 1.0;
+		positions[i].y += Random(2.0) - 1.0;
+		grid.Move(instances[i], positions[i].x, positions[i].y);
+	}
+	double moveUs = MicrosecondsSince(start, count);
+
+	start = std::clock();
+	for (int i = 0; i < PointQueries; ++i)
+	{
+		grid.QueryPoint(Random(extent), Random(extent), PointRadius, result);
+		found += result.size();
+	}
+	double pointUs = MicrosecondsSince(start, PointQueries);
+
+	start = std::clock();
+	for (int i = 0; i < RectQueries; ++i)
+	{
+		double x = Random(extent);
+		double y = Random(extent);
+		grid.QueryRect(x, y, x + RectWidth, y + RectHeight, result);
+		found += result.size();
+	}
+	double rectUs = MicrosecondsSince(start, RectQueries);
+
+	// the same point query walking every instance
+	start = std::clock();
+	for (int i = 0; i < LinearQueries; ++i)
+	{
+		double x = Random(extent);
+		double y = Random(extent);
+		result.clear();
+		for (int j = 0; j < count; ++j)
+		{
+			double dx = positions[j].x - x;
+			double dy = positions[j].y - y;
+			if (dx * dx + dy * dy <= PointRadius * PointRadius)
+			{
+				result.push_back(instances[j]);
+			}
+		}
+		found += result.size();
+	}
+	double linearUs = MicrosecondsSince(start, LinearQueries);
+
+	std::cout << std::fixed << std::setprecision(3)
+		<< "instances:          " << grid.GetSize() << std::endl
+		<< "insert:             " << insertUs << " us" << std::endl
+		<< "move:               " << moveUs << " us" << std::endl
+		<< "point query:        " << pointUs << " us" << std::endl
+		<< "rect query:         " << rectUs << " us" << std::endl
+		<< "linear point query: " << linearUs << " us" << std::endl
+		<< "(" << found << " results)" << std::endl;
+
+	return 0;
+}